@@ -0,0 +1,333 @@
+/*
+ * ldfbench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of LIN databases over synthetic files of several scales, or over
+ * existing files:
+ *
+ *   ldfbench [-i iterations] [small|medium|large|huge|name=value,...|file.ldf] ...
+ *
+ * Every scale runs in its own process so the peak RSS belongs to it alone. One
+ * line is printed per scale and phase (parse, sort, validate, lookup and save)
+ * with space separated key=value fields:
+ *
+ *   scale=large phase=parse iterations=3 bytes=3345537 ops=1 ms=86.876
+ *     min_ms=81.454 mb_s=38.5 ops_s=11.5 allocs=201912 frees=33392
+ *     alloc_bytes=45631768 peak_rss_kb=33604
+ *
+ * Times, allocation counts and allocated bytes are averages of one iteration.
+ * Parsing includes indexing and validating the database, as the constructor
+ * does both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <atomic>
+#include <stdexcept>
+#include <ldf.h>
+#include <ldfsynthetic.h>
+#include <linclock.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+/*
+ * Allocation counters. The C library allocator is wrapped, so both malloc() and
+ * operator new are counted, the latter allocating through malloc().
+ */
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+extern "C" void __libc_free(void *p);
+
+static atomic<uint64_t> allocs(0);
+static atomic<uint64_t> frees(0);
+static atomic<uint64_t> alloc_bytes(0);
+
+extern "C" void *malloc(size_t size) noexcept
+{
+	allocs.fetch_add(1, memory_order_relaxed);
+	alloc_bytes.fetch_add(size, memory_order_relaxed);
+	return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) noexcept
+{
+	allocs.fetch_add(1, memory_order_relaxed);
+	alloc_bytes.fetch_add(n * size, memory_order_relaxed);
+	return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *p, size_t size) noexcept
+{
+	allocs.fetch_add(1, memory_order_relaxed);
+	alloc_bytes.fetch_add(size, memory_order_relaxed);
+	return __libc_realloc(p, size);
+}
+
+extern "C" void free(void *p) noexcept
+{
+	if (p) frees.fetch_add(1, memory_order_relaxed);
+	__libc_free(p);
+}
+
+
+// Measures of a phase, added up over the iterations
+struct phase_s
+{
+	const char *name;
+	double total;
+	double min;
+	uint64_t ops;
+	uint64_t allocs;
+	uint64_t frees;
+	uint64_t alloc_bytes;
+
+	// Counters when the current iteration started
+	double start;
+	uint64_t start_allocs;
+	uint64_t start_frees;
+	uint64_t start_alloc_bytes;
+};
+
+
+static void PhaseStart(phase_s *p)
+{
+	p->start_allocs = allocs.load();
+	p->start_frees = frees.load();
+	p->start_alloc_bytes = alloc_bytes.load();
+	p->start = linclock::Now() / 1e9;
+}
+
+static void PhaseEnd(phase_s *p, uint64_t ops)
+{
+	double t = linclock::Now() / 1e9 - p->start;
+
+	p->total += t;
+	if (p->min == 0 || t < p->min) p->min = t;
+	p->ops += ops;
+	p->allocs += allocs.load() - p->start_allocs;
+	p->frees += frees.load() - p->start_frees;
+	p->alloc_bytes += alloc_bytes.load() - p->start_alloc_bytes;
+}
+
+static void PhasePrint(const char *scale, phase_s *p, uint32_t iterations, size_t bytes)
+{
+	struct rusage usage;
+	double mean = p->total / iterations;
+
+	getrusage(RUSAGE_SELF, &usage);
+	printf("scale=%s phase=%s iterations=%u bytes=%zu ops=%llu ms=%.3f min_ms=%.3f mb_s=%.1f ops_s=%.1f "
+			"allocs=%llu frees=%llu alloc_bytes=%llu peak_rss_kb=%ld\n",
+			scale, p->name, iterations, bytes, (unsigned long long)(p->ops / iterations),
+			1000.0 * mean, 1000.0 * p->min, (mean > 0) ? bytes / mean / 1e6 : 0,
+			(mean > 0) ? p->ops / iterations / mean : 0,
+			(unsigned long long)(p->allocs / iterations), (unsigned long long)(p->frees / iterations),
+			(unsigned long long)(p->alloc_bytes / iterations), usage.ru_maxrss);
+}
+
+static uint8_t **CopyNames(uint32_t count, const uint8_t *(*name)(ldf *db, uint32_t ix), ldf *db)
+{
+	uint8_t **names = (uint8_t **)malloc((count + 1) * sizeof(names[0]));
+
+	// Callers look up names they own, not the interned ones
+	for (uint32_t i = 0; i < count; i++)
+		names[i] = (uint8_t *)strdup((const char *)name(db, i));
+	names[count] = NULL;
+
+	return names;
+}
+
+static void FreeNames(uint8_t **names)
+{
+	for (uint32_t i = 0; names[i]; i++)
+		free(names[i]);
+	free(names);
+}
+
+static int RunScale(const char *scale, uint32_t iterations)
+{
+	char source[] = "/tmp/ldfbench.XXXXXX";
+	char saved[] = "/tmp/ldfbench.XXXXXX";
+	const char *filename = scale;
+	ldfsynthetic::ldfsynthetic_params_s params;
+	struct stat st;
+	phase_s parse = { "parse" };
+	phase_s sort = { "sort" };
+	phase_s validate = { "validate" };
+	phase_s lookup = { "lookup" };
+	phase_s save = { "save" };
+	int fd;
+
+	// Temporary files for generated and saved databases
+	fd = mkstemp(saved);
+	if (fd < 0)
+	{
+		perror("mkstemp");
+		return 1;
+	}
+	close(fd);
+
+	// Existing files are benchmarked as they are, scales are generated first
+	if (stat(scale, &st) != 0)
+	{
+		ldfwriter w;
+
+		if (!ldfsynthetic::ParseScale(scale, &params))
+		{
+			fprintf(stderr, "Invalid scale '%s'\n", scale);
+			unlink(saved);
+			return 2;
+		}
+
+		fd = mkstemp(source);
+		if (fd < 0)
+		{
+			perror("mkstemp");
+			unlink(saved);
+			return 1;
+		}
+		close(fd);
+
+		ldfsynthetic::Generate(&params, &w);
+		w.WriteFile((const uint8_t *)source);
+		filename = source;
+		stat(filename, &st);
+	}
+
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		uint8_t **signal_names, **frame_names, **node_names, **table_names;
+		uint64_t ops;
+		ldf *db;
+
+		// Parse
+		PhaseStart(&parse);
+		try
+		{
+			db = new ldf((const uint8_t *)filename);
+		}
+		catch (const exception &e)
+		{
+			fprintf(stderr, "%s\n", e.what());
+			if (filename == source) unlink(source);
+			unlink(saved);
+			return 1;
+		}
+		PhaseEnd(&parse, 1);
+
+		// Sort
+		PhaseStart(&sort);
+		db->SortData();
+		PhaseEnd(&sort, 1);
+
+		// Validate
+		PhaseStart(&validate);
+		db->Validate();
+		PhaseEnd(&validate, 1);
+
+		// Look up every name and frame ID
+		signal_names = CopyNames(db->GetSignalsCount(),
+				[](ldf *db, uint32_t ix) -> const uint8_t * { return db->GetSignalByIndex(ix)->GetName(); }, db);
+		frame_names = CopyNames(db->GetFramesCount(),
+				[](ldf *db, uint32_t ix) -> const uint8_t * { return db->GetFrameByIndex(ix)->GetName(); }, db);
+		node_names = CopyNames(db->GetSlaveNodesCount(),
+				[](ldf *db, uint32_t ix) -> const uint8_t * { return db->GetSlaveNodeByIndex(ix)->GetName(); }, db);
+		table_names = CopyNames(db->GetScheduleTablesCount(),
+				[](ldf *db, uint32_t ix) -> const uint8_t * { return db->GetScheduleTableByIndex(ix)->GetName(); }, db);
+
+		ops = db->GetSignalsCount() + db->GetFramesCount() + db->GetSlaveNodesCount() + db->GetScheduleTablesCount() + 64;
+
+		PhaseStart(&lookup);
+		for (uint32_t j = 0; signal_names[j]; j++)
+			db->GetSignalByName(signal_names[j]);
+		for (uint32_t j = 0; frame_names[j]; j++)
+			db->GetFrameByName(frame_names[j]);
+		for (uint32_t j = 0; node_names[j]; j++)
+			db->GetSlaveNodeAttributesByName(node_names[j]);
+		for (uint32_t j = 0; table_names[j]; j++)
+			db->GetScheduleTableByName(table_names[j]);
+		for (uint32_t id = 0; id < 64; id++)
+			db->GetFrameById(id);
+		PhaseEnd(&lookup, ops);
+
+		FreeNames(signal_names);
+		FreeNames(frame_names);
+		FreeNames(node_names);
+		FreeNames(table_names);
+
+		// Save
+		PhaseStart(&save);
+		db->Save((const uint8_t *)saved);
+		PhaseEnd(&save, 1);
+
+		delete db;
+	}
+
+	if (filename == source) unlink(source);
+	unlink(saved);
+
+	// Byte throughputs refer to the size of the file
+	PhasePrint(scale, &parse, iterations, st.st_size);
+	PhasePrint(scale, &sort, iterations, st.st_size);
+	PhasePrint(scale, &validate, iterations, st.st_size);
+	PhasePrint(scale, &lookup, iterations, st.st_size);
+	PhasePrint(scale, &save, iterations, st.st_size);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *default_scales[] = { "small", "medium", "large" };
+	const char **scales = default_scales;
+	uint32_t scales_count = sizeof(default_scales) / sizeof(default_scales[0]);
+	uint32_t iterations = 5;
+	int result = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "i:")) != -1)
+	{
+		if (opt == 'i')
+		{
+			iterations = atoi(optarg);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-i iterations] [small|medium|large|huge|name=value,...|file.ldf] ...\n", argv[0]);
+			return 2;
+		}
+	}
+	if (iterations == 0) iterations = 1;
+	if (optind < argc)
+	{
+		scales = (const char **)&argv[optind];
+		scales_count = argc - optind;
+	}
+
+	// One process per scale
+	for (uint32_t i = 0; i < scales_count; i++)
+	{
+		int status;
+		pid_t pid;
+
+		fflush(stdout);
+		pid = fork();
+		if (pid == 0)
+			exit(RunScale(scales[i], iterations));
+
+		if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			result = 1;
+	}
+
+	return result;
+}
@@ -0,0 +1,56 @@
+/*
+ * ldfgen.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Generator of synthetic LIN databases. The scale is a name (small, medium,
+ * large or huge) or a list of parameters overriding the medium scale:
+ *
+ *   ldfgen <scale> [output.ldf]
+ *   ldfgen frames=2000,slaves=32,signals_per_frame=4 big.ldf
+ *
+ * Parameters are slaves, frames, signals_per_frame, schedule_tables,
+ * table_entries, encoding_types and logical_values. The database is printed
+ * to the standard output when no file is given.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <ldfsynthetic.h>
+
+
+using namespace lin;
+
+
+int main(int argc, char *argv[])
+{
+	ldfsynthetic::ldfsynthetic_params_s params;
+
+	if (argc < 2 || !ldfsynthetic::ParseScale(argv[1], &params))
+	{
+		fprintf(stderr, "Usage: %s <small|medium|large|huge|name=value,...> [output.ldf]\n", argv[0]);
+		return 2;
+	}
+
+	// Stream to the standard output
+	if (argc < 3)
+	{
+		ldfwriter w(STDOUT_FILENO);
+
+		ldfsynthetic::Generate(&params, &w);
+		return w.Flush() ? 0 : 1;
+	}
+
+	// Or write the whole file at once
+	ldfwriter w;
+
+	ldfsynthetic::Generate(&params, &w);
+	if (!w.WriteFile((const uint8_t *)argv[2]))
+	{
+		perror(argv[2]);
+		return 1;
+	}
+
+	return 0;
+}
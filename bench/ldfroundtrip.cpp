@@ -0,0 +1,97 @@
+/*
+ * ldfroundtrip.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Round trip benchmark of LIN databases: parse a file, save it and parse the
+ * saved file again, checking that a second save gives the same bytes.
+ *
+ *   ldfroundtrip <file.ldf> [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <ldf.h>
+#include <linclock.h>
+
+
+using namespace lin;
+
+
+int main(int argc, char *argv[])
+{
+	char saved[] = "/tmp/ldfroundtrip.XXXXXX";
+	uint32_t iterations;
+	double parse = 0, save = 0, reparse = 0;
+	size_t size = 0;
+	bool identical = true;
+
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <file.ldf> [iterations]\n", argv[0]);
+		return 2;
+	}
+	iterations = (argc > 2) ? atoi(argv[2]) : 10;
+	if (iterations == 0) iterations = 1;
+
+	// Temporary file for saved databases
+	int fd = mkstemp(saved);
+	if (fd < 0)
+	{
+		perror("mkstemp");
+		return 1;
+	}
+	close(fd);
+
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		double t0, t1, t2, t3;
+		ldf *db, *db2;
+		ldfwriter w1, w2;
+
+		try
+		{
+			// Parse, save and parse the saved file
+			t0 = linclock::Now() / 1e9;
+			db = new ldf((const uint8_t *)argv[1]);
+			t1 = linclock::Now() / 1e9;
+			db->Save((const uint8_t *)saved);
+			t2 = linclock::Now() / 1e9;
+			db2 = new ldf((const uint8_t *)saved);
+			t3 = linclock::Now() / 1e9;
+		}
+		catch (const std::exception &e)
+		{
+			fprintf(stderr, "%s\n", e.what());
+			unlink(saved);
+			return 1;
+		}
+
+		parse += t1 - t0;
+		save += t2 - t1;
+		reparse += t3 - t2;
+
+		// Saving the reparsed database gives the same text
+		db->ToLdfFile(&w1);
+		db2->ToLdfFile(&w2);
+		size = w1.GetLength();
+		if (w1.GetLength() != w2.GetLength() || memcmp(w1.GetBuffer(), w2.GetBuffer(), w1.GetLength()) != 0)
+			identical = false;
+
+		delete db;
+		delete db2;
+	}
+
+	unlink(saved);
+
+	printf("file=%s iterations=%u bytes=%zu\n", argv[1], iterations, size);
+	printf("parse_ms=%.3f save_ms=%.3f reparse_ms=%.3f\n",
+			1000.0 * parse / iterations, 1000.0 * save / iterations, 1000.0 * reparse / iterations);
+	printf("save_mb_s=%.1f identical=%s\n", size / (save / iterations) / 1e6, identical ? "yes" : "no");
+
+	return identical ? 0 : 1;
+}
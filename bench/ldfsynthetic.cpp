@@ -0,0 +1,324 @@
+/*
+ * ldfsynthetic.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <stdexcept>
+#include <linprotocol.h>
+#include <ldfsynthetic.h>
+
+
+// Unconditional frame IDs available in LIN 2.x, the ones below the diagnostic frames
+#define LDFSYNTHETIC_FRAME_IDS				LIN_PROTOCOL_MASTER_REQUEST_ID
+
+
+namespace lin {
+
+// Named scales, from the size of a real database to a whole vehicle
+static const struct
+{
+	const char *name;
+	ldfsynthetic::ldfsynthetic_params_s params;
+} scales[] =
+{
+	{ "small",	{ 4,	16,		4,	2,		16,		4,		4 } },
+	{ "medium",	{ 16,	256,	8,	8,		64,		32,		8 } },
+	{ "large",	{ 64,	4096,	8,	32,		256,	256,	16 } },
+	{ "huge",	{ 256,	32768,	8,	128,	1024,	1024,	32 } },
+};
+
+void ldfsynthetic::GetDefaultParams(ldfsynthetic_params_s *params)
+{
+	*params = scales[1].params;
+}
+
+bool ldfsynthetic::ParseScale(const char *scale, ldfsynthetic_params_s *params)
+{
+	char *text, *item, *save = NULL;
+	bool ok = true;
+
+	// A scale name
+	for (uint32_t i = 0; i < sizeof(scales) / sizeof(scales[0]); i++)
+	{
+		if (strcmp(scale, scales[i].name) == 0)
+		{
+			*params = scales[i].params;
+			return true;
+		}
+	}
+
+	// Or a list of parameters overriding the default scale, like "frames=1000,slaves=8"
+	GetDefaultParams(params);
+	text = strdup(scale);
+	for (item = strtok_r(text, ",", &save); ok && item; item = strtok_r(NULL, ",", &save))
+	{
+		char *value = strchr(item, '=');
+		uint32_t v;
+
+		if (value == NULL)
+		{
+			ok = false;
+			break;
+		}
+		*value++ = 0;
+		v = strtoul(value, NULL, 0);
+
+		if (strcmp(item, "slaves") == 0) params->slaves = v;
+		else if (strcmp(item, "frames") == 0) params->frames = v;
+		else if (strcmp(item, "signals_per_frame") == 0) params->signals_per_frame = v;
+		else if (strcmp(item, "schedule_tables") == 0) params->schedule_tables = v;
+		else if (strcmp(item, "table_entries") == 0) params->table_entries = v;
+		else if (strcmp(item, "encoding_types") == 0) params->encoding_types = v;
+		else if (strcmp(item, "logical_values") == 0) params->logical_values = v;
+		else ok = false;
+	}
+	free(text);
+
+	// Every frame has at least one signal and a publisher
+	if (params->slaves == 0 || params->signals_per_frame == 0 || params->signals_per_frame > 64)
+		ok = false;
+
+	return ok;
+}
+
+static void Name(ldfwriter *w, const char *prefix, uint32_t ix)
+{
+	w->Text(prefix);
+	w->Dec(ix);
+}
+
+static void FramePublisher(ldfwriter *w, const ldfsynthetic::ldfsynthetic_params_s *p, uint32_t frame)
+{
+	// One frame in four is published by the master
+	if (frame % 4 == 0)
+		w->Text("Master");
+	else
+		Name(w, "Slave_", frame % p->slaves);
+}
+
+static void FrameSubscriber(ldfwriter *w, const ldfsynthetic::ldfsynthetic_params_s *p, uint32_t frame)
+{
+	if (frame % 4 == 0)
+		Name(w, "Slave_", frame % p->slaves);
+	else
+		w->Text("Master");
+}
+
+static void SignalName(ldfwriter *w, uint32_t frame, uint32_t ix)
+{
+	Name(w, "Sig_", frame);
+	Name(w, "_", ix);
+}
+
+void ldfsynthetic::Generate(const ldfsynthetic_params_s *p, ldfwriter *w)
+{
+	uint32_t signal_size = 64 / p->signals_per_frame;
+
+	// Scalar signals are 16 bits long at most
+	if (signal_size > 16) signal_size = 16;
+
+	// Header
+	w->Text("LIN_description_file ;\n");
+	w->Text("LIN_protocol_version = \"2.1\" ;\n");
+	w->Text("LIN_language_version = \"2.1\" ;\n");
+	w->Text("LIN_speed = 19.2 kbps ;\n");
+
+	// Nodes
+	w->Text("Nodes {\n    Master: Master, 5 ms, 0.1 ms ;\n    Slaves: ");
+	for (uint32_t i = 0; i < p->slaves; i++)
+	{
+		if (i > 0) w->Text(", ");
+		Name(w, "Slave_", i);
+	}
+	w->Text(" ;\n}\n");
+
+	// Signals
+	w->Text("Signals {\n");
+	for (uint32_t f = 0; f < p->frames; f++)
+	{
+		for (uint32_t i = 0; i < p->signals_per_frame; i++)
+		{
+			w->Text("    ");
+			SignalName(w, f, i);
+			w->Text(": ");
+			w->Dec(signal_size);
+			w->Text(", 0x");
+			w->Hex((f + i) & ((1 << signal_size) - 1), 1, false);
+			w->Text(", ");
+			FramePublisher(w, p, f);
+			w->Text(", ");
+			FrameSubscriber(w, p, f);
+			w->Text(" ;\n");
+		}
+	}
+	w->Text("}\n");
+
+	// Frames
+	w->Text("Frames {\n");
+	for (uint32_t f = 0; f < p->frames; f++)
+	{
+		Name(w, "    Frm_", f);
+		w->Text(": 0x");
+		w->Hex(f % LDFSYNTHETIC_FRAME_IDS, 2, true);
+		w->Text(", ");
+		FramePublisher(w, p, f);
+		w->Text(", 8 {\n");
+		for (uint32_t i = 0; i < p->signals_per_frame; i++)
+		{
+			w->Text("        ");
+			SignalName(w, f, i);
+			w->Text(", ");
+			w->Dec(i * signal_size);
+			w->Text(" ;\n");
+		}
+		w->Text("    }\n");
+	}
+	w->Text("}\n");
+
+	// Node attributes, slaves configure the frames they publish or subscribe
+	w->Text("Node_attributes {\n");
+	for (uint32_t s = 0; s < p->slaves; s++)
+	{
+		Name(w, "    Slave_", s);
+		w->Text(" {\n        LIN_protocol = \"2.1\" ;\n        configured_NAD = 0x");
+		w->Hex((s % 0x7D) + 1, 2, true);
+		w->Text(" ;\n        initial_NAD = 0x");
+		w->Hex((s % 0x7D) + 1, 2, true);
+		w->Text(" ;\n        product_id = 0x1E, 0x");
+		w->Hex(s, 1, true);
+		w->Text(", 0 ;\n");
+		for (uint32_t f = s; f < p->frames; f += p->slaves)
+		{
+			// Response error is the first signal the slave publishes
+			if (f % 4 != 0)
+			{
+				w->Text("        response_error = ");
+				SignalName(w, f, 0);
+				w->Text(" ;\n");
+				break;
+			}
+		}
+		w->Text("        P2_min = 50 ms ;\n        ST_min = 0 ms ;\n        configurable_frames {\n");
+		for (uint32_t f = s, id = 0; f < p->frames; f += p->slaves, id++)
+		{
+			// Message IDs are given, without them all frames would share ID 0xFF
+			Name(w, "            Frm_", f);
+			w->Text(" = 0x");
+			w->Hex(id & 0xFF, 2, true);
+			w->Text(" ;\n");
+		}
+		w->Text("        }\n    }\n");
+	}
+	w->Text("}\n");
+
+	// Schedule tables go through all frames in turns
+	w->Text("Schedule_tables {\n");
+	for (uint32_t t = 0; t < p->schedule_tables && p->frames > 0; t++)
+	{
+		Name(w, "    Table_", t);
+		w->Text(" {\n");
+		for (uint32_t e = 0; e < p->table_entries; e++)
+		{
+			Name(w, "        Frm_", (t * p->table_entries + e) % p->frames);
+			w->Text(" delay 10 ms ;\n");
+		}
+		w->Text("    }\n");
+	}
+	w->Text("}\n");
+
+	// Encoding types, logical values first and then a physical range
+	w->Text("Signal_encoding_types {\n");
+	for (uint32_t e = 0; e < p->encoding_types; e++)
+	{
+		Name(w, "    Enc_", e);
+		w->Text(" {\n");
+		for (uint32_t v = 0; v < p->logical_values; v++)
+		{
+			w->Text("        logical_value, ");
+			w->Dec(v);
+			Name(w, ", \"Value_", v);
+			w->Text("\" ;\n");
+		}
+		w->Text("        physical_value, ");
+		w->Dec(p->logical_values);
+		w->Text(", 65535, 0.5, -10, \"unit\" ;\n    }\n");
+	}
+	w->Text("}\n");
+
+	// Signals take encoding types in turns
+	w->Text("Signal_representation {\n");
+	for (uint32_t e = 0; e < p->encoding_types; e++)
+	{
+		uint32_t signals_count = p->frames * p->signals_per_frame;
+		bool first = true;
+
+		if (e >= signals_count)
+			break;
+
+		Name(w, "    Enc_", e);
+		w->Text(": ");
+		for (uint32_t s = e; s < signals_count; s += p->encoding_types)
+		{
+			if (!first) w->Text(", ");
+			SignalName(w, s / p->signals_per_frame, s % p->signals_per_frame);
+			first = false;
+		}
+		w->Text(" ;\n");
+	}
+	w->Text("}\n");
+}
+
+ldf *ldfsynthetic::Load(const char *scale)
+{
+	char source[] = "/tmp/ldfsynthetic.XXXXXX";
+	const char *filename = scale;
+	ldfsynthetic_params_s params;
+	struct stat st;
+	ldf *db = NULL;
+
+	// Existing files are used as they are, scales are generated first
+	if (stat(scale, &st) != 0)
+	{
+		ldfwriter w;
+		int fd;
+
+		if (!ParseScale(scale, &params))
+		{
+			fprintf(stderr, "Invalid scale '%s'\n", scale);
+			return NULL;
+		}
+
+		fd = mkstemp(source);
+		if (fd < 0)
+		{
+			perror("mkstemp");
+			return NULL;
+		}
+		close(fd);
+
+		Generate(&params, &w);
+		w.WriteFile((const uint8_t *)source);
+		filename = source;
+	}
+
+	try
+	{
+		db = new ldf((const uint8_t *)filename);
+	}
+	catch (const std::exception &e)
+	{
+		fprintf(stderr, "%s\n", e.what());
+	}
+	if (filename == source) unlink(source);
+
+	return db;
+}
+
+} /* namespace lin */
@@ -0,0 +1,51 @@
+/*
+ * ldfsynthetic.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef BENCH_LDFSYNTHETIC_H_
+#define BENCH_LDFSYNTHETIC_H_
+
+#include <stdint.h>
+#include <ldf.h>
+#include <ldfwriter.h>
+
+
+namespace lin {
+
+/*
+ * Generator of synthetic LIN databases for benchmarks. The output only depends
+ * on the parameters, so the same scale always gives the same file.
+ *
+ * Frames take IDs 0x00 to 0x3B in turns, databases with more than 60 frames
+ * repeat IDs and validation reports them.
+ */
+class ldfsynthetic {
+
+public:
+	struct ldfsynthetic_params_s
+	{
+		uint32_t slaves;				// Slave nodes, at least one
+		uint32_t frames;				// Unconditional frames
+		uint32_t signals_per_frame;		// Signals packed in every frame, 1 to 64
+		uint32_t schedule_tables;		// Schedule tables
+		uint32_t table_entries;			// Frame slots of every schedule table
+		uint32_t encoding_types;		// Encoding types, signals take them in turns
+		uint32_t logical_values;		// Logical values of every encoding type
+	};
+
+public:
+	static void GetDefaultParams(ldfsynthetic_params_s *params);
+	static bool ParseScale(const char *scale, ldfsynthetic_params_s *params);
+	static void Generate(const ldfsynthetic_params_s *params, ldfwriter *w);
+
+	// Parses an existing file, or a database generated at the scale given. NULL, with the error printed, on failure.
+	static ldf *Load(const char *scale);
+
+};
+
+} /* namespace lin */
+
+#endif /* BENCH_LDFSYNTHETIC_H_ */
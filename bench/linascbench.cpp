@@ -0,0 +1,421 @@
+/*
+ * linascbench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the ASC text log import and export:
+ *
+ *   linascbench [-n frames] [scale|name=value,...|file.ldf]
+ *
+ * A binary trace of the frames of the database in turns, with frames of IDs
+ * out of the database, headers without response and checksum and framing
+ * errors now and then, is exported to an ASC log, with frame names, and the log
+ * imported back into a binary trace. Every frame imported is checked against
+ * the trace exported, a short log with decimal numbers and relative
+ * timestamps against the frames it holds, and frames named with hexadecimal
+ * digits only, like ACC, against their IDs; any difference is printed and the
+ * exit code is 1.
+ *
+ * One line is printed per direction with space separated key=value fields, the
+ * throughput over the text and the peak resident memory of the process so far.
+ * The text goes through fixed buffers both ways, the memory only grows with the
+ * pages of the binary trace mapped for the export:
+ *
+ *   mode=export frames=2000000 mb=107.7 ms=262.7 mb_s=409.9 ns_frame=131.3 rss_mb=26.9
+ *   mode=import frames=2000000 mb=107.7 ms=499.2 mb_s=215.7 ns_frame=249.6 rss_mb=26.9
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <stdexcept>
+#include <ldf.h>
+#include <linprotocol.h>
+#include <lintrace.h>
+#include <linasc.h>
+#include <ldfsynthetic.h>
+#include <linclock.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+// Cluster of about 500 signals
+#define DEFAULT_SCALE						"slaves=8,frames=60,signals_per_frame=8,schedule_tables=1,table_entries=60,encoding_types=16,logical_values=4"
+
+// Time between frames, timestamps are kept in microseconds like the log
+#define FRAME_US							5000ull
+
+
+typedef lincapture::lincaptureframe_s frame_t;
+
+
+// Log in decimal with relative timestamps, and the frames it holds
+static const char *sample =
+		"date Sat Oct 17 06:50:00.000 pm 2026\n"
+		"base dec  timestamps relative\n"
+		"// version 13.0.0\n"
+		"Begin Triggerblock Sat Oct 17 06:50:00.000 pm 2026\n"
+		"   0.000000 Start of measurement\n"
+		"   0.010000 L1 16 Rx 2 1 255 checksum = 200 header time = 40, full time = 70\r\n"
+		"   0.000500 L2 TransmErr id = 3\n"
+		"   0.001 L1 CSErr id = 63 Tx 1 10 checksum = 0\n"
+		"   0.000250 1 20 Rx d 8 1 2 3 4 5 6 7 8\n"
+		"   0.0000001 L1 RcvError: id = 5 Rx\n"
+		"End TriggerBlock";
+
+static const frame_t sample_frames[] = {
+	{ 10000000ull, { 1, 255 }, 0x50, 2, 200, 0, 0 },
+	{ 10500000ull, { 0 }, 0x03, 0, 0, lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE, 1 },
+	{ 11500000ull, { 10 }, 0xBF, 1, 0, lincapture::LIN_CAPTURE_ERROR_CHECKSUM, 0 },
+	{ 11750100ull, { 0 }, 0x85, 0, 0, lincapture::LIN_CAPTURE_ERROR_FRAMING, 0 },
+};
+
+// Frames named with hexadecimal digits, ACC is 0x10 and not 0xACC
+static const char *names_database =
+		"LIN_description_file;\n"
+		"LIN_protocol_version = \"2.1\";\n"
+		"LIN_language_version = \"2.1\";\n"
+		"LIN_speed = 19.2 kbps;\n"
+		"Nodes {\n"
+		"    Master: Master, 5 ms, 0.1 ms ;\n"
+		"    Slaves: Slave ;\n"
+		"}\n"
+		"Signals {\n"
+		"    Acc: 8, 0, Slave, Master ;\n"
+		"    Be: 8, 0, Master, Slave ;\n"
+		"}\n"
+		"Frames {\n"
+		"    ACC: 0x10, Slave, 1 {\n"
+		"        Acc, 0 ;\n"
+		"    }\n"
+		"    BE: 0x3B, Master, 1 {\n"
+		"        Be, 0 ;\n"
+		"    }\n"
+		"}\n";
+
+// ACC and BE written by name, 0x0A by number
+static const frame_t names_frames[] = {
+	{ 1000000ull, { 0x12 }, 0x50, 1, 0x9B, 0, 0 },
+	{ 2000000ull, { 0xFF }, 0xFB, 1, 0xC4, 0, 0 },
+	{ 3000000ull, { 0x01 }, 0xCA, 1, 0xB4, 0, 0 },
+};
+
+
+static double PeakMemory()
+{
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024.0;
+}
+
+static bool SameFrame(const frame_t *a, const frame_t *b)
+{
+	return a->timestamp == b->timestamp && a->pid == b->pid && a->length == b->length && a->checksum == b->checksum &&
+			a->flags == b->flags && a->bus == b->bus && memcmp(a->data, b->data, a->length) == 0;
+}
+
+// Frame as the log keeps it: errors other than no response or checksum are framing errors without data
+static void Expected(const frame_t *f, frame_t *e)
+{
+	memset(e, 0, sizeof(*e));
+	e->timestamp = f->timestamp;
+	e->pid = linprotocol::Pid(f->pid & 0x3F);
+	e->bus = f->bus;
+
+	if (f->flags & lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE)
+		e->flags = lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE;
+	else if (f->flags & ~lincapture::LIN_CAPTURE_ERROR_CHECKSUM)
+		e->flags = lincapture::LIN_CAPTURE_ERROR_FRAMING;
+	else
+	{
+		e->flags = f->flags;
+		e->length = f->length;
+		memcpy(e->data, f->data, f->length);
+		e->checksum = f->checksum;
+	}
+}
+
+static bool WriteTrace(ldf *db, const char *filename, uint64_t count)
+{
+	lintracewriter w;
+	uint8_t ids[LIN_PROTOCOL_IDS];
+	uint32_t ids_count = 0;
+
+	for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+		if (db->GetFrameById(id) != NULL)
+			ids[ids_count++] = id;
+	if (!w.Open(filename))
+		return false;
+
+	for (uint64_t n = 0; n < count; n++)
+	{
+		uint64_t data = ((uint64_t)rand() << 32) ^ rand();
+		uint32_t r = rand() % 200;
+		frame_t frame;
+
+		memset(&frame, 0, sizeof(frame));
+		frame.timestamp = (n * FRAME_US + rand() % 1000) * 1000;
+		frame.pid = linprotocol::Pid((ids_count > 0 && n % 8 != 0) ? ids[n % ids_count] : rand() % LIN_PROTOCOL_IDS);
+		frame.length = 1 + rand() % 8;
+		memcpy(frame.data, &data, frame.length);
+		frame.checksum = linprotocol::Checksum(frame.pid, linprotocol::LIN_CHECKSUM_ENHANCED, frame.data, frame.length);
+		frame.bus = rand() % 2;
+
+		if (r < 4)
+		{
+			frame.flags = lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE;
+			frame.length = 0;
+		}
+		else if (r < 6)
+			frame.flags = lincapture::LIN_CAPTURE_ERROR_CHECKSUM;
+		else if (r < 7)
+			frame.flags = lincapture::LIN_CAPTURE_ERROR_PARITY;
+
+		if (!w.Write(&frame))
+			return false;
+	}
+
+	return w.Close();
+}
+
+static bool Export(ldf *db, const char *trace, const char *log)
+{
+	lintracereader r;
+	linascwriter w(db);
+	frame_t frame;
+
+	if (!r.Open(trace) || !w.Open(log))
+		return false;
+
+	r.SetPrefetch(4);
+	while (r.Next(&frame))
+		if (!w.Write(&frame))
+			return false;
+
+	return w.Close();
+}
+
+static bool Import(ldf *db, const char *log, const char *trace)
+{
+	linascreader r(db);
+	lintracewriter w;
+	frame_t frame;
+
+	if (!r.Open(log) || !w.Open(trace))
+		return false;
+
+	while (r.Next(&frame))
+		if (!w.Write(&frame))
+			return false;
+
+	return w.Close();
+}
+
+static uint32_t Check(const char *exported, const char *imported)
+{
+	lintracereader a, b;
+	frame_t fa, fb, e;
+	uint64_t n = 0;
+
+	if (!a.Open(exported) || !b.Open(imported))
+		return 1;
+
+	while (a.Next(&fa))
+	{
+		Expected(&fa, &e);
+		if (!b.Next(&fb) || !SameFrame(&e, &fb))
+		{
+			fprintf(stderr, "Frame %llu differs after the import\n", (unsigned long long)n);
+			return 1;
+		}
+		n++;
+	}
+	if (b.Next(&fb))
+	{
+		fprintf(stderr, "More frames imported than exported\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+static uint32_t CheckSample(const char *log)
+{
+	linascreader r(NULL);
+	uint32_t count = sizeof(sample_frames) / sizeof(sample_frames[0]);
+	uint32_t n = 0;
+	frame_t frame;
+	FILE *f;
+
+	f = fopen(log, "w");
+	if (f == NULL)
+		return 1;
+	fputs(sample, f);
+	fclose(f);
+
+	if (!r.Open(log))
+		return 1;
+	while (r.Next(&frame))
+	{
+		if (n >= count || !SameFrame(&sample_frames[n], &frame))
+		{
+			fprintf(stderr, "Frame %u of the sample log differs\n", n);
+			return 1;
+		}
+		n++;
+	}
+	if (n != count || r.GetSkippedLinesCount() != 2)
+	{
+		fprintf(stderr, "Sample log read %u frames of %u, %llu lines skipped\n", n, count,
+				(unsigned long long)r.GetSkippedLinesCount());
+		return 1;
+	}
+
+	return 0;
+}
+
+static uint32_t CheckNames(const char *log)
+{
+	char source[] = "/tmp/linascbench.XXXXXX";
+	uint32_t count = sizeof(names_frames) / sizeof(names_frames[0]);
+	uint32_t errors = 0;
+	uint32_t n = 0;
+	frame_t frame;
+	ldf *db = NULL;
+	int fd;
+
+	fd = mkstemp(source);
+	if (fd < 0)
+		return 1;
+	if (write(fd, names_database, strlen(names_database)) == (ssize_t)strlen(names_database))
+	{
+		try
+		{
+			db = new ldf((const uint8_t *)source);
+		}
+		catch (const exception &e)
+		{
+			fprintf(stderr, "%s\n", e.what());
+		}
+	}
+	close(fd);
+	unlink(source);
+	if (db == NULL)
+		return 1;
+
+	linascwriter w(db);
+	linascreader r(db);
+
+	if (!w.Open(log))
+		errors++;
+	for (uint32_t i = 0; i < count && errors == 0; i++)
+		if (!w.Write(&names_frames[i]))
+			errors++;
+	if (errors > 0 || !w.Close() || !r.Open(log))
+	{
+		delete db;
+		return 1;
+	}
+
+	while (r.Next(&frame))
+	{
+		if (n >= count || !SameFrame(&names_frames[n], &frame))
+		{
+			fprintf(stderr, "Frame %u named with hexadecimal digits differs\n", n);
+			errors++;
+			break;
+		}
+		n++;
+	}
+	if (errors == 0 && n != count)
+	{
+		fprintf(stderr, "Log of frames named with hexadecimal digits read %u frames of %u\n", n, count);
+		errors++;
+	}
+
+	r.Close();
+	delete db;
+
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *exported = "/tmp/linascbench.lint";
+	const char *imported = "/tmp/linascbench.import.lint";
+	const char *log = "/tmp/linascbench.asc";
+	const char *scale = DEFAULT_SCALE;
+	uint64_t count = 2000000;
+	uint32_t errors = 0;
+	struct stat st;
+	double t0, t1, t2;
+	ldf *db;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		if (opt == 'n' && atoll(optarg) > 0)
+		{
+			count = atoll(optarg);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n frames] [scale|name=value,...|file.ldf]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (optind < argc)
+		scale = argv[optind];
+
+	errors += CheckSample(log);
+	errors += CheckNames(log);
+
+	db = ldfsynthetic::Load(scale);
+	if (db == NULL)
+		return 1;
+
+	srand(1);
+	if (!WriteTrace(db, exported, count))
+	{
+		fprintf(stderr, "Cannot write %s\n", exported);
+		delete db;
+		return 1;
+	}
+
+	t0 = linclock::Now() / 1e9;
+	if (!Export(db, exported, log))
+	{
+		fprintf(stderr, "Cannot export %s\n", log);
+		errors++;
+	}
+	t1 = linclock::Now() / 1e9;
+	stat(log, &st);
+	printf("mode=export frames=%llu mb=%.1f ms=%.1f mb_s=%.1f ns_frame=%.1f rss_mb=%.1f\n", (unsigned long long)count,
+			st.st_size / 1e6, (t1 - t0) * 1e3, st.st_size / 1e6 / (t1 - t0), (t1 - t0) * 1e9 / count, PeakMemory());
+	fflush(stdout);
+
+	if (!Import(db, log, imported))
+	{
+		fprintf(stderr, "Cannot import %s\n", log);
+		errors++;
+	}
+	t2 = linclock::Now() / 1e9;
+	printf("mode=import frames=%llu mb=%.1f ms=%.1f mb_s=%.1f ns_frame=%.1f rss_mb=%.1f\n", (unsigned long long)count,
+			st.st_size / 1e6, (t2 - t1) * 1e3, st.st_size / 1e6 / (t2 - t1), (t2 - t1) * 1e9 / count, PeakMemory());
+
+	errors += Check(exported, imported);
+
+	unlink(exported);
+	unlink(imported);
+	unlink(log);
+	delete db;
+
+	return (errors == 0) ? 0 : 1;
+}
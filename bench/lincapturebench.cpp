@@ -0,0 +1,189 @@
+/*
+ * lincapturebench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the capture ring with one writer and several consumers:
+ *
+ *   lincapturebench [-n frames] [-c consumers] [-s ring size] [-r frames/s]
+ *
+ * The writer writes frames as fast as it can, or at the given rate, while the
+ * consumers wait for them and read them in batches. Every frame carries its
+ * number and data derived from it, so consumers check that frames come in
+ * order and are never torn; any damaged frame makes the exit code 1.
+ *
+ * One line is printed for the writer and one per consumer, with space
+ * separated key=value fields:
+ *
+ *   role=writer frames=10000000 ms=750.801 frames_s=13319101 ns_frame=75.1
+ *     lin_buses=35998
+ *   role=consumer id=0 read=5626134 dropped=4373866 damaged=0
+ *
+ * lin_buses is the number of LIN buses at 20 kbit/s, sending their shortest
+ * frames back to back, that the writer keeps up with. Unpaced, consumers
+ * sharing the CPU with the writer drop frames; with -r at any real bus rate
+ * they should read them all.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <lincapture.h>
+#include <linclock.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+// Shortest LIN frame, header and one data byte with checksum, at 20 kbit/s
+#define LIN_MAX_FRAMES_S					(20000 / 54)
+
+// Frames read at once by consumers
+#define READ_BATCH							256
+
+
+struct consumer_s
+{
+	uint64_t read;
+	uint64_t dropped;
+	uint64_t damaged;
+};
+
+
+static void MakeFrame(uint64_t n, lincapture::lincaptureframe_s *f)
+{
+	uint64_t data = n * 0x9E3779B97F4A7C15ull;
+
+	f->timestamp = n;
+	memcpy(f->data, &data, sizeof(f->data));
+	f->pid = n;
+	f->length = 8;
+	f->checksum = ~n;
+	f->flags = 0;
+	f->bus = n >> 8;
+}
+
+static bool SameFrame(const lincapture::lincaptureframe_s *a, const lincapture::lincaptureframe_s *b)
+{
+	return a->timestamp == b->timestamp && memcmp(a->data, b->data, sizeof(a->data)) == 0 && a->pid == b->pid &&
+			a->length == b->length && a->checksum == b->checksum && a->flags == b->flags && a->bus == b->bus;
+}
+
+static void Consume(lincapture *ring, atomic<bool> *done, consumer_s *result)
+{
+	lincapturereader r(ring);
+	lincapture::lincaptureframe_s frames[READ_BATCH];
+	lincapture::lincaptureframe_s expected;
+	uint64_t last = 0;
+	bool first = true;
+
+	result->damaged = 0;
+	while (true)
+	{
+		uint32_t count = r.Read(frames, READ_BATCH);
+
+		if (count == 0)
+		{
+			if (done->load())
+				break;
+			r.Wait(10);
+			continue;
+		}
+
+		// Frames in order and whole
+		for (uint32_t i = 0; i < count; i++)
+		{
+			MakeFrame(frames[i].timestamp, &expected);
+			if ((!first && frames[i].timestamp <= last) || !SameFrame(&frames[i], &expected))
+				result->damaged++;
+			last = frames[i].timestamp;
+			first = false;
+		}
+	}
+
+	result->read = r.GetRead();
+	result->dropped = r.GetDropped();
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t frames = 10000000;
+	uint32_t consumers = 2;
+	uint32_t size = 65536;
+	uint32_t rate = 0;
+	consumer_s *results;
+	thread **threads;
+	atomic<bool> done(false);
+	uint64_t damaged = 0;
+	double t0, t1;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:c:s:r:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'n': frames = strtoull(optarg, NULL, 0); break;
+		case 'c': consumers = atoi(optarg); break;
+		case 's': size = atoi(optarg); break;
+		case 'r': rate = atoi(optarg); break;
+		default:
+			fprintf(stderr, "Usage: %s [-n frames] [-c consumers] [-s ring size] [-r frames/s]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	lincapture ring(size);
+
+	results = new consumer_s[consumers];
+	threads = new thread *[consumers];
+	for (uint32_t i = 0; i < consumers; i++)
+		threads[i] = new thread(Consume, &ring, &done, &results[i]);
+
+	// Let consumers attach before the first frame
+	usleep(10000);
+
+	t0 = linclock::Now() / 1e9;
+	for (uint64_t n = 0; n < frames; n++)
+	{
+		lincapture::lincaptureframe_s f;
+
+		// Paced writer, sleeping until the time of every 64th frame
+		if (rate > 0 && (n & 63) == 0)
+		{
+			double due = t0 + (double)n / rate;
+			double now = linclock::Now() / 1e9;
+			if (due > now)
+				usleep((due - now) * 1e6);
+		}
+
+		MakeFrame(n, &f);
+		ring.Write(&f);
+	}
+	t1 = linclock::Now() / 1e9;
+
+	done = true;
+	for (uint32_t i = 0; i < consumers; i++)
+	{
+		threads[i]->join();
+		delete threads[i];
+	}
+
+	printf("role=writer frames=%llu ms=%.3f frames_s=%.0f ns_frame=%.1f lin_buses=%.0f\n",
+			(unsigned long long)frames, (t1 - t0) * 1e3, frames / (t1 - t0), (t1 - t0) * 1e9 / frames,
+			frames / (t1 - t0) / LIN_MAX_FRAMES_S);
+	for (uint32_t i = 0; i < consumers; i++)
+	{
+		printf("role=consumer id=%u read=%llu dropped=%llu damaged=%llu\n", i,
+				(unsigned long long)results[i].read, (unsigned long long)results[i].dropped, (unsigned long long)results[i].damaged);
+		damaged += results[i].damaged;
+	}
+
+	delete[] threads;
+	delete[] results;
+	return (damaged == 0) ? 0 : 1;
+}
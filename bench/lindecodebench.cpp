@@ -0,0 +1,248 @@
+/*
+ * lindecodebench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the parallel trace decoder:
+ *
+ *   lindecodebench [-n frames] [-j threads,...] [scale|name=value,...|file.ldf]
+ *
+ * A trace of the frames of the database in turns, 5 ms apart, with random
+ * signal values now and then, is written and decoded into signal columns with
+ * every number of workers given (1 and one per core by default). Every sample
+ * of every column is checked against decoding the trace frame by frame; any
+ * difference is printed and the exit code is 1.
+ *
+ * The default database has 60 frames of 8 signals, 480 signals. One line is
+ * printed per number of workers with space separated key=value fields, the
+ * time per frame and the time it would take to decode a week of traffic at
+ * the rate of the trace:
+ *
+ *   threads=1 frames=1000000 signals=480 samples=8000000 ms=215.5 ns_frame=215.5
+ *     week_s=26.1
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <thread>
+#include <vector>
+#include <ldf.h>
+#include <linlayout.h>
+#include <linencoding.h>
+#include <linprotocol.h>
+#include <lintrace.h>
+#include <lintracedecoder.h>
+#include <ldfsynthetic.h>
+#include <linclock.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+// Cluster of about 500 signals
+#define DEFAULT_SCALE						"slaves=8,frames=60,signals_per_frame=8,schedule_tables=1,table_entries=60,encoding_types=16,logical_values=4"
+
+// Time between frames
+#define FRAME_NS							5000000ull
+
+#define WEEK_NS								(7 * 24 * 3600 * 1000000000ull)
+
+
+static bool WriteTrace(ldf *db, const char *filename, uint64_t count)
+{
+	linlayout layout(db);
+	lintracewriter w;
+	const linlayout::linlayoutframe_s *frames[LIN_PROTOCOL_IDS];
+	uint64_t values[LIN_PROTOCOL_IDS][64];
+	uint32_t frames_count = 0;
+
+	for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		const linlayout::linlayoutframe_s *f = layout.GetFrame(id);
+
+		if (f != NULL && f->count <= 64)
+		{
+			memset(values[frames_count], 0, sizeof(values[frames_count]));
+			frames[frames_count++] = f;
+		}
+	}
+	if (frames_count == 0 || !w.Open(filename))
+		return false;
+
+	for (uint64_t n = 0; n < count; n++)
+	{
+		uint32_t ix = n % frames_count;
+		const linlayout::linlayoutframe_s *f = frames[ix];
+		lincapture::lincaptureframe_s frame;
+
+		// One in ten frames changes a signal
+		if (rand() % 10 == 0 && f->count > 0)
+		{
+			uint32_t s = rand() % f->count;
+			values[ix][s] = (((uint64_t)rand() << 32) ^ rand()) & layout.GetSignal(f, s)->mask;
+		}
+
+		memset(&frame, 0, sizeof(frame));
+		frame.timestamp = n * FRAME_NS + rand() % 50000;
+		frame.pid = linprotocol::Pid(f->frame->GetId());
+		frame.length = f->length;
+		layout.Pack(f, values[ix], frame.data);
+		frame.checksum = linprotocol::Checksum(frame.pid, linprotocol::LIN_CHECKSUM_ENHANCED, frame.data, frame.length);
+		if (!w.Write(&frame))
+			return false;
+	}
+
+	return w.Close();
+}
+
+// Frame by frame, every sample shall be the next one of its column
+static uint32_t Check(ldf *db, const char *filename, lintracedecoder *decoder)
+{
+	linlayout layout(db);
+	lintracereader r;
+	lincapture::lincaptureframe_s frame;
+	vector<uint64_t> positions(decoder->GetColumnsCount(), 0);
+	uint64_t values[64];
+
+	if (!r.Open(filename))
+		return 1;
+
+	while (r.Next(&frame))
+	{
+		const linlayout::linlayoutframe_s *f = layout.GetFrame(frame.pid & 0x3F);
+		if (f == NULL)
+			continue;
+
+		layout.Unpack(f, frame.data, values);
+		for (uint32_t i = 0; i < f->count; i++)
+		{
+			const linlayout::linlayoutsignal_s *s = layout.GetSignal(f, i);
+			const lintracedecoder::lintracecolumn_s *col;
+			uint32_t raw = values[i];
+			double physical;
+			uint64_t p;
+
+			if (s->mask == 0 || s->signal == NULL)
+				continue;
+
+			col = decoder->GetColumnByName(s->signal->GetName());
+			p = positions[col - decoder->GetColumnByIndex(0)]++;
+
+			if (p >= col->count || col->timestamps[p] != frame.timestamp || col->raw[p] != values[i])
+			{
+				fprintf(stderr, "Sample %llu of %s differs\n", (unsigned long long)p, s->signal->GetName());
+				return 1;
+			}
+			if (col->physical != NULL)
+			{
+				linencoding::ToPhysical(col->encoding, &raw, &physical, 1);
+				if (!(physical == col->physical[p] || (isnan(physical) && isnan(col->physical[p]))))
+				{
+					fprintf(stderr, "Physical value %llu of %s differs\n", (unsigned long long)p, s->signal->GetName());
+					return 1;
+				}
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < decoder->GetColumnsCount(); i++)
+	{
+		if (positions[i] != decoder->GetColumnByIndex(i)->count)
+		{
+			fprintf(stderr, "Column %s has %llu samples, %llu expected\n", decoder->GetColumnByIndex(i)->signal->GetName(),
+					(unsigned long long)decoder->GetColumnByIndex(i)->count, (unsigned long long)positions[i]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *filename = "/tmp/lindecodebench.lint";
+	const char *scale = DEFAULT_SCALE;
+	uint64_t count = 1000000;
+	vector<uint32_t> threads;
+	uint32_t errors = 0;
+	ldf *db;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:j:")) != -1)
+	{
+		if (opt == 'n' && atoll(optarg) > 0)
+		{
+			count = atoll(optarg);
+		}
+		else if (opt == 'j')
+		{
+			for (char *s = strtok(optarg, ","); s != NULL; s = strtok(NULL, ","))
+				threads.push_back(atoi(s));
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n frames] [-j threads,...] [scale|name=value,...|file.ldf]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (optind < argc)
+		scale = argv[optind];
+	if (threads.empty())
+		threads = { 1, thread::hardware_concurrency() };
+
+	db = ldfsynthetic::Load(scale);
+	if (db == NULL)
+		return 1;
+
+	srand(1);
+	if (!WriteTrace(db, filename, count))
+	{
+		fprintf(stderr, "Cannot write %s\n", filename);
+		delete db;
+		return 1;
+	}
+
+	for (uint32_t t : threads)
+	{
+		lintracedecoder decoder(db);
+		uint64_t samples = 0;
+		uint32_t signals = 0;
+		double t0, t1;
+
+		t0 = linclock::Now() / 1e9;
+		if (!decoder.Decode(filename, t))
+		{
+			fprintf(stderr, "Cannot decode %s\n", filename);
+			errors++;
+			break;
+		}
+		t1 = linclock::Now() / 1e9;
+
+		for (uint32_t i = 0; i < decoder.GetColumnsCount(); i++)
+		{
+			samples += decoder.GetColumnByIndex(i)->count;
+			signals += (decoder.GetColumnByIndex(i)->count > 0);
+		}
+
+		printf("threads=%u frames=%llu signals=%u samples=%llu ms=%.1f ns_frame=%.1f week_s=%.1f\n",
+				t, (unsigned long long)decoder.GetFramesCount(), signals, (unsigned long long)samples, (t1 - t0) * 1e3,
+				(t1 - t0) * 1e9 / count, (t1 - t0) * WEEK_NS / FRAME_NS / count);
+
+		if (decoder.GetFramesCount() != count || decoder.GetSkippedFramesCount() != 0)
+		{
+			fprintf(stderr, "Decoded %llu frames of %llu\n", (unsigned long long)decoder.GetFramesCount(), (unsigned long long)count);
+			errors++;
+		}
+		errors += Check(db, filename, &decoder);
+	}
+
+	unlink(filename);
+	delete db;
+
+	return (errors == 0) ? 0 : 1;
+}
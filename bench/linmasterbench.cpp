@@ -0,0 +1,512 @@
+/*
+ * linmasterbench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the master node schedule:
+ *
+ *   linmasterbench [-n slots]
+ *
+ * A database with two schedule tables, of unconditional and diagnostic frames
+ * and slot times that are not multiples of the time base, is run by linmaster
+ * with a send callback recording every slot. The callback switches tables
+ * every few slots and overruns one slot once, then a second run with no jitter
+ * allowed has the tables switched from another thread. The compiled slots, the
+ * order of the slots sent, the spacing of their deadlines, the table switches
+ * at the first slot boundary after they are requested and the cycle, switch,
+ * overrun and per slot statistics are checked against the recording, and a
+ * run stopped before its thread reached Run() must return without sending; any
+ * difference is printed and the exit code is 1.
+ *
+ * One line is printed per run with space separated key=value fields, the
+ * latency of the send callback against the slot deadline and the slots that
+ * started later than the jitter of the master node:
+ *
+ *   mode=callback slots=1000 switches=142 overruns=2 cycles=285 misses=297 mean_jitter_us=97.7 max_jitter_us=4014.1
+ *     ms=3710.2
+ *   mode=thread slots=1000 switches=141 overruns=2 cycles=283 misses=1000 mean_jitter_us=103.3 max_jitter_us=2648.3
+ *     ms=3281.6
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <ldf.h>
+#include <linclock.h>
+#include <linprotocol.h>
+#include <linmaster.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+// Time base of 2 ms, slots of 1 and 3 ms are rounded up
+static const char *database =
+		"LIN_description_file;\n"
+		"LIN_protocol_version = \"2.1\";\n"
+		"LIN_language_version = \"2.1\";\n"
+		"LIN_speed = 19.2 kbps;\n"
+		"Nodes {\n"
+		"    Master: Master, 2 ms, 0.1 ms ;\n"
+		"    Slaves: Slave ;\n"
+		"}\n"
+		"Signals {\n"
+		"    Command: 8, 0, Master, Slave ;\n"
+		"    Status: 8, 0, Slave, Master ;\n"
+		"}\n"
+		"Frames {\n"
+		"    MasterCommand: 0x10, Master, 1 {\n"
+		"        Command, 0 ;\n"
+		"    }\n"
+		"    SlaveStatus: 0x11, Slave, 1 {\n"
+		"        Status, 0 ;\n"
+		"    }\n"
+		"}\n"
+		"Schedule_tables {\n"
+		"    Fast {\n"
+		"        MasterCommand delay 2 ms ;\n"
+		"        SlaveStatus delay 1 ms ;\n"
+		"        MasterReq delay 3 ms ;\n"
+		"        SlaveResp delay 2 ms ;\n"
+		"    }\n"
+		"    Slow {\n"
+		"        SlaveStatus delay 4 ms ;\n"
+		"        MasterCommand delay 5 ms ;\n"
+		"    }\n"
+		"}\n";
+
+// Slots between the table switches of the send callback, not a multiple of the table lengths
+#define SWITCH_EVERY						7
+
+// Slot of the first run whose send callback takes longer than the slot
+#define OVERRUN_AT							100
+
+// Time between the table switches of the second run
+#define SWITCH_THREAD_US					23000
+
+// Time a run stopped before it started is given to return
+#define EARLY_STOP_WAIT_MS					1000
+
+
+struct record_s
+{
+	uint32_t table;
+	uint32_t slot;
+	uint64_t deadline;
+	uint64_t late;					// Time of the callback against the deadline
+};
+
+struct recorder_s
+{
+	linmaster *master;
+	vector<record_s> records;
+	uint32_t size;
+	uint32_t switch_every;			// 0 when the callback does not switch tables
+	uint32_t overrun_at;			// 0 when no slot overruns
+	atomic<bool> done;
+};
+
+// Switch requested by another thread, to table at time
+struct request_s
+{
+	uint32_t table;
+	uint64_t time;
+};
+
+
+static ldf *Load()
+{
+	char source[] = "/tmp/linmasterbench.XXXXXX";
+	ldf *db = NULL;
+	int fd;
+
+	fd = mkstemp(source);
+	if (fd < 0)
+	{
+		perror("mkstemp");
+		return NULL;
+	}
+	if (write(fd, database, strlen(database)) != (ssize_t)strlen(database))
+	{
+		perror("write");
+		close(fd);
+		unlink(source);
+		return NULL;
+	}
+	close(fd);
+
+	try
+	{
+		db = new ldf((const uint8_t *)source);
+	}
+	catch (const exception &e)
+	{
+		fprintf(stderr, "%s\n", e.what());
+	}
+	unlink(source);
+
+	return db;
+}
+
+static void Send(void *context, const linmaster::linmasterslot_s *slot, uint64_t deadline)
+{
+	recorder_s *r = (recorder_s *)context;
+	uint64_t now = linclock::Now();
+	uint32_t t = r->master->GetCurrentScheduleTable();
+	record_s rec;
+
+	rec.table = t;
+	rec.slot = UINT32_MAX;
+	for (uint32_t i = 0; i < r->master->GetSlotsCount(t); i++)
+		if (r->master->GetSlot(t, i) == slot)
+			rec.slot = i;
+	rec.deadline = deadline;
+	rec.late = (now > deadline) ? now - deadline : 0;
+	r->records.push_back(rec);
+
+	if (r->records.size() == r->size)
+	{
+		r->master->Stop();
+		r->done = true;
+		return;
+	}
+
+	// Switch after this slot, taken when it ends
+	if (r->switch_every > 0 && r->records.size() % r->switch_every == 0)
+		r->master->SetScheduleTable((t + 1) % r->master->GetScheduleTablesCount());
+
+	// Sleep past the next deadline
+	if (r->records.size() == r->overrun_at)
+		usleep(slot->delay_ns * 3 / 1000);
+}
+
+// Protected IDs and slot times as compiled from the database
+static uint32_t CheckSlots(ldf *db, linmaster *master)
+{
+	uint64_t timebase_ns = db->GetMasterNode()->GetTimebase() * 100000ull;
+	uint32_t errors = 0;
+
+	for (uint32_t t = 0; t < master->GetScheduleTablesCount(); t++)
+	{
+		ldfscheduletable *table = master->GetScheduleTable(t);
+
+		for (uint32_t i = 0; i < master->GetSlotsCount(t); i++)
+		{
+			const linmaster::linmasterslot_s *s = master->GetSlot(t, i);
+			ldfschedulecommand *c = table->GetCommandByIndex(i);
+			ldfframe *frame = db->GetFrameByName(c->GetFrameName());
+			uint64_t delay_ns = c->GetTimeoutMs() * 1000000ull;
+			uint8_t pid;
+
+			delay_ns = ((delay_ns + timebase_ns - 1) / timebase_ns) * timebase_ns;
+			if (c->GetType() == ldfschedulecommand::LDF_SCMD_TYPE_UnconditionalFrame)
+				pid = (frame != NULL) ? frame->GetPid() : 0;
+			else if (c->GetType() == ldfschedulecommand::LDF_SCMD_TYPE_SlaveResp)
+				pid = linprotocol::Pid(LIN_PROTOCOL_SLAVE_RESPONSE_ID);
+			else
+				pid = linprotocol::Pid(LIN_PROTOCOL_MASTER_REQUEST_ID);
+
+			if (s->command != c || s->pid != pid || s->delay_ns != delay_ns)
+			{
+				fprintf(stderr, "Slot %u of table %s compiled as PID 0x%02X and %llu ns\n", i, (const char *)table->GetName(),
+						s->pid, (unsigned long long)s->delay_ns);
+				errors++;
+			}
+		}
+	}
+
+	return errors;
+}
+
+static uint32_t CheckRun(linmaster *master, recorder_s *r, const vector<request_s> &requests)
+{
+	const vector<record_s> &rec = r->records;
+	uint32_t tables = master->GetScheduleTablesCount();
+	linmaster::linmasterstats_s stats;
+	uint32_t switches = 0, overruns = 0, cycles = 0;
+	uint32_t errors = 0;
+
+	master->GetStats(&stats);
+	if (rec.size() != r->size)
+	{
+		fprintf(stderr, "%zu slots recorded of %u\n", rec.size(), r->size);
+		return 1;
+	}
+
+	for (size_t k = 0; k < rec.size(); k++)
+	{
+		const record_s *a = &rec[k];
+		const record_s *b;
+		uint32_t count = master->GetSlotsCount(a->table);
+		uint64_t delay_ns;
+
+		if (a->slot == UINT32_MAX)
+		{
+			fprintf(stderr, "Slot %zu is not a slot of table %u\n", k, a->table);
+			return errors + 1;
+		}
+		if (a->slot == count - 1)
+			cycles++;
+		if (k + 1 == rec.size())
+			break;
+		b = &rec[k + 1];
+
+		// Same table in order, or the first slot of another table
+		if (b->table != a->table)
+		{
+			switches++;
+			if (b->slot != 0)
+			{
+				fprintf(stderr, "Slot %zu switches to slot %u of table %u\n", k + 1, b->slot, b->table);
+				errors++;
+			}
+		}
+		else if (b->slot != (a->slot + 1) % count)
+		{
+			fprintf(stderr, "Slot %zu is slot %u after slot %u\n", k + 1, b->slot, a->slot);
+			errors++;
+		}
+
+		// Deadlines one slot time apart, later only after an overrun
+		delay_ns = master->GetSlot(a->table, a->slot)->delay_ns;
+		if (b->deadline < a->deadline + delay_ns)
+		{
+			fprintf(stderr, "Slot %zu starts %lld ns before its time\n", k + 1,
+					(long long)(a->deadline + delay_ns - b->deadline));
+			errors++;
+		}
+		else if (b->deadline > a->deadline + delay_ns)
+		{
+			overruns++;
+		}
+	}
+
+	// Switches of the callback are taken by the next slot
+	for (size_t k = r->switch_every; r->switch_every > 0 && k < rec.size(); k += r->switch_every)
+	{
+		if (rec[k].slot != 0 || rec[k].table != (rec[k - 1].table + 1) % tables)
+		{
+			fprintf(stderr, "Switch after slot %zu not taken at its end\n", k - 1);
+			errors++;
+		}
+	}
+	if (r->overrun_at > 0 && rec[r->overrun_at].deadline <= rec[r->overrun_at - 1].deadline +
+			master->GetSlot(rec[r->overrun_at - 1].table, rec[r->overrun_at - 1].slot)->delay_ns)
+	{
+		fprintf(stderr, "Slot %u did not overrun\n", r->overrun_at - 1);
+		errors++;
+	}
+
+	// Switches of another thread are taken by the first slot starting after them, or by the slot waking up then
+	for (const request_s &q : requests)
+	{
+		size_t j = 0;
+
+		while (j < rec.size() && rec[j].deadline <= q.time)
+			j++;
+		if (j < 2 || j == rec.size())
+			continue;
+		if (!(rec[j].table == q.table && rec[j].slot == 0 && rec[j - 1].table != q.table) &&
+			!(rec[j - 1].table == q.table && rec[j - 1].slot == 0 && rec[j - 2].table != q.table))
+		{
+			fprintf(stderr, "Switch to table %u not taken at slot %zu\n", q.table, j);
+			errors++;
+		}
+	}
+
+	if (stats.switches != switches || stats.overruns != overruns || stats.cycles != cycles)
+	{
+		fprintf(stderr, "Stats switches=%u overruns=%u cycles=%u, recorded %u, %u and %u\n", stats.switches,
+				stats.overruns, stats.cycles, switches, overruns, cycles);
+		errors++;
+	}
+
+	// The run starts earlier than the callback, its jitter is a bound of the one of the stats
+	for (uint32_t t = 0; t < tables; t++)
+	{
+		for (uint32_t i = 0; i < master->GetSlotsCount(t); i++)
+		{
+			const linmaster::linmasterslotstats_s *st = master->GetSlotStats(t, i);
+			linmaster::linmasterslotstats_s e;
+
+			memset(&e, 0, sizeof(e));
+			for (const record_s &a : rec)
+			{
+				if (a.table != t || a.slot != i)
+					continue;
+				e.runs++;
+				e.total_jitter_ns += a.late;
+				if (a.late > e.max_jitter_ns)
+					e.max_jitter_ns = a.late;
+				if (a.late > master->GetJitterNs())
+					e.misses++;
+			}
+
+			if (st->runs != e.runs || st->total_jitter_ns > e.total_jitter_ns || st->max_jitter_ns > e.max_jitter_ns ||
+				st->misses > e.misses || (master->GetJitterNs() == 0 && st->misses != st->runs))
+			{
+				fprintf(stderr, "Slot %u of table %u stats runs=%u misses=%u max=%llu total=%llu, recorded %u %u %llu %llu\n",
+						i, t, st->runs, st->misses, (unsigned long long)st->max_jitter_ns,
+						(unsigned long long)st->total_jitter_ns, e.runs, e.misses, (unsigned long long)e.max_jitter_ns,
+						(unsigned long long)e.total_jitter_ns);
+				errors++;
+			}
+		}
+	}
+
+	return errors;
+}
+
+// A Stop() issued before the runner thread reaches Run() is not lost
+static uint32_t CheckEarlyStop(linmaster *master, recorder_s *r)
+{
+	atomic<bool> returned(false);
+	uint32_t errors = 0;
+
+	r->records.clear();
+	r->switch_every = 0;
+	r->overrun_at = 0;
+	r->done = false;
+
+	master->Stop();
+	thread runner([master, &returned]() { master->Run(); returned = true; });
+	for (uint32_t ms = 0; ms < EARLY_STOP_WAIT_MS && !returned; ms++)
+		usleep(1000);
+	if (!returned)
+	{
+		fprintf(stderr, "Run() did not return after an earlier Stop()\n");
+		errors++;
+		master->Stop();
+	}
+	runner.join();
+
+	if (!r->records.empty())
+	{
+		fprintf(stderr, "%zu slots sent after Stop()\n", r->records.size());
+		errors++;
+	}
+
+	return errors;
+}
+
+static void Print(const char *mode, linmaster *master, recorder_s *r, double ms)
+{
+	linmaster::linmasterstats_s stats;
+	uint64_t total = 0, max = 0;
+	uint32_t runs = 0, misses = 0;
+
+	master->GetStats(&stats);
+	for (uint32_t t = 0; t < master->GetScheduleTablesCount(); t++)
+	{
+		for (uint32_t i = 0; i < master->GetSlotsCount(t); i++)
+		{
+			const linmaster::linmasterslotstats_s *st = master->GetSlotStats(t, i);
+
+			runs += st->runs;
+			misses += st->misses;
+			total += st->total_jitter_ns;
+			if (st->max_jitter_ns > max)
+				max = st->max_jitter_ns;
+		}
+	}
+
+	printf("mode=%s slots=%zu switches=%u overruns=%u cycles=%u misses=%u mean_jitter_us=%.1f max_jitter_us=%.1f ms=%.1f\n",
+			mode, r->records.size(), stats.switches, stats.overruns, stats.cycles, misses,
+			(runs > 0) ? total / 1e3 / runs : 0.0, max / 1e3, ms);
+	fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t size = 1000;
+	uint32_t errors = 0;
+	vector<request_s> requests;
+	linmaster::linmasterstats_s stats;
+	recorder_s r;
+	uint64_t t0;
+	ldf *db;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		if (opt == 'n' && atoi(optarg) > OVERRUN_AT)
+		{
+			size = atoi(optarg);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n slots], more than %u slots\n", argv[0], OVERRUN_AT);
+			return 2;
+		}
+	}
+
+	db = Load();
+	if (db == NULL)
+		return 1;
+
+	linmaster master(db, Send, &r);
+	errors += CheckSlots(db, &master);
+
+	// Switches and an overrun from the callback
+	r.master = &master;
+	r.records.reserve(size);
+	r.size = size;
+	r.switch_every = SWITCH_EVERY;
+	r.overrun_at = OVERRUN_AT;
+	r.done = false;
+
+	t0 = linclock::Now();
+	if (!master.Run())
+	{
+		fprintf(stderr, "Nothing to run\n");
+		delete db;
+		return 1;
+	}
+	Print("callback", &master, &r, (linclock::Now() - t0) / 1e6);
+	errors += CheckRun(&master, &r, requests);
+
+	// Switches from another thread, every slot misses without jitter
+	db->GetMasterNode()->SetJitter(0);
+	master.Compile();
+	r.records.clear();
+	r.switch_every = 0;
+	r.overrun_at = 0;
+	r.done = false;
+
+	t0 = linclock::Now();
+	thread runner([&master]() { master.Run(); });
+	while (!r.done)
+	{
+		request_s q;
+
+		usleep(SWITCH_THREAD_US);
+		q.table = (master.GetCurrentScheduleTable() + 1) % master.GetScheduleTablesCount();
+		q.time = linclock::Now();
+		master.SetScheduleTable(q.table);
+		requests.push_back(q);
+	}
+	runner.join();
+	Print("thread", &master, &r, (linclock::Now() - t0) / 1e6);
+	errors += CheckRun(&master, &r, requests);
+	errors += CheckEarlyStop(&master, &r);
+
+	// Statistics start again from zero
+	master.ResetStats();
+	master.GetStats(&stats);
+	if (stats.switches != 0 || stats.overruns != 0 || stats.cycles != 0 || master.GetSlotStats(0, 0)->runs != 0)
+	{
+		fprintf(stderr, "Stats not reset\n");
+		errors++;
+	}
+
+	delete db;
+
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+/*
+ * linpackbench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the compiled signal layouts against packing and unpacking the
+ * signals bit by bit from the database objects:
+ *
+ *   linpackbench [-i iterations] [small|medium|large|huge|name=value,...|file.ldf] ...
+ *
+ * Random values are packed and unpacked for every frame with an ID, both ways
+ * must give the same data and values. One line is printed per database and
+ * operation with space separated key=value fields:
+ *
+ *   scale=large op=pack frames=60 signals=480 reference_ns=708.4
+ *     compiled_ns=36.4 speedup=19.5
+ *
+ * Times are nanoseconds per frame.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <stdexcept>
+#include <ldf.h>
+#include <linlayout.h>
+#include <ldfsynthetic.h>
+#include <linclock.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+// Most signals of a frame, 64 one bit signals
+#define MAX_FRAME_SIGNALS					64
+
+
+// Reference, bit by bit with the signals looked up in the database
+static void ReferencePack(ldf *db, ldfframe *f, const uint64_t *values, uint8_t *data)
+{
+	uint32_t length = (f->GetSize() <= 8) ? f->GetSize() : 8;
+
+	memset(data, 0xFF, length);
+	for (uint32_t i = 0; i < f->GetSignalsCount(); i++)
+	{
+		ldfframesignal *fs = f->GetSignal(i);
+		ldfsignal *s = db->GetSignalByName(fs->GetName());
+		if (s == NULL)
+			continue;
+
+		for (uint32_t b = 0; b < s->GetBitSize(); b++)
+		{
+			uint32_t bit = fs->GetOffset() + b;
+			if (bit >= length * 8)
+				break;
+
+			if ((values[i] >> b) & 1)
+				data[bit >> 3] |= (1 << (bit & 7));
+			else
+				data[bit >> 3] &= ~(1 << (bit & 7));
+		}
+	}
+}
+
+static void ReferenceUnpack(ldf *db, ldfframe *f, const uint8_t *data, uint64_t *values)
+{
+	uint32_t length = (f->GetSize() <= 8) ? f->GetSize() : 8;
+
+	for (uint32_t i = 0; i < f->GetSignalsCount(); i++)
+	{
+		ldfframesignal *fs = f->GetSignal(i);
+		ldfsignal *s = db->GetSignalByName(fs->GetName());
+
+		values[i] = 0;
+		if (s == NULL)
+			continue;
+
+		for (uint32_t b = 0; b < s->GetBitSize(); b++)
+		{
+			uint32_t bit = fs->GetOffset() + b;
+			if (bit >= length * 8)
+				break;
+
+			if ((data[bit >> 3] >> (bit & 7)) & 1)
+				values[i] |= 1ull << b;
+		}
+	}
+}
+
+static int Bench(const char *scale, uint32_t iterations)
+{
+	char source[] = "/tmp/linpackbench.XXXXXX";
+	const char *filename = scale;
+	ldfsynthetic::ldfsynthetic_params_s params;
+	struct stat st;
+	ldf *db;
+	linlayout *layout;
+	uint64_t (*values)[MAX_FRAME_SIGNALS];
+	uint64_t unpacked[MAX_FRAME_SIGNALS];
+	uint8_t data[8], reference[8];
+	const linlayout::linlayoutframe_s *frames[LIN_PROTOCOL_IDS];
+	uint32_t frames_count = 0, signals_count = 0;
+	double t0, t1, t2, t3, t4;
+	volatile uint64_t sink = 0;
+	int fd;
+
+	// Existing files are benchmarked as they are, scales are generated first
+	if (stat(scale, &st) != 0)
+	{
+		ldfwriter w;
+
+		if (!ldfsynthetic::ParseScale(scale, &params))
+		{
+			fprintf(stderr, "Invalid scale '%s'\n", scale);
+			return 2;
+		}
+
+		fd = mkstemp(source);
+		if (fd < 0)
+		{
+			perror("mkstemp");
+			return 1;
+		}
+		close(fd);
+
+		ldfsynthetic::Generate(&params, &w);
+		w.WriteFile((const uint8_t *)source);
+		filename = source;
+	}
+
+	try
+	{
+		db = new ldf((const uint8_t *)filename);
+	}
+	catch (const exception &e)
+	{
+		fprintf(stderr, "%s\n", e.what());
+		if (filename == source) unlink(source);
+		return 1;
+	}
+	if (filename == source) unlink(source);
+	layout = new linlayout(db);
+
+	// Random values of every signal, masked to its size
+	values = new uint64_t[LIN_PROTOCOL_IDS][MAX_FRAME_SIGNALS];
+	srand(1);
+	for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		const linlayout::linlayoutframe_s *f = layout->GetFrame(id);
+		if (f == NULL || f->count > MAX_FRAME_SIGNALS)
+			continue;
+
+		frames[frames_count++] = f;
+		signals_count += f->count;
+		for (uint32_t i = 0; i < f->count; i++)
+			values[frames_count - 1][i] = (((uint64_t)rand() << 32) ^ rand()) & layout->GetSignal(f, i)->mask;
+	}
+	if (frames_count == 0)
+	{
+		fprintf(stderr, "No frames with ID in %s\n", scale);
+		return 1;
+	}
+
+	// Both ways give the same data and values
+	for (uint32_t i = 0; i < frames_count; i++)
+	{
+		const linlayout::linlayoutframe_s *f = frames[i];
+
+		layout->Pack(f, values[i], data);
+		ReferencePack(db, f->frame, values[i], reference);
+		layout->Unpack(f, reference, unpacked);
+		if (memcmp(data, reference, f->length) != 0 || memcmp(unpacked, values[i], f->count * sizeof(uint64_t)) != 0)
+		{
+			fprintf(stderr, "Frame %s differs from reference\n", f->frame->GetName());
+			return 1;
+		}
+	}
+
+	t0 = linclock::Now() / 1e9;
+	for (uint32_t n = 0; n < iterations; n++)
+		for (uint32_t i = 0; i < frames_count; i++)
+		{
+			ReferencePack(db, frames[i]->frame, values[i], data);
+			sink += data[0];
+		}
+	t1 = linclock::Now() / 1e9;
+	for (uint32_t n = 0; n < iterations; n++)
+		for (uint32_t i = 0; i < frames_count; i++)
+		{
+			layout->Pack(frames[i], values[i], data);
+			sink += data[0];
+		}
+	t2 = linclock::Now() / 1e9;
+	for (uint32_t n = 0; n < iterations; n++)
+		for (uint32_t i = 0; i < frames_count; i++)
+		{
+			ReferenceUnpack(db, frames[i]->frame, data, unpacked);
+			sink += unpacked[0];
+		}
+	t3 = linclock::Now() / 1e9;
+	for (uint32_t n = 0; n < iterations; n++)
+		for (uint32_t i = 0; i < frames_count; i++)
+		{
+			layout->Unpack(frames[i], data, unpacked);
+			sink += unpacked[0];
+		}
+	t4 = linclock::Now() / 1e9;
+
+	double ops = (double)iterations * frames_count / 1e9;
+	printf("scale=%s op=pack frames=%u signals=%u reference_ns=%.1f compiled_ns=%.1f speedup=%.1f\n",
+			scale, frames_count, signals_count, (t1 - t0) / ops, (t2 - t1) / ops, (t1 - t0) / (t2 - t1));
+	printf("scale=%s op=unpack frames=%u signals=%u reference_ns=%.1f compiled_ns=%.1f speedup=%.1f\n",
+			scale, frames_count, signals_count, (t3 - t2) / ops, (t4 - t3) / ops, (t3 - t2) / (t4 - t3));
+
+	delete[] values;
+	delete layout;
+	delete db;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t iterations = 10000;
+	int opt, ret = 0;
+
+	while ((opt = getopt(argc, argv, "i:")) != -1)
+	{
+		if (opt == 'i' && atoi(optarg) > 0)
+		{
+			iterations = atoi(optarg);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-i iterations] [small|medium|large|huge|name=value,...|file.ldf] ...\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind == argc)
+		return Bench("small", iterations);
+
+	for (int i = optind; i < argc; i++)
+	{
+		int r = Bench(argv[i], iterations);
+		if (r > ret) ret = r;
+	}
+
+	return ret;
+}
@@ -0,0 +1,281 @@
+/*
+ * linprotocolbench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Correctness checks and benchmark of the protocol kernels:
+ *
+ *   linprotocolbench [-n frames]
+ *
+ * The kernels are first checked against the definitions of the LIN
+ * specification: protected IDs of all the IDs, parity of all the bytes, and
+ * both checksum models for every protected ID with every data of one and two
+ * bytes, and random frames of every length. Any difference is printed and the
+ * exit code is 1.
+ *
+ * Then one line is printed per kernel with space separated key=value fields,
+ * the time per frame of the definition and of the kernel:
+ *
+ *   kernel=checksum_word frames=1000000 reference_ns=15.48 kernel_ns=4.97
+ *     speedup=3.1
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linprotocol.h>
+#include <linclock.h>
+
+
+using namespace lin;
+
+
+// Results of the timed loops, so they are not optimized out
+static volatile uint32_t sink;
+
+// Parity bits as the specification defines them
+static uint8_t ReferencePid(uint8_t id)
+{
+	uint8_t b[6];
+
+	for (uint32_t i = 0; i < 6; i++)
+		b[i] = (id >> i) & 1;
+
+	uint8_t p0 = b[0] ^ b[1] ^ b[2] ^ b[4];
+	uint8_t p1 = !(b[1] ^ b[3] ^ b[4] ^ b[5]);
+	return (id & 0x3F) | (p0 << 6) | (p1 << 7);
+}
+
+// Sum with carry, subtracting 255 whenever the sum exceeds it
+static uint8_t ReferenceChecksum(uint8_t pid, uint8_t model, const uint8_t *data, uint8_t length)
+{
+	uint16_t sum = (model == linprotocol::LIN_CHECKSUM_ENHANCED) ? pid : 0;
+
+	for (uint8_t i = 0; i < length; i++)
+	{
+		sum += data[i];
+		if (sum > 0xFF) sum -= 0xFF;
+	}
+
+	return ~sum;
+}
+
+static uint64_t ToWord(const uint8_t *data, uint8_t length)
+{
+	uint64_t w = 0;
+
+	for (uint8_t i = 0; i < length; i++)
+		w |= (uint64_t)data[i] << (i * 8);
+
+	return w;
+}
+
+static uint64_t Random64()
+{
+	return ((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ rand();
+}
+
+static uint32_t CheckPid()
+{
+	uint32_t errors = 0;
+
+	for (uint32_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		if (linprotocol::Pid(id) != ReferencePid(id) || linprotocol::PidToId(ReferencePid(id)) != id)
+		{
+			fprintf(stderr, "Protected ID of 0x%02X differs\n", id);
+			errors++;
+		}
+	}
+
+	for (uint32_t pid = 0; pid < 256; pid++)
+	{
+		bool valid = (ReferencePid(pid & 0x3F) == pid);
+
+		if (linprotocol::IsValidPid(pid) != valid)
+		{
+			fprintf(stderr, "Parity of 0x%02X differs\n", pid);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static uint32_t CheckChecksum(uint8_t pid, uint8_t model, const uint8_t *data, uint8_t length)
+{
+	uint8_t expected = ReferenceChecksum(pid, model, data, length);
+	uint64_t w = ToWord(data, length) | (Random64() & ~((length >= 8) ? ~0ull : ((1ull << (length * 8)) - 1)));
+
+	// The word kernel shall ignore the bytes after length
+	if (linprotocol::Checksum(pid, model, data, length) == expected && linprotocol::Checksum(pid, model, w, length) == expected)
+		return 0;
+
+	fprintf(stderr, "Checksum differs: pid=0x%02X model=%u length=%u\n", pid, model, length);
+	return 1;
+}
+
+static uint32_t CheckChecksums()
+{
+	uint32_t errors = 0;
+	uint8_t data[8];
+
+	for (uint32_t model = 0; model < 2; model++)
+	{
+		for (uint32_t pid = 0; pid < 256 && errors < 10; pid++)
+		{
+			// Every data of up to two bytes
+			errors += CheckChecksum(pid, model, data, 0);
+			for (uint32_t a = 0; a < 256; a++)
+			{
+				data[0] = a;
+				errors += CheckChecksum(pid, model, data, 1);
+				for (uint32_t b = 0; b < 256; b++)
+				{
+					data[1] = b;
+					errors += CheckChecksum(pid, model, data, 2);
+				}
+			}
+		}
+	}
+
+	// Random frames of every length, with many carries
+	for (uint32_t i = 0; i < 1000000 && errors < 10; i++)
+	{
+		uint64_t w = Random64() | ((i & 1) ? 0xF0F0F0F0F0F0F0F0ull : 0);
+
+		memcpy(data, &w, sizeof(data));
+		errors += CheckChecksum(rand() & 0xFF, i & 1, data, i % 9);
+	}
+
+	// All ones, the largest sum
+	memset(data, 0xFF, sizeof(data));
+	for (uint32_t length = 0; length <= 8; length++)
+		errors += CheckChecksum(0xFF, linprotocol::LIN_CHECKSUM_ENHANCED, data, length);
+
+	return errors;
+}
+
+static uint32_t CheckBatch(const linprotocol::linprotocolframe_s *frames, uint32_t count, uint8_t *ok)
+{
+	uint32_t errors = 0, bad;
+
+	bad = linprotocol::CheckFrames(frames, count, ok);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint8_t data[8];
+
+		memcpy(data, &frames[i].data, sizeof(data));
+		bool good = ReferencePid(frames[i].pid & 0x3F) == frames[i].pid &&
+				ReferenceChecksum(frames[i].pid, frames[i].model, data, frames[i].length) == frames[i].checksum;
+
+		if (ok[i] != good)
+			errors++;
+		bad -= !good;
+	}
+
+	if (errors != 0 || bad != 0)
+	{
+		fprintf(stderr, "Batch check differs in %u frames\n", errors);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void Print(const char *kernel, uint32_t frames, double reference, double kernel_time)
+{
+	printf("kernel=%s frames=%u reference_ns=%.2f kernel_ns=%.2f speedup=%.1f\n",
+			kernel, frames, reference * 1e9 / frames, kernel_time * 1e9 / frames, reference / kernel_time);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t count = 1000000;
+	linprotocol::linprotocolframe_s *frames;
+	uint8_t (*data)[8];
+	uint8_t *ok;
+	uint32_t acc = 0;
+	double t0, t1, t2, t3;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		if (opt == 'n' && atoi(optarg) > 0)
+		{
+			count = atoi(optarg);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n frames]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	// Against the definitions
+	srand(1);
+	if (CheckPid() != 0 || CheckChecksums() != 0)
+		return 1;
+
+	// Captured frames, one in eight with a wrong checksum or parity
+	frames = new linprotocol::linprotocolframe_s[count];
+	data = new uint8_t[count][8];
+	ok = new uint8_t[count];
+	for (uint32_t i = 0; i < count; i++)
+	{
+		linprotocol::linprotocolframe_s *f = &frames[i];
+
+		f->length = 1 + rand() % 8;
+		f->data = Random64() & ((f->length >= 8) ? ~0ull : ((1ull << (f->length * 8)) - 1));
+		f->pid = linprotocol::Pid(rand());
+		f->model = (f->pid & 0x3F) < LIN_PROTOCOL_MASTER_REQUEST_ID;
+		f->checksum = ReferenceChecksum(f->pid, f->model, (const uint8_t *)&f->data, f->length);
+		if (rand() % 8 == 0) f->checksum ^= 1 << (rand() % 8);
+		if (rand() % 8 == 0) f->pid ^= 1 << (rand() % 8);
+		memcpy(data[i], &f->data, sizeof(data[i]));
+	}
+	if (CheckBatch(frames, count, ok) != 0)
+		return 1;
+
+	// Protected IDs
+	t0 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < count; i++)
+		acc += ReferencePid(i);
+	t1 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < count; i++)
+		acc += linprotocol::Pid(i);
+	t2 = linclock::Now() / 1e9;
+	Print("pid", count, t1 - t0, t2 - t1);
+
+	// Checksums, on bytes and on words
+	t0 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < count; i++)
+		acc += ReferenceChecksum(frames[i].pid, frames[i].model, data[i], frames[i].length);
+	t1 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < count; i++)
+		acc += linprotocol::Checksum(frames[i].pid, frames[i].model, data[i], frames[i].length);
+	t2 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < count; i++)
+		acc += linprotocol::Checksum(frames[i].pid, frames[i].model, frames[i].data, frames[i].length);
+	t3 = linclock::Now() / 1e9;
+	Print("checksum_bytes", count, t1 - t0, t2 - t1);
+	Print("checksum_word", count, t1 - t0, t3 - t2);
+
+	// Whole frames, parity and checksum
+	t0 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < count; i++)
+		acc += ReferencePid(frames[i].pid & 0x3F) == frames[i].pid &&
+				ReferenceChecksum(frames[i].pid, frames[i].model, data[i], frames[i].length) == frames[i].checksum;
+	t1 = linclock::Now() / 1e9;
+	acc += linprotocol::CheckFrames(frames, count, ok);
+	t2 = linclock::Now() / 1e9;
+	Print("check_frames", count, t1 - t0, t2 - t1);
+
+	sink = acc;
+	delete[] frames;
+	delete[] data;
+	delete[] ok;
+	return 0;
+}
@@ -0,0 +1,289 @@
+/*
+ * linreplaybench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the trace replay onto a pseudo-terminal, standing in for the
+ * LIN interface:
+ *
+ *   linreplaybench [-n frames] [-s speed,...]
+ *
+ * A trace of synthetic traffic, frames in slots of 5 and 10 ms with a few
+ * headers without response, is written and replayed at every speed given (1
+ * by default, then 10 and 0, as fast as possible) through linserial into the
+ * slave side of a pseudo-terminal. A thread reads the master side and checks
+ * every header and response against the trace, a send callback slow to write
+ * the header checks the drift counts that time, and a replay stopped before
+ * Run() must send nothing; any difference is printed and the exit code is 1.
+ *
+ * One line is printed per speed with space separated key=value fields, the
+ * drift of the frames against their deadlines and how long the replay took
+ * against the recorded time divided by the speed:
+ *
+ *   speed=1 frames=400 errors=0 late=9 mean_drift_us=179.0 max_drift_us=5153.0
+ *     ms=3000.5 expected_ms=3000.4
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <thread>
+#include <vector>
+#include <linclock.h>
+#include <linserial.h>
+#include <lintrace.h>
+#include <linreplay.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+// Speed of the pseudo-terminal, only kept by termios
+#define REPLAY_SPEED						19200
+
+// Time the receiver waits for bytes after the replay ended
+#define RECEIVE_TIMEOUT_MS					1000
+
+// Time the slow send callback takes before the header is written, and the frames it sends
+#define SLOW_SEND_US						2000
+#define SLOW_SEND_FRAMES					20
+
+
+typedef lincapture::lincaptureframe_s frame_t;
+
+struct slowsend_s
+{
+	linreplay *replay;
+	uint32_t frames;
+};
+
+
+static void Generate(vector<frame_t> *frames, uint32_t count)
+{
+	uint64_t t = 1000000000ull;
+
+	frames->resize(count);
+	for (uint32_t n = 0; n < count; n++)
+	{
+		frame_t *f = &(*frames)[n];
+		uint64_t data = ((uint64_t)rand() << 32) ^ rand();
+
+		t += ((n & 1) ? 5000000 : 10000000) + rand() % 50000;
+
+		memset(f, 0, sizeof(*f));
+		f->timestamp = t;
+		f->pid = rand();
+		f->length = 1 + rand() % 8;
+		memcpy(f->data, &data, f->length);
+		f->checksum = rand();
+		if (rand() % 20 == 0)
+			f->flags = lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE;
+	}
+}
+
+// Bytes of the frames as the other side of the bus sees them, the break comes as a 0x00 byte
+static void Expected(const vector<frame_t> &frames, vector<uint8_t> *bytes)
+{
+	bytes->clear();
+	for (const frame_t &f : frames)
+	{
+		bytes->push_back(0x00);
+		bytes->push_back(0x55);
+		bytes->push_back(f.pid);
+		if (f.flags & lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE)
+			continue;
+		bytes->insert(bytes->end(), f.data, f.data + f.length);
+		bytes->push_back(f.checksum);
+	}
+}
+
+static void Receive(int fd, const vector<uint8_t> *expected, size_t *received, bool *same)
+{
+	uint8_t buffer[4096];
+
+	*received = 0;
+	*same = true;
+	while (*received < expected->size())
+	{
+		struct pollfd p = { fd, POLLIN, 0 };
+		ssize_t n;
+
+		if (poll(&p, 1, RECEIVE_TIMEOUT_MS) <= 0 || (n = read(fd, buffer, sizeof(buffer))) <= 0)
+			break;
+		if (*received + n > expected->size() || memcmp(buffer, expected->data() + *received, n) != 0)
+			*same = false;
+		*received += n;
+	}
+}
+
+static bool SlowSend(void *context, const frame_t *frame, uint64_t deadline, uint64_t *sent)
+{
+	slowsend_s *s = (slowsend_s *)context;
+
+	usleep(SLOW_SEND_US);
+	*sent = linclock::Now();
+	if (++s->frames == SLOW_SEND_FRAMES)
+		s->replay->Stop();
+
+	return true;
+}
+
+// Drift is taken when the header is written, not when the callback is called
+static uint32_t CheckDrift(const char *filename)
+{
+	linreplay::linreplaystats_s stats;
+	lintracereader r;
+	slowsend_s s;
+
+	if (!r.Open(filename))
+		return 1;
+
+	linreplay replay(&r, SlowSend, &s);
+	s.replay = &replay;
+	s.frames = 0;
+	replay.Run();
+	replay.GetStats(&stats);
+
+	if (stats.frames != SLOW_SEND_FRAMES || stats.late != stats.frames ||
+		stats.total_drift_ns < stats.frames * SLOW_SEND_US * 1000ull)
+	{
+		fprintf(stderr, "Drift of headers written %u us late: frames=%llu late=%llu mean_drift_us=%.1f\n", SLOW_SEND_US,
+				(unsigned long long)stats.frames, (unsigned long long)stats.late,
+				(stats.frames > 0) ? stats.total_drift_ns / 1e3 / stats.frames : 0.0);
+		return 1;
+	}
+
+	return 0;
+}
+
+// A Stop() issued before Run() is not lost, and it is taken by that Run() only
+static uint32_t CheckEarlyStop(const char *filename)
+{
+	lintracereader r;
+	slowsend_s s;
+
+	if (!r.Open(filename))
+		return 1;
+
+	linreplay replay(&r, SlowSend, &s);
+	s.replay = &replay;
+	s.frames = 0;
+	replay.Stop();
+	if (replay.Run() || s.frames != 0)
+	{
+		fprintf(stderr, "Replay stopped before Run() sent %u frames\n", s.frames);
+		return 1;
+	}
+
+	replay.Run();
+	if (s.frames != SLOW_SEND_FRAMES)
+	{
+		fprintf(stderr, "Replay after a stopped one sent %u frames of %u\n", s.frames, SLOW_SEND_FRAMES);
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *filename = "/tmp/linreplaybench.lint";
+	uint32_t count = 400;
+	vector<double> speeds;
+	vector<frame_t> frames;
+	vector<uint8_t> expected;
+	lintracewriter w;
+	uint32_t errors = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:s:")) != -1)
+	{
+		if (opt == 'n' && atoi(optarg) > 0)
+		{
+			count = atoi(optarg);
+		}
+		else if (opt == 's')
+		{
+			for (char *s = strtok(optarg, ","); s != NULL; s = strtok(NULL, ","))
+				speeds.push_back(atof(s));
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n frames] [-s speed,...]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (speeds.empty())
+		speeds = { 1, 10, 0 };
+
+	// Trace
+	srand(1);
+	Generate(&frames, count);
+	Expected(frames, &expected);
+	if (!w.Open(filename))
+	{
+		fprintf(stderr, "Cannot create %s\n", filename);
+		return 1;
+	}
+	for (const frame_t &f : frames)
+		w.Write(&f);
+	if (!w.Close())
+	{
+		fprintf(stderr, "Cannot write %s\n", filename);
+		return 1;
+	}
+
+	for (double speed : speeds)
+	{
+		linreplay::linreplaystats_s stats;
+		lintracereader r;
+		linserial serial;
+		size_t received;
+		bool same;
+		double t0, t1;
+
+		// Pseudo-terminal, the replay writes to the slave side
+		int master = posix_openpt(O_RDWR | O_NOCTTY);
+		if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 ||
+			!serial.Open(ptsname(master), REPLAY_SPEED, false) || !r.Open(filename))
+		{
+			fprintf(stderr, "Cannot open the pseudo-terminal or the trace\n");
+			return 1;
+		}
+
+		linreplay replay(&r, linreplay::SendSerial, &serial);
+		replay.SetSpeed(speed);
+
+		thread receiver(Receive, master, &expected, &received, &same);
+		t0 = linclock::Now() / 1e9;
+		replay.Run();
+		t1 = linclock::Now() / 1e9;
+		receiver.join();
+
+		replay.GetStats(&stats);
+		printf("speed=%g frames=%llu errors=%llu late=%llu mean_drift_us=%.1f max_drift_us=%.1f ms=%.1f expected_ms=%.1f\n",
+				speed, (unsigned long long)stats.frames, (unsigned long long)stats.errors, (unsigned long long)stats.late,
+				stats.total_drift_ns / 1e3 / stats.frames, stats.max_drift_ns / 1e3, (t1 - t0) * 1e3,
+				(speed > 0) ? (frames[count - 1].timestamp - frames[0].timestamp) / 1e6 / speed : 0.0);
+
+		if (stats.frames != count || stats.errors != 0 || received != expected.size() || !same)
+		{
+			fprintf(stderr, "Replay at speed %g differs: %zu bytes of %zu received\n", speed, received, expected.size());
+			errors++;
+		}
+
+		serial.Close();
+		close(master);
+	}
+
+	errors += CheckDrift(filename);
+	errors += CheckEarlyStop(filename);
+	unlink(filename);
+
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,439 @@
+/*
+ * linserialbench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the serial transport on a pseudo-terminal, standing in for the
+ * LIN interface:
+ *
+ *   linserialbench [-n frames]
+ *
+ * The master side of the pseudo-terminal plays the bus. It sends headers as
+ * 0x00 0x55 PID, in turns of frames the slave publishes, frames it subscribes
+ * with their response, frames it ignores, with responses full of 0x00 bytes and
+ * of 0x00 0x55 followed by bad parity, headers without response, and headers
+ * the transport writes itself. linserial reads them on the slave side with
+ * ReadHeader(), ReadResponse() and WriteResponse(), first without echo, then
+ * with a thread echoing every byte back as the transceiver does. A response cut
+ * short, an echo that differs and a speed without a termios Bxxx code are
+ * checked at the end. Any difference is printed and the exit code is 1.
+ *
+ * One line is printed per echo mode with space separated key=value fields, and
+ * the time from a header written on the master side to the response of the
+ * slave read back:
+ *
+ *   echo=0 frames=20000 errors=0 headers=16669 mean_us=6.0 max_us=72.3 ms=100.9
+ *   echo=1 frames=20000 errors=0 headers=20002 mean_us=13.6 max_us=57.4 ms=147.5
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <linprotocol.h>
+#include <linserial.h>
+#include <linclock.h>
+
+// termios2 of the kernel, its struct termios clashes with the one of the C library
+#define termios linserialbench_kernel_termios
+#include <asm/termbits.h>
+#undef termios
+
+
+using namespace std;
+using namespace lin;
+
+
+// Speed of the pseudo-terminal, only kept by termios
+#define BENCH_SPEED							19200
+
+// Speed without a Bxxx code, checked through termios2
+#define BENCH_OTHER_SPEED					10417
+
+// Time any byte is waited for, nothing is lost on a pseudo-terminal
+#define BENCH_TIMEOUT_MS					1000
+
+// Time a response cut short is waited for
+#define BENCH_SHORT_TIMEOUT_MS				20
+
+// LIN sync byte
+#define BENCH_SYNC_BYTE						0x55
+
+
+enum kind_e
+{
+	KIND_PUBLISHED = 0,			// Slave writes the response
+	KIND_SUBSCRIBED,			// Master writes the response, slave reads it
+	KIND_IGNORED,				// Master writes a response the slave does not read
+	KIND_IGNORED_SYNC,			// Same, with 0x00 0x55 and a PID of bad parity in the response
+	KIND_HEADER_ONLY,			// Nobody responds
+	KIND_WRITTEN,				// Slave writes the header, as a master node
+	KINDS
+};
+
+// Master side of the pseudo-terminal, echoing and recording the bytes the slave side writes
+struct bus_s
+{
+	int fd;
+	atomic<bool> stop;
+	atomic<bool> corrupt;
+	mutex lock;
+	vector<uint8_t> written;
+};
+
+
+static bool WriteAll(int fd, const uint8_t *data, size_t size)
+{
+	while (size > 0)
+	{
+		ssize_t n = write(fd, data, size);
+
+		if (n <= 0)
+			return false;
+		data += n;
+		size -= n;
+	}
+
+	return true;
+}
+
+static bool ReadAll(int fd, uint8_t *data, size_t size)
+{
+	while (size > 0)
+	{
+		struct pollfd p = { fd, POLLIN, 0 };
+		ssize_t n;
+
+		if (poll(&p, 1, BENCH_TIMEOUT_MS) <= 0)
+			return false;
+		n = read(fd, data, size);
+		if (n <= 0)
+			return false;
+		data += n;
+		size -= n;
+	}
+
+	return true;
+}
+
+static void Echo(bus_s *bus)
+{
+	uint8_t bytes[LIN_SERIAL_BUFFER_SIZE];
+
+	while (!bus->stop)
+	{
+		struct pollfd p = { bus->fd, POLLIN, 0 };
+		ssize_t n;
+
+		if (poll(&p, 1, 10) <= 0)
+			continue;
+		n = read(bus->fd, bytes, sizeof(bytes));
+		if (n <= 0)
+			continue;
+
+		{
+			lock_guard<mutex> guard(bus->lock);
+			bus->written.insert(bus->written.end(), bytes, bytes + n);
+		}
+
+		// A conflict on the bus changes the last bit of the first byte
+		if (bus->corrupt)
+			bytes[0] ^= 0x01;
+		WriteAll(bus->fd, bytes, n);
+	}
+}
+
+// Response bytes of the frame, data and checksum
+static uint8_t Response(uint8_t pid, uint8_t kind, uint8_t *bytes)
+{
+	uint8_t length = 1 + rand() % 8;
+
+	for (uint8_t i = 0; i < length; i++)
+		bytes[i] = (kind == KIND_IGNORED && rand() % 2 == 0) ? 0x00 : rand();
+
+	// 0x00 0x55 inside a response is only a header when a good protected ID follows
+	if (kind == KIND_IGNORED_SYNC)
+	{
+		length = 8;
+		bytes[0] = 0x00;
+		bytes[1] = BENCH_SYNC_BYTE;
+		bytes[2] = pid ^ 0x40;
+		bytes[3] = 0x00;
+	}
+	bytes[length] = linprotocol::Checksum(pid, linprotocol::LIN_CHECKSUM_ENHANCED, bytes, length);
+
+	// Random bytes must not make a header by chance
+	for (uint8_t i = 1; i <= length; i++)
+		if (bytes[i - 1] == 0x00 && bytes[i] == BENCH_SYNC_BYTE && (i == length || linprotocol::IsValidPid(bytes[i + 1])))
+			bytes[i]++;
+
+	return length + 1;
+}
+
+static uint32_t Run(bool echo, uint32_t count, uint32_t *headers, double *mean_us, double *max_us)
+{
+	bus_s bus;
+	linserial serial;
+	thread echoer;
+	vector<uint8_t> expected;
+	linserial::linserialstats_s stats;
+	uint32_t errors = 0;
+	uint32_t published = 0;
+	double sum = 0;
+
+	*headers = 0;
+	*mean_us = 0;
+	*max_us = 0;
+
+	bus.fd = posix_openpt(O_RDWR | O_NOCTTY);
+	bus.stop = false;
+	bus.corrupt = false;
+	if (bus.fd < 0 || grantpt(bus.fd) != 0 || unlockpt(bus.fd) != 0 || !serial.Open(ptsname(bus.fd), BENCH_SPEED, echo))
+	{
+		fprintf(stderr, "Cannot open a pseudo-terminal\n");
+		if (bus.fd >= 0) close(bus.fd);
+		return 1;
+	}
+	if (echo)
+		echoer = thread(Echo, &bus);
+
+	for (uint32_t n = 0; n < count && errors == 0; n++)
+	{
+		uint8_t kind = n % KINDS;
+		uint8_t pid = linprotocol::Pid(rand() % LIN_PROTOCOL_IDS);
+		uint8_t bytes[3 + 9];
+		uint8_t response[9];
+		uint8_t read[9];
+		uint8_t size = 0;
+		uint8_t got = 0;
+		uint64_t timestamp;
+		double t0 = linclock::Now() / 1e9;
+
+		// The transport as master node, the header comes back as the echo or on the master side
+		if (kind == KIND_WRITTEN)
+		{
+			const uint8_t header[3] = { 0x00, BENCH_SYNC_BYTE, pid };
+
+			if (!serial.WriteHeader(pid))
+			{
+				fprintf(stderr, "echo=%d frame %u: header not written\n", echo, n);
+				errors++;
+			}
+			else if (!echo && (!ReadAll(bus.fd, read, sizeof(header)) || memcmp(read, header, sizeof(header)) != 0))
+			{
+				fprintf(stderr, "echo=%d frame %u: header written differs\n", echo, n);
+				errors++;
+			}
+			expected.insert(expected.end(), header, header + sizeof(header));
+
+			// Only the echo is read as a header
+			if (echo) (*headers)++;
+			continue;
+		}
+
+		// Header, and the response when another node sends it
+		bytes[0] = 0x00;
+		bytes[1] = BENCH_SYNC_BYTE;
+		bytes[2] = pid;
+		if (kind != KIND_PUBLISHED && kind != KIND_HEADER_ONLY)
+			size = Response(pid, kind, bytes + 3);
+		if (!WriteAll(bus.fd, bytes, 3 + size))
+		{
+			fprintf(stderr, "Cannot write to the pseudo-terminal\n");
+			errors++;
+			break;
+		}
+
+		if (!serial.ReadHeader(&got, &timestamp, BENCH_TIMEOUT_MS) || got != pid)
+		{
+			fprintf(stderr, "echo=%d frame %u: header 0x%02X read as 0x%02X\n", echo, n, pid, got);
+			errors++;
+			continue;
+		}
+		(*headers)++;
+
+		if (kind == KIND_SUBSCRIBED)
+		{
+			if (serial.ReadResponse(read, size, BENCH_TIMEOUT_MS, &timestamp) != size || memcmp(read, bytes + 3, size) != 0)
+			{
+				fprintf(stderr, "echo=%d frame %u: response read differs\n", echo, n);
+				errors++;
+			}
+		}
+		else if (kind == KIND_PUBLISHED)
+		{
+			double us;
+
+			size = Response(pid, kind, response);
+			if (!serial.WriteResponse(response, size))
+			{
+				fprintf(stderr, "echo=%d frame %u: response not written\n", echo, n);
+				errors++;
+			}
+			else if (!echo && (!ReadAll(bus.fd, read, size) || memcmp(read, response, size) != 0))
+			{
+				fprintf(stderr, "echo=%d frame %u: response written differs\n", echo, n);
+				errors++;
+			}
+			expected.insert(expected.end(), response, response + size);
+
+			us = (linclock::Now() / 1e9 - t0) * 1e6;
+			sum += us;
+			if (us > *max_us) *max_us = us;
+			published++;
+		}
+	}
+	if (published > 0)
+		*mean_us = sum / published;
+
+	// A response cut short returns what came, and the next header is read
+	if (errors == 0)
+	{
+		const uint8_t cut[5] = { 0x00, BENCH_SYNC_BYTE, linprotocol::Pid(0x10), 0x12, 0x00 };
+		const uint8_t next[3] = { 0x00, BENCH_SYNC_BYTE, linprotocol::Pid(0x11) };
+		uint8_t pid = 0;
+		uint8_t read[9];
+
+		WriteAll(bus.fd, cut, sizeof(cut));
+		if (!serial.ReadHeader(&pid, NULL, BENCH_TIMEOUT_MS) || pid != cut[2] ||
+				serial.ReadResponse(read, 9, BENCH_SHORT_TIMEOUT_MS, NULL) != 2 || memcmp(read, cut + 3, 2) != 0)
+		{
+			fprintf(stderr, "echo=%d: response cut short misread\n", echo);
+			errors++;
+		}
+		WriteAll(bus.fd, next, sizeof(next));
+		if (!serial.ReadHeader(&pid, NULL, BENCH_TIMEOUT_MS) || pid != next[2])
+		{
+			fprintf(stderr, "echo=%d: header after a response cut short misread\n", echo);
+			errors++;
+		}
+		*headers += 2;
+	}
+
+	// An echo that differs is a conflict on the bus
+	if (echo && errors == 0)
+	{
+		const uint8_t response[2] = { 0x42, 0x00 };
+
+		bus.corrupt = true;
+		serial.GetStats(&stats);
+		if (serial.WriteResponse(response, sizeof(response)) || stats.echo_errors != 0)
+		{
+			fprintf(stderr, "echo=%d: bus conflict not seen\n", echo);
+			errors++;
+		}
+		serial.GetStats(&stats);
+		if (stats.echo_errors != 1)
+		{
+			fprintf(stderr, "echo=%d: %u echo errors counted for one conflict\n", echo, stats.echo_errors);
+			errors++;
+		}
+	}
+
+	if (echo)
+	{
+		bus.stop = true;
+		echoer.join();
+
+		// Bytes written by the slave side, as the echoing thread saw them
+		if (errors == 0 && (bus.written.size() < expected.size() || memcmp(bus.written.data(), expected.data(), expected.size()) != 0))
+		{
+			fprintf(stderr, "echo=%d: bytes written differ\n", echo);
+			errors++;
+		}
+	}
+
+	serial.GetStats(&stats);
+	if (errors == 0 && (stats.headers != *headers || stats.sync_errors != 0 || stats.framing_errors != 0))
+	{
+		fprintf(stderr, "echo=%d: stats headers=%u of %u sync_errors=%u framing_errors=%u\n", echo, stats.headers, *headers,
+				stats.sync_errors, stats.framing_errors);
+		errors++;
+	}
+
+	serial.Close();
+	close(bus.fd);
+
+	return errors;
+}
+
+// Speeds without a Bxxx code reach the driver in bps
+static uint32_t CheckOtherSpeed()
+{
+	struct termios2 t2;
+	linserial serial;
+	uint32_t errors = 0;
+	int master;
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 || !serial.Open(ptsname(master), BENCH_OTHER_SPEED, false))
+	{
+		fprintf(stderr, "Cannot open a pseudo-terminal at %u bps\n", BENCH_OTHER_SPEED);
+		if (master >= 0) close(master);
+		return 1;
+	}
+
+	if (ioctl(serial.GetFd(), TCGETS2, &t2) != 0 || (t2.c_cflag & CBAUD) != BOTHER || t2.c_ospeed != BENCH_OTHER_SPEED ||
+			t2.c_ispeed != BENCH_OTHER_SPEED)
+	{
+		fprintf(stderr, "Speed of %u bps not set\n", BENCH_OTHER_SPEED);
+		errors++;
+	}
+	serial.Close();
+	close(master);
+
+	if (serial.Open("/dev/null", 0, false))
+	{
+		fprintf(stderr, "Speed of 0 bps accepted\n");
+		errors++;
+	}
+
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t count = 20000;
+	uint32_t errors = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		if (opt == 'n' && atoi(optarg) > 0)
+		{
+			count = atoi(optarg);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n frames]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	srand(1);
+	for (int echo = 0; echo <= 1; echo++)
+	{
+		uint32_t headers;
+		uint32_t e;
+		double mean_us, max_us;
+		double t0 = linclock::Now() / 1e9;
+
+		e = Run(echo, count, &headers, &mean_us, &max_us);
+		printf("echo=%d frames=%u errors=%u headers=%u mean_us=%.1f max_us=%.1f ms=%.1f\n", echo, count, e, headers,
+				mean_us, max_us, (linclock::Now() / 1e9 - t0) * 1e3);
+		fflush(stdout);
+		errors += e;
+	}
+
+	errors += CheckOtherSpeed();
+
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+/*
+ * linslavebench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the slave emulation engine:
+ *
+ *   linslavebench [-n headers] [scale|name=value,...|file.ldf]
+ *
+ * Every slave of the database is compiled and its table checked against a
+ * reference built bit by bit from the database: the protected ID, the direction
+ * of every frame for the node, the response with the default values of the
+ * signals and the bits no signal covers recessive, and its checksum, summed
+ * byte by byte with the classic or enhanced model. OnHeader() is checked with
+ * the 256 possible PIDs, SetResponseData() and OnResponse() with random data,
+ * good and bad checksums and wrong lengths. Any difference is printed and the
+ * exit code is 1.
+ *
+ * The default database has 60 frames of 3 signals of 16 bits, so a quarter of
+ * every response is left recessive. Then headers of the frames of the database
+ * in random order are served by the slave publishing most frames, and one line
+ * is printed with space separated key=value fields and the time per header:
+ *
+ *   node=Slave_1 frames=60 published=8 subscribed=0 headers=100000000 ms=192.9
+ *     ns_header=1.93
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ldf.h>
+#include <linprotocol.h>
+#include <linslave.h>
+#include <ldfsynthetic.h>
+#include <linclock.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+// Cluster with signals not covering their frames
+#define DEFAULT_SCALE						"slaves=8,frames=60,signals_per_frame=3,schedule_tables=1,table_entries=60,encoding_types=16,logical_values=4"
+
+// PIDs of the header sequence, a power of two
+#define SEQUENCE_SIZE						4096
+
+
+// Sum of the responses served, so the lookups are not optimized away
+static volatile uint64_t responses_sum;
+
+
+static uint8_t ReferencePid(uint8_t id)
+{
+	uint8_t b[6];
+
+	for (int i = 0; i < 6; i++)
+		b[i] = (id >> i) & 1;
+
+	return id | ((b[0] ^ b[1] ^ b[2] ^ b[4]) << 6) | ((1 ^ b[1] ^ b[3] ^ b[4] ^ b[5]) << 7);
+}
+
+// Inverted sum with carry, of the PID too for the enhanced model
+static uint8_t ReferenceChecksum(uint8_t pid, bool enhanced, const uint8_t *data, uint8_t length)
+{
+	uint32_t sum = enhanced ? pid : 0;
+
+	for (uint8_t i = 0; i < length; i++)
+	{
+		sum += data[i];
+		if (sum > 0xFF)
+			sum -= 0xFF;
+	}
+
+	return ~sum & 0xFF;
+}
+
+// Response of the default values, one bit at a time, bits of no signal are recessive
+static void ReferenceResponse(ldf *db, ldfframe *f, uint8_t length, uint8_t *data)
+{
+	uint8_t bits[64];
+
+	memset(bits, 1, sizeof(bits));
+	for (uint32_t i = 0; i < f->GetSignalsCount(); i++)
+	{
+		ldfframesignal *fs = f->GetSignal(i);
+		ldfsignal *s = db->GetSignalByName(fs->GetName());
+
+		for (uint32_t b = 0; s != NULL && b < s->GetBitSize(); b++)
+			if (fs->GetOffset() + b < length * 8u)
+				bits[fs->GetOffset() + b] = (b < 32) ? (s->GetDefaultValue() >> b) & 1 : 0;
+	}
+
+	for (uint8_t i = 0; i < length; i++)
+	{
+		data[i] = 0;
+		for (int b = 0; b < 8; b++)
+			data[i] |= bits[i * 8 + b] << b;
+	}
+}
+
+static uint8_t ReferenceDirection(ldf *db, ldfframe *f, const uint8_t *node)
+{
+	if (NameEq(f->GetPublisher(), node))
+		return linslave::LIN_SLAVE_PUBLISH;
+
+	for (uint32_t i = 0; i < f->GetSignalsCount(); i++)
+	{
+		ldfsignal *s = db->GetSignalByName(f->GetSignal(i)->GetName());
+
+		for (uint32_t j = 0; s != NULL && j < s->GetSubscribersCount(); j++)
+			if (NameEq(s->GetSubscriber(j), node))
+				return linslave::LIN_SLAVE_SUBSCRIBE;
+	}
+
+	return linslave::LIN_SLAVE_IGNORE;
+}
+
+static uint32_t Check(ldf *db, linslave *slave)
+{
+	const uint8_t *node = slave->GetNodeName();
+
+	for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		const linslave::linslaveentry_s *e = slave->GetEntry(id);
+		ldfframe *f = db->GetFrameById(id);
+		uint8_t pid = ReferencePid(id);
+		uint8_t response[LIN_RESPONSE_MAX_SIZE];
+		uint8_t data[8];
+		uint8_t length;
+		bool enhanced;
+
+		if (f == NULL)
+		{
+			if (e->direction != linslave::LIN_SLAVE_IGNORE || e->frame != NULL)
+			{
+				fprintf(stderr, "%s: ID 0x%02X has no frame but is not ignored\n", node, id);
+				return 1;
+			}
+			continue;
+		}
+
+		// Table entry
+		length = (f->GetSize() <= 8) ? f->GetSize() : 8;
+		enhanced = id < LIN_PROTOCOL_MASTER_REQUEST_ID && db->GetLinProtocolVersion() != LIN_PROTOCOL_VERSION_NONE;
+		ReferenceResponse(db, f, length, response);
+		response[length] = ReferenceChecksum(pid, enhanced, response, length);
+
+		if (e->frame != f || e->pid != pid || e->length != length || e->direction != ReferenceDirection(db, f, node) ||
+			e->checksum != (enhanced ? linprotocol::LIN_CHECKSUM_ENHANCED : linprotocol::LIN_CHECKSUM_CLASSIC) ||
+			memcmp(e->response, response, length + 1) != 0)
+		{
+			fprintf(stderr, "%s: entry of frame %s differs\n", node, f->GetName());
+			return 1;
+		}
+
+		// Headers, only the right PID of a published frame is answered
+		for (uint32_t p = 0; p < 256; p++)
+		{
+			if ((p & 0x3F) != id)
+				continue;
+
+			const uint8_t *r = NULL;
+			uint8_t n = slave->OnHeader(p, &r);
+			bool answer = p == pid && e->direction == linslave::LIN_SLAVE_PUBLISH;
+
+			if (answer ? (n != length + 1 || r == NULL || memcmp(r, response, n) != 0) : n != 0)
+			{
+				fprintf(stderr, "%s: header 0x%02X of frame %s answered wrong\n", node, p, f->GetName());
+				return 1;
+			}
+		}
+
+		// New data, published frames take it with its checksum, the rest refuse it
+		for (uint8_t i = 0; i < 8; i++)
+			data[i] = rand();
+		if (slave->SetResponseData(id, data) != (e->direction == linslave::LIN_SLAVE_PUBLISH))
+		{
+			fprintf(stderr, "%s: response data of frame %s set wrong\n", node, f->GetName());
+			return 1;
+		}
+		if (e->direction == linslave::LIN_SLAVE_PUBLISH)
+		{
+			const uint8_t *r = NULL;
+
+			memcpy(response, data, length);
+			response[length] = ReferenceChecksum(pid, enhanced, data, length);
+			if (slave->OnHeader(pid, &r) != length + 1 || memcmp(r, response, length + 1) != 0)
+			{
+				fprintf(stderr, "%s: response of frame %s after new data differs\n", node, f->GetName());
+				return 1;
+			}
+		}
+
+		// Received responses, only complete ones of subscribed frames with a good checksum are kept
+		memcpy(response, data, length);
+		response[length] = ReferenceChecksum(pid, enhanced, data, length);
+		if (slave->OnResponse(pid, response, length + 1) != (e->direction == linslave::LIN_SLAVE_SUBSCRIBE) ||
+			(e->direction == linslave::LIN_SLAVE_SUBSCRIBE && memcmp(e->response, response, length + 1) != 0))
+		{
+			fprintf(stderr, "%s: response of frame %s received wrong\n", node, f->GetName());
+			return 1;
+		}
+
+		response[length] ^= 0x01;
+		if (slave->OnResponse(pid, response, length + 1) || slave->OnResponse(pid, response, length) ||
+			slave->OnResponse(pid ^ 0x80, response, length + 1))
+		{
+			fprintf(stderr, "%s: bad response of frame %s kept\n", node, f->GetName());
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *scale = DEFAULT_SCALE;
+	uint64_t count = 100000000;
+	uint8_t sequence[SEQUENCE_SIZE];
+	uint8_t pids[LIN_PROTOCOL_IDS];
+	uint32_t pids_count = 0;
+	uint32_t errors = 0;
+	uint32_t published = 0, subscribed = 0;
+	uint32_t busiest = 0;
+	uint64_t sum = 0;
+	linslave *slave;
+	double t0, t1;
+	ldf *db;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		if (opt == 'n' && atoll(optarg) > 0)
+		{
+			count = atoll(optarg);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n headers] [scale|name=value,...|file.ldf]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (optind < argc)
+		scale = argv[optind];
+
+	db = ldfsynthetic::Load(scale);
+	if (db == NULL)
+		return 1;
+	if (db->GetSlaveNodesCount() == 0)
+	{
+		fprintf(stderr, "No slaves in the database\n");
+		delete db;
+		return 1;
+	}
+
+	// Every slave, each one with its own data
+	srand(1);
+	for (uint32_t i = 0; i < db->GetSlaveNodesCount(); i++)
+	{
+		linslave s(db, db->GetSlaveNodeByIndex(i)->GetName());
+		uint32_t n = 0;
+
+		errors += Check(db, &s);
+		for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+			n += (s.GetEntry(id)->direction == linslave::LIN_SLAVE_PUBLISH);
+		if (n > published)
+		{
+			published = n;
+			busiest = i;
+		}
+	}
+
+	// Headers of the frames of the database, served by the slave publishing most of them
+	published = 0;
+	slave = new linslave(db, db->GetSlaveNodeByIndex(busiest)->GetName());
+	for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		const linslave::linslaveentry_s *e = slave->GetEntry(id);
+
+		if (e->frame == NULL)
+			continue;
+		pids[pids_count++] = e->pid;
+		published += (e->direction == linslave::LIN_SLAVE_PUBLISH);
+		subscribed += (e->direction == linslave::LIN_SLAVE_SUBSCRIBE);
+	}
+	for (uint32_t i = 0; i < SEQUENCE_SIZE; i++)
+		sequence[i] = (pids_count > 0) ? pids[rand() % pids_count] : 0;
+
+	t0 = linclock::Now() / 1e9;
+	for (uint64_t n = 0; n < count; n++)
+	{
+		const uint8_t *r;
+		uint8_t size = slave->OnHeader(sequence[n & (SEQUENCE_SIZE - 1)], &r);
+
+		if (size != 0)
+			sum += r[size - 1];
+	}
+	t1 = linclock::Now() / 1e9;
+	responses_sum = sum;
+
+	printf("node=%s frames=%u published=%u subscribed=%u headers=%llu ms=%.1f ns_header=%.2f\n",
+			slave->GetNodeName(), pids_count, published, subscribed, (unsigned long long)count, (t1 - t0) * 1e3,
+			(t1 - t0) * 1e9 / count);
+	delete slave;
+	delete db;
+
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,287 @@
+/*
+ * lintracebench.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Benchmark of the binary trace format on synthetic bus traffic:
+ *
+ *   lintracebench [-n frames] [-f file.lint]
+ *
+ * The traffic is a schedule of 16 frames in slots of 5 and 10 ms with some
+ * jitter, whose signals change now and then, with a few frames without
+ * response. It is written to a trace, which is then read back whole, seeked
+ * to random times, frames and frame IDs, and recovered after cutting it in the
+ * middle of a block without its index, as if the recorder was killed. Every
+ * frame read is checked against the written one; any difference is printed
+ * and the exit code is 1.
+ *
+ * One line is printed per operation with space separated key=value fields:
+ *
+ *   op=write frames=1000000 bytes=6328344 bytes_frame=6.33 ns_frame=14.7
+ *     hours=2.09
+ *   op=seek_time seeks=1000 us_seek=15.20
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <vector>
+#include <lintrace.h>
+#include <linclock.h>
+
+
+using namespace std;
+using namespace lin;
+
+
+// Frames of the synthetic schedule
+#define SCHEDULE_FRAMES						16
+
+// Random seeks of every kind
+#define SEEKS								1000
+
+
+typedef lincapture::lincaptureframe_s frame_t;
+
+
+static uint64_t Random64()
+{
+	return ((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ rand();
+}
+
+static bool SameFrame(const frame_t *a, const frame_t *b)
+{
+	return a->timestamp == b->timestamp && memcmp(a->data, b->data, a->length) == 0 && a->pid == b->pid &&
+			a->length == b->length && a->checksum == b->checksum && a->flags == b->flags && a->bus == b->bus;
+}
+
+static void Generate(vector<frame_t> *frames, uint64_t count)
+{
+	uint64_t data[SCHEDULE_FRAMES];
+	uint64_t t = 1000000000ull;
+
+	for (uint32_t i = 0; i < SCHEDULE_FRAMES; i++)
+		data[i] = Random64();
+
+	frames->resize(count);
+	for (uint64_t n = 0; n < count; n++)
+	{
+		uint32_t slot = n % SCHEDULE_FRAMES;
+		frame_t *f = &(*frames)[n];
+
+		// Slots of 5 or 10 ms, up to 50 us late
+		t += ((slot & 1) ? 5000000 : 10000000) + rand() % 50000;
+
+		// One in twenty frames carries a new value
+		if (rand() % 20 == 0)
+			data[slot] ^= 1ull << (rand() % 64);
+
+		memset(f, 0, sizeof(*f));
+		f->timestamp = t;
+		f->pid = slot * 3;
+		f->length = 2 + slot % 7;
+		memcpy(f->data, &data[slot], f->length);
+		f->checksum = data[slot] >> 56;
+		if (rand() % 1000 == 0)
+		{
+			f->length = 0;
+			memset(f->data, 0, sizeof(f->data));
+			f->checksum = 0;
+			f->flags = lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE;
+		}
+	}
+}
+
+static uint32_t CheckRead(lintracereader *r, const vector<frame_t> &frames, uint64_t count)
+{
+	frame_t f;
+	uint64_t n = 0;
+
+	r->SeekFrame(0);
+	while (r->Next(&f))
+	{
+		if (n >= count || !SameFrame(&f, &frames[n]))
+		{
+			fprintf(stderr, "Frame %llu differs\n", (unsigned long long)n);
+			return 1;
+		}
+		n++;
+	}
+
+	if (n != count)
+	{
+		fprintf(stderr, "Read %llu frames of %llu\n", (unsigned long long)n, (unsigned long long)count);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void Print(const char *op, uint32_t seeks, double t)
+{
+	printf("op=%s seeks=%u us_seek=%.2f\n", op, seeks, t * 1e6 / seeks);
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t count = 1000000;
+	const char *filename = "/tmp/lintracebench.lint";
+	char recovered[1000];
+	vector<frame_t> frames;
+	lintracewriter w;
+	lintracereader r;
+	frame_t f;
+	struct stat st;
+	uint32_t errors = 0;
+	double t0, t1;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:f:")) != -1)
+	{
+		if (opt == 'n' && atoll(optarg) > 0)
+			count = atoll(optarg);
+		else if (opt == 'f')
+			filename = optarg;
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n frames] [-f file.lint]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	srand(1);
+	Generate(&frames, count);
+
+	// Write
+	t0 = linclock::Now() / 1e9;
+	if (!w.Open(filename))
+	{
+		fprintf(stderr, "Cannot create %s\n", filename);
+		return 1;
+	}
+	for (uint64_t n = 0; n < count; n++)
+		w.Write(&frames[n]);
+	if (!w.Close() || stat(filename, &st) != 0)
+	{
+		fprintf(stderr, "Cannot write %s\n", filename);
+		return 1;
+	}
+	t1 = linclock::Now() / 1e9;
+	printf("op=write frames=%llu bytes=%llu bytes_frame=%.2f ns_frame=%.1f hours=%.2f\n",
+			(unsigned long long)count, (unsigned long long)st.st_size, (double)st.st_size / count,
+			(t1 - t0) * 1e9 / count, (frames[count - 1].timestamp - frames[0].timestamp) / 3.6e12);
+
+	// Open with the index
+	t0 = linclock::Now() / 1e9;
+	if (!r.Open(filename) || !r.IsComplete() || r.GetFramesCount() != count)
+	{
+		fprintf(stderr, "Cannot open %s\n", filename);
+		return 1;
+	}
+	t1 = linclock::Now() / 1e9;
+	printf("op=open blocks=%u us=%.1f\n", r.GetBlocksCount(), (t1 - t0) * 1e6);
+
+	// Whole trace
+	t0 = linclock::Now() / 1e9;
+	errors += CheckRead(&r, frames, count);
+	t1 = linclock::Now() / 1e9;
+	printf("op=read frames=%llu ns_frame=%.1f\n", (unsigned long long)count, (t1 - t0) * 1e9 / count);
+
+	// Random times, the frame read shall be the first at or after them
+	t0 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < SEEKS && errors == 0; i++)
+	{
+		uint64_t t = frames[0].timestamp + Random64() % (frames[count - 1].timestamp - frames[0].timestamp + 1);
+		uint64_t n = lower_bound(frames.begin(), frames.end(), t,
+				[](const frame_t &a, uint64_t t) { return a.timestamp < t; }) - frames.begin();
+
+		if (!r.SeekTime(t) || r.GetPosition() != n || !r.Next(&f) || !SameFrame(&f, &frames[n]))
+		{
+			fprintf(stderr, "Seek to time %llu differs\n", (unsigned long long)t);
+			errors++;
+		}
+	}
+	t1 = linclock::Now() / 1e9;
+	Print("seek_time", SEEKS, t1 - t0);
+
+	// Random frames
+	t0 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < SEEKS && errors == 0; i++)
+	{
+		uint64_t n = Random64() % count;
+
+		if (!r.SeekFrame(n) || !r.Next(&f) || !SameFrame(&f, &frames[n]))
+		{
+			fprintf(stderr, "Seek to frame %llu differs\n", (unsigned long long)n);
+			errors++;
+		}
+	}
+	t1 = linclock::Now() / 1e9;
+	Print("seek_frame", SEEKS, t1 - t0);
+
+	// Next frames of an ID from random frames
+	t0 = linclock::Now() / 1e9;
+	for (uint32_t i = 0; i < SEEKS && errors == 0; i++)
+	{
+		uint64_t n = Random64() % count;
+		uint8_t id = (rand() % SCHEDULE_FRAMES) * 3;
+
+		r.SeekFrame(n);
+		for (uint32_t j = 0; j < 3 && errors == 0; j++)
+		{
+			while (n < count && (frames[n].pid & 0x3F) != id)
+				n++;
+			if (n < count ? !r.Next(id, &f) || !SameFrame(&f, &frames[n]) : r.Next(id, &f))
+			{
+				fprintf(stderr, "Next frame of ID 0x%02X after %llu differs\n", id, (unsigned long long)n);
+				errors++;
+			}
+			n++;
+		}
+	}
+	t1 = linclock::Now() / 1e9;
+	Print("seek_id", SEEKS, t1 - t0);
+	r.Close();
+
+	// Killed recorder: no index and the last block cut
+	snprintf(recovered, sizeof(recovered), "%s.cut", filename);
+	{
+		int in = open(filename, O_RDONLY);
+		int out = open(recovered, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		vector<uint8_t> image(st.st_size);
+		uint64_t zero = 0;
+
+		if (in < 0 || out < 0 || read(in, image.data(), st.st_size) != st.st_size)
+		{
+			fprintf(stderr, "Cannot copy %s\n", filename);
+			return 1;
+		}
+		memcpy(&image[8], &zero, sizeof(zero));
+		if (write(out, image.data(), st.st_size * 6 / 10) != st.st_size * 6 / 10)
+			errors++;
+		close(in);
+		close(out);
+	}
+
+	t0 = linclock::Now() / 1e9;
+	if (!r.Open(recovered) || r.IsComplete() || r.GetFramesCount() > count)
+	{
+		fprintf(stderr, "Cannot recover %s\n", recovered);
+		return 1;
+	}
+	t1 = linclock::Now() / 1e9;
+	printf("op=recover blocks=%u frames=%llu us=%.1f\n", r.GetBlocksCount(), (unsigned long long)r.GetFramesCount(),
+			(t1 - t0) * 1e6);
+	errors += CheckRead(&r, frames, r.GetFramesCount());
+	r.Close();
+
+	unlink(recovered);
+	unlink(filename);
+
+	return (errors == 0) ? 0 : 1;
+}
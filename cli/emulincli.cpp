@@ -0,0 +1,606 @@
+/*
+ * emulincli.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ *
+ * Command line front end for LIN databases, it only uses the lin:: core and
+ * never starts GTK:
+ *
+ *   emulin-cli validate [-j threads] [-c] [-q] [-W] <file.ldf> ...
+ *   emulin-cli stats [-j threads] [-c] <file.ldf> ...
+ *   emulin-cli save [-j threads] [-c] <file.ldf> ...
+ *   emulin-cli format [-c] [-o output.ldf] <file.ldf>
+ *   emulin-cli query [-c] <file.ldf> <signal|frame|node|table|id> <name|id>
+ *   emulin-cli decode [-j threads] [-c] <file.ldf> <trace.lint>
+ *   emulin-cli import [-c] <trace.asc> <trace.lint> [file.ldf]
+ *   emulin-cli export [-c] <trace.lint> <trace.asc> [file.ldf]
+ *
+ * validate prints the findings of every file, stats prints one line of space
+ * separated key=value fields per file, save rewrites files in place with the
+ * normalized text and format prints it. query prints an entity in LDF syntax
+ * followed by the entities using it. decode decodes a binary trace into the
+ * signals of the database, on all cores, and prints one line per signal with
+ * its samples, time span and range of values (physical when it has a physical
+ * encoding), and a last line for the trace. import and export convert between
+ * Vector ASC text logs and binary traces, streaming, and print one line with
+ * the frames converted; with a database, frames are named in the log by their
+ * frame name. Files are processed in parallel, one
+ * worker per core by default, and reports are printed in the order of the
+ * files. With -c, databases are loaded through their binary cache.
+ *
+ * Exit codes are the highest of all files: 0 when all went fine, 1 when
+ * validation found errors (or warnings with -W) or a query found nothing, 2 on
+ * wrong usage and 3 when a file could not be read or written.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include <ldf.h>
+#include <ldfcache.h>
+#include <lintracedecoder.h>
+#include <lintrace.h>
+#include <linasc.h>
+
+
+// Exit codes
+#define CLI_EXIT_OK							0
+#define CLI_EXIT_FINDINGS					1
+#define CLI_EXIT_USAGE						2
+#define CLI_EXIT_IO							3
+
+// Trace blocks read ahead while exporting
+#define CLI_EXPORT_PREFETCH_BLOCKS			4
+
+
+using namespace std;
+using namespace lin;
+
+
+enum cli_command_e
+{
+	CLI_COMMAND_VALIDATE,
+	CLI_COMMAND_STATS,
+	CLI_COMMAND_SAVE,
+	CLI_COMMAND_FORMAT,
+	CLI_COMMAND_QUERY,
+	CLI_COMMAND_DECODE,
+	CLI_COMMAND_IMPORT,
+	CLI_COMMAND_EXPORT
+};
+
+struct cli_options_s
+{
+	cli_command_e command;
+	uint32_t threads;
+	bool use_cache;
+	bool quiet;
+	bool warnings_are_errors;
+	const char *output;
+};
+
+
+static const char *commands[] = { "validate", "stats", "save", "format", "query", "decode", "import", "export" };
+
+
+static void Usage(const char *program)
+{
+	fprintf(stderr,
+			"Usage: %s validate [-j threads] [-c] [-q] [-W] <file.ldf> ...\n"
+			"       %s stats [-j threads] [-c] <file.ldf> ...\n"
+			"       %s save [-j threads] [-c] <file.ldf> ...\n"
+			"       %s format [-c] [-o output.ldf] <file.ldf>\n"
+			"       %s query [-c] <file.ldf> <signal|frame|node|table|id> <name|id>\n"
+			"       %s decode [-j threads] [-c] <file.ldf> <trace.lint>\n"
+			"       %s import [-c] <trace.asc> <trace.lint> [file.ldf]\n"
+			"       %s export [-c] <trace.lint> <trace.asc> [file.ldf]\n",
+			program, program, program, program, program, program, program, program);
+}
+
+static ldf *Load(const char *filename, cli_options_s *options)
+{
+	try
+	{
+		if (options->use_cache)
+		{
+			bool stored;
+			ldf *db = ldfcache::Load((const uint8_t *)filename, &stored);
+
+			// The database is still loaded, only the next load will parse it again
+			if (!stored)
+				fprintf(stderr, "%s: cache cannot be written\n", filename);
+			return db;
+		}
+		return new ldf((const uint8_t *)filename);
+	}
+	catch (const exception &e)
+	{
+		fprintf(stderr, "%s: %s\n", filename, e.what());
+		return NULL;
+	}
+}
+
+static int Validate(const char *filename, ldf *db, cli_options_s *options, ldfwriter *out)
+{
+	ldfdiagnostics *d = db->GetDiagnostics();
+	uint32_t errors = d->GetCount(ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR);
+	uint32_t warnings = d->GetCount(ldfdiagnostics::LDF_DIAG_SEVERITY_WARNING);
+	char text[1000];
+
+	// Findings
+	for (uint32_t i = 0; !options->quiet && i < d->GetCount(); i++)
+	{
+		d->GetText(i, text, sizeof(text));
+		if (d->GetOccurrences(i) > 1)
+			out->Printf("%s: %s (%u times)\n", filename, text, d->GetOccurrences(i));
+		else
+			out->Printf("%s: %s\n", filename, text);
+	}
+	if (!options->quiet && d->GetDroppedCount() > 0)
+		out->Printf("%s: %u more findings not stored\n", filename, d->GetDroppedCount());
+
+	// Summary
+	out->Printf("%s: %u errors, %u warnings\n", filename, errors, warnings);
+
+	if (errors > 0 || (options->warnings_are_errors && warnings > 0))
+		return CLI_EXIT_FINDINGS;
+	return CLI_EXIT_OK;
+}
+
+static int Stats(const char *filename, ldf *db, ldfwriter *out)
+{
+	ldfdiagnostics *d = db->GetDiagnostics();
+	ldf::ldf_footprint_s footprint;
+
+	db->GetMemoryFootprint(&footprint);
+	out->Printf("file=%s protocol=%s speed=%u slaves=%u signals=%u frames=%u schedule_tables=%u "
+			"errors=%u warnings=%u infos=%u memory=%zu memory_database=%zu memory_entities=%zu "
+			"memory_strings=%zu memory_validation=%zu\n",
+			filename, (db->GetLinProtocolVersion() == LIN_PROTOCOL_VERSION_2_0) ? "2.0" : "2.1",
+			db->GetLinSpeed(), db->GetSlaveNodesCount(), db->GetSignalsCount(), db->GetFramesCount(),
+			db->GetScheduleTablesCount(),
+			d->GetCount(ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR), d->GetCount(ldfdiagnostics::LDF_DIAG_SEVERITY_WARNING),
+			d->GetCount(ldfdiagnostics::LDF_DIAG_SEVERITY_INFO), footprint.total, footprint.database,
+			footprint.entities, footprint.strings, footprint.validation);
+
+	return CLI_EXIT_OK;
+}
+
+static int Save(const char *filename, ldf *db)
+{
+	if (db->Save((const uint8_t *)filename))
+		return CLI_EXIT_OK;
+
+	fprintf(stderr, "%s: cannot be written\n", filename);
+	return CLI_EXIT_IO;
+}
+
+static int ProcessFile(const char *filename, cli_options_s *options, ldfwriter *out)
+{
+	int result = CLI_EXIT_OK;
+	ldf *db;
+
+	db = Load(filename, options);
+	if (db == NULL)
+		return CLI_EXIT_IO;
+
+	switch (options->command)
+	{
+
+	case CLI_COMMAND_VALIDATE:
+		result = Validate(filename, db, options, out);
+		break;
+
+	case CLI_COMMAND_STATS:
+		result = Stats(filename, db, out);
+		break;
+
+	case CLI_COMMAND_SAVE:
+		result = Save(filename, db);
+		break;
+
+	default:
+		break;
+
+	}
+
+	delete db;
+	return result;
+}
+
+static int ProcessFiles(char **filenames, uint32_t count, cli_options_s *options)
+{
+	atomic<uint32_t> next(0);
+	atomic<int> result(CLI_EXIT_OK);
+	ldfwriter *reports = new ldfwriter[count];
+	uint32_t threads = options->threads;
+	thread *workers;
+
+	// One worker per core by default, never more workers than files
+	if (threads == 0) threads = thread::hardware_concurrency();
+	if (threads == 0) threads = 1;
+	if (threads > count) threads = count;
+
+	// Each worker takes the next pending file, reports are kept to print them in order
+	auto worker = [&]()
+	{
+		uint32_t ix;
+
+		while ((ix = next++) < count)
+		{
+			int r = ProcessFile(filenames[ix], options, &reports[ix]);
+			int current = result.load();
+
+			while (r > current && !result.compare_exchange_weak(current, r));
+		}
+	};
+
+	// Run workers, the calling thread is one of them
+	workers = new thread[threads];
+	for (uint32_t i = 1; i < threads; i++)
+		workers[i] = thread(worker);
+	worker();
+	for (uint32_t i = 1; i < threads; i++)
+		workers[i].join();
+	delete[] workers;
+
+	// Print reports, commands like save write none
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (reports[i].GetLength() > 0)
+			fwrite(reports[i].GetBuffer(), 1, reports[i].GetLength(), stdout);
+	}
+	delete[] reports;
+
+	return result;
+}
+
+static int Format(const char *filename, cli_options_s *options)
+{
+	bool ok;
+	ldf *db;
+
+	db = Load(filename, options);
+	if (db == NULL)
+		return CLI_EXIT_IO;
+
+	// Normalized text to a file or to the standard output
+	if (options->output)
+		ok = db->Save((const uint8_t *)options->output);
+	else
+		ok = db->Save(STDOUT_FILENO);
+	delete db;
+
+	if (!ok)
+	{
+		fprintf(stderr, "%s: cannot be written\n", options->output ? options->output : "standard output");
+		return CLI_EXIT_IO;
+	}
+
+	return CLI_EXIT_OK;
+}
+
+static const char *GetUserName(ldfreferences::ldfuser_s *user, const char **type)
+{
+	switch (user->type)
+	{
+
+	case ldfreferences::LDF_USER_SIGNAL:
+		*type = "signal";
+		return (const char *)((ldfsignal *)user->entity)->GetName();
+
+	case ldfreferences::LDF_USER_FRAME:
+		*type = "frame";
+		return (const char *)((ldfframe *)user->entity)->GetName();
+
+	case ldfreferences::LDF_USER_NODE_ATTRIBUTES:
+		*type = "node";
+		return (const char *)((ldfnodeattributes *)user->entity)->GetName();
+
+	case ldfreferences::LDF_USER_SCHEDULE_TABLE:
+		*type = "table";
+		return (const char *)((ldfscheduletable *)user->entity)->GetName();
+
+	case ldfreferences::LDF_USER_ENCODING_SIGNALS:
+		*type = "encoding";
+		return (const char *)((ldfencodingsignals *)user->entity)->GetEncodingName();
+
+	}
+
+	*type = "unknown";
+	return "";
+}
+
+static void PrintUsers(ldf *db, ldfreferences::ldfreferencetype_e type, const uint8_t *name, ldfwriter *out)
+{
+	ldfreferences *references = db->GetReferences();
+	const uint8_t *interned = db->GetStrings()->Find(name);
+	uint32_t count = references->GetUsersCount(type, interned);
+
+	// Users as LDF comments, so the output is still valid LDF text
+	for (uint32_t i = 0; i < count; i++)
+	{
+		ldfreferences::ldfuser_s *user = references->GetUser(type, interned, i);
+		const char *user_type;
+		const char *user_name = GetUserName(user, &user_type);
+
+		out->Printf("// Used by %s %s (%u references)\n", user_type, user_name, user->references);
+	}
+}
+
+static int Query(const char *filename, const char *type, const char *name, cli_options_s *options)
+{
+	ldfwriter out(STDOUT_FILENO);
+	bool found = true;
+	ldf *db;
+
+	db = Load(filename, options);
+	if (db == NULL)
+		return CLI_EXIT_IO;
+
+	if (strcmp(type, "signal") == 0)
+	{
+		ldfsignal *s = db->GetSignalByName((const uint8_t *)name);
+
+		found = (s != NULL);
+		if (s) s->ToLdfFile(&out);
+		if (s) PrintUsers(db, ldfreferences::LDF_REF_SIGNAL, s->GetName(), &out);
+	}
+	else if (strcmp(type, "frame") == 0 || strcmp(type, "id") == 0)
+	{
+		ldfframe *f;
+
+		// Frames by name, or by ID
+		if (strcmp(type, "frame") == 0)
+			f = db->GetFrameByName((const uint8_t *)name);
+		else
+			f = db->GetFrameById(ParseInt(name));
+
+		found = (f != NULL);
+		if (f) f->ToLdfFile(&out);
+		if (f) PrintUsers(db, ldfreferences::LDF_REF_FRAME, f->GetName(), &out);
+	}
+	else if (strcmp(type, "node") == 0)
+	{
+		ldfnodeattributes *n = db->GetSlaveNodeAttributesByName((const uint8_t *)name);
+
+		found = (n != NULL);
+		if (n) n->ToLdfFile(&out);
+		if (n) PrintUsers(db, ldfreferences::LDF_REF_NODE, n->GetName(), &out);
+	}
+	else if (strcmp(type, "table") == 0)
+	{
+		ldfscheduletable *t = db->GetScheduleTableByName((const uint8_t *)name);
+
+		found = (t != NULL);
+		if (t) t->ToLdfFile(&out, db);
+	}
+	else
+	{
+		delete db;
+		return CLI_EXIT_USAGE;
+	}
+
+	if (!found)
+		fprintf(stderr, "%s: %s '%s' not found\n", filename, type, name);
+
+	out.Flush();
+	delete db;
+	return found ? CLI_EXIT_OK : CLI_EXIT_FINDINGS;
+}
+
+static int DecodeTrace(const char *filename, const char *trace, cli_options_s *options)
+{
+	ldfwriter out(STDOUT_FILENO);
+	lintracedecoder *decoder;
+	uint64_t samples = 0;
+	uint32_t signals = 0;
+	ldf *db;
+
+	db = Load(filename, options);
+	if (db == NULL)
+		return CLI_EXIT_IO;
+
+	decoder = new lintracedecoder(db);
+	if (!decoder->Decode(trace, options->threads))
+	{
+		fprintf(stderr, "%s: cannot be decoded\n", trace);
+		delete decoder;
+		delete db;
+		return CLI_EXIT_IO;
+	}
+
+	// Signals found in the trace, values out of the physical range are left out
+	for (uint32_t i = 0; i < decoder->GetColumnsCount(); i++)
+	{
+		const lintracedecoder::lintracecolumn_s *c = decoder->GetColumnByIndex(i);
+		double min = NAN, max = NAN;
+
+		if (c->count == 0)
+			continue;
+
+		for (uint64_t j = 0; j < c->count; j++)
+		{
+			double v = (c->physical != NULL) ? c->physical[j] : (double)c->raw[j];
+
+			if (isnan(v))
+				continue;
+			if (isnan(min) || v < min) min = v;
+			if (isnan(max) || v > max) max = v;
+		}
+
+		out.Printf("signal=%s samples=%llu first_ns=%llu last_ns=%llu min=%g max=%g\n", c->signal->GetName(),
+				(unsigned long long)c->count, (unsigned long long)c->timestamps[0],
+				(unsigned long long)c->timestamps[c->count - 1], min, max);
+		samples += c->count;
+		signals++;
+	}
+	out.Printf("trace=%s frames=%llu skipped=%llu signals=%u samples=%llu\n", trace,
+			(unsigned long long)decoder->GetFramesCount(), (unsigned long long)decoder->GetSkippedFramesCount(),
+			signals, (unsigned long long)samples);
+
+	out.Flush();
+	delete decoder;
+	delete db;
+	return CLI_EXIT_OK;
+}
+
+static int ImportTrace(const char *log, const char *trace, const char *filename, cli_options_s *options)
+{
+	lincapture::lincaptureframe_s frame;
+	lintracewriter w;
+	ldf *db = NULL;
+	int result = CLI_EXIT_OK;
+	bool ok = true;
+
+	if (filename != NULL && (db = Load(filename, options)) == NULL)
+		return CLI_EXIT_IO;
+
+	linascreader r(db);
+	if (!r.Open(log))
+	{
+		fprintf(stderr, "%s: cannot be read\n", log);
+		delete db;
+		return CLI_EXIT_IO;
+	}
+	if (!w.Open(trace))
+	{
+		fprintf(stderr, "%s: cannot be written\n", trace);
+		delete db;
+		return CLI_EXIT_IO;
+	}
+
+	while (ok && r.Next(&frame))
+		ok = w.Write(&frame);
+	if (!w.Close() || !ok)
+	{
+		fprintf(stderr, "%s: cannot be written\n", trace);
+		result = CLI_EXIT_IO;
+	}
+
+	printf("log=%s lines=%llu skipped=%llu frames=%llu\n", log, (unsigned long long)r.GetLinesCount(),
+			(unsigned long long)r.GetSkippedLinesCount(), (unsigned long long)r.GetFramesCount());
+
+	delete db;
+	return result;
+}
+
+static int ExportTrace(const char *trace, const char *log, const char *filename, cli_options_s *options)
+{
+	lincapture::lincaptureframe_s frame;
+	lintracereader r;
+	ldf *db = NULL;
+	int result = CLI_EXIT_OK;
+
+	if (filename != NULL && (db = Load(filename, options)) == NULL)
+		return CLI_EXIT_IO;
+
+	linascwriter w(db);
+	if (!r.Open(trace))
+	{
+		fprintf(stderr, "%s: cannot be read\n", trace);
+		delete db;
+		return CLI_EXIT_IO;
+	}
+	if (!w.Open(log))
+	{
+		fprintf(stderr, "%s: cannot be written\n", log);
+		delete db;
+		return CLI_EXIT_IO;
+	}
+
+	// The log starts with the first frame
+	w.SetOrigin(r.GetFirstTimestamp());
+	r.SetPrefetch(CLI_EXPORT_PREFETCH_BLOCKS);
+	while (r.Next(&frame))
+		w.Write(&frame);
+	if (!w.Close())
+	{
+		fprintf(stderr, "%s: cannot be written\n", log);
+		result = CLI_EXIT_IO;
+	}
+
+	printf("log=%s frames=%llu\n", log, (unsigned long long)w.GetFramesCount());
+
+	delete db;
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	cli_options_s options = { CLI_COMMAND_VALIDATE, 0, false, false, false, NULL };
+	uint32_t i;
+	int opt;
+
+	// Command
+	if (argc < 2)
+	{
+		Usage(argv[0]);
+		return CLI_EXIT_USAGE;
+	}
+	for (i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+		if (strcmp(argv[1], commands[i]) == 0)
+			break;
+	if (i == sizeof(commands) / sizeof(commands[0]))
+	{
+		Usage(argv[0]);
+		return CLI_EXIT_USAGE;
+	}
+	options.command = (cli_command_e)i;
+
+	// Options
+	optind = 2;
+	while ((opt = getopt(argc, argv, "j:cqWo:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'j': options.threads = atoi(optarg); break;
+		case 'c': options.use_cache = true; break;
+		case 'q': options.quiet = true; break;
+		case 'W': options.warnings_are_errors = true; break;
+		case 'o': options.output = optarg; break;
+		default:
+			Usage(argv[0]);
+			return CLI_EXIT_USAGE;
+		}
+	}
+
+	// Files
+	switch (options.command)
+	{
+
+	case CLI_COMMAND_FORMAT:
+		if (argc - optind != 1) break;
+		return Format(argv[optind], &options);
+
+	case CLI_COMMAND_QUERY:
+		if (argc - optind != 3) break;
+		return Query(argv[optind], argv[optind + 1], argv[optind + 2], &options);
+
+	case CLI_COMMAND_DECODE:
+		if (argc - optind != 2) break;
+		return DecodeTrace(argv[optind], argv[optind + 1], &options);
+
+	case CLI_COMMAND_IMPORT:
+		if (argc - optind != 2 && argc - optind != 3) break;
+		return ImportTrace(argv[optind], argv[optind + 1], (argc - optind == 3) ? argv[optind + 2] : NULL, &options);
+
+	case CLI_COMMAND_EXPORT:
+		if (argc - optind != 2 && argc - optind != 3) break;
+		return ExportTrace(argv[optind], argv[optind + 1], (argc - optind == 3) ? argv[optind + 2] : NULL, &options);
+
+	default:
+		if (argc - optind < 1) break;
+		return ProcessFiles(&argv[optind], argc - optind, &options);
+
+	}
+
+	Usage(argv[0]);
+	return CLI_EXIT_USAGE;
+}
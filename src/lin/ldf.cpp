@@ -10,8 +10,16 @@
 #include <ctype.h>
 #include <stdexcept>
 #include <stdlib.h>
+#include <thread>
+#include <atomic>
 #include "ldf.h"
 #include "ldfcommon.h"
+#include "ldftokenizer.h"
+
+
+// Entities validated by each task, and database size that makes worth using more threads
+#define VALIDATION_CHUNK_SIZE				512
+#define VALIDATION_PARALLEL_THRESHOLD		2048
 
 
 using namespace std;
@@ -20,10 +28,85 @@ using namespace std;
 namespace lin
 {
 
-ldf::ldf(const uint8_t *filename)
+// Validation rule groups, in the order their findings are reported
+enum validation_group_e
+{
+	VALIDATION_GROUP_SIGNAL_NODES,
+	VALIDATION_GROUP_SIGNAL_UNICITY,
+	VALIDATION_GROUP_FRAMES,
+	VALIDATION_GROUP_NODE_ATTRIBUTES,
+	VALIDATION_GROUP_SCHEDULE_TABLES,
+	VALIDATION_GROUP_ENCODING_SIGNALS,
+	VALIDATION_GROUP_COUNT
+};
+
+// Chunk of entities of a rule group and the findings it raised
+struct validation_task_s
+{
+	validation_group_e group;
+	uint32_t first;
+	uint32_t last;
+	ldfdiagnostics *diagnostics;
+};
+
+template <typename T> static void IndexAdd(ldfindex *index, T *item)
+{
+	// Keep the first entity of repeated names
+	if (index->Get(item->GetName()) == NULL)
+		index->Put(item->GetName(), item);
+}
+
+template <typename T> static void IndexRemove(ldfindex *index, T **items, uint32_t count, T *item)
+{
+	const uint8_t *name = item->GetName();
+
+	if (index->Get(name) != item)
+		return;
+
+	// Give the name to the next entity that repeats it, if any
+	index->Remove(name);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (items[i] != item && NameEq(items[i]->GetName(), name))
+		{
+			index->Put(name, items[i]);
+			break;
+		}
+	}
+}
+
+template <typename T, typename F> static uint32_t *CollectDirty(T **items, uint32_t count, ldfindex *dirty, uint32_t *dirty_count, F name)
 {
-	int32_t c = EOF;
+	uint32_t *ix = (uint32_t *)malloc((count + 1) * sizeof(uint32_t));
+
+	// Positions of the entities whose name is marked, in database order
+	*dirty_count = 0;
+	for (uint32_t i = 0; i < count; i++)
+		if (dirty->Get(name(items[i])) != NULL)
+			ix[(*dirty_count)++] = i;
 
+	return ix;
+}
+
+template <typename T, typename F> static uint32_t *NextSameName(T **items, uint32_t count, F name)
+{
+	ldfindex last;
+	uint32_t *next = (uint32_t *)malloc((count + 1) * sizeof(uint32_t));
+
+	// Link every entity to the next one with the same name, count when there is none
+	for (uint32_t i = count; i-- > 0;)
+	{
+		uintptr_t ix = (uintptr_t)last.Get(name(items[i]));
+
+		next[i] = (ix != 0) ? (uint32_t)(ix - 1) : count;
+		last.Put(name(items[i]), (void *)(uintptr_t)(i + 1));
+	}
+
+	return next;
+}
+
+ldf::ldf()
+{
 	// Initialize state parameters
 	parsing_state = LDF_PARSING_STATE_NONE;
 	is_lin_description_file = false;
@@ -33,34 +116,64 @@ ldf::ldf(const uint8_t *filename)
 	lin_protocol_version = LIN_PROTOCOL_VERSION_NONE;
 	lin_language_version = LIN_LANGUAGE_VERSION_NONE;
 	lin_speed = 0;
-	slaves_count = 0;
 	master = NULL;
+	slaves = NULL;
 	slaves_count = 0;
+	slaves_capacity = 0;
+	signals = NULL;
 	signals_count = 0;
+	signals_capacity = 0;
+	frames = NULL;
 	frames_count = 0;
+	frames_capacity = 0;
+	node_attributes = NULL;
 	node_attributes_count = 0;
+	node_attributes_capacity = 0;
+	schedule_tables = NULL;
 	schedule_tables_count = 0;
+	schedule_tables_capacity = 0;
+	encoding_types = NULL;
 	encoding_types_count = 0;
+	encoding_types_capacity = 0;
+	encoding_signals = NULL;
 	encoding_signals_count = 0;
-	validation_messages_count = 0;
+	encoding_signals_capacity = 0;
+	memset(frames_by_id, 0, sizeof(frames_by_id));
+}
 
-	// Open file
-	FILE *ldf_file = fopen((char *)filename, "rb");
-	if (!ldf_file)
-	{
-		throw runtime_error("Filename does not exist");
-	}
+ldf::ldf(const uint8_t *filename) : ldf()
+{
+	ldftokenizer::ldftoken_s token;
+
+	// Map file, it throws if file does not exist
+	ldftokenizer tokenizer(filename);
 
-	// Parse file by character
-	while ((c = getc(ldf_file)) != EOF)
+	// Parse file by statements and groups
+	while (tokenizer.Next(&token))
 	{
-		parse_char(c);
-	}
+		switch (token.type)
+		{
 
-	// Close file
-	fclose(ldf_file);
+		case ldftokenizer::LDF_TOKEN_STATEMENT:
+			process_statement(token.text);
+			break;
+
+		case ldftokenizer::LDF_TOKEN_GROUP_START:
+			process_group_start(token.text);
+			group_level++;
+			break;
+
+		case ldftokenizer::LDF_TOKEN_GROUP_END:
+			process_group_end(token.text);
+			group_level--;
+			break;
+
+		}
+	}
 
-	// Validate data
+	// Index data and validate it
+	BuildIndexes();
+	BuildReferences();
 	Validate();
 }
 
@@ -74,194 +187,446 @@ ldf::~ldf()
 	while (schedule_tables_count > 0) delete schedule_tables[--schedule_tables_count];
 	while (encoding_types_count > 0) delete encoding_types[--encoding_types_count];
 	while (encoding_signals_count > 0) delete encoding_signals[--encoding_signals_count];
-	while (validation_messages_count > 0) delete validation_messages[--validation_messages_count];
+	free(slaves);
+	free(signals);
+	free(frames);
+	free(node_attributes);
+	free(schedule_tables);
+	free(encoding_types);
+	free(encoding_signals);
+}
+
+uint32_t ldf::LoadFiles(const uint8_t **filenames, uint32_t count, ldf **databases, uint32_t threads)
+{
+	atomic<uint32_t> next(0);
+	atomic<uint32_t> loaded(0);
+	thread *workers;
+
+	// One worker per core by default, never more workers than files
+	if (threads == 0) threads = thread::hardware_concurrency();
+	if (threads == 0) threads = 1;
+	if (threads > count) threads = count;
+
+	// Each worker takes the next pending file until all of them are parsed
+	auto worker = [&]()
+	{
+		uint32_t ix;
+
+		while ((ix = next++) < count)
+		{
+			try
+			{
+				databases[ix] = new ldf(filenames[ix]);
+				loaded++;
+			}
+			catch (const exception &e)
+			{
+				databases[ix] = NULL;
+			}
+		}
+	};
+
+	// Run workers, the calling thread is one of them
+	workers = new thread[threads];
+	for (uint32_t i = 1; i < threads; i++)
+		workers[i] = thread(worker);
+	worker();
+	for (uint32_t i = 1; i < threads; i++)
+		workers[i].join();
+	delete[] workers;
+
+	return loaded;
 }
 
 void ldf::SortData()
 {
+	uint32_t ids_count[256] = { 0 };
+	bool ids_dirty[256] = { false };
+	ldfindex ranks;
+
+	// Rank frames among the ones sharing their ID, findings on repeated IDs depend on it
+	for (uint32_t i = 0; i < frames_count; i++)
+		ranks.Put(frames[i], (void *)(uintptr_t)(++ids_count[frames[i]->GetId()]));
+
 	// Sort signals
 	qsort(signals, signals_count, sizeof(signals[0]), SorterSignals);
 	qsort(frames, frames_count, sizeof(frames[0]), SorterFrames);
 
+	// Revalidate frames sharing an ID that changed their order
+	memset(ids_count, 0, sizeof(ids_count));
+	for (uint32_t i = 0; i < frames_count; i++)
+	{
+		uint8_t id = frames[i]->GetId();
+
+		if ((uintptr_t)ranks.Get(frames[i]) != ++ids_count[id] && !ids_dirty[id])
+		{
+			ids_dirty[id] = true;
+			MarkFrameIdDirty(id);
+		}
+	}
+
+	// Frames check the signal their name resolves to, that changes when a repeated name moves
+	for (uint32_t i = 0; i < signals_count; i++)
+	{
+		if (signals_by_name.Get(signals[i]->GetName()) != signals[i])
+			MarkUsersDirty(ldfreferences::LDF_REF_SIGNAL, signals[i]->GetName());
+	}
+
 	// Sort nodes configurable frames
 	for (uint32_t i = 0; i < node_attributes_count; i++)
 	{
-		node_attributes[i]->SortData();
+		if (node_attributes[i]->SortData())
+			MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, node_attributes[i]->GetName());
 	}
 
 	// Sort frames frame signals
 	for (uint32_t i = 0; i < frames_count; i++)
 	{
-		frames[i]->SortData();
+		if (frames[i]->SortData())
+			MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, frames[i]->GetName());
 	}
+
+	// Repeated names resolve to the first entity in the new order
+	BuildIndexes();
 }
 
 bool ldf::Validate(void)
 {
 	uint32_t i, j;
-
-	// Validate results
-	if (!is_lin_description_file)
-	{
-		validation_messages[validation_messages_count++] = StrDup(STR_ERR "Not a LIN definition file");
-	}
-	if (lin_protocol_version == LIN_PROTOCOL_VERSION_NONE)
-	{
-		validation_messages[validation_messages_count++] = StrDup(STR_ERR "Protocol version not supported");
-	}
-	if (lin_language_version == LIN_LANGUAGE_VERSION_NONE)
-	{
-		validation_messages[validation_messages_count++] = StrDup(STR_ERR "Language version not supported");
-	}
-	if (lin_speed == 0)
-	{
-		validation_messages[validation_messages_count++] = StrDup(STR_ERR "LIN speed no defined");
-	}
-	if (master == NULL)
+	uint32_t tasks_count = 0;
+	uint32_t threads;
+	validation_task_s *tasks;
+	atomic<uint32_t> next(0);
+	thread *workers;
+
+	// Forget previous findings
+	diagnostics.Clear();
+
+	// Validate database settings
+	ValidateSettings();
+
+	// Chain repeated names and frame IDs, so unicity rules only visit the pairs that fail
+	uint32_t *next_signal = NextSameName(signals, signals_count, [](ldfsignal *s) { return s->GetName(); });
+	uint32_t *next_frame = NextSameName(frames, frames_count, [](ldfframe *f) { return f->GetName(); });
+	uint32_t *next_attributes = NextSameName(node_attributes, node_attributes_count, [](ldfnodeattributes *n) { return (const uint8_t *)n->GetName(); });
+	uint32_t *next_table = NextSameName(schedule_tables, schedule_tables_count, [](ldfscheduletable *t) { return (const uint8_t *)t->GetName(); });
+	uint32_t *next_encoding = NextSameName(encoding_signals, encoding_signals_count, [](ldfencodingsignals *e) { return e->GetEncodingName(); });
+	uint32_t *next_frame_id = (uint32_t *)malloc((frames_count + 1) * sizeof(uint32_t));
+	uint32_t last_frame_id[256];
+
+	for (i = 0; i < 256; i++) last_frame_id[i] = frames_count;
+	for (i = frames_count; i-- > 0;)
 	{
-		validation_messages[validation_messages_count++] = StrDup(STR_ERR "LIN master not found in database");
-	}
-	if (slaves_count == 0)
-	{
-		validation_messages[validation_messages_count++] = StrDup(STR_ERR "LIN slaves not found in database");
-	}
-
-	// Validate publishers and subscribers of signals
-	for (i = 0; i < signals_count; i++)
-	{
-		signals[i]->ValidateNodes(master, slaves, slaves_count, validation_messages, &validation_messages_count);
+		next_frame_id[i] = last_frame_id[frames[i]->GetId()];
+		last_frame_id[frames[i]->GetId()] = i;
 	}
 
-	// Validate signals are not repeated
-	for (i = 0; i < signals_count; i++)
+	// Split rule groups in chunks, each one with its own findings
+	uint32_t groups_count[VALIDATION_GROUP_COUNT] = {
+		signals_count, signals_count, frames_count, node_attributes_count, schedule_tables_count, encoding_signals_count
+	};
+	for (i = 0; i < VALIDATION_GROUP_COUNT; i++)
+		tasks_count += (groups_count[i] + VALIDATION_CHUNK_SIZE - 1) / VALIDATION_CHUNK_SIZE;
+	tasks = (validation_task_s *)malloc((tasks_count + 1) * sizeof(validation_task_s));
+	tasks_count = 0;
+	for (i = 0; i < VALIDATION_GROUP_COUNT; i++)
 	{
-		for (j = i + 1; j < signals_count; j++)
+		for (j = 0; j < groups_count[i]; j += VALIDATION_CHUNK_SIZE)
 		{
-			signals[i]->ValidateUnicity(signals[j], validation_messages, &validation_messages_count);
+			tasks[tasks_count].group = (validation_group_e)i;
+			tasks[tasks_count].first = j;
+			tasks[tasks_count].last = (groups_count[i] - j > VALIDATION_CHUNK_SIZE) ? j + VALIDATION_CHUNK_SIZE : groups_count[i];
+			tasks[tasks_count].diagnostics = NULL;
+			tasks_count++;
 		}
 	}
 
-	// Validate frames
-	for (i = 0; i < frames_count; i++)
+	// Run the rules of one chunk, in the same order as a single pass over the database
+	auto run = [&](validation_task_s *t)
 	{
-		// Validate frame publisher
-		frames[i]->ValidatePublisher(master, slaves, slaves_count, validation_messages, &validation_messages_count);
+		ldfdiagnostics *d = new ldfdiagnostics();
 
-		// Validate frame unicity
-		for (j = i + 1; j < frames_count; j++)
+		t->diagnostics = d;
+
+		for (uint32_t i = t->first; i < t->last; i++)
 		{
-			frames[i]->ValidateUnicity(frames[j], validation_messages, &validation_messages_count);
+			switch (t->group)
+			{
+
+			case VALIDATION_GROUP_SIGNAL_NODES:
+				// Validate publishers and subscribers of signals
+				signals[i]->ValidateNodes(master, slaves, slaves_count, d);
+				break;
+
+			case VALIDATION_GROUP_SIGNAL_UNICITY:
+				// Validate signals are not repeated
+				for (uint32_t j = next_signal[i]; j < signals_count; j = next_signal[j])
+					signals[i]->ValidateUnicity(signals[j], d);
+				break;
+
+			case VALIDATION_GROUP_FRAMES:
+				// Validate frame publisher
+				frames[i]->ValidatePublisher(master, slaves, slaves_count, d);
+
+				// Validate frame unicity, following frames with the same name or ID
+				for (uint32_t j = next_frame[i], k = next_frame_id[i]; j < frames_count || k < frames_count;)
+				{
+					uint32_t n = (j < k) ? j : k;
+
+					frames[i]->ValidateUnicity(frames[n], d);
+					if (j == n) j = next_frame[j];
+					if (k == n) k = next_frame_id[k];
+				}
+
+				// Validate frame signals and size
+				frames[i]->ValidateSignals(&signals_by_name, d);
+				break;
+
+			case VALIDATION_GROUP_NODE_ATTRIBUTES:
+				// Validate node name in between slaves
+				node_attributes[i]->ValidateNode(slaves, slaves_count, d);
+
+				// Validate node attributes unicity
+				for (uint32_t j = next_attributes[i]; j < node_attributes_count; j = next_attributes[j])
+					node_attributes[i]->ValidateUnicity(node_attributes[j], d);
+
+				// Validate configurable frames
+				node_attributes[i]->ValidateFrames(&frames_by_name, d);
+				break;
+
+			case VALIDATION_GROUP_SCHEDULE_TABLES:
+				// Validate schedule table unicity
+				for (uint32_t j = next_table[i]; j < schedule_tables_count; j = next_table[j])
+					schedule_tables[i]->ValidateUnicity(schedule_tables[j], d);
+
+				// Check frames
+				schedule_tables[i]->ValidateFrames(&frames_by_name, d);
+				break;
+
+			case VALIDATION_GROUP_ENCODING_SIGNALS:
+				// Check encoding signals unicity
+				for (uint32_t j = next_encoding[i]; j < encoding_signals_count; j = next_encoding[j])
+					encoding_signals[i]->ValidateUnicity(encoding_signals[j], d);
+
+				// Check signals
+				encoding_signals[i]->ValidateSignals(&signals_by_name, d);
+				break;
+
+			default:
+				break;
+			}
 		}
+	};
 
-		// Validate frame signals and size
-		frames[i]->ValidateSignals(signals, signals_count, validation_messages, &validation_messages_count);
-	}
+	// Small databases are validated by the calling thread only
+	threads = (signals_count + frames_count < VALIDATION_PARALLEL_THRESHOLD) ? 1 : thread::hardware_concurrency();
+	if (threads == 0) threads = 1;
+	if (threads > tasks_count) threads = tasks_count;
 
-	// Validate node attributes
-	for (i = 0; i < node_attributes_count; i++)
+	// Each worker takes the next pending chunk until all of them are validated
+	auto worker = [&]()
 	{
-		// Validate node name in between slaves
-		node_attributes[i]->ValidateNode(slaves, slaves_count, validation_messages, &validation_messages_count);
+		uint32_t ix;
 
-		// Validate frame unicity
-		for (j = i + 1; j < node_attributes_count; j++)
-		{
-			node_attributes[i]->ValidateUnicity(node_attributes[j], validation_messages, &validation_messages_count);
-		}
+		while ((ix = next++) < tasks_count)
+			run(&tasks[ix]);
+	};
 
-		// Validate configurable frames
-		node_attributes[i]->ValidateFrames(frames, frames_count, validation_messages, &validation_messages_count);
+	if (threads > 1)
+	{
+		workers = new thread[threads];
+		for (i = 1; i < threads; i++)
+			workers[i] = thread(worker);
+		worker();
+		for (i = 1; i < threads; i++)
+			workers[i].join();
+		delete[] workers;
+	}
+	else
+	{
+		worker();
 	}
 
-	// Validate schedule tables
-	for (i = 0; i < schedule_tables_count; i++)
+	// Merge findings in chunk order, so results do not depend on scheduling
+	for (i = 0; i < tasks_count; i++)
 	{
-		// Validate schedule table unicity
-		for (j = i + 1; j < schedule_tables_count; j++)
-		{
-			schedule_tables[j]->ValidateUnicity(schedule_tables[j], validation_messages, &validation_messages_count);
-		}
+		diagnostics.Merge(tasks[i].diagnostics);
+		delete tasks[i].diagnostics;
+	}
+
+	free(tasks);
+	free(next_signal);
+	free(next_frame);
+	free(next_frame_id);
+	free(next_attributes);
+	free(next_table);
+	free(next_encoding);
+
+	// Everything is up to date
+	ClearDirty();
 
-		// Check frames
-		schedule_tables[i]->ValidateFrames(frames, frames_count, validation_messages, &validation_messages_count);
+	return diagnostics.GetCount(ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR) == 0;
+}
+
+bool ldf::Revalidate(void)
+{
+	uint32_t i, j;
+	uint32_t count;
+	uint32_t *items;
+
+	// Findings that were dropped can not be traced back to their entities, validate it all
+	if (diagnostics.GetDroppedCount() > 0)
+		return Validate();
+
+	// Forget findings of database settings and changed entities
+	diagnostics.Remove(ldfdiagnostics::LDF_DIAG_ENTITY_DATABASE, NULL);
+	for (i = ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL; i < ldfdiagnostics::LDF_DIAG_ENTITY_COUNT; i++)
+		diagnostics.Remove((ldfdiagnostics::ldfdiagnosticentity_e)i, &dirty[i]);
+
+	// Validate database settings
+	ValidateSettings();
+
+	// Validate changed signals, all signals sharing a name are changed together
+	items = CollectDirty(signals, signals_count, &dirty[ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL], &count,
+			[](ldfsignal *s) { return (const uint8_t *)s->GetName(); });
+	for (i = 0; i < count; i++)
+		signals[items[i]]->ValidateNodes(master, slaves, slaves_count, &diagnostics);
+	for (i = 0; i < count; i++)
+		for (j = i + 1; j < count; j++)
+			if (NameEq(signals[items[i]]->GetName(), signals[items[j]]->GetName()))
+				signals[items[i]]->ValidateUnicity(signals[items[j]], &diagnostics);
+	free(items);
+
+	// Validate changed frames, frames with the same ID as a changed one were marked too
+	items = CollectDirty(frames, frames_count, &dirty[ldfdiagnostics::LDF_DIAG_ENTITY_FRAME], &count,
+			[](ldfframe *f) { return (const uint8_t *)f->GetName(); });
+	for (i = 0; i < count; i++)
+	{
+		ldfframe *f = frames[items[i]];
+
+		f->ValidatePublisher(master, slaves, slaves_count, &diagnostics);
+		for (j = items[i] + 1; j < frames_count; j++)
+			if (NameEq(f->GetName(), frames[j]->GetName()) || f->GetId() == frames[j]->GetId())
+				f->ValidateUnicity(frames[j], &diagnostics);
+		f->ValidateSignals(&signals_by_name, &diagnostics);
 	}
+	free(items);
 
-	// Validate signal representations
-	for (i = 0; i < encoding_signals_count; i++)
+	// Validate changed node attributes
+	items = CollectDirty(node_attributes, node_attributes_count, &dirty[ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES], &count,
+			[](ldfnodeattributes *n) { return (const uint8_t *)n->GetName(); });
+	for (i = 0; i < count; i++)
 	{
-		// Check encoding signals unicity
-		for (j = i + 1; j < encoding_signals_count; j++)
-		{
-			encoding_signals[i]->ValidateUnicity(encoding_signals[j], validation_messages, &validation_messages_count);
-		}
+		node_attributes[items[i]]->ValidateNode(slaves, slaves_count, &diagnostics);
+		for (j = i + 1; j < count; j++)
+			if (NameEq(node_attributes[items[i]]->GetName(), node_attributes[items[j]]->GetName()))
+				node_attributes[items[i]]->ValidateUnicity(node_attributes[items[j]], &diagnostics);
+		node_attributes[items[i]]->ValidateFrames(&frames_by_name, &diagnostics);
+	}
+	free(items);
 
-		// Check signals
-		encoding_signals[i]->ValidateSignals(signals, signals_count, validation_messages, &validation_messages_count);
+	// Validate changed schedule tables
+	items = CollectDirty(schedule_tables, schedule_tables_count, &dirty[ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE], &count,
+			[](ldfscheduletable *t) { return (const uint8_t *)t->GetName(); });
+	for (i = 0; i < count; i++)
+	{
+		for (j = i + 1; j < count; j++)
+			if (NameEq(schedule_tables[items[i]]->GetName(), schedule_tables[items[j]]->GetName()))
+				schedule_tables[items[i]]->ValidateUnicity(schedule_tables[items[j]], &diagnostics);
+		schedule_tables[items[i]]->ValidateFrames(&frames_by_name, &diagnostics);
 	}
+	free(items);
 
-	return validation_messages_count == 0;
-}
+	// Validate changed signal encodings
+	items = CollectDirty(encoding_signals, encoding_signals_count, &dirty[ldfdiagnostics::LDF_DIAG_ENTITY_ENCODING_SIGNALS], &count,
+			[](ldfencodingsignals *e) { return (const uint8_t *)e->GetEncodingName(); });
+	for (i = 0; i < count; i++)
+	{
+		for (j = i + 1; j < count; j++)
+			if (NameEq(encoding_signals[items[i]]->GetEncodingName(), encoding_signals[items[j]]->GetEncodingName()))
+				encoding_signals[items[i]]->ValidateUnicity(encoding_signals[items[j]], &diagnostics);
+		encoding_signals[items[i]]->ValidateSignals(&signals_by_name, &diagnostics);
+	}
+	free(items);
 
-bool ldf::char_in_set(uint8_t c, const char *set)
-{
-	for (const char *p = set; *p; p++)
-		if (c == *p)
-			return true;
+	// Everything is up to date
+	ClearDirty();
 
-	return false;
+	return diagnostics.GetCount(ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR) == 0;
 }
 
-void ldf::parse_char(uint8_t c)
+void ldf::ValidateSettings()
 {
-	static uint8_t line[10000];
-	static uint32_t line_length = 0;
-	static bool skip = false;
-
-	if (c == ';')
+	if (!is_lin_description_file)
 	{
-		line[line_length] = 0;
-		process_statement(line);
-		line[0] = 0;
-		line_length = 0;
+		diagnostics.Add(ldfdiagnostics::LDF_DIAG_NOT_LDF_FILE, NULL, NULL, 0);
 	}
-	else if (c == '{')
+	if (lin_protocol_version == LIN_PROTOCOL_VERSION_NONE)
 	{
-		line[line_length] = 0;
-		process_group_start(line);
-		line[0] = 0;
-		line_length = 0;
-		group_level++;
+		diagnostics.Add(ldfdiagnostics::LDF_DIAG_PROTOCOL_VERSION, NULL, NULL, 0);
 	}
-	else if (c == '}')
+	if (lin_language_version == LIN_LANGUAGE_VERSION_NONE)
+	{
+		diagnostics.Add(ldfdiagnostics::LDF_DIAG_LANGUAGE_VERSION, NULL, NULL, 0);
+	}
+	if (lin_speed == 0)
 	{
-		line[line_length] = 0;
-		process_group_end(line);
-		line[0] = 0;
-		line_length = 0;
-		group_level--;
+		diagnostics.Add(ldfdiagnostics::LDF_DIAG_LIN_SPEED, NULL, NULL, 0);
 	}
-	else if (c == '/')
+	if (master == NULL)
 	{
-		// Skip comments
-		skip = true;
+		diagnostics.Add(ldfdiagnostics::LDF_DIAG_MASTER_MISSING, NULL, NULL, 0);
 	}
-	else if (c == '\n')
+	if (slaves_count == 0)
 	{
-		// Comments are valid to the end of the line
-		skip = false;
+		diagnostics.Add(ldfdiagnostics::LDF_DIAG_SLAVES_MISSING, NULL, NULL, 0);
 	}
-	else if (!skip && (line_length != 0 || !char_in_set(c, BLANK_CHARACTERS)))
+}
+
+void ldf::MarkDirty(ldfdiagnostics::ldfdiagnosticentity_e type, const uint8_t *name)
+{
+	if (name != NULL)
+		dirty[type].Put(name, (void *)name);
+}
+
+void ldf::MarkUserDirty(ldfreferences::ldfuser_s *user)
+{
+	switch (user->type)
 	{
-		if (line_length < sizeof(line) - 1)
-		{
-			line[line_length++] = c;
-		}
+	case ldfreferences::LDF_USER_SIGNAL: MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL, ((ldfsignal *)user->entity)->GetName()); break;
+	case ldfreferences::LDF_USER_FRAME: MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, ((ldfframe *)user->entity)->GetName()); break;
+	case ldfreferences::LDF_USER_NODE_ATTRIBUTES: MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, ((ldfnodeattributes *)user->entity)->GetName()); break;
+	case ldfreferences::LDF_USER_SCHEDULE_TABLE: MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE, ((ldfscheduletable *)user->entity)->GetName()); break;
+	case ldfreferences::LDF_USER_ENCODING_SIGNALS: MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_ENCODING_SIGNALS, ((ldfencodingsignals *)user->entity)->GetEncodingName()); break;
 	}
 }
 
+void ldf::MarkUsersDirty(ldfreferences::ldfreferencetype_e type, const uint8_t *name)
+{
+	uint32_t count = references.GetUsersCount(type, name);
+
+	for (uint32_t i = 0; i < count; i++)
+		MarkUserDirty(references.GetUser(type, name, i));
+}
+
+void ldf::MarkFrameIdDirty(uint8_t id)
+{
+	// Unicity findings pair frames sharing an ID
+	for (uint32_t i = 0; i < frames_count; i++)
+		if (frames[i]->GetId() == id)
+			MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, frames[i]->GetName());
+}
+
+void ldf::ClearDirty()
+{
+	for (uint32_t i = 0; i < ldfdiagnostics::LDF_DIAG_ENTITY_COUNT; i++)
+		dirty[i].Clear();
+}
+
 void ldf::process_statement(uint8_t *statement)
 {
 	char *p = NULL;
+	char *save = NULL;
 	ldfsignal *signal = NULL;
 	ldfmasternode *masternode = NULL;
 	ldfframe *frame = NULL;
@@ -276,12 +641,12 @@ void ldf::process_statement(uint8_t *statement)
 	case LDF_PARSING_STATE_SCHEDULE_TABLES:
 		if (group_level == 1)
 		{
-			p = strtok((char *)statement, BLANK_CHARACTERS);
-			if (p) schedule_tables[schedule_tables_count++] = new ldfscheduletable(Str(p));
+			p = strtok_r((char *)statement, BLANK_CHARACTERS, &save);
+			if (p) ArrayAppend(&schedule_tables, &schedule_tables_count, &schedule_tables_capacity, new ldfscheduletable(&strings, Str(p)));
 		}
 		else if (group_level == 2)
 		{
-			schedule_command = ldfschedulecommand::FromLdfStatement(statement);
+			schedule_command = ldfschedulecommand::FromLdfStatement(&strings, statement);
 			if (schedule_command) schedule_tables[schedule_tables_count - 1]->AddCommand(schedule_command);
 		}
 		break;
@@ -289,7 +654,7 @@ void ldf::process_statement(uint8_t *statement)
 	case LDF_PARSING_STATE_CONFIGURABLE_FRAMES:
 		if (group_level == 3)
 		{
-			configurable_frame = ldfconfigurableframe::FromLdfStatement(statement);
+			configurable_frame = ldfconfigurableframe::FromLdfStatement(&strings, statement);
 			if (configurable_frame) node_attributes[node_attributes_count - 1]->AddConfigurableFrame(configurable_frame);
 		}
 		break;
@@ -298,10 +663,10 @@ void ldf::process_statement(uint8_t *statement)
 		if (group_level == 1)
 		{
 			// Isolate node name
-			p = strtok((char *)statement, BLANK_CHARACTERS);
+			p = strtok_r((char *)statement, BLANK_CHARACTERS, &save);
 
 			// Add new node attributes
-			node_attributes[node_attributes_count++] = new ldfnodeattributes(Str(p));
+			ArrayAppend(&node_attributes, &node_attributes_count, &node_attributes_capacity, new ldfnodeattributes(&strings, Str(p)));
 		}
 		else if (group_level == 2)
 		{
@@ -313,12 +678,12 @@ void ldf::process_statement(uint8_t *statement)
 	case LDF_PARSING_STATE_FRAMES:
 		if (group_level == 1)
 		{
-			frame = ldfframe::FromLdfStatement(statement);
-			if (frame) frames[frames_count++] = frame;
+			frame = ldfframe::FromLdfStatement(&strings, statement);
+			if (frame) ArrayAppend(&frames, &frames_count, &frames_capacity, frame);
 		}
 		else if (group_level == 2)
 		{
-			framesignal = ldfframesignal::FromLdfStatement(statement);
+			framesignal = ldfframesignal::FromLdfStatement(&strings, statement);
 			if (framesignal) frames[frames_count - 1]->AddSignal(framesignal);
 		}
 		break;
@@ -326,14 +691,14 @@ void ldf::process_statement(uint8_t *statement)
 	case LDF_PARSING_STATE_SIGNALS:
 		if (group_level == 1)
 		{
-			signal = ldfsignal::FromLdfStatement(statement);
-			if (signal) signals[signals_count++] = signal;
+			signal = ldfsignal::FromLdfStatement(&strings, statement);
+			if (signal) ArrayAppend(&signals, &signals_count, &signals_capacity, signal);
 		}
 		break;
 
 	case LDF_PARSING_STATE_NODES:
 		// Isolate first token
-		p = strtok((char *)statement, ":" BLANK_CHARACTERS);
+		p = strtok_r((char *)statement, ":" BLANK_CHARACTERS, &save);
 
 		if (StrEq(p, "Master"))
 		{
@@ -342,7 +707,7 @@ void ldf::process_statement(uint8_t *statement)
 			while (!(*p)) p++;
 
 			// Parse master node
-			masternode = ldfmasternode::FromLdfStatement(Str(p));
+			masternode = ldfmasternode::FromLdfStatement(&strings, Str(p));
 			if (master == NULL && masternode)
 				master = masternode;
 		}
@@ -350,8 +715,8 @@ void ldf::process_statement(uint8_t *statement)
 		{
 			while (p)
 			{
-				p = strtok(NULL, "," BLANK_CHARACTERS);
-				if (p) slaves[slaves_count++] = new ldfnode(Str(p));
+				p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);
+				if (p) ArrayAppend(&slaves, &slaves_count, &slaves_capacity, new ldfnode(&strings, Str(p)));
 			}
 		}
 		break;
@@ -359,8 +724,8 @@ void ldf::process_statement(uint8_t *statement)
 	case LDF_PARSING_STATE_ENCODING_TYPES:
 		if (group_level == 1)
 		{
-			p = strtok((char *)statement, BLANK_CHARACTERS);
-			if (p) encoding_types[encoding_types_count++] = new ldfencodingtype(Str(p));
+			p = strtok_r((char *)statement, BLANK_CHARACTERS, &save);
+			if (p) ArrayAppend(&encoding_types, &encoding_types_count, &encoding_types_capacity, new ldfencodingtype(&strings, Str(p)));
 		}
 		else if (group_level == 2)
 		{
@@ -371,15 +736,15 @@ void ldf::process_statement(uint8_t *statement)
 	case LDF_PARSING_STATE_ENCODING_SIGNALS:
 		if (group_level == 1)
 		{
-			encoding_signal = ldfencodingsignals::FromLdfStatement(statement);
-			if (encoding_signal) encoding_signals[encoding_signals_count++] = encoding_signal;
+			encoding_signal = ldfencodingsignals::FromLdfStatement(&strings, statement);
+			if (encoding_signal) ArrayAppend(&encoding_signals, &encoding_signals_count, &encoding_signals_capacity, encoding_signal);
 		}
 		break;
 
 	case LDF_PARSING_STATE_NONE:
 	default:
 		// Isolate first token
-		p = strtok((char *)statement, "=" BLANK_CHARACTERS);
+		p = strtok_r((char *)statement, "=" BLANK_CHARACTERS, &save);
 
 		// Check token
 		if (StrEq(p, "LIN_description_file"))
@@ -388,7 +753,7 @@ void ldf::process_statement(uint8_t *statement)
 		}
 		else if (StrEq(p, "LIN_protocol_version"))
 		{
-			p = strtok(NULL, "=" BLANK_CHARACTERS);
+			p = strtok_r(NULL, "=" BLANK_CHARACTERS, &save);
 			if (p && StrEq(p, "\"2.1\""))
 			{
 				lin_protocol_version = LIN_PROTOCOL_VERSION_2_1;
@@ -400,7 +765,7 @@ void ldf::process_statement(uint8_t *statement)
 		}
 		else if (StrEq(p, "LIN_language_version"))
 		{
-			p = strtok(NULL, "=" BLANK_CHARACTERS);
+			p = strtok_r(NULL, "=" BLANK_CHARACTERS, &save);
 			if (p && StrEq(p, "\"2.1\""))
 			{
 				lin_language_version = LIN_LANGUAGE_VERSION_2_1;
@@ -412,7 +777,7 @@ void ldf::process_statement(uint8_t *statement)
 		}
 		else if (StrEq(p, "LIN_speed"))
 		{
-			p = strtok(NULL, "=" BLANK_CHARACTERS);
+			p = strtok_r(NULL, "=" BLANK_CHARACTERS, &save);
 			if (p)
 			{
 				lin_speed = atof(p) * 1000;
@@ -425,6 +790,7 @@ void ldf::process_statement(uint8_t *statement)
 void ldf::process_group_start(uint8_t *start)
 {
 	char *p;
+	char *save = NULL;
 
 	switch (parsing_state)
 	{
@@ -454,7 +820,7 @@ void ldf::process_group_start(uint8_t *start)
 
 	default:
 		// Isolate first token
-		p = strtok((char *)start, BLANK_CHARACTERS);
+		p = strtok_r((char *)start, BLANK_CHARACTERS, &save);
 
 		// Analyze group
 		if (StrEq(p, "Nodes"))
@@ -516,6 +882,154 @@ int ldf::SorterFrames(const void *a, const void *b)
 	return res;
 }
 
+void ldf::BuildIndexes()
+{
+	uint32_t i;
+
+	signals_by_name.Clear();
+	frames_by_name.Clear();
+	node_attributes_by_name.Clear();
+	schedule_tables_by_name.Clear();
+	memset(frames_by_id, 0, sizeof(frames_by_id));
+
+	for (i = 0; i < signals_count; i++) IndexAdd(&signals_by_name, signals[i]);
+	for (i = 0; i < frames_count; i++) IndexAdd(&frames_by_name, frames[i]);
+	for (i = 0; i < frames_count; i++) IndexFrameId(frames[i]);
+	for (i = 0; i < node_attributes_count; i++) IndexAdd(&node_attributes_by_name, node_attributes[i]);
+	for (i = 0; i < schedule_tables_count; i++) IndexAdd(&schedule_tables_by_name, schedule_tables[i]);
+}
+
+void ldf::IndexFrameId(ldfframe *f)
+{
+	uint8_t id = f->GetId();
+
+	if (id < 64 && frames_by_id[id] == NULL)
+		frames_by_id[id] = f;
+}
+
+void ldf::UnindexFrameId(ldfframe *f)
+{
+	uint8_t id = f->GetId();
+
+	if (id >= 64 || frames_by_id[id] != f)
+		return;
+
+	// Give the ID to the next frame that repeats it, if any
+	frames_by_id[id] = NULL;
+	for (uint32_t i = 0; i < frames_count; i++)
+	{
+		if (frames[i] != f && frames[i]->GetId() == id)
+		{
+			frames_by_id[id] = frames[i];
+			break;
+		}
+	}
+}
+
+void ldf::BuildReferences()
+{
+	uint32_t i;
+
+	references.Clear();
+	for (i = 0; i < signals_count; i++) LinkReferences(ldfreferences::LDF_USER_SIGNAL, signals[i], true);
+	for (i = 0; i < frames_count; i++) LinkReferences(ldfreferences::LDF_USER_FRAME, frames[i], true);
+	for (i = 0; i < node_attributes_count; i++) LinkReferences(ldfreferences::LDF_USER_NODE_ATTRIBUTES, node_attributes[i], true);
+	for (i = 0; i < schedule_tables_count; i++) LinkReferences(ldfreferences::LDF_USER_SCHEDULE_TABLE, schedule_tables[i], true);
+	for (i = 0; i < encoding_signals_count; i++) LinkReferences(ldfreferences::LDF_USER_ENCODING_SIGNALS, encoding_signals[i], true);
+}
+
+void ldf::LinkReferences(ldfreferences::ldfusertype_e type, void *entity, bool link)
+{
+	uint32_t i;
+
+	// Add or remove one reference of the entity to a name
+	auto reference = [&](ldfreferences::ldfreferencetype_e t, const uint8_t *name)
+	{
+		if (link)
+			references.Add(t, name, type, entity);
+		else
+			references.Remove(t, name, entity);
+	};
+
+	switch (type)
+	{
+
+	case ldfreferences::LDF_USER_SIGNAL:
+	{
+		ldfsignal *s = (ldfsignal *)entity;
+
+		reference(ldfreferences::LDF_REF_NODE, s->GetPublisher());
+		for (i = 0; i < s->GetSubscribersCount(); i++)
+			reference(ldfreferences::LDF_REF_NODE, s->GetSubscriber(i));
+		break;
+	}
+
+	case ldfreferences::LDF_USER_FRAME:
+	{
+		ldfframe *f = (ldfframe *)entity;
+
+		reference(ldfreferences::LDF_REF_NODE, f->GetPublisher());
+		for (i = 0; i < f->GetSignalsCount(); i++)
+			reference(ldfreferences::LDF_REF_SIGNAL, f->GetSignal(i)->GetName());
+		break;
+	}
+
+	case ldfreferences::LDF_USER_NODE_ATTRIBUTES:
+	{
+		ldfnodeattributes *n = (ldfnodeattributes *)entity;
+
+		reference(ldfreferences::LDF_REF_SIGNAL, n->GetResponseErrorSignalName());
+		for (i = 0; i < n->GetFaultStateSignalsCount(); i++)
+			reference(ldfreferences::LDF_REF_SIGNAL, n->GetFaultStateSignal(i));
+		for (i = 0; i < n->GetConfigurableFramesCount(); i++)
+			reference(ldfreferences::LDF_REF_FRAME, n->GetConfigurableFrame(i)->GetName());
+		break;
+	}
+
+	case ldfreferences::LDF_USER_SCHEDULE_TABLE:
+	{
+		ldfscheduletable *t = (ldfscheduletable *)entity;
+
+		for (i = 0; i < t->GetCommandsCount(); i++)
+		{
+			ldfschedulecommand *c = t->GetCommandByIndex(i);
+
+			reference(ldfreferences::LDF_REF_FRAME, c->GetFrameName());
+			reference(ldfreferences::LDF_REF_NODE, c->GetSlaveName());
+			reference(ldfreferences::LDF_REF_FRAME, c->GetAssignFrameIdName());
+		}
+		break;
+	}
+
+	case ldfreferences::LDF_USER_ENCODING_SIGNALS:
+	{
+		ldfencodingsignals *e = (ldfencodingsignals *)entity;
+
+		for (i = 0; i < e->GetSignalsCount(); i++)
+			reference(ldfreferences::LDF_REF_SIGNAL, e->GetSignal(i));
+		break;
+	}
+
+	}
+}
+
+uint32_t ldf::TakeUsers(ldfreferences::ldfreferencetype_e type, const uint8_t *name, ldfreferences::ldfuser_s **users)
+{
+	uint32_t count = references.GetUsersCount(type, name);
+
+	// Copy the users of the name and unlink them, so they can be changed and linked again
+	*users = (ldfreferences::ldfuser_s *)malloc((count + 1) * sizeof(ldfreferences::ldfuser_s));
+	for (uint32_t i = 0; i < count; i++)
+	{
+		(*users)[i] = *references.GetUser(type, name, i);
+		MarkUserDirty(&(*users)[i]);
+	}
+	for (uint32_t i = 0; i < count; i++)
+		LinkReferences((*users)[i].type, (*users)[i].entity, false);
+
+	return count;
+}
+
 void ldf::DeleteSlaveNodeByIndex(uint32_t ix)
 {
 	delete slaves[ix];
@@ -526,6 +1040,8 @@ void ldf::DeleteSlaveNodeByIndex(uint32_t ix)
 
 void ldf::DeleteSlaveNodeAttributesByIndex(uint32_t ix)
 {
+	IndexRemove(&node_attributes_by_name, node_attributes, node_attributes_count, node_attributes[ix]);
+	LinkReferences(ldfreferences::LDF_USER_NODE_ATTRIBUTES, node_attributes[ix], false);
 	delete node_attributes[ix];
 	node_attributes_count--;
 	for (;ix < node_attributes_count; ix++)
@@ -534,6 +1050,8 @@ void ldf::DeleteSlaveNodeAttributesByIndex(uint32_t ix)
 
 void ldf::DeleteSignalByIndex(uint32_t ix)
 {
+	IndexRemove(&signals_by_name, signals, signals_count, signals[ix]);
+	LinkReferences(ldfreferences::LDF_USER_SIGNAL, signals[ix], false);
 	delete signals[ix];
 	signals_count--;
 	for (;ix < signals_count; ix++)
@@ -542,6 +1060,9 @@ void ldf::DeleteSignalByIndex(uint32_t ix)
 
 void ldf::DeleteFrameByIndex(uint32_t ix)
 {
+	IndexRemove(&frames_by_name, frames, frames_count, frames[ix]);
+	UnindexFrameId(frames[ix]);
+	LinkReferences(ldfreferences::LDF_USER_FRAME, frames[ix], false);
 	delete frames[ix];
 	frames_count--;
 	for (;ix < frames_count; ix++)
@@ -550,6 +1071,8 @@ void ldf::DeleteFrameByIndex(uint32_t ix)
 
 void ldf::DeleteScheduleTableByIndex(uint32_t ix)
 {
+	IndexRemove(&schedule_tables_by_name, schedule_tables, schedule_tables_count, schedule_tables[ix]);
+	LinkReferences(ldfreferences::LDF_USER_SCHEDULE_TABLE, schedule_tables[ix], false);
 	delete schedule_tables[ix];
 	schedule_tables_count--;
 	for (; ix < schedule_tables_count; ix++)
@@ -590,7 +1113,7 @@ ldfmasternode *ldf::GetMasterNode()
 {
 	if (master == NULL)
 	{
-		master = new ldfmasternode(Str(""), 0, 0);
+		master = new ldfmasternode(&strings, Str(""), 0, 0);
 	}
 
 	return master;
@@ -608,34 +1131,40 @@ uint32_t ldf::GetSlaveNodesCount()
 
 ldfnodeattributes *ldf::GetSlaveNodeAttributesByName(const uint8_t *slave_name)
 {
-	uint32_t ix;
-	ldfnodeattributes *ret = NULL;
-
-	// Skip if parameter is invalid
+	// Skip if parameter is invalid or the name is not known in the database
+	slave_name = strings.Find(slave_name);
 	if (slave_name == NULL)
 		return NULL;
 
 	// Look for node attributes
-	for (ix = 0; (ret == NULL) && (ix < node_attributes_count); ix++)
-	{
-		ret = StrEq(slave_name, node_attributes[ix]->GetName()) ? node_attributes[ix] : NULL;
-	}
-
-	return ret;
+	return (ldfnodeattributes *)node_attributes_by_name.Get(slave_name);
 }
 
 void ldf::AddSlaveNode(ldfnodeattributes *n)
 {
 	// Add slave and store slave node attributes
-	if (slaves_count < sizeof(slaves) / sizeof(slaves[0]))
-	{
-		slaves[slaves_count++] = new ldfnode(n->GetName());
-		node_attributes[node_attributes_count++] = n;
-	}
+	ArrayAppend(&slaves, &slaves_count, &slaves_capacity, new ldfnode(&strings, n->GetName()));
+	ArrayAppend(&node_attributes, &node_attributes_count, &node_attributes_capacity, n);
+	IndexAdd(&node_attributes_by_name, n);
+	LinkReferences(ldfreferences::LDF_USER_NODE_ATTRIBUTES, n, true);
+
+	// Revalidate the slave and its users
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, n->GetName());
+	MarkUsersDirty(ldfreferences::LDF_REF_NODE, n->GetName());
 }
 
 void ldf::UpdateSlaveNode(const uint8_t *old_slave_name, ldfnodeattributes *n)
 {
+	ldfreferences::ldfuser_s *users;
+	uint32_t users_count;
+
+	old_slave_name = strings.Find(old_slave_name);
+
+	// Revalidate the slave and the users of both names
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, old_slave_name);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, n->GetName());
+	MarkUsersDirty(ldfreferences::LDF_REF_NODE, n->GetName());
+
 	// Update slave name
 	for (uint32_t ix = 0; ix < slaves_count; ix++)
 	{
@@ -646,41 +1175,52 @@ void ldf::UpdateSlaveNode(const uint8_t *old_slave_name, ldfnodeattributes *n)
 	for (uint32_t ix = 0; ix < node_attributes_count; ix++)
 	{
 		// Skip node attributes
-		if (!StrEq(old_slave_name, node_attributes[ix]->GetName()))
+		if (!NameEq(old_slave_name, node_attributes[ix]->GetName()))
 			continue;
 
 		// Replace node attibutes
+		IndexRemove(&node_attributes_by_name, node_attributes, node_attributes_count, node_attributes[ix]);
+		LinkReferences(ldfreferences::LDF_USER_NODE_ATTRIBUTES, node_attributes[ix], false);
 		delete node_attributes[ix];
 		node_attributes[ix] = n;
+		IndexAdd(&node_attributes_by_name, n);
+		LinkReferences(ldfreferences::LDF_USER_NODE_ATTRIBUTES, n, true);
 		break;
 	}
 
-	// Update slave node in signals
-	for (uint32_t ix = 0; ix < signals_count; ix++)
-	{
-		signals[ix]->UpdateNodeName(old_slave_name, n->GetName());
-	}
-
-	// Update slave node in frames
-	for (uint32_t ix = 0; ix < frames_count; ix++)
+	// Update slave node in signals, frames and schedule tables that use it
+	users_count = TakeUsers(ldfreferences::LDF_REF_NODE, old_slave_name, &users);
+	for (uint32_t ix = 0; ix < users_count; ix++)
 	{
-		frames[ix]->UpdateNodeName(old_slave_name, n->GetName());
-	}
-
-	// Update slave node name in schedule tables
-	for (uint32_t ix = 0; ix < schedule_tables_count; ix++)
-	{
-		schedule_tables[ix]->UpdateCommandsSlaveName(old_slave_name, n->GetName());
+		switch (users[ix].type)
+		{
+		case ldfreferences::LDF_USER_SIGNAL: ((ldfsignal *)users[ix].entity)->UpdateNodeName(old_slave_name, n->GetName()); break;
+		case ldfreferences::LDF_USER_FRAME: ((ldfframe *)users[ix].entity)->UpdateNodeName(old_slave_name, n->GetName()); break;
+		case ldfreferences::LDF_USER_SCHEDULE_TABLE: ((ldfscheduletable *)users[ix].entity)->UpdateCommandsSlaveName(old_slave_name, n->GetName()); break;
+		default: break;
+		}
+		LinkReferences(users[ix].type, users[ix].entity, true);
 	}
+	free(users);
 }
 
 void ldf::DeleteSlaveNode(const uint8_t *slave_name)
 {
+	ldfreferences::ldfuser_s *users;
+	uint32_t users_count;
+	ldfindex deleted;
+	const uint8_t **deleted_signals;
+	uint32_t deleted_signals_count = 0;
+	uint32_t ix, jx;
+
+	slave_name = strings.Find(slave_name);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, slave_name);
+
 	// Delete slave name
-	for (uint32_t ix = 0; ix < slaves_count; ix++)
+	for (ix = 0; ix < slaves_count; ix++)
 	{
 		// Skip slaves
-		if (!StrEq(slave_name, slaves[ix]->GetName()))
+		if (!NameEq(slave_name, slaves[ix]->GetName()))
 			continue;
 
 		// Delete slave and move all list one slot back
@@ -689,10 +1229,10 @@ void ldf::DeleteSlaveNode(const uint8_t *slave_name)
 	}
 
 	// Delete slave node attributes
-	for (uint32_t ix = 0; ix < node_attributes_count; ix++)
+	for (ix = 0; ix < node_attributes_count; ix++)
 	{
 		// Skip node attributes
-		if (!StrEq(slave_name, node_attributes[ix]->GetName()))
+		if (!NameEq(slave_name, node_attributes[ix]->GetName()))
 			continue;
 
 		// Delete node attributes and move all list one slot back
@@ -700,56 +1240,90 @@ void ldf::DeleteSlaveNode(const uint8_t *slave_name)
 		break;
 	}
 
-	// Delete signals that use the slave
-	for (uint32_t ix = 0; ix < signals_count; )
+	// Signals and frames that use the slave are deleted, schedule tables lose its commands
+	users_count = TakeUsers(ldfreferences::LDF_REF_NODE, slave_name, &users);
+	deleted_signals = (const uint8_t **)malloc((users_count + 1) * sizeof(const uint8_t *));
+	for (ix = 0; ix < users_count; ix++)
 	{
-		// Skip signals
-		if (!signals[ix]->UsesSlave(slave_name))
+		switch (users[ix].type)
 		{
-			ix++;
-			continue;
+		case ldfreferences::LDF_USER_SIGNAL:
+			deleted_signals[deleted_signals_count++] = ((ldfsignal *)users[ix].entity)->GetName();
+			deleted.Put(users[ix].entity, users[ix].entity);
+			MarkUsersDirty(ldfreferences::LDF_REF_SIGNAL, ((ldfsignal *)users[ix].entity)->GetName());
+			break;
+
+		case ldfreferences::LDF_USER_FRAME:
+			deleted.Put(users[ix].entity, users[ix].entity);
+			MarkUsersDirty(ldfreferences::LDF_REF_FRAME, ((ldfframe *)users[ix].entity)->GetName());
+			MarkFrameIdDirty(((ldfframe *)users[ix].entity)->GetId());
+			break;
+
+		case ldfreferences::LDF_USER_SCHEDULE_TABLE:
+			((ldfscheduletable *)users[ix].entity)->DeleteCommandsBySlaveName(slave_name);
+			LinkReferences(users[ix].type, users[ix].entity, true);
+			break;
+
+		default:
+			LinkReferences(users[ix].type, users[ix].entity, true);
+			break;
 		}
-
-		// Delete signal and drag all others back
-		DeleteSignalByIndex(ix);
 	}
+	free(users);
 
-	// Delete frames that use the slave
-	for (uint32_t ix = 0; ix < frames_count; )
+	// Delete signals and frames in one pass, dragging the others back
+	for (ix = 0, jx = 0; ix < signals_count; ix++)
 	{
-		// Skip frame
-		if (!StrEq(frames[ix]->GetPublisher(), slave_name))
-		{
-			ix++;
-			continue;
-		}
-
-		// Delete frame and drag all others back
-		DeleteFrameByIndex(ix);
+		if (deleted.Get(signals[ix]) == NULL)
+			signals[jx++] = signals[ix];
+		else
+			delete signals[ix];
 	}
+	signals_count = jx;
 
-	// Delete schedule tables that use the slave
-	for (uint32_t ix = 0; ix < schedule_tables_count; ix++)
+	for (ix = 0, jx = 0; ix < frames_count; ix++)
 	{
-		schedule_tables[ix]->DeleteCommandsBySlaveName(slave_name);
+		if (deleted.Get(frames[ix]) == NULL)
+			frames[jx++] = frames[ix];
+		else
+			delete frames[ix];
 	}
+	frames_count = jx;
+
+	BuildIndexes();
 
 	// Remove deleted signals from frames
-	for (uint32_t ix = 0; ix < frames_count; ix++)
+	for (ix = 0; ix < deleted_signals_count; ix++)
 	{
-		for (uint32_t jx = 0; jx < frames[ix]->GetSignalsCount(); )
+		// Skip signals whose name is still defined
+		if (signals_by_name.Get(deleted_signals[ix]) != NULL)
+			continue;
+
+		users_count = TakeUsers(ldfreferences::LDF_REF_SIGNAL, deleted_signals[ix], &users);
+		for (uint32_t ux = 0; ux < users_count; ux++)
 		{
-			// Skip signal
-			if (GetSignalByName(frames[ix]->GetSignal(jx)->GetName()))
+			if (users[ux].type == ldfreferences::LDF_USER_FRAME)
 			{
-				jx++;
-				continue;
+				ldfframe *f = (ldfframe *)users[ux].entity;
+
+				for (jx = 0; jx < f->GetSignalsCount(); )
+				{
+					// Skip signal
+					if (!NameEq(f->GetSignal(jx)->GetName(), deleted_signals[ix]))
+					{
+						jx++;
+						continue;
+					}
+
+					// Remove signal from frame
+					f->DeleteSignalByIndex(jx);
+				}
 			}
-
-			// Remove signal from frame
-			frames[ix]->DeleteSignalByIndex(jx);
+			LinkReferences(users[ux].type, users[ux].entity, true);
 		}
+		free(users);
 	}
+	free(deleted_signals);
 }
 
 ldfsignal *ldf::GetSignalByIndex(uint32_t ix)
@@ -759,14 +1333,11 @@ ldfsignal *ldf::GetSignalByIndex(uint32_t ix)
 
 ldfsignal *ldf::GetSignalByName(const uint8_t *signal_name)
 {
+	signal_name = strings.Find(signal_name);
 	if (signal_name == NULL)
 		return NULL;
 
-	for (uint32_t ix = 0; ix < signals_count; ix++)
-		if (StrEq(signals[ix]->GetName(), signal_name))
-			return signals[ix];
-
-	return NULL;
+	return (ldfsignal *)signals_by_name.Get(signal_name);
 }
 
 uint32_t ldf::GetSignalsCount()
@@ -776,50 +1347,76 @@ uint32_t ldf::GetSignalsCount()
 
 void ldf::AddSignal(ldfsignal *s)
 {
-	signals[signals_count++] = s;
+	ArrayAppend(&signals, &signals_count, &signals_capacity, s);
+	IndexAdd(&signals_by_name, s);
+	LinkReferences(ldfreferences::LDF_USER_SIGNAL, s, true);
+
+	// Revalidate the signal and its users
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL, s->GetName());
+	MarkUsersDirty(ldfreferences::LDF_REF_SIGNAL, s->GetName());
 }
 
 void ldf::UpdateSignal(const uint8_t *old_signal_name, ldfsignal *s)
 {
+	ldfreferences::ldfuser_s *users;
+	uint32_t users_count;
+
+	old_signal_name = strings.Find(old_signal_name);
 	if (old_signal_name == NULL)
 		return;
 
+	// Revalidate the signal and the users of both names
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL, old_signal_name);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL, s->GetName());
+	MarkUsersDirty(ldfreferences::LDF_REF_SIGNAL, s->GetName());
+
 	// Update signal with the new one
 	for (uint32_t ix = 0; ix < signals_count; ix++)
 	{
 		// Look for signal by ID
-		if (!StrEq(signals[ix]->GetName(), old_signal_name))
+		if (!NameEq(signals[ix]->GetName(), old_signal_name))
 			continue;
 
-		// Delete signal
+		// Replace signal
+		IndexRemove(&signals_by_name, signals, signals_count, signals[ix]);
+		LinkReferences(ldfreferences::LDF_USER_SIGNAL, signals[ix], false);
 		delete signals[ix];
 		signals[ix] = s;
+		IndexAdd(&signals_by_name, s);
+		LinkReferences(ldfreferences::LDF_USER_SIGNAL, s, true);
 		break;
 	}
 
-	// Update signal name in frames
-	for (uint32_t ix = 0; ix < frames_count; ix++)
+	// Update signal name in frames and slave's response error signal
+	users_count = TakeUsers(ldfreferences::LDF_REF_SIGNAL, old_signal_name, &users);
+	for (uint32_t ix = 0; ix < users_count; ix++)
 	{
-		frames[ix]->UpdateSignalName(old_signal_name, s->GetName());
-	}
-
-	// Update signal name in slave's response error signal
-	for (uint32_t ix = 0; ix < node_attributes_count; ix++)
-	{
-		node_attributes[ix]->UpdateResponseErrorSignalName(old_signal_name, s->GetName());
+		switch (users[ix].type)
+		{
+		case ldfreferences::LDF_USER_FRAME: ((ldfframe *)users[ix].entity)->UpdateSignalName(old_signal_name, s->GetName()); break;
+		case ldfreferences::LDF_USER_NODE_ATTRIBUTES: ((ldfnodeattributes *)users[ix].entity)->UpdateResponseErrorSignalName(old_signal_name, s->GetName()); break;
+		default: break;
+		}
+		LinkReferences(users[ix].type, users[ix].entity, true);
 	}
+	free(users);
 }
 
 void ldf::DeleteSignal(const uint8_t *signal_name)
 {
+	ldfreferences::ldfuser_s *users;
+	uint32_t users_count;
+
+	signal_name = strings.Find(signal_name);
 	if (signal_name == NULL)
 		return;
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL, signal_name);
 
 	// Delete signal from signals
 	for (uint32_t ix = 0; ix < signals_count; ix++)
 	{
 		// Look for signal by ID
-		if (!StrEq(signals[ix]->GetName(), signal_name))
+		if (!NameEq(signals[ix]->GetName(), signal_name))
 			continue;
 
 		// Delete signal
@@ -828,25 +1425,38 @@ void ldf::DeleteSignal(const uint8_t *signal_name)
 	}
 
 	// Delete signal from frames
-	for (uint32_t ix = 0; ix < frames_count; ix++)
+	users_count = TakeUsers(ldfreferences::LDF_REF_SIGNAL, signal_name, &users);
+	for (uint32_t ix = 0; ix < users_count; ix++)
 	{
-		frames[ix]->DeleteSignalByName(signal_name);
+		if (users[ix].type == ldfreferences::LDF_USER_FRAME)
+			((ldfframe *)users[ix].entity)->DeleteSignalByName(signal_name);
+		LinkReferences(users[ix].type, users[ix].entity, true);
 	}
+	free(users);
 }
 
 void ldf::UpdateMasterNodeName(const uint8_t *old_name, const uint8_t *new_name)
 {
-	// Update master node name in signals
-	for (uint32_t ix = 0; ix < signals_count; ix++)
-	{
-		signals[ix]->UpdateNodeName(old_name, new_name);
-	}
+	ldfreferences::ldfuser_s *users;
+	uint32_t users_count;
 
-	// Update master node name in frames
-	for (uint32_t ix = 0; ix < frames_count; ix++)
+	old_name = strings.Find(old_name);
+	new_name = strings.Intern(new_name);
+	MarkUsersDirty(ldfreferences::LDF_REF_NODE, new_name);
+
+	// Update master node name in signals and frames
+	users_count = TakeUsers(ldfreferences::LDF_REF_NODE, old_name, &users);
+	for (uint32_t ix = 0; ix < users_count; ix++)
 	{
-		frames[ix]->UpdateNodeName(old_name, new_name);
+		switch (users[ix].type)
+		{
+		case ldfreferences::LDF_USER_SIGNAL: ((ldfsignal *)users[ix].entity)->UpdateNodeName(old_name, new_name); break;
+		case ldfreferences::LDF_USER_FRAME: ((ldfframe *)users[ix].entity)->UpdateNodeName(old_name, new_name); break;
+		default: break;
+		}
+		LinkReferences(users[ix].type, users[ix].entity, true);
 	}
+	free(users);
 
 	// Update master node name
 	master->UpdateName(old_name, new_name);
@@ -859,18 +1469,19 @@ ldfframe *ldf::GetFrameByIndex(uint32_t ix)
 
 ldfframe *ldf::GetFrameByName(const uint8_t *frame_name)
 {
+	frame_name = strings.Find(frame_name);
 	if (frame_name == NULL)
 		return NULL;
 
-	for (uint32_t ix = 0; ix < frames_count; ix++)
-		if (StrEq(frames[ix]->GetName(), frame_name))
-			return frames[ix];
-
-	return NULL;
+	return (ldfframe *)frames_by_name.Get(frame_name);
 }
 
 ldfframe *ldf::GetFrameById(uint8_t frame_id)
 {
+	if (frame_id < 64)
+		return frames_by_id[frame_id];
+
+	// IDs out of range are not valid, but they can still be in the database
 	for (uint32_t ix = 0; ix < frames_count; ix++)
 		if (frames[ix]->GetId() == frame_id)
 			return frames[ix];
@@ -880,11 +1491,10 @@ ldfframe *ldf::GetFrameById(uint8_t frame_id)
 
 ldfframe *ldf::GetFrameByPid(uint8_t frame_pid)
 {
-	for (uint32_t ix = 0; ix < frames_count; ix++)
-		if (frames[ix]->GetPid() == frame_pid)
-			return frames[ix];
+	ldfframe *f = frames_by_id[frame_pid & 0x3F];
 
-	return NULL;
+	// Parity bits shall match too
+	return (f != NULL && f->GetPid() == frame_pid) ? f : NULL;
 }
 
 uint32_t ldf::GetFramesCount()
@@ -894,59 +1504,97 @@ uint32_t ldf::GetFramesCount()
 
 void ldf::AddFrame(ldfframe *f)
 {
-	frames[frames_count++] = f;
+	ArrayAppend(&frames, &frames_count, &frames_capacity, f);
+	IndexAdd(&frames_by_name, f);
+	IndexFrameId(f);
+	LinkReferences(ldfreferences::LDF_USER_FRAME, f, true);
+
+	// Revalidate the frame, its users and frames with the same ID
+	MarkFrameIdDirty(f->GetId());
+	MarkUsersDirty(ldfreferences::LDF_REF_FRAME, f->GetName());
 }
 
 void ldf::UpdateFrame(const uint8_t *old_frame_name, ldfframe *f)
 {
-	// Update frame in configurable frames
-	for (uint32_t i = 0; i < node_attributes_count; i++)
-	{
-		node_attributes[i]->UpdateConfigurableFrameNames(old_frame_name, f->GetName());
-	}
+	ldfreferences::ldfuser_s *users;
+	uint32_t users_count;
 
-	// Update frame in schedule tables
-	for (uint32_t i = 0; i < schedule_tables_count; i++)
+	old_frame_name = strings.Find(old_frame_name);
+
+	// Revalidate the frame and the users of both names
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, old_frame_name);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, f->GetName());
+	MarkUsersDirty(ldfreferences::LDF_REF_FRAME, f->GetName());
+
+	// Update frame in configurable frames and schedule tables
+	users_count = TakeUsers(ldfreferences::LDF_REF_FRAME, old_frame_name, &users);
+	for (uint32_t ix = 0; ix < users_count; ix++)
 	{
-		schedule_tables[i]->UpdateCommandsFrameName(old_frame_name, f->GetName());
+		switch (users[ix].type)
+		{
+		case ldfreferences::LDF_USER_NODE_ATTRIBUTES: ((ldfnodeattributes *)users[ix].entity)->UpdateConfigurableFrameNames(old_frame_name, f->GetName()); break;
+		case ldfreferences::LDF_USER_SCHEDULE_TABLE: ((ldfscheduletable *)users[ix].entity)->UpdateCommandsFrameName(old_frame_name, f->GetName()); break;
+		default: break;
+		}
+		LinkReferences(users[ix].type, users[ix].entity, true);
 	}
+	free(users);
 
 	// Update frame
 	for (uint32_t ix = 0; ix < frames_count; ix++)
 	{
 		// Skip frames
-		if (!StrEq(frames[ix]->GetName(), old_frame_name))
+		if (!NameEq(frames[ix]->GetName(), old_frame_name))
 			continue;
 
+		// Frames with the old or the new ID are revalidated too
+		MarkFrameIdDirty(frames[ix]->GetId());
+		MarkFrameIdDirty(f->GetId());
+
 		// Replace frame in index
+		IndexRemove(&frames_by_name, frames, frames_count, frames[ix]);
+		UnindexFrameId(frames[ix]);
+		LinkReferences(ldfreferences::LDF_USER_FRAME, frames[ix], false);
 		delete frames[ix];
 		frames[ix] = f;
+		IndexAdd(&frames_by_name, f);
+		IndexFrameId(f);
+		LinkReferences(ldfreferences::LDF_USER_FRAME, f, true);
 		break;
 	}
 }
 
 void ldf::DeleteFrame(const uint8_t *frame_name)
 {
-	// Update frame in configurable frames
-	for (uint32_t i = 0; i < node_attributes_count; i++)
-	{
-		node_attributes[i]->DeleteConfigurableFramesByName(frame_name);
-	}
+	ldfreferences::ldfuser_s *users;
+	uint32_t users_count;
 
-	// Update frame in schedule tables
-	for (uint32_t i = 0; i < schedule_tables_count; i++)
+	frame_name = strings.Find(frame_name);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, frame_name);
+
+	// Delete frame from configurable frames and schedule tables
+	users_count = TakeUsers(ldfreferences::LDF_REF_FRAME, frame_name, &users);
+	for (uint32_t ix = 0; ix < users_count; ix++)
 	{
-		schedule_tables[i]->DeleteCommandsByFrameName(frame_name);
+		switch (users[ix].type)
+		{
+		case ldfreferences::LDF_USER_NODE_ATTRIBUTES: ((ldfnodeattributes *)users[ix].entity)->DeleteConfigurableFramesByName(frame_name); break;
+		case ldfreferences::LDF_USER_SCHEDULE_TABLE: ((ldfscheduletable *)users[ix].entity)->DeleteCommandsByFrameName(frame_name); break;
+		default: break;
+		}
+		LinkReferences(users[ix].type, users[ix].entity, true);
 	}
+	free(users);
 
 	// Delete frame
 	for (uint32_t ix = 0; ix < frames_count; ix++)
 	{
 		// Skip frames
-		if (!StrEq(frames[ix]->GetName(), frame_name))
+		if (!NameEq(frames[ix]->GetName(), frame_name))
 			continue;
 
-		// Delete frame and shuffle the rest ones
+		// Delete frame and shuffle the rest ones, frames with the same ID are revalidated
+		MarkFrameIdDirty(frames[ix]->GetId());
 		DeleteFrameByIndex(ix);
 		break;
 	}
@@ -959,14 +1607,11 @@ ldfscheduletable *ldf::GetScheduleTableByIndex(uint32_t ix)
 
 ldfscheduletable *ldf::GetScheduleTableByName(const uint8_t *name)
 {
+	name = strings.Find(name);
 	if (name == NULL)
 		return NULL;
 
-	for (uint32_t i = 0; i < schedule_tables_count; i++)
-		if (StrEq(name, schedule_tables[i]->GetName()))
-			return schedule_tables[i];
-
-	return NULL;
+	return (ldfscheduletable *)schedule_tables_by_name.Get(name);
 }
 
 uint32_t ldf::GetScheduleTablesCount()
@@ -976,32 +1621,46 @@ uint32_t ldf::GetScheduleTablesCount()
 
 void ldf::AddScheduleTable(ldfscheduletable *t)
 {
-	schedule_tables[schedule_tables_count++] = t;
+	ArrayAppend(&schedule_tables, &schedule_tables_count, &schedule_tables_capacity, t);
+	IndexAdd(&schedule_tables_by_name, t);
+	LinkReferences(ldfreferences::LDF_USER_SCHEDULE_TABLE, t, true);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE, t->GetName());
 }
 
 void ldf::UpdateScheduleTable(const uint8_t *old_schedule_table_name, ldfscheduletable *t)
 {
+	old_schedule_table_name = strings.Find(old_schedule_table_name);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE, old_schedule_table_name);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE, t->GetName());
+
 	for (uint32_t i = 0; i < schedule_tables_count; i++)
 	{
 		// Skip schedule tables with different names
-		if (!StrEq(schedule_tables[i]->GetName(), old_schedule_table_name))
+		if (!NameEq(schedule_tables[i]->GetName(), old_schedule_table_name))
 		{
 			continue;
 		}
 
 		// Replace schedule table
+		IndexRemove(&schedule_tables_by_name, schedule_tables, schedule_tables_count, schedule_tables[i]);
+		LinkReferences(ldfreferences::LDF_USER_SCHEDULE_TABLE, schedule_tables[i], false);
 		delete schedule_tables[i];
 		schedule_tables[i] = t;
+		IndexAdd(&schedule_tables_by_name, t);
+		LinkReferences(ldfreferences::LDF_USER_SCHEDULE_TABLE, t, true);
 		break;
 	}
 }
 
 void ldf::DeleteScheduleTable(const uint8_t *schedule_table_name)
 {
+	schedule_table_name = strings.Find(schedule_table_name);
+	MarkDirty(ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE, schedule_table_name);
+
 	for (uint32_t i = 0; i < schedule_tables_count; i++)
 	{
 		// Skip schedule tables with different names
-		if (!StrEq(schedule_tables[i]->GetName(), schedule_table_name))
+		if (!NameEq(schedule_tables[i]->GetName(), schedule_table_name))
 		{
 			continue;
 		}
@@ -1012,75 +1671,165 @@ void ldf::DeleteScheduleTable(const uint8_t *schedule_table_name)
 	}
 }
 
-uint32_t ldf::GetValidationMessagesCount()
+ldfencodingtype *ldf::GetEncodingTypeByIndex(uint32_t ix)
 {
-	return validation_messages_count;
+	return encoding_types[ix];
 }
 
-const uint8_t *ldf::GetValidationMessageByIndex(uint32_t ix)
+ldfencodingtype *ldf::GetEncodingTypeByName(const uint8_t *name)
 {
-	return validation_messages[ix];
+	name = strings.Find(name);
+	if (name == NULL)
+		return NULL;
+
+	for (uint32_t i = 0; i < encoding_types_count; i++)
+		if (NameEq(encoding_types[i]->GetName(), name))
+			return encoding_types[i];
+
+	return NULL;
 }
 
-bool ldf::Save(const uint8_t *filename)
+uint32_t ldf::GetEncodingTypesCount()
+{
+	return encoding_types_count;
+}
+
+ldfencodingsignals *ldf::GetEncodingSignalsByIndex(uint32_t ix)
+{
+	return encoding_signals[ix];
+}
+
+uint32_t ldf::GetEncodingSignalsCount()
+{
+	return encoding_signals_count;
+}
+
+ldfstrings *ldf::GetStrings()
+{
+	return &strings;
+}
+
+ldfdiagnostics *ldf::GetDiagnostics()
 {
-	// Open file
-	FILE *ldf_file = fopen((char *)filename, "wb");
-	if (!ldf_file)
-		return false;
+	return &diagnostics;
+}
 
+ldfreferences *ldf::GetReferences()
+{
+	return &references;
+}
+
+void ldf::ToLdfFile(ldfwriter *w)
+{
 	// Print ldf master configuration
-	fprintf(ldf_file, "LIN_description_file;\r\n");
-	fprintf(ldf_file, "LIN_protocol_version = \"%s\";\r\n", (lin_protocol_version == LIN_PROTOCOL_VERSION_2_0) ? "2.0" : "2.1");
-	fprintf(ldf_file, "LIN_language_version = \"%s\";\r\n", (lin_language_version == LIN_LANGUAGE_VERSION_2_0) ? "2.0" : "2.1");
-	fprintf(ldf_file, "LIN_speed = %0.3f kbps;\r\n", 1.0f * lin_speed / 1000.0f);
-	fprintf(ldf_file, "\r\n");
+	w->Text("LIN_description_file;\r\n");
+	w->Text("LIN_protocol_version = \"");
+	w->Text((lin_protocol_version == LIN_PROTOCOL_VERSION_2_0) ? "2.0" : "2.1");
+	w->Text("\";\r\n");
+	w->Text("LIN_language_version = \"");
+	w->Text((lin_language_version == LIN_LANGUAGE_VERSION_2_0) ? "2.0" : "2.1");
+	w->Text("\";\r\n");
+	w->Printf("LIN_speed = %0.3f kbps;\r\n", 1.0f * lin_speed / 1000.0f);
+	w->Text("\r\n");
 
 	// Print ldf nodes configuration
-	fprintf(ldf_file, "Nodes {\r\n");
-	fprintf(ldf_file, "    ");
-	master->ToLdfFile(ldf_file);
-	fprintf(ldf_file, "    Slaves: ");
+	w->Text("Nodes {\r\n");
+	w->Text("    ");
+	master->ToLdfFile(w);
+	w->Text("    Slaves: ");
 	for (uint32_t i = 0; i < slaves_count; i++)
 	{
-		if (i != 0) fprintf(ldf_file, ", ");
-		fprintf(ldf_file, "%s", slaves[i]->GetName());
+		if (i != 0) w->Text(", ");
+		w->Text(slaves[i]->GetName());
 	}
-	fprintf(ldf_file, ";\r\n");
-	fprintf(ldf_file, "}\r\n");
-	fprintf(ldf_file, "\r\n");
+	w->Text(";\r\n");
+	w->Text("}\r\n");
+	w->Text("\r\n");
 
 	// Print ldf signals configuration
-	fprintf(ldf_file, "Signals {\r\n");
+	w->Text("Signals {\r\n");
 	for (uint32_t i = 0; i < signals_count; i++)
-		signals[i]->ToLdfFile(ldf_file);
-	fprintf(ldf_file, "}\r\n");
-	fprintf(ldf_file, "\r\n");
+		signals[i]->ToLdfFile(w);
+	w->Text("}\r\n");
+	w->Text("\r\n");
 
 	// Print ldf frames configuration
-	fprintf(ldf_file, "Frames {\r\n");
+	w->Text("Frames {\r\n");
 	for (uint32_t i = 0; i < frames_count; i++)
-		frames[i]->ToLdfFile(ldf_file);
-	fprintf(ldf_file, "}\r\n");
-	fprintf(ldf_file, "\r\n");
+		frames[i]->ToLdfFile(w);
+	w->Text("}\r\n");
+	w->Text("\r\n");
 
 	// Print ldf node attributes configuration
-	fprintf(ldf_file, "Node_attributes {\r\n");
+	w->Text("Node_attributes {\r\n");
 	for (uint32_t i = 0; i < node_attributes_count; i++)
-		node_attributes[i]->ToLdfFile(ldf_file);
-	fprintf(ldf_file, "}\r\n");
-	fprintf(ldf_file, "\r\n");
+		node_attributes[i]->ToLdfFile(w);
+	w->Text("}\r\n");
+	w->Text("\r\n");
 
 	// Print ldf schedule tables configuration
-	fprintf(ldf_file, "Schedule_tables {\r\n");
+	w->Text("Schedule_tables {\r\n");
 	for (uint32_t i = 0; i < schedule_tables_count; i++)
-		schedule_tables[i]->ToLdfFile(ldf_file, this);
-	fprintf(ldf_file, "}\r\n");
-	fprintf(ldf_file, "\r\n");
+		schedule_tables[i]->ToLdfFile(w, this);
+	w->Text("}\r\n");
+	w->Text("\r\n");
+}
 
-	// Close file and return true
-	fclose(ldf_file);
-	return true;
+bool ldf::Save(const uint8_t *filename)
+{
+	ldfwriter w;
+
+	// Format the whole database in memory and write it at once
+	ToLdfFile(&w);
+	return w.WriteFile(filename);
+}
+
+bool ldf::Save(int fd)
+{
+	ldfwriter w(fd);
+
+	// Format the database a buffer at a time
+	ToLdfFile(&w);
+	return w.Flush();
+}
+
+void ldf::GetMemoryFootprint(ldf_footprint_s *footprint)
+{
+	uint32_t i;
+
+	// Database object and its lists
+	footprint->database = sizeof(*this) - sizeof(strings) - sizeof(diagnostics) - sizeof(references);
+	footprint->database += references.GetMemoryFootprint();
+	footprint->database += slaves_capacity * sizeof(slaves[0]);
+	footprint->database += signals_capacity * sizeof(signals[0]);
+	footprint->database += frames_capacity * sizeof(frames[0]);
+	footprint->database += node_attributes_capacity * sizeof(node_attributes[0]);
+	footprint->database += schedule_tables_capacity * sizeof(schedule_tables[0]);
+	footprint->database += encoding_types_capacity * sizeof(encoding_types[0]);
+	footprint->database += encoding_signals_capacity * sizeof(encoding_signals[0]);
+	footprint->database += signals_by_name.GetMemoryFootprint() - sizeof(ldfindex);
+	footprint->database += frames_by_name.GetMemoryFootprint() - sizeof(ldfindex);
+	footprint->database += node_attributes_by_name.GetMemoryFootprint() - sizeof(ldfindex);
+	footprint->database += schedule_tables_by_name.GetMemoryFootprint() - sizeof(ldfindex);
+	for (i = 0; i < ldfdiagnostics::LDF_DIAG_ENTITY_COUNT; i++) footprint->database += dirty[i].GetMemoryFootprint() - sizeof(ldfindex);
+
+	// Entities
+	footprint->entities = (master != NULL) ? sizeof(*master) : 0;
+	footprint->entities += slaves_count * sizeof(ldfnode);
+	for (i = 0; i < signals_count; i++) footprint->entities += signals[i]->GetMemoryFootprint();
+	for (i = 0; i < frames_count; i++) footprint->entities += frames[i]->GetMemoryFootprint();
+	for (i = 0; i < node_attributes_count; i++) footprint->entities += node_attributes[i]->GetMemoryFootprint();
+	for (i = 0; i < schedule_tables_count; i++) footprint->entities += schedule_tables[i]->GetMemoryFootprint();
+	for (i = 0; i < encoding_types_count; i++) footprint->entities += encoding_types[i]->GetMemoryFootprint();
+	for (i = 0; i < encoding_signals_count; i++) footprint->entities += encoding_signals[i]->GetMemoryFootprint();
+
+	// Interned names
+	footprint->strings = strings.GetMemoryFootprint();
+
+	// Validation findings
+	footprint->validation = diagnostics.GetMemoryFootprint();
+
+	footprint->total = footprint->database + footprint->entities + footprint->strings + footprint->validation;
 }
 
 
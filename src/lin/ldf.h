@@ -10,6 +10,11 @@
 
 #include <stdint.h>
 #include <ldfcommon.h>
+#include <ldfstrings.h>
+#include <ldfindex.h>
+#include <ldfdiagnostics.h>
+#include <ldfreferences.h>
+#include <ldfwriter.h>
 #include <ldfmasternode.h>
 #include <ldfsignal.h>
 #include <ldfframe.h>
@@ -23,8 +28,23 @@
 
 namespace lin {
 
+class ldfcache;	/* ldfcache rebuilds databases directly from its binary image */
+
 class ldf {
 
+	friend class ldfcache;
+
+public:
+	// Bytes used by a database, names are counted once in the strings arena
+	struct ldf_footprint_s
+	{
+		size_t database;			// Database object and its lists
+		size_t entities;			// Entity objects and their lists
+		size_t strings;				// Interned names arena and hash table
+		size_t validation;			// Validation findings
+		size_t total;
+	};
+
 private:
 	enum ldf_parsing_state_e
 	{
@@ -45,6 +65,9 @@ private:
 	ldf_parsing_state_e parsing_state;
 	uint32_t group_level;
 
+	// Interned names of all entities
+	ldfstrings strings;
+
 	// Global parameters
 	lin_protocol_version_e lin_protocol_version;
 	lin_language_version_e lin_language_version;
@@ -53,41 +76,58 @@ private:
 	// Nodes
 	ldfmasternode *master;
 
-	ldfnode *slaves[128];
-	uint8_t slaves_count;
+	ldfnode **slaves;
+	uint32_t slaves_count;
+	uint32_t slaves_capacity;
 
 	// Signals
-	ldfsignal *signals[10000];
+	ldfsignal **signals;
 	uint32_t signals_count;
+	uint32_t signals_capacity;
 
 	// Frames
-	ldfframe *frames[1000];
+	ldfframe **frames;
 	uint32_t frames_count;
+	uint32_t frames_capacity;
 
 	// Node attributes
-	ldfnodeattributes *node_attributes[1000];
+	ldfnodeattributes **node_attributes;
 	uint32_t node_attributes_count;
+	uint32_t node_attributes_capacity;
 
 	// Schedule tables
-	ldfscheduletable *schedule_tables[100];
+	ldfscheduletable **schedule_tables;
 	uint32_t schedule_tables_count;
+	uint32_t schedule_tables_capacity;
 
 	// Signal encodings
-	ldfencodingtype *encoding_types[1000];
+	ldfencodingtype **encoding_types;
 	uint32_t encoding_types_count;
+	uint32_t encoding_types_capacity;
 
 	// Relationships between encodings and signals
-	ldfencodingsignals *encoding_signals[1000];
+	ldfencodingsignals **encoding_signals;
 	uint32_t encoding_signals_count;
+	uint32_t encoding_signals_capacity;
+
+	// Lookup indexes, the first entity wins when a name or ID is repeated
+	ldfindex signals_by_name;
+	ldfindex frames_by_name;
+	ldfindex node_attributes_by_name;
+	ldfindex schedule_tables_by_name;
+	ldfframe *frames_by_id[64];
+
+	// Users of every signal, frame and node name
+	ldfreferences references;
+
+	// Validation findings
+	ldfdiagnostics diagnostics;
 
-	// Validation messages
-	uint8_t *validation_messages[10000];
-	uint32_t validation_messages_count;
+	// Names of the entities changed since the last validation, by type of diagnostic entity
+	ldfindex dirty[ldfdiagnostics::LDF_DIAG_ENTITY_COUNT];
 
 
 private:
-	bool char_in_set(uint8_t c, const char *set);
-	void parse_char(uint8_t c);
 	void process_statement(uint8_t *statement);
 	void process_group_start(uint8_t *start);
 	void process_group_end(uint8_t *end);
@@ -95,18 +135,42 @@ private:
 	static int SorterSignals(const void *a, const void *b);
 	static int SorterFrames(const void *a, const void *b);
 
+	void BuildIndexes();
+	void IndexFrameId(ldfframe *f);
+	void UnindexFrameId(ldfframe *f);
+
+	void BuildReferences();
+	void LinkReferences(ldfreferences::ldfusertype_e type, void *entity, bool link);
+	uint32_t TakeUsers(ldfreferences::ldfreferencetype_e type, const uint8_t *name, ldfreferences::ldfuser_s **users);
+
+	void ValidateSettings();
+	void MarkDirty(ldfdiagnostics::ldfdiagnosticentity_e type, const uint8_t *name);
+	void MarkUserDirty(ldfreferences::ldfuser_s *user);
+	void MarkUsersDirty(ldfreferences::ldfreferencetype_e type, const uint8_t *name);
+	void MarkFrameIdDirty(uint8_t id);
+	void ClearDirty();
+
 	void DeleteSlaveNodeByIndex(uint32_t ix);
 	void DeleteSlaveNodeAttributesByIndex(uint32_t ix);
 	void DeleteSignalByIndex(uint32_t ix);
 	void DeleteFrameByIndex(uint32_t ix);
 	void DeleteScheduleTableByIndex(uint32_t ix);
 
+	ldf();
+
 public:
 	ldf(const uint8_t *filename);
 	virtual ~ldf();
 
+	static uint32_t LoadFiles(const uint8_t **filenames, uint32_t count, ldf **databases, uint32_t threads);
+
 	void SortData();
+
+	// Findings go to the diagnostics, true when none of them is an error
 	bool Validate(void);
+	bool Revalidate(void);
+
+	ldfstrings *GetStrings();
 
 	lin_protocol_version_e GetLinProtocolVersion();
 	void SetLinProtocolVersion(lin_protocol_version_e v);
@@ -151,10 +215,20 @@ public:
 	void UpdateScheduleTable(const uint8_t *old_schedule_table_name, ldfscheduletable *t);
 	void DeleteScheduleTable(const uint8_t *schedule_table_name);
 
-	uint32_t GetValidationMessagesCount();
-	const uint8_t *GetValidationMessageByIndex(uint32_t ix);
+	ldfencodingtype *GetEncodingTypeByIndex(uint32_t ix);
+	ldfencodingtype *GetEncodingTypeByName(const uint8_t *name);
+	uint32_t GetEncodingTypesCount();
+	ldfencodingsignals *GetEncodingSignalsByIndex(uint32_t ix);
+	uint32_t GetEncodingSignalsCount();
 
+	ldfdiagnostics *GetDiagnostics();
+	ldfreferences *GetReferences();
+
+	void ToLdfFile(ldfwriter *w);
 	bool Save(const uint8_t *filename);
+	bool Save(int fd);
+
+	void GetMemoryFootprint(ldf_footprint_s *footprint);
 
 };
 
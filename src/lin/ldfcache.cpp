@@ -0,0 +1,734 @@
+/*
+ * ldfcache.cpp
+ *
+ *  Created on: 13 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <ldfcommon.h>
+#include <ldfcache.h>
+
+
+#define LDFC_MAGIC					"LDFC"
+#define LDFC_VERSION				3
+#define LDFC_NO_STRING				0xFFFFFFFF
+
+
+using namespace std;
+
+
+namespace lin {
+
+struct ldfcache_header_s
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t source_size;
+	int64_t source_mtime;
+	uint64_t source_hash;
+	uint32_t strings_size;
+	uint32_t records_size;
+};
+
+struct ldfcache_writer_s
+{
+	uint8_t *records;
+	size_t records_size;
+	size_t records_capacity;
+	char *strings;
+	size_t strings_size;
+	size_t strings_capacity;
+	unordered_map<string, uint32_t> ids;
+};
+
+struct ldfcache_reader_s
+{
+	const uint8_t *p;
+	const uint8_t *end;
+	const char *strings;
+	uint32_t strings_size;
+	bool ok;
+};
+
+
+static void Append(uint8_t **buffer, size_t *size, size_t *capacity, const void *v, size_t n)
+{
+	if (*size + n > *capacity)
+	{
+		*capacity = (*capacity == 0) ? 65536 : *capacity;
+		while (*size + n > *capacity) *capacity *= 2;
+		*buffer = (uint8_t *)realloc(*buffer, *capacity);
+	}
+
+	memcpy(*buffer + *size, v, n);
+	*size += n;
+}
+
+static void PutBytes(ldfcache_writer_s *w, const void *v, size_t n)
+{
+	Append(&w->records, &w->records_size, &w->records_capacity, v, n);
+}
+
+static void PutU8(ldfcache_writer_s *w, uint8_t v) { PutBytes(w, &v, sizeof(v)); }
+static void PutU16(ldfcache_writer_s *w, uint16_t v) { PutBytes(w, &v, sizeof(v)); }
+static void PutU32(ldfcache_writer_s *w, uint32_t v) { PutBytes(w, &v, sizeof(v)); }
+static void PutF32(ldfcache_writer_s *w, float v) { PutBytes(w, &v, sizeof(v)); }
+
+static void PutStr(ldfcache_writer_s *w, const uint8_t *s)
+{
+	uint32_t id = LDFC_NO_STRING;
+
+	if (s != NULL)
+	{
+		// Every distinct identifier is stored once, references point to its offset
+		auto it = w->ids.find((const char *)s);
+		if (it == w->ids.end())
+		{
+			id = w->strings_size;
+			Append((uint8_t **)&w->strings, &w->strings_size, &w->strings_capacity, s, strlen((const char *)s) + 1);
+			w->ids[(const char *)s] = id;
+		}
+		else
+		{
+			id = it->second;
+		}
+	}
+
+	PutU32(w, id);
+}
+
+static void GetBytes(ldfcache_reader_s *r, void *v, size_t n)
+{
+	if (!r->ok || (size_t)(r->end - r->p) < n)
+	{
+		r->ok = false;
+		memset(v, 0, n);
+		return;
+	}
+
+	memcpy(v, r->p, n);
+	r->p += n;
+}
+
+static uint8_t GetU8(ldfcache_reader_s *r) { uint8_t v; GetBytes(r, &v, sizeof(v)); return v; }
+static uint16_t GetU16(ldfcache_reader_s *r) { uint16_t v; GetBytes(r, &v, sizeof(v)); return v; }
+static uint32_t GetU32(ldfcache_reader_s *r) { uint32_t v; GetBytes(r, &v, sizeof(v)); return v; }
+static float GetF32(ldfcache_reader_s *r) { float v; GetBytes(r, &v, sizeof(v)); return v; }
+
+static const uint8_t *GetStr(ldfcache_reader_s *r)
+{
+	uint32_t id = GetU32(r);
+
+	if (id == LDFC_NO_STRING)
+		return NULL;
+
+	if (id >= r->strings_size)
+	{
+		r->ok = false;
+		return NULL;
+	}
+
+	return Str(r->strings + id);
+}
+
+static bool CheckCount(ldfcache_reader_s *r, uint32_t n)
+{
+	// Every record takes at least 4 bytes, so bogus counts are rejected before allocating
+	return r->ok && n <= (size_t)(r->end - r->p) / 4;
+}
+
+static int64_t GetMtime(const struct stat *st)
+{
+	return (int64_t)st->st_mtim.tv_sec * 1000000000LL + st->st_mtim.tv_nsec;
+}
+
+uint64_t ldfcache::Hash(const uint8_t *data, size_t size)
+{
+	uint64_t h = 0xCBF29CE484222325ULL ^ size;
+	uint64_t w;
+	size_t i;
+
+	// Fold the file 8 bytes at a time
+	for (i = 0; i + 8 <= size; i += 8)
+	{
+		memcpy(&w, data + i, 8);
+		h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+		h ^= h >> 29;
+	}
+
+	// Fold the tail
+	for (; i < size; i++)
+	{
+		h = (h ^ data[i]) * 0x100000001B3ULL;
+	}
+
+	return h ^ (h >> 32);
+}
+
+bool ldfcache::HashFile(const char *filename, uint64_t *hash)
+{
+	struct stat st;
+	void *p;
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	if (st.st_size == 0)
+	{
+		*hash = Hash(NULL, 0);
+		close(fd);
+		return true;
+	}
+
+	p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		return false;
+
+	*hash = Hash((const uint8_t *)p, st.st_size);
+	munmap(p, st.st_size);
+
+	return true;
+}
+
+void ldfcache::GetCacheFilename(const uint8_t *filename, char *cache_filename, size_t size)
+{
+	snprintf(cache_filename, size, "%sc", (const char *)filename);
+}
+
+ldf *ldfcache::Read(const uint8_t *image, size_t size)
+{
+	ldfcache_header_s h;
+	ldfcache_reader_s r;
+	uint32_t i, j, n, m;
+	ldf *db;
+
+	// Check header and string table, strings shall be NUL terminated inside the table
+	if (size < sizeof(h)) return NULL;
+	memcpy(&h, image, sizeof(h));
+	if (sizeof(h) + (size_t)h.strings_size + h.records_size != size) return NULL;
+	if (h.strings_size > 0 && image[sizeof(h) + h.strings_size - 1] != 0) return NULL;
+
+	r.strings = (const char *)image + sizeof(h);
+	r.strings_size = h.strings_size;
+	r.p = image + sizeof(h) + h.strings_size;
+	r.end = r.p + h.records_size;
+	r.ok = true;
+
+	db = new ldf();
+
+	// Global parameters
+	db->is_lin_description_file = GetU8(&r) != 0;
+	db->lin_protocol_version = (lin_protocol_version_e)GetU8(&r);
+	db->lin_language_version = (lin_language_version_e)GetU8(&r);
+	db->lin_speed = GetU32(&r);
+
+	// Master node
+	if (GetU8(&r) != 0)
+	{
+		const uint8_t *name = GetStr(&r);
+		uint16_t timebase = GetU16(&r);
+		uint16_t jitter = GetU16(&r);
+		db->master = new ldfmasternode(&db->strings, name, timebase, jitter);
+	}
+
+	// Slave nodes
+	n = GetU32(&r);
+	r.ok = CheckCount(&r, n);
+	for (i = 0; r.ok && i < n; i++)
+	{
+		ArrayAppend(&db->slaves, &db->slaves_count, &db->slaves_capacity, new ldfnode(&db->strings, GetStr(&r)));
+	}
+
+	// Signals
+	n = GetU32(&r);
+	r.ok = CheckCount(&r, n);
+	for (i = 0; r.ok && i < n; i++)
+	{
+		const uint8_t **subscribers;
+		const uint8_t *name = GetStr(&r);
+		uint8_t bit_size = GetU8(&r);
+		uint32_t default_value = GetU32(&r);
+		const uint8_t *publisher = GetStr(&r);
+
+		m = GetU32(&r);
+		r.ok = CheckCount(&r, m);
+		if (!r.ok) break;
+		subscribers = (const uint8_t **)malloc(m * sizeof(subscribers[0]));
+		for (j = 0; r.ok && j < m; j++)
+			subscribers[j] = GetStr(&r);
+
+		if (r.ok) ArrayAppend(&db->signals, &db->signals_count, &db->signals_capacity, new ldfsignal(&db->strings, name, bit_size, default_value, publisher, subscribers, m));
+		free(subscribers);
+	}
+
+	// Frames and frame signals
+	n = GetU32(&r);
+	r.ok = CheckCount(&r, n);
+	for (i = 0; r.ok && i < n; i++)
+	{
+		const uint8_t *name = GetStr(&r);
+		uint8_t id = GetU8(&r);
+		const uint8_t *publisher = GetStr(&r);
+		uint8_t frame_size = GetU8(&r);
+		ldfframe *f = new ldfframe(&db->strings, name, id, publisher, frame_size);
+
+		ArrayAppend(&db->frames, &db->frames_count, &db->frames_capacity, f);
+		m = GetU32(&r);
+		for (j = 0; r.ok && j < m; j++)
+		{
+			const uint8_t *signal_name = GetStr(&r);
+			uint16_t offset = GetU16(&r);
+			if (r.ok) f->AddSignal(new ldfframesignal(&db->strings, signal_name, offset));
+		}
+	}
+
+	// Node attributes
+	n = GetU32(&r);
+	r.ok = CheckCount(&r, n);
+	for (i = 0; r.ok && i < n; i++)
+	{
+		ldfnodeattributes *a = new ldfnodeattributes(&db->strings, GetStr(&r));
+
+		ArrayAppend(&db->node_attributes, &db->node_attributes_count, &db->node_attributes_capacity, a);
+		a->SetProtocolVersion((lin_protocol_version_e)GetU8(&r));
+		a->SetConfiguredNAD(GetU8(&r));
+		a->SetInitialNAD(GetU8(&r));
+		a->SetSupplierID(GetU16(&r));
+		a->SetFunctionID(GetU16(&r));
+		a->SetVariant(GetU8(&r));
+		a->SetResponseErrorSignalName(GetStr(&r));
+		m = GetU32(&r);
+		for (j = 0; r.ok && j < m; j++)
+		{
+			const uint8_t *signal_name = GetStr(&r);
+			if (r.ok) a->AddFaultStateSignal(signal_name);
+		}
+		a->SetP2_min(GetU16(&r));
+		a->SetST_min(GetU16(&r));
+		a->SetN_As_timeout(GetU16(&r));
+		a->SetN_Cr_timeout(GetU16(&r));
+		m = GetU32(&r);
+		for (j = 0; r.ok && j < m; j++)
+		{
+			const uint8_t *frame_name = GetStr(&r);
+			uint8_t id = GetU8(&r);
+			if (r.ok) a->AddConfigurableFrame(new ldfconfigurableframe(&db->strings, frame_name, id));
+		}
+	}
+
+	// Schedule tables
+	n = GetU32(&r);
+	r.ok = CheckCount(&r, n);
+	for (i = 0; r.ok && i < n; i++)
+	{
+		ldfscheduletable *t = new ldfscheduletable(&db->strings, GetStr(&r));
+
+		ArrayAppend(&db->schedule_tables, &db->schedule_tables_count, &db->schedule_tables_capacity, t);
+		m = GetU32(&r);
+		for (j = 0; r.ok && j < m; j++)
+		{
+			uint8_t data[8];
+			ldfschedulecommand::ldfschedulecommandtype_t type = (ldfschedulecommand::ldfschedulecommandtype_t)GetU8(&r);
+			const uint8_t *frame_name = GetStr(&r);
+			uint16_t timeout = GetU16(&r);
+			const uint8_t *slave_name = GetStr(&r);
+			GetBytes(&r, data, sizeof(data));
+			const uint8_t *assign_frame_name = GetStr(&r);
+			if (r.ok) t->AddCommand(new ldfschedulecommand(&db->strings, type, frame_name, timeout, slave_name, data, assign_frame_name));
+		}
+	}
+
+	// Encoding types
+	n = GetU32(&r);
+	r.ok = CheckCount(&r, n);
+	for (i = 0; r.ok && i < n; i++)
+	{
+		ldfencodingtype *e = new ldfencodingtype(&db->strings, GetStr(&r));
+
+		ArrayAppend(&db->encoding_types, &db->encoding_types_count, &db->encoding_types_capacity, e);
+		e->SetTreatAsBcd(GetU8(&r) != 0);
+		e->SetTreatAsAscii(GetU8(&r) != 0);
+		if (GetU8(&r) != 0)
+		{
+			float min = GetF32(&r);
+			float max = GetF32(&r);
+			float scale = GetF32(&r);
+			float offset = GetF32(&r);
+			const uint8_t *description = GetStr(&r);
+			if (r.ok) e->SetPhysicalValue(new ldfphysicalvalue(&db->strings, min, max, scale, offset, description));
+		}
+		m = GetU32(&r);
+		for (j = 0; r.ok && j < m; j++)
+		{
+			uint32_t value = GetU32(&r);
+			const uint8_t *description = GetStr(&r);
+			if (r.ok) e->AddLogicalValue(new ldflogicalvalue(&db->strings, value, description));
+		}
+	}
+
+	// Signal representations
+	n = GetU32(&r);
+	r.ok = CheckCount(&r, n);
+	for (i = 0; r.ok && i < n; i++)
+	{
+		ldfencodingsignals *e = new ldfencodingsignals(&db->strings, GetStr(&r));
+
+		ArrayAppend(&db->encoding_signals, &db->encoding_signals_count, &db->encoding_signals_capacity, e);
+		m = GetU32(&r);
+		for (j = 0; r.ok && j < m; j++)
+		{
+			const uint8_t *signal_name = GetStr(&r);
+			if (r.ok) e->AddSignal(signal_name);
+		}
+	}
+
+	// Validation findings, so the database is not validated again
+	n = GetU32(&r);
+	r.ok = CheckCount(&r, n);
+	for (i = 0; r.ok && i < n; i++)
+	{
+		uint8_t code = GetU8(&r);
+		const uint8_t *entity = GetStr(&r);
+		const uint8_t *argument = GetStr(&r);
+		uint32_t value = GetU32(&r);
+		uint32_t occurrences = GetU32(&r);
+
+		r.ok = r.ok && code < ldfdiagnostics::LDF_DIAG_CODES_COUNT;
+		if (r.ok) db->diagnostics.Add((ldfdiagnostics::ldfdiagnosticcode_e)code, db->strings.Intern(entity), db->strings.Intern(argument), value, occurrences);
+	}
+	db->diagnostics.AddDropped(GetU32(&r));
+
+	// Drop partial databases
+	if (!r.ok || r.p != r.end)
+	{
+		delete db;
+		return NULL;
+	}
+
+	db->BuildIndexes();
+	db->BuildReferences();
+
+	return db;
+}
+
+ldf *ldfcache::Load(const uint8_t *filename)
+{
+	bool stored;
+
+	return Load(filename, &stored);
+}
+
+ldf *ldfcache::Load(const uint8_t *filename, bool *stored)
+{
+	ldf *db = LoadCache(filename, stored);
+
+	// Parse text database only when the cache is missing or outdated
+	if (db == NULL)
+	{
+		db = new ldf(filename);
+		*stored = Store(db, filename);
+	}
+
+	return db;
+}
+
+ldf *ldfcache::LoadCache(const uint8_t *filename)
+{
+	bool stored;
+
+	return LoadCache(filename, &stored);
+}
+
+ldf *ldfcache::LoadCache(const uint8_t *filename, bool *stored)
+{
+	char cache_filename[10000];
+	struct stat source_st;
+	struct stat cache_st;
+	ldfcache_header_s h;
+	uint64_t hash;
+	bool touched = false;
+	ldf *db = NULL;
+	void *p;
+
+	// Check source file
+	*stored = true;
+	if (stat((const char *)filename, &source_st) != 0)
+		return NULL;
+
+	// Map cache file
+	GetCacheFilename(filename, cache_filename, sizeof(cache_filename));
+	int fd = open(cache_filename, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	if (fstat(fd, &cache_st) != 0 || (size_t)cache_st.st_size < sizeof(h))
+	{
+		close(fd);
+		return NULL;
+	}
+	p = mmap(NULL, cache_st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		return NULL;
+
+	// Check the cache belongs to this version of the source file, hash it only when its time stamp changed
+	memcpy(&h, p, sizeof(h));
+	if (memcmp(h.magic, LDFC_MAGIC, sizeof(h.magic)) == 0 &&
+		h.version == LDFC_VERSION &&
+		h.source_size == (uint64_t)source_st.st_size &&
+		(h.source_mtime == GetMtime(&source_st) ||
+		(touched = (HashFile((const char *)filename, &hash) && hash == h.source_hash))))
+	{
+		db = Read((const uint8_t *)p, cache_st.st_size);
+	}
+
+	munmap(p, cache_st.st_size);
+
+	// Same text with a new time stamp, keep the new one so the next load skips the hash.
+	// A cache that cannot be updated is still valid, it is only hashed again
+	if (db != NULL && touched)
+	{
+		int64_t mtime = GetMtime(&source_st);
+
+		fd = open(cache_filename, O_WRONLY);
+		if (fd < 0)
+		{
+			*stored = false;
+		}
+		else
+		{
+			if (pwrite(fd, &mtime, sizeof(mtime), offsetof(ldfcache_header_s, source_mtime)) != sizeof(mtime))
+				*stored = false;
+			close(fd);
+		}
+	}
+
+	return db;
+}
+
+bool ldfcache::Store(ldf *db, const uint8_t *filename)
+{
+	char cache_filename[10000];
+	char temp_filename[sizeof(cache_filename) + 8];
+	struct stat source_st;
+	ldfcache_header_s h;
+	ldfcache_writer_s w;
+	uint32_t i, j;
+	bool ok;
+
+	// Identify source file
+	if (stat((const char *)filename, &source_st) != 0)
+		return false;
+
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, LDFC_MAGIC, sizeof(h.magic));
+	h.version = LDFC_VERSION;
+	h.source_size = source_st.st_size;
+	h.source_mtime = GetMtime(&source_st);
+	if (!HashFile((const char *)filename, &h.source_hash))
+		return false;
+
+	w.records = NULL;
+	w.records_size = 0;
+	w.records_capacity = 0;
+	w.strings = NULL;
+	w.strings_size = 0;
+	w.strings_capacity = 0;
+
+	// Global parameters
+	PutU8(&w, db->is_lin_description_file);
+	PutU8(&w, db->lin_protocol_version);
+	PutU8(&w, db->lin_language_version);
+	PutU32(&w, db->lin_speed);
+
+	// Master node
+	PutU8(&w, db->master != NULL);
+	if (db->master != NULL)
+	{
+		PutStr(&w, db->master->GetName());
+		PutU16(&w, db->master->GetTimebase());
+		PutU16(&w, db->master->GetJitter());
+	}
+
+	// Slave nodes
+	PutU32(&w, db->slaves_count);
+	for (i = 0; i < db->slaves_count; i++)
+		PutStr(&w, db->slaves[i]->GetName());
+
+	// Signals
+	PutU32(&w, db->signals_count);
+	for (i = 0; i < db->signals_count; i++)
+	{
+		ldfsignal *s = db->signals[i];
+
+		PutStr(&w, s->GetName());
+		PutU8(&w, s->GetBitSize());
+		PutU32(&w, s->GetDefaultValue());
+		PutStr(&w, s->GetPublisher());
+		PutU32(&w, s->GetSubscribersCount());
+		for (j = 0; j < s->GetSubscribersCount(); j++)
+			PutStr(&w, s->GetSubscriber(j));
+	}
+
+	// Frames and frame signals
+	PutU32(&w, db->frames_count);
+	for (i = 0; i < db->frames_count; i++)
+	{
+		ldfframe *f = db->frames[i];
+
+		PutStr(&w, f->GetName());
+		PutU8(&w, f->GetId());
+		PutStr(&w, f->GetPublisher());
+		PutU8(&w, f->GetSize());
+		PutU32(&w, f->GetSignalsCount());
+		for (j = 0; j < f->GetSignalsCount(); j++)
+		{
+			PutStr(&w, f->GetSignal(j)->GetName());
+			PutU16(&w, f->GetSignal(j)->GetOffset());
+		}
+	}
+
+	// Node attributes
+	PutU32(&w, db->node_attributes_count);
+	for (i = 0; i < db->node_attributes_count; i++)
+	{
+		ldfnodeattributes *a = db->node_attributes[i];
+
+		PutStr(&w, a->GetName());
+		PutU8(&w, a->GetProtocolVersion());
+		PutU8(&w, a->GetConfiguredNAD());
+		PutU8(&w, a->GetInitialNAD());
+		PutU16(&w, a->GetSupplierID());
+		PutU16(&w, a->GetFunctionID());
+		PutU8(&w, a->GetVariant());
+		PutStr(&w, a->GetResponseErrorSignalName());
+		PutU32(&w, a->GetFaultStateSignalsCount());
+		for (j = 0; j < a->GetFaultStateSignalsCount(); j++)
+			PutStr(&w, a->GetFaultStateSignal(j));
+		PutU16(&w, a->GetP2_min());
+		PutU16(&w, a->GetST_min());
+		PutU16(&w, a->GetN_As_timeout());
+		PutU16(&w, a->GetN_Cr_timeout());
+		PutU32(&w, a->GetConfigurableFramesCount());
+		for (j = 0; j < a->GetConfigurableFramesCount(); j++)
+		{
+			PutStr(&w, a->GetConfigurableFrame(j)->GetName());
+			PutU8(&w, a->GetConfigurableFrame(j)->GetId());
+		}
+	}
+
+	// Schedule tables
+	PutU32(&w, db->schedule_tables_count);
+	for (i = 0; i < db->schedule_tables_count; i++)
+	{
+		ldfscheduletable *t = db->schedule_tables[i];
+
+		PutStr(&w, t->GetName());
+		PutU32(&w, t->GetCommandsCount());
+		for (j = 0; j < t->GetCommandsCount(); j++)
+		{
+			ldfschedulecommand *c = t->GetCommandByIndex(j);
+
+			PutU8(&w, c->GetType());
+			PutStr(&w, c->GetFrameName());
+			PutU16(&w, c->GetTimeoutMs());
+			PutStr(&w, c->GetSlaveName());
+			PutBytes(&w, c->GetData(), 8);
+			PutStr(&w, c->GetAssignFrameIdName());
+		}
+	}
+
+	// Encoding types
+	PutU32(&w, db->encoding_types_count);
+	for (i = 0; i < db->encoding_types_count; i++)
+	{
+		ldfencodingtype *e = db->encoding_types[i];
+		ldfphysicalvalue *pv = e->GetPhysicalValue();
+
+		PutStr(&w, e->GetName());
+		PutU8(&w, e->GetTreatAsBcd());
+		PutU8(&w, e->GetTreatAsAscii());
+		PutU8(&w, pv != NULL);
+		if (pv != NULL)
+		{
+			PutF32(&w, pv->GetMin());
+			PutF32(&w, pv->GetMax());
+			PutF32(&w, pv->GetScale());
+			PutF32(&w, pv->GetOffset());
+			PutStr(&w, pv->GetDescription());
+		}
+		PutU32(&w, e->GetLogicalValuesCount());
+		for (j = 0; j < e->GetLogicalValuesCount(); j++)
+		{
+			PutU32(&w, e->GetLogicalValue(j)->GetValue());
+			PutStr(&w, e->GetLogicalValue(j)->GetDescription());
+		}
+	}
+
+	// Signal representations
+	PutU32(&w, db->encoding_signals_count);
+	for (i = 0; i < db->encoding_signals_count; i++)
+	{
+		ldfencodingsignals *e = db->encoding_signals[i];
+
+		PutStr(&w, e->GetEncodingName());
+		PutU32(&w, e->GetSignalsCount());
+		for (j = 0; j < e->GetSignalsCount(); j++)
+			PutStr(&w, e->GetSignal(j));
+	}
+
+	// Validation findings
+	PutU32(&w, db->diagnostics.GetCount());
+	for (i = 0; i < db->diagnostics.GetCount(); i++)
+	{
+		PutU8(&w, db->diagnostics.GetCode(i));
+		PutStr(&w, db->diagnostics.GetEntity(i));
+		PutStr(&w, db->diagnostics.GetArgument(i));
+		PutU32(&w, db->diagnostics.GetValue(i));
+		PutU32(&w, db->diagnostics.GetOccurrences(i));
+	}
+	PutU32(&w, db->diagnostics.GetDroppedCount());
+
+	h.strings_size = w.strings_size;
+	h.records_size = w.records_size;
+
+	// Write a temporary file and move it over the cache, so readers never see a partial image
+	GetCacheFilename(filename, cache_filename, sizeof(cache_filename));
+	snprintf(temp_filename, sizeof(temp_filename), "%s.XXXXXX", cache_filename);
+	int fd = mkstemp(temp_filename);
+	ok = fd >= 0;
+	if (ok)
+	{
+		fchmod(fd, 0644);
+		ok = write(fd, &h, sizeof(h)) == (ssize_t)sizeof(h);
+		ok = ok && (w.strings_size == 0 || write(fd, w.strings, w.strings_size) == (ssize_t)w.strings_size);
+		ok = ok && (w.records_size == 0 || write(fd, w.records, w.records_size) == (ssize_t)w.records_size);
+		ok = (close(fd) == 0) && ok;
+		ok = ok && rename(temp_filename, cache_filename) == 0;
+		if (!ok) unlink(temp_filename);
+	}
+
+	free(w.records);
+	free(w.strings);
+
+	return ok;
+}
+
+} /* namespace lin */
@@ -0,0 +1,49 @@
+/*
+ * ldfcache.h
+ *
+ *  Created on: 13 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LDFCACHE_H_
+#define LIN_LDFCACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ldf.h>
+
+
+namespace lin {
+
+/*
+ * Precompiled binary image of a parsed and validated database (.ldfc).
+ * The image lives next to the text file ("database.ldf" -> "database.ldfc")
+ * and is keyed by the size, modification time and hash of the text file, so
+ * it is only trusted while the text file is unchanged. When only the time
+ * changed and the hash still matches, the time is updated in the image so the
+ * next load does not hash the text file again.
+ */
+class ldfcache {
+
+private:
+	static uint64_t Hash(const uint8_t *data, size_t size);
+	static bool HashFile(const char *filename, uint64_t *hash);
+	static void GetCacheFilename(const uint8_t *filename, char *cache_filename, size_t size);
+	static ldf *Read(const uint8_t *image, size_t size);
+
+public:
+	static ldf *Load(const uint8_t *filename);
+
+	// Same as Load(), stored tells whether the cache is up to date afterwards
+	static ldf *Load(const uint8_t *filename, bool *stored);
+	static ldf *LoadCache(const uint8_t *filename);
+
+	// Same as LoadCache(), stored is false when a new time stamp could not be written to the image
+	static ldf *LoadCache(const uint8_t *filename, bool *stored);
+	static bool Store(ldf *db, const uint8_t *filename);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LDFCACHE_H_ */
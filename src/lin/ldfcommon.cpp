@@ -6,14 +6,24 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "ldfcommon.h"
-#include "tools.h"
 
-using namespace tools;
+#define ARR_SIZE(A)				(sizeof(A) / sizeof(A[0]))
 
 static const char *lin_protocol_ids[] = { NULL, "1", "0" };
 static const char *lin_language_ids[] = { NULL, "1", "0" };
 
+// Index of an ID, NULL IDs match the NULL entry. Returns ids_count if not found.
+static uint32_t GetStrIndexByID(const char **ids, uint32_t ids_count, const char *id)
+{
+	for (uint32_t i = 0; i < ids_count; i++)
+		if (ids[i] == id || (ids[i] != NULL && id != NULL && strcmp(ids[i], id) == 0))
+			return i;
+
+	return ids_count;
+}
+
 namespace lin
 {
 
@@ -53,6 +63,10 @@ bool StrEq(const uint8_t *a, const uint8_t *b)
 	if (a == NULL || b == NULL)
 		return false;
 
+	// Interned names are the same pointer
+	if (a == b)
+		return true;
+
 	return strcmp((char *)a, (char *)b) == 0;
 }
 
@@ -82,10 +96,10 @@ uint8_t *StrDup(const uint8_t *a)
 	return StrDup((const char *)a);
 }
 
-char *StrTokenParseFirst(char *p, char **p_token, const char *tokenizers)
+char *StrTokenParseFirst(char *p, char **p_token, const char *tokenizers, char **save)
 {
 	if (p == NULL) return NULL;
-	p = strtok(p, tokenizers);
+	p = strtok_r(p, tokenizers, save);
 	if (p_token != NULL)
 	{
 		*p_token = p;
@@ -93,10 +107,10 @@ char *StrTokenParseFirst(char *p, char **p_token, const char *tokenizers)
 	return p;
 }
 
-char *StrTokenParseNext(char *p, char **p_token, const char *tokenizers)
+char *StrTokenParseNext(char *p, char **p_token, const char *tokenizers, char **save)
 {
 	if (p == NULL) return NULL;
-	p = strtok(NULL, tokenizers);
+	p = strtok_r(NULL, tokenizers, save);
 	if (p_token != NULL)
 	{
 		*p_token = p;
@@ -104,19 +118,19 @@ char *StrTokenParseNext(char *p, char **p_token, const char *tokenizers)
 	return p;
 }
 
-char *StrTokenParseFirstAndCheck(char *p, const char *token, const char *tokenizers)
+char *StrTokenParseFirstAndCheck(char *p, const char *token, const char *tokenizers, char **save)
 {
 	char *parsed;
 
-	p = StrTokenParseFirst(p, &parsed, tokenizers);
+	p = StrTokenParseFirst(p, &parsed, tokenizers, save);
 	if (p == NULL) return NULL;
 
 	return StrEq(p, token) ? p : NULL;
 }
 
-char *StrTokenParseNextAndCheck(char *p, const char *token, const char *tokenizers)
+char *StrTokenParseNextAndCheck(char *p, const char *token, const char *tokenizers, char **save)
 {
-	p = StrTokenParseNext(p, NULL, tokenizers);
+	p = StrTokenParseNext(p, NULL, tokenizers, save);
 
 	return StrEq(p, token) ? p : NULL;
 }
@@ -9,6 +9,7 @@
 #define LIN_LDFCOMMON_H_
 
 #include <stdint.h>
+#include <stdlib.h>
 
 
 #define BLANK_CHARACTERS					" \t\r\n"
@@ -46,12 +47,26 @@ bool StrEq(const char *a, const uint8_t *b);
 bool StrEq(const char *a, const char *b);
 uint8_t *StrDup(const char *a);
 uint8_t *StrDup(const uint8_t *a);
-char *StrTokenParseFirst(char *p, char **p_token, const char *tokenizers);
-char *StrTokenParseNext(char *p, char **p_token, const char *tokenizers);
-char *StrTokenParseFirstAndCheck(char *p, const char *token, const char *tokenizers);
-char *StrTokenParseNextAndCheck(char *p, const char *token, const char *tokenizers);
+char *StrTokenParseFirst(char *p, char **p_token, const char *tokenizers, char **save);
+char *StrTokenParseNext(char *p, char **p_token, const char *tokenizers, char **save);
+char *StrTokenParseFirstAndCheck(char *p, const char *token, const char *tokenizers, char **save);
+char *StrTokenParseNextAndCheck(char *p, const char *token, const char *tokenizers, char **save);
 inline const uint8_t *Str(const char *c) { return (const uint8_t *)c; }
 
+/*
+ * Appends an item to a heap array of pointers, doubling its capacity when it is
+ * full. Arrays start as NULL with count and capacity 0 and are released with free().
+ */
+template <typename T, typename U> void ArrayAppend(T **array, uint32_t *count, uint32_t *capacity, U item)
+{
+	if (*count == *capacity)
+	{
+		*capacity = (*capacity == 0) ? 4 : 2 * *capacity;
+		*array = (T *)realloc(*array, *capacity * sizeof(T));
+	}
+	(*array)[(*count)++] = item;
+}
+
 }
 
 #endif /* LIN_LDFCOMMON_H_ */
@@ -13,32 +13,32 @@
 
 namespace lin {
 
-ldfconfigurableframe::ldfconfigurableframe(const uint8_t *name, uint8_t id)
+ldfconfigurableframe::ldfconfigurableframe(ldfstrings *strings, const uint8_t *name, uint8_t id)
 {
-	this->name = StrDup(name);
+	this->name = strings->Intern(name);
 	this->id = id;
 }
 
 ldfconfigurableframe::~ldfconfigurableframe()
 {
-	if (name) delete name;
 }
 
-ldfconfigurableframe *ldfconfigurableframe::FromLdfStatement(uint8_t *statement)
+ldfconfigurableframe *ldfconfigurableframe::FromLdfStatement(ldfstrings *strings, uint8_t *statement)
 {
 	char *p;
+	char *save = NULL;
 	char *name = NULL;
 	uint8_t id = 0xFF;
 
-	p = strtok((char *) statement, "=" BLANK_CHARACTERS);
+	p = strtok_r((char *) statement, "=" BLANK_CHARACTERS, &save);
 	if (p) name = p;
 
-	if (p) p = strtok(NULL, "=" BLANK_CHARACTERS);
+	if (p) p = strtok_r(NULL, "=" BLANK_CHARACTERS, &save);
 	if (p) id = ParseInt(p);
 
 	if (name)
 	{
-		return new ldfconfigurableframe(Str(name), id);
+		return new ldfconfigurableframe(strings, Str(name), id);
 	}
 	else
 	{
@@ -69,29 +69,25 @@ uint8_t ldfconfigurableframe::GetId()
 	return id;
 }
 
-void ldfconfigurableframe::ValidateUnicity(uint8_t *attributes, ldfconfigurableframe *frame, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfconfigurableframe::ValidateUnicity(uint8_t *attributes, ldfconfigurableframe *frame, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
-	if (StrEq((char *)name, (char *)frame->name))
+	if (NameEq(name, frame->name))
 	{
-		sprintf(str, STR_ERR "Node_attributes '%s' configurable frame name '%s' repeated.", attributes, name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_NODE_FRAME_NAME_REPEATED, attributes, name, 0);
 	}
 
-	if (id == frame->id)
+	// LIN 2.1 configurable frames have no message ID, they are kept as 0xFF
+	if (id != 0xFF && id == frame->id)
 	{
-		sprintf(str, STR_ERR "Node_attributes '%s' configurable frame ID 0x%X repeated.", attributes, id);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_NODE_FRAME_ID_REPEATED, attributes, NULL, id);
 	}
 }
 
 void ldfconfigurableframe::UpdateName(const uint8_t *old_frame_name, const uint8_t *new_frame_name)
 {
-	if (StrEq((char *)name, (char *)old_frame_name))
+	if (NameEq(name, old_frame_name))
 	{
-		delete name;
-		name = StrDup(new_frame_name);
+		name = (uint8_t *)new_frame_name;
 	}
 }
 
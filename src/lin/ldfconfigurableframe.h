@@ -9,6 +9,8 @@
 #define LIN_LDFCONFIGURABLEFRAME_H_
 
 #include <stdint.h>
+#include <ldfstrings.h>
+#include <ldfdiagnostics.h>
 
 namespace lin {
 
@@ -19,16 +21,16 @@ private:
 	uint8_t id;
 
 public:
-	ldfconfigurableframe(const uint8_t *name, uint8_t id);
+	ldfconfigurableframe(ldfstrings *strings, const uint8_t *name, uint8_t id);
 	virtual ~ldfconfigurableframe();
 
-	static ldfconfigurableframe *FromLdfStatement(uint8_t *statement);
+	static ldfconfigurableframe *FromLdfStatement(ldfstrings *strings, uint8_t *statement);
 	static int32_t SorterConfigurableFrames(const void *a, const void *b);
 
 	uint8_t *GetName();
 	uint8_t GetId();
 
-	void ValidateUnicity(uint8_t *attributes, ldfconfigurableframe *frame, uint8_t **validation_messages, uint32_t *validation_messages_count);
+	void ValidateUnicity(uint8_t *attributes, ldfconfigurableframe *frame, ldfdiagnostics *diagnostics);
 	void UpdateName(const uint8_t *old_frame_name, const uint8_t *new_frame_name);
 
 };
@@ -0,0 +1,325 @@
+/*
+ * ldfdiagnostics.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ldfcommon.h>
+#include <ldfdiagnostics.h>
+
+
+#define LDFDIAGNOSTICS_MAX_COUNT			10000
+#define LDFDIAGNOSTICS_TABLE_SIZE			64
+
+
+namespace lin {
+
+// Order of the parameters in the text of a rule: entity (E), argument (A) and value (V)
+enum diagnostic_layout_e
+{
+	LAYOUT_NONE,
+	LAYOUT_E,
+	LAYOUT_A,
+	LAYOUT_AE,
+	LAYOUT_EA,
+	LAYOUT_EV,
+	LAYOUT_VEA
+};
+
+// Findings that do not stop the cluster from running are warnings: undefined
+// listeners, attributes of unknown nodes, frames polled twice by a table
+static const struct
+{
+	ldfdiagnostics::ldfdiagnosticseverity_e severity;
+	ldfdiagnostics::ldfdiagnosticentity_e entity;
+	diagnostic_layout_e layout;
+	const char *format;
+} rules[ldfdiagnostics::LDF_DIAG_CODES_COUNT] =
+{
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_DATABASE, LAYOUT_NONE, "Not a LIN definition file" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_DATABASE, LAYOUT_NONE, "Protocol version not supported" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_DATABASE, LAYOUT_NONE, "Language version not supported" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_DATABASE, LAYOUT_NONE, "LIN speed no defined" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_DATABASE, LAYOUT_NONE, "LIN master not found in database" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_DATABASE, LAYOUT_NONE, "LIN slaves not found in database" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL, LAYOUT_A, "Publisher '%s' not defined in database" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_WARNING, ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL, LAYOUT_A, "Subscriber '%s' not defined in database" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_SIGNAL, LAYOUT_E, "Signal '%s' is defined twice" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, LAYOUT_AE, "Publisher node '%s' assigned to frame '%s' is not defined." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, LAYOUT_E, "Frame name '%s' used in two different frame definitions." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, LAYOUT_VEA, "Frame ID 0x'%X' used in two different frames: '%s' and '%s'." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, LAYOUT_EV, "Frame '%s' size %d incorrect." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, LAYOUT_AE, "Signal '%s' used in frame '%s' not defined." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, LAYOUT_AE, "Signal name '%s' used twice in frame '%s'." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, LAYOUT_AE, "Signal '%s' used in frame '%s' outside of frame boundaries." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_FRAME, LAYOUT_AE, "Signal '%s' used in frame '%s' overlapping previous signal." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_WARNING, ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, LAYOUT_E, "Node_attributes '%s' protocol not defined." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_WARNING, ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, LAYOUT_E, "Node_attributes '%s' node not defined in database's slaves" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, LAYOUT_E, "Node_attributes '%s' node defined twice" },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, LAYOUT_EA, "Node_attributes '%s' configurable frame '%s' not defined." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, LAYOUT_EA, "Node_attributes '%s' configurable frame name '%s' repeated." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_NODE_ATTRIBUTES, LAYOUT_EV, "Node_attributes '%s' configurable frame ID 0x%X repeated." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE, LAYOUT_E, "Schedule table name '%s' repeated." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE, LAYOUT_EA, "Schedule table '%s' command frame '%s' not defined." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_WARNING, ldfdiagnostics::LDF_DIAG_ENTITY_SCHEDULE_TABLE, LAYOUT_EA, "Schedule table '%s' schedule command frame name '%s' repeated." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_ERROR, ldfdiagnostics::LDF_DIAG_ENTITY_ENCODING_SIGNALS, LAYOUT_E, "Encoding name '%s' repeated." },
+	{ ldfdiagnostics::LDF_DIAG_SEVERITY_WARNING, ldfdiagnostics::LDF_DIAG_ENTITY_ENCODING_SIGNALS, LAYOUT_EA, "Signal representation '%s' uses signal '%s' not defined." },
+};
+
+ldfdiagnostics::ldfdiagnostics()
+{
+	diagnostics = NULL;
+	diagnostics_count = 0;
+	diagnostics_capacity = 0;
+	dropped_count = 0;
+
+	// Table is allocated with the first finding, most validations raise none
+	table = NULL;
+	table_size = 0;
+}
+
+ldfdiagnostics::~ldfdiagnostics()
+{
+	free(diagnostics);
+	free(table);
+}
+
+uint32_t ldfdiagnostics::Hash(ldfdiagnosticcode_e code, const uint8_t *entity, const uint8_t *argument, uint32_t value)
+{
+	uint64_t h = (uint64_t)code;
+
+	h = (h ^ (uintptr_t)entity) * 0x9E3779B97F4A7C15ULL;
+	h = (h ^ (uintptr_t)argument) * 0x9E3779B97F4A7C15ULL;
+	h = (h ^ value) * 0x9E3779B97F4A7C15ULL;
+
+	return (uint32_t)(h >> 32);
+}
+
+void ldfdiagnostics::Rehash(uint32_t size)
+{
+	// Place all findings again in a table of the given size
+	free(table);
+	table_size = size;
+	table = (uint32_t *)calloc(table_size, sizeof(uint32_t));
+	for (uint32_t i = 0; i < diagnostics_count; i++)
+	{
+		diagnostic_s *d = &diagnostics[i];
+		uint32_t j = Hash(d->code, d->entity, d->argument, d->value) & (table_size - 1);
+
+		while (table[j] != 0) j = (j + 1) & (table_size - 1);
+		table[j] = i + 1;
+	}
+}
+
+void ldfdiagnostics::Grow()
+{
+	// Double the table
+	Rehash((table_size == 0) ? LDFDIAGNOSTICS_TABLE_SIZE : 2 * table_size);
+}
+
+void ldfdiagnostics::Add(ldfdiagnosticcode_e code, const uint8_t *entity, const uint8_t *argument, uint32_t value)
+{
+	Add(code, entity, argument, value, 1);
+}
+
+void ldfdiagnostics::Add(ldfdiagnosticcode_e code, const uint8_t *entity, const uint8_t *argument, uint32_t value, uint32_t occurrences)
+{
+	diagnostic_s d;
+	uint32_t i;
+
+	if (table == NULL)
+		Grow();
+
+	// Count repetitions of a known finding
+	for (i = Hash(code, entity, argument, value) & (table_size - 1); table[i] != 0; i = (i + 1) & (table_size - 1))
+	{
+		diagnostic_s *e = &diagnostics[table[i] - 1];
+
+		if (e->code == code && e->entity == entity && e->argument == argument && e->value == value)
+		{
+			e->occurrences += occurrences;
+			return;
+		}
+	}
+
+	// Drop new findings when the store is full
+	if (diagnostics_count >= LDFDIAGNOSTICS_MAX_COUNT)
+	{
+		dropped_count += occurrences;
+		return;
+	}
+
+	d.code = code;
+	d.value = value;
+	d.occurrences = occurrences;
+	d.entity = entity;
+	d.argument = argument;
+	ArrayAppend(&diagnostics, &diagnostics_count, &diagnostics_capacity, d);
+	table[i] = diagnostics_count;
+
+	// Keep load factor under 1/2
+	if (2 * diagnostics_count > table_size)
+		Grow();
+}
+
+void ldfdiagnostics::AddDropped(uint32_t count)
+{
+	dropped_count += count;
+}
+
+void ldfdiagnostics::Merge(ldfdiagnostics *diagnostics)
+{
+	for (uint32_t i = 0; i < diagnostics->diagnostics_count; i++)
+	{
+		diagnostic_s *d = &diagnostics->diagnostics[i];
+		Add(d->code, d->entity, d->argument, d->value, d->occurrences);
+	}
+
+	dropped_count += diagnostics->dropped_count;
+}
+
+void ldfdiagnostics::Remove(ldfdiagnosticentity_e entity_type, ldfindex *entities)
+{
+	uint32_t i, j;
+
+	// Drop findings raised on the entities, all of the type when there is no set, keeping the order of the rest
+	for (i = 0, j = 0; i < diagnostics_count; i++)
+	{
+		diagnostic_s *d = &diagnostics[i];
+
+		if (rules[d->code].entity == entity_type && (entities == NULL || entities->Get(d->entity) != NULL))
+			continue;
+
+		diagnostics[j++] = *d;
+	}
+
+	if (j == diagnostics_count)
+		return;
+
+	diagnostics_count = j;
+	Rehash(table_size);
+}
+
+void ldfdiagnostics::Clear()
+{
+	diagnostics_count = 0;
+	dropped_count = 0;
+	if (table != NULL) memset(table, 0, table_size * sizeof(uint32_t));
+}
+
+uint32_t ldfdiagnostics::GetCount()
+{
+	return diagnostics_count;
+}
+
+uint32_t ldfdiagnostics::GetDroppedCount()
+{
+	return dropped_count;
+}
+
+uint32_t ldfdiagnostics::GetCount(ldfdiagnosticseverity_e severity)
+{
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < diagnostics_count; i++)
+		if (rules[diagnostics[i].code].severity == severity)
+			count++;
+
+	return count;
+}
+
+uint32_t ldfdiagnostics::Find(uint32_t from, ldfdiagnosticseverity_e severity, const uint8_t *entity)
+{
+	// Look for the next finding at least as severe and, if given, about the entity
+	for (uint32_t i = from; i < diagnostics_count; i++)
+	{
+		diagnostic_s *d = &diagnostics[i];
+
+		if (rules[d->code].severity < severity)
+			continue;
+
+		if (entity == NULL || d->entity == entity || d->argument == entity)
+			return i;
+	}
+
+	return diagnostics_count;
+}
+
+ldfdiagnostics::ldfdiagnosticcode_e ldfdiagnostics::GetCode(uint32_t ix)
+{
+	return diagnostics[ix].code;
+}
+
+ldfdiagnostics::ldfdiagnosticseverity_e ldfdiagnostics::GetSeverity(uint32_t ix)
+{
+	return rules[diagnostics[ix].code].severity;
+}
+
+ldfdiagnostics::ldfdiagnosticentity_e ldfdiagnostics::GetEntityType(uint32_t ix)
+{
+	return rules[diagnostics[ix].code].entity;
+}
+
+const uint8_t *ldfdiagnostics::GetEntity(uint32_t ix)
+{
+	return diagnostics[ix].entity;
+}
+
+const uint8_t *ldfdiagnostics::GetArgument(uint32_t ix)
+{
+	return diagnostics[ix].argument;
+}
+
+uint32_t ldfdiagnostics::GetValue(uint32_t ix)
+{
+	return diagnostics[ix].value;
+}
+
+uint32_t ldfdiagnostics::GetOccurrences(uint32_t ix)
+{
+	return diagnostics[ix].occurrences;
+}
+
+const char *ldfdiagnostics::GetText(uint32_t ix, char *text, size_t size)
+{
+	diagnostic_s *d = &diagnostics[ix];
+	const char *e = (d->entity != NULL) ? (const char *)d->entity : "";
+	const char *a = (d->argument != NULL) ? (const char *)d->argument : "";
+	const char *format = rules[d->code].format;
+	int n;
+
+	// Severity prefix
+	switch (rules[d->code].severity)
+	{
+	case LDF_DIAG_SEVERITY_ERROR: n = snprintf(text, size, STR_ERR); break;
+	case LDF_DIAG_SEVERITY_WARNING: n = snprintf(text, size, STR_WARN); break;
+	default: n = 0; break;
+	}
+	if (n < 0 || (size_t)n >= size)
+		return text;
+
+	// Rule text
+	switch (rules[d->code].layout)
+	{
+	case LAYOUT_NONE: snprintf(text + n, size - n, "%s", format); break;
+	case LAYOUT_E: snprintf(text + n, size - n, format, e); break;
+	case LAYOUT_A: snprintf(text + n, size - n, format, a); break;
+	case LAYOUT_AE: snprintf(text + n, size - n, format, a, e); break;
+	case LAYOUT_EA: snprintf(text + n, size - n, format, e, a); break;
+	case LAYOUT_EV: snprintf(text + n, size - n, format, e, d->value); break;
+	case LAYOUT_VEA: snprintf(text + n, size - n, format, d->value, e, a); break;
+	}
+
+	return text;
+}
+
+size_t ldfdiagnostics::GetMemoryFootprint()
+{
+	return sizeof(*this) + diagnostics_capacity * sizeof(diagnostic_s) + table_size * sizeof(uint32_t);
+}
+
+} /* namespace lin */
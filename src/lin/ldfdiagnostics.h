@@ -0,0 +1,138 @@
+/*
+ * ldfdiagnostics.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LDFDIAGNOSTICS_H_
+#define LIN_LDFDIAGNOSTICS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ldfindex.h>
+
+
+namespace lin {
+
+/*
+ * Findings of the database validation. Every finding keeps its rule code, the
+ * name of the entity it was raised on, one more name and one number; the text
+ * is only formatted when it is requested. Names are not copied, so they shall
+ * come from the database strings table.
+ *
+ * Repeated findings are stored once with their number of occurrences, and no
+ * more than LDFDIAGNOSTICS_MAX_COUNT different findings are kept, the rest are
+ * only counted as dropped.
+ */
+class ldfdiagnostics {
+
+public:
+	enum ldfdiagnosticseverity_e
+	{
+		LDF_DIAG_SEVERITY_INFO = 0,
+		LDF_DIAG_SEVERITY_WARNING,
+		LDF_DIAG_SEVERITY_ERROR
+	};
+
+	enum ldfdiagnosticentity_e
+	{
+		LDF_DIAG_ENTITY_DATABASE = 0,
+		LDF_DIAG_ENTITY_SIGNAL,
+		LDF_DIAG_ENTITY_FRAME,
+		LDF_DIAG_ENTITY_NODE_ATTRIBUTES,
+		LDF_DIAG_ENTITY_SCHEDULE_TABLE,
+		LDF_DIAG_ENTITY_ENCODING_SIGNALS,
+		LDF_DIAG_ENTITY_COUNT
+	};
+
+	// Codes are stored in database caches, add new ones at the end
+	enum ldfdiagnosticcode_e
+	{
+		LDF_DIAG_NOT_LDF_FILE = 0,
+		LDF_DIAG_PROTOCOL_VERSION,
+		LDF_DIAG_LANGUAGE_VERSION,
+		LDF_DIAG_LIN_SPEED,
+		LDF_DIAG_MASTER_MISSING,
+		LDF_DIAG_SLAVES_MISSING,
+		LDF_DIAG_SIGNAL_PUBLISHER,
+		LDF_DIAG_SIGNAL_SUBSCRIBER,
+		LDF_DIAG_SIGNAL_REPEATED,
+		LDF_DIAG_FRAME_PUBLISHER,
+		LDF_DIAG_FRAME_NAME_REPEATED,
+		LDF_DIAG_FRAME_ID_REPEATED,
+		LDF_DIAG_FRAME_SIZE,
+		LDF_DIAG_FRAME_SIGNAL_UNDEFINED,
+		LDF_DIAG_FRAME_SIGNAL_REPEATED,
+		LDF_DIAG_FRAME_SIGNAL_BOUNDARIES,
+		LDF_DIAG_FRAME_SIGNAL_OVERLAP,
+		LDF_DIAG_NODE_PROTOCOL,
+		LDF_DIAG_NODE_UNDEFINED,
+		LDF_DIAG_NODE_REPEATED,
+		LDF_DIAG_NODE_FRAME_UNDEFINED,
+		LDF_DIAG_NODE_FRAME_NAME_REPEATED,
+		LDF_DIAG_NODE_FRAME_ID_REPEATED,
+		LDF_DIAG_TABLE_REPEATED,
+		LDF_DIAG_TABLE_FRAME_UNDEFINED,
+		LDF_DIAG_TABLE_FRAME_REPEATED,
+		LDF_DIAG_ENCODING_REPEATED,
+		LDF_DIAG_ENCODING_SIGNAL_UNDEFINED,
+		LDF_DIAG_CODES_COUNT
+	};
+
+private:
+	struct diagnostic_s
+	{
+		ldfdiagnosticcode_e code;
+		uint32_t value;
+		uint32_t occurrences;
+		const uint8_t *entity;
+		const uint8_t *argument;
+	};
+
+	// Findings in the order they were raised
+	diagnostic_s *diagnostics;
+	uint32_t diagnostics_count;
+	uint32_t diagnostics_capacity;
+	uint32_t dropped_count;
+
+	// Open addressing table of diagnostic indexes plus one, used to find repetitions
+	uint32_t *table;
+	uint32_t table_size;
+
+	static uint32_t Hash(ldfdiagnosticcode_e code, const uint8_t *entity, const uint8_t *argument, uint32_t value);
+	void Rehash(uint32_t size);
+	void Grow();
+
+public:
+	ldfdiagnostics();
+	virtual ~ldfdiagnostics();
+
+	void Add(ldfdiagnosticcode_e code, const uint8_t *entity, const uint8_t *argument, uint32_t value);
+	void Add(ldfdiagnosticcode_e code, const uint8_t *entity, const uint8_t *argument, uint32_t value, uint32_t occurrences);
+	void AddDropped(uint32_t count);
+	void Merge(ldfdiagnostics *diagnostics);
+	void Remove(ldfdiagnosticentity_e entity_type, ldfindex *entities);
+	void Clear();
+
+	uint32_t GetCount();
+	uint32_t GetDroppedCount();
+	uint32_t GetCount(ldfdiagnosticseverity_e severity);
+	uint32_t Find(uint32_t from, ldfdiagnosticseverity_e severity, const uint8_t *entity);
+
+	ldfdiagnosticcode_e GetCode(uint32_t ix);
+	ldfdiagnosticseverity_e GetSeverity(uint32_t ix);
+	ldfdiagnosticentity_e GetEntityType(uint32_t ix);
+	const uint8_t *GetEntity(uint32_t ix);
+	const uint8_t *GetArgument(uint32_t ix);
+	uint32_t GetValue(uint32_t ix);
+	uint32_t GetOccurrences(uint32_t ix);
+	const char *GetText(uint32_t ix, char *text, size_t size);
+
+	size_t GetMemoryFootprint();
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LDFDIAGNOSTICS_H_ */
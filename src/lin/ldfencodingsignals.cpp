@@ -14,81 +14,93 @@
 
 namespace lin {
 
-ldfencodingsignals::ldfencodingsignals(const uint8_t *encoding_name)
+ldfencodingsignals::ldfencodingsignals(ldfstrings *strings, const uint8_t *encoding_name)
 {
-	this->encoding_name = StrDup(encoding_name);
+	this->strings = strings;
+	this->encoding_name = strings->Intern(encoding_name);
+	this->signals = NULL;
 	this->signals_count = 0;
+	this->signals_capacity = 0;
 }
 
 ldfencodingsignals::~ldfencodingsignals()
 {
-	if (encoding_name) delete encoding_name;
-	while (signals_count > 0) delete signals[--signals_count];
+	free(signals);
 }
 
 void ldfencodingsignals::AddSignal(const uint8_t *signal)
 {
-	signals[signals_count++] = StrDup(signal);
+	ArrayAppend(&signals, &signals_count, &signals_capacity, strings->Intern(signal));
 }
 
-ldfencodingsignals *ldfencodingsignals::FromLdfStatement(const uint8_t *statement)
+const uint8_t *ldfencodingsignals::GetEncodingName()
+{
+	return encoding_name;
+}
+
+const uint8_t *ldfencodingsignals::GetSignal(uint32_t ix)
+{
+	return signals[ix];
+}
+
+uint32_t ldfencodingsignals::GetSignalsCount()
+{
+	return signals_count;
+}
+
+size_t ldfencodingsignals::GetMemoryFootprint()
+{
+	return sizeof(*this) + signals_capacity * sizeof(signals[0]);
+}
+
+ldfencodingsignals *ldfencodingsignals::FromLdfStatement(ldfstrings *strings, const uint8_t *statement)
 {
 	char *encoding_name;
+	char *save = NULL;
 	ldfencodingsignals *s;
 
 	// Type name
-	char *p = strtok((char *)statement, ":," BLANK_CHARACTERS);
+	char *p = strtok_r((char *)statement, ":," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	encoding_name = p;
 
 	// First signal
-	p = strtok(NULL, "," BLANK_CHARACTERS);
+	p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 
 	// Create relationship between encoding and signal
-	s = new ldfencodingsignals(Str(encoding_name));
+	s = new ldfencodingsignals(strings, Str(encoding_name));
 
 	// If any add more signals
 	while (p)
 	{
 		s->AddSignal(Str(p));
-		p = strtok(NULL, "," BLANK_CHARACTERS);
+		p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);
 	}
 
 	return s;
 }
 
-void ldfencodingsignals::ValidateUnicity(ldfencodingsignals *encoding, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfencodingsignals::ValidateUnicity(ldfencodingsignals *encoding, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
-	if (StrEq(encoding_name, encoding->encoding_name))
+	if (NameEq(encoding_name, encoding->encoding_name))
 	{
-		sprintf(str, STR_ERR "Encoding name '%s' repeated.", encoding_name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_ENCODING_REPEATED, encoding_name, NULL, 0);
 	}
 }
 
-void ldfencodingsignals::ValidateSignals(ldfsignal **signals, uint32_t signals_count, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfencodingsignals::ValidateSignals(ldfindex *signals_by_name, ldfdiagnostics *diagnostics)
 {
-	uint32_t i, j;
-	char str[1000];
-
+	uint32_t i;
 	for (i = 0; i < this->signals_count; i++)
 	{
-		ldfsignal *s = NULL;
-
 		// Look for signal
-		for (j = 0; (s == NULL) && (j < signals_count); j++)
-		{
-			s = StrEq(signals[j]->GetName(), this->signals[i]) ? signals[j] : NULL;
-		}
+		ldfsignal *s = (ldfsignal *)signals_by_name->Get(this->signals[i]);
 
 		// Check signal is defined
 		if (s == NULL)
 		{
-			sprintf(str, STR_ERR "Signal representation '%s' uses signal '%s' not defined.", encoding_name, this->signals[i]);
-			validation_messages[*validation_messages_count++] = StrDup(str);
+			diagnostics->Add(ldfdiagnostics::LDF_DIAG_ENCODING_SIGNAL_UNDEFINED, encoding_name, this->signals[i], 0);
 		}
 	}
 }
@@ -10,6 +10,8 @@
 
 #include <stdint.h>
 #include <ldfsignal.h>
+#include <ldfindex.h>
+#include <ldfdiagnostics.h>
 
 
 namespace lin {
@@ -17,20 +19,28 @@ namespace lin {
 class ldfencodingsignals {
 
 private:
+	ldfstrings *strings;
 	uint8_t *encoding_name;
-	uint8_t *signals[1000];
+	uint8_t **signals;
 	uint32_t signals_count;
+	uint32_t signals_capacity;
 
 public:
-	ldfencodingsignals(const uint8_t *encoding_name);
+	ldfencodingsignals(ldfstrings *strings, const uint8_t *encoding_name);
 	virtual ~ldfencodingsignals();
 
 	void AddSignal(const uint8_t *signal);
 
-	static ldfencodingsignals *FromLdfStatement(const uint8_t *statement);
+	const uint8_t *GetEncodingName();
+	const uint8_t *GetSignal(uint32_t ix);
+	uint32_t GetSignalsCount();
 
-	void ValidateUnicity(ldfencodingsignals *encoding, uint8_t **validation_messages, uint32_t *validation_messages_count);
-	void ValidateSignals(ldfsignal **signals, uint32_t signals_count, uint8_t **validation_messages, uint32_t *validation_messages_count);
+	static ldfencodingsignals *FromLdfStatement(ldfstrings *strings, const uint8_t *statement);
+
+	void ValidateUnicity(ldfencodingsignals *encoding, ldfdiagnostics *diagnostics);
+	void ValidateSignals(ldfindex *signals_by_name, ldfdiagnostics *diagnostics);
+
+	size_t GetMemoryFootprint();
 
 };
 
@@ -11,38 +11,43 @@
 
 namespace lin {
 
-ldfencodingtype::ldfencodingtype(const uint8_t *name)
+ldfencodingtype::ldfencodingtype(ldfstrings *strings, const uint8_t *name)
 {
-	this->name = StrDup(name);
+	this->strings = strings;
+	this->name = strings->Intern(name);
 	treat_as_bcd = false;
 	treat_as_ascii = false;
 	physical_value = NULL;
+	logical_values = NULL;
 	logical_values_count = 0;
+	logical_values_capacity = 0;
 }
 
 ldfencodingtype::~ldfencodingtype()
 {
-	if (name) delete name;
 	if (physical_value) delete physical_value;
 	while (logical_values_count > 0) delete logical_values[--logical_values_count];
+	free(logical_values);
 }
 
 void ldfencodingtype::UpdateFromLdfStatement(uint8_t *statement)
 {
+	char *save = NULL;
+
 	// Type name
-	char *p = strtok((char *)statement, "," BLANK_CHARACTERS);
+	char *p = strtok_r((char *)statement, "," BLANK_CHARACTERS, &save);
 
 	// Parse the rest
 	if (StrEq(p, "logical_value"))
 	{
-		logical_values[logical_values_count] = ldflogicalvalue::FromLdfStatement(Str(strtok(NULL, "")));
-		if (logical_values[logical_values_count]) logical_values_count++;
+		ldflogicalvalue *v = ldflogicalvalue::FromLdfStatement(strings, Str(strtok_r(NULL, "", &save)));
+		if (v) ArrayAppend(&logical_values, &logical_values_count, &logical_values_capacity, v);
 	}
 	else if (StrEq(p, "physical_value"))
 	{
 		if (physical_value == NULL)
 		{
-			physical_value = ldfphysicalvalue::FromLdfStatement(Str(strtok(NULL, "")));
+			physical_value = ldfphysicalvalue::FromLdfStatement(strings, Str(strtok_r(NULL, "", &save)));
 		}
 	}
 	else if (StrEq(p, "bcd_value"))
@@ -55,4 +60,66 @@ void ldfencodingtype::UpdateFromLdfStatement(uint8_t *statement)
 	}
 }
 
+const uint8_t *ldfencodingtype::GetName()
+{
+	return name;
+}
+
+bool ldfencodingtype::GetTreatAsBcd()
+{
+	return treat_as_bcd;
+}
+
+bool ldfencodingtype::GetTreatAsAscii()
+{
+	return treat_as_ascii;
+}
+
+ldfphysicalvalue *ldfencodingtype::GetPhysicalValue()
+{
+	return physical_value;
+}
+
+ldflogicalvalue *ldfencodingtype::GetLogicalValue(uint32_t ix)
+{
+	return logical_values[ix];
+}
+
+uint32_t ldfencodingtype::GetLogicalValuesCount()
+{
+	return logical_values_count;
+}
+
+void ldfencodingtype::SetTreatAsBcd(bool v)
+{
+	treat_as_bcd = v;
+}
+
+void ldfencodingtype::SetTreatAsAscii(bool v)
+{
+	treat_as_ascii = v;
+}
+
+void ldfencodingtype::SetPhysicalValue(ldfphysicalvalue *v)
+{
+	if (physical_value) delete physical_value;
+	physical_value = v;
+}
+
+void ldfencodingtype::AddLogicalValue(ldflogicalvalue *v)
+{
+	ArrayAppend(&logical_values, &logical_values_count, &logical_values_capacity, v);
+}
+
+size_t ldfencodingtype::GetMemoryFootprint()
+{
+	size_t size = sizeof(*this) + logical_values_capacity * sizeof(logical_values[0]);
+
+	if (physical_value) size += sizeof(*physical_value);
+	for (uint32_t i = 0; i < logical_values_count; i++)
+		size += sizeof(*logical_values[i]);
+
+	return size;
+}
+
 } /* namespace lin */
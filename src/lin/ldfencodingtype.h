@@ -17,20 +17,36 @@ namespace lin {
 class ldfencodingtype {
 
 private:
+	ldfstrings *strings;
 	uint8_t *name;
 	bool treat_as_bcd;
 	bool treat_as_ascii;
 	ldfphysicalvalue *physical_value;
-	ldflogicalvalue *logical_values[10000];
+	ldflogicalvalue **logical_values;
 	uint32_t logical_values_count;
+	uint32_t logical_values_capacity;
 
 
 public:
-	ldfencodingtype(const uint8_t *name);
+	ldfencodingtype(ldfstrings *strings, const uint8_t *name);
 	virtual ~ldfencodingtype();
 
 	void UpdateFromLdfStatement(uint8_t *statement);
 
+	const uint8_t *GetName();
+	bool GetTreatAsBcd();
+	bool GetTreatAsAscii();
+	ldfphysicalvalue *GetPhysicalValue();
+	ldflogicalvalue *GetLogicalValue(uint32_t ix);
+	uint32_t GetLogicalValuesCount();
+
+	void SetTreatAsBcd(bool v);
+	void SetTreatAsAscii(bool v);
+	void SetPhysicalValue(ldfphysicalvalue *v);
+	void AddLogicalValue(ldflogicalvalue *v);
+
+	size_t GetMemoryFootprint();
+
 };
 
 } /* namespace lin */
@@ -9,55 +9,58 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ldfcommon.h>
+#include <linprotocol.h>
 #include <ldfframe.h>
 
 
 namespace lin {
 
-ldfframe::ldfframe(const uint8_t *name, uint8_t id, const uint8_t *publisher, uint8_t size)
+ldfframe::ldfframe(ldfstrings *strings, const uint8_t *name, uint8_t id, const uint8_t *publisher, uint8_t size)
 {
-	this->name = StrDup(name);
+	this->name = strings->Intern(name);
 	this->id = id;
-	this->publisher = StrDup(publisher);
+	this->publisher = strings->Intern(publisher);
 	this->size = size;
+	this->signals = NULL;
 	this->signals_count = 0;
+	this->signals_capacity = 0;
 }
 
 ldfframe::~ldfframe()
 {
-	if (name) delete name;
-	if (publisher) delete publisher;
 	while (signals_count--) delete signals[signals_count];
+	free(signals);
 }
 
-ldfframe *ldfframe::FromLdfStatement(uint8_t *statement)
+ldfframe *ldfframe::FromLdfStatement(ldfstrings *strings, uint8_t *statement)
 {
 	char *p = NULL;
+	char *save = NULL;
 	char *name = NULL;
 	char *publisher = NULL;
 	uint8_t id = 0xFF;
 	uint8_t frame_size = 0;
 
 	// Name
-	p = strtok((char *)statement, ":," BLANK_CHARACTERS);
+	p = strtok_r((char *)statement, ":," BLANK_CHARACTERS, &save);
 	if (p) name = p;
 
 	// ID
-	if (p) p = strtok(NULL, ":," BLANK_CHARACTERS);
+	if (p) p = strtok_r(NULL, ":," BLANK_CHARACTERS, &save);
 	if (p) id = ParseInt(p);
 
 	// Publisher
-	if (p) p = strtok(NULL, ":," BLANK_CHARACTERS);
+	if (p) p = strtok_r(NULL, ":," BLANK_CHARACTERS, &save);
 	if (p) publisher = p;
 
 	// Frame size
-	if (p) p = strtok(NULL, ":," BLANK_CHARACTERS);
+	if (p) p = strtok_r(NULL, ":," BLANK_CHARACTERS, &save);
 	if (p) frame_size = ParseInt(p);
 
 	// Validate and return a new frame
 	if (name != NULL && publisher != NULL && id != 0xFF && frame_size != 0)
 	{
-		return new ldfframe(Str(name), id, Str(publisher), frame_size);
+		return new ldfframe(strings, Str(name), id, Str(publisher), frame_size);
 	}
 	else
 	{
@@ -77,9 +80,7 @@ uint8_t ldfframe::GetId()
 
 uint8_t ldfframe::GetPid()
 {
-	uint8_t p1 = 0x01 & (id ^ (id >> 1) ^ (id >> 2) ^ (id >> 4));
-	uint8_t p2 = 0x01 & ~((id >> 1) ^ (id >> 3) ^ (id >> 4) ^ (id >> 5));
-	return id | (p1 << 6) | (p2 << 7);
+	return linprotocol::Pid(id);
 }
 
 uint8_t *ldfframe::GetPublisher()
@@ -104,7 +105,7 @@ uint32_t ldfframe::GetSignalsCount()
 
 void ldfframe::AddSignal(ldfframesignal *signal)
 {
-	signals[signals_count++] = signal;
+	ArrayAppend(&signals, &signals_count, &signals_capacity, signal);
 }
 
 void ldfframe::DeleteSignalByIndex(uint32_t ix)
@@ -119,7 +120,7 @@ void ldfframe::DeleteSignalByName(const uint8_t *signal_name)
 	for (uint32_t ix = 0; ix < signals_count; ix++)
 	{
 		// Search signal
-		if (!StrEq(signals[ix]->GetName(), signal_name))
+		if (!NameEq(signals[ix]->GetName(), signal_name))
 			continue;
 
 		// Move back all signals one place
@@ -133,7 +134,7 @@ void ldfframe::UpdateSignalName(const uint8_t *old_signal_name, const uint8_t *n
 	for (uint32_t ix = 0; ix < signals_count; ix++)
 	{
 		// Search signal
-		if (!StrEq(signals[ix]->GetName(), old_signal_name))
+		if (!NameEq(signals[ix]->GetName(), old_signal_name))
 			continue;
 
 		// Move back all signals one place
@@ -144,55 +145,45 @@ void ldfframe::UpdateSignalName(const uint8_t *old_signal_name, const uint8_t *n
 
 void ldfframe::UpdateNodeName(const uint8_t *old_name, const uint8_t *new_name)
 {
-	if (!StrEq(old_name, publisher))
+	if (!NameEq(old_name, publisher))
 		return;
 
-	delete publisher;
-	publisher = StrDup(new_name);
+	publisher = (uint8_t *)new_name;
 }
 
-void ldfframe::ValidatePublisher(ldfnode *master, ldfnode **slaves, uint32_t slaves_count, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfframe::ValidatePublisher(ldfnode *master, ldfnode **slaves, uint32_t slaves_count, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
 	// Check publisher node exists
 	if (!ldfnode::CheckNodeName(publisher, master, slaves, slaves_count))
 	{
-		sprintf(str, STR_ERR "Publisher node '%s' assigned to frame '%s' is not defined.", publisher, name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_FRAME_PUBLISHER, name, publisher, 0);
 	}
 }
 
-void ldfframe::ValidateUnicity(ldfframe *frame, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfframe::ValidateUnicity(ldfframe *frame, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
-	if (StrEq(name, frame->name))
+	if (NameEq(name, frame->name))
 	{
-		sprintf(str, STR_ERR "Frame name '%s' used in two different frame definitions.", name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_FRAME_NAME_REPEATED, name, NULL, 0);
 	}
 
 	if (id == frame->id)
 	{
-		sprintf(str, STR_ERR "Frame ID 0x'%X' used in two different frames: '%s' and '%s'.", id, name, frame->name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_FRAME_ID_REPEATED, name, frame->name, id);
 	}
 }
 
-void ldfframe::ValidateSignals(ldfsignal **signals, uint32_t signals_count, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfframe::ValidateSignals(ldfindex *signals_by_name, ldfdiagnostics *diagnostics)
 {
 	bool overlapping;
 	uint32_t i, j;
-	char str[1000];
 	bool frame_bitmap[64];
 	uint32_t frame_bit_length = 8 * this->size;
 
 	// Check frame size
 	if (this->size > 8)
 	{
-		sprintf(str, STR_ERR "Frame '%s' size %d incorrect.", this->name, this->size);
-		validation_messages[(*validation_messages_count)++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_FRAME_SIZE, name, NULL, size);
 		return;
 	}
 
@@ -200,40 +191,29 @@ void ldfframe::ValidateSignals(ldfsignal **signals, uint32_t signals_count, uint
 	memset(frame_bitmap, 0, sizeof(frame_bitmap));
 	for (i = 0; i < this->signals_count; i++)
 	{
-		ldfsignal *s = NULL;
-
 		// Look for signal definition
-		for (j = 0; (s == NULL) && (j < signals_count); j++)
-		{
-			if (StrEq(this->signals[i]->GetName(), signals[j]->GetName()))
-			{
-				s = signals[j];
-			}
-		}
+		ldfsignal *s = (ldfsignal *)signals_by_name->Get(this->signals[i]->GetName());
 
 		// Check signal is defined
 		if (s == NULL)
 		{
-			sprintf(str, STR_ERR "Signal '%s' used in frame '%s' not defined.", this->signals[i]->GetName(), name);
-			validation_messages[(*validation_messages_count)++] = StrDup(str);
+			diagnostics->Add(ldfdiagnostics::LDF_DIAG_FRAME_SIGNAL_UNDEFINED, name, this->signals[i]->GetName(), 0);
 			continue;
 		}
 
 		// Check signal name for repetition
 		for (j = i + 1; j < this->signals_count; j++)
 		{
-			if (StrEq(this->signals[i]->GetName(), this->signals[j]->GetName()))
+			if (NameEq(this->signals[i]->GetName(), this->signals[j]->GetName()))
 			{
-				sprintf(str, STR_ERR "Signal name '%s' used twice in frame '%s'.", this->signals[i]->GetName(), name);
-				validation_messages[(*validation_messages_count)++] = StrDup(str);
+				diagnostics->Add(ldfdiagnostics::LDF_DIAG_FRAME_SIGNAL_REPEATED, name, this->signals[i]->GetName(), 0);
 			}
 		}
 
 		// Check signal boundaries
 		if (this->signals[i]->GetOffset() + s->GetBitSize() > frame_bit_length)
 		{
-			sprintf(str, STR_ERR "Signal '%s' used in frame '%s' outside of frame boundaries.", this->signals[i]->GetName(), name);
-			validation_messages[(*validation_messages_count)++] = StrDup(str);
+			diagnostics->Add(ldfdiagnostics::LDF_DIAG_FRAME_SIGNAL_BOUNDARIES, name, this->signals[i]->GetName(), 0);
 			continue;
 		}
 
@@ -251,8 +231,7 @@ void ldfframe::ValidateSignals(ldfsignal **signals, uint32_t signals_count, uint
 		// Check signal overlapping
 		if (overlapping)
 		{
-			sprintf(str, STR_ERR "Signal '%s' used in frame '%s' overlapping previous signal.", this->signals[i]->GetName(), name);
-			validation_messages[(*validation_messages_count)++] = StrDup(str);
+			diagnostics->Add(ldfdiagnostics::LDF_DIAG_FRAME_SIGNAL_OVERLAP, name, this->signals[i]->GetName(), 0);
 		}
 	}
 }
@@ -269,17 +248,45 @@ int32_t ldfframe::ComparePublisher(const ldfframe *a, const ldfframe *b)
 	return strcmp((char *)a->publisher, (char *)b->publisher);
 }
 
-void ldfframe::SortData()
+bool ldfframe::SortData()
 {
+	uint32_t i;
+
+	// Tell whether the order changed, overlaps are checked against the previous signal
+	for (i = 1; i < signals_count; i++)
+		if (ldfframesignal::SorterFrameSignals(&signals[i - 1], &signals[i]) > 0)
+			break;
+	if (i >= signals_count)
+		return false;
+
 	qsort(signals, signals_count, sizeof(signals[0]), ldfframesignal::SorterFrameSignals);
+	return true;
+}
+
+void ldfframe::ToLdfFile(ldfwriter *w)
+{
+	w->Text("    ");
+	w->Text(name);
+	w->Text(":0x");
+	w->Hex(id, 2, false);
+	w->Char(',');
+	w->Text(publisher);
+	w->Char(',');
+	w->Dec(size);
+	w->Text(" {\r\n");
+	for (uint32_t i = 0; i < signals_count; i++)
+		signals[i]->ToLdfFile(w);
+	w->Text("    }\r\n");
 }
 
-void ldfframe::ToLdfFile(FILE *f)
+size_t ldfframe::GetMemoryFootprint()
 {
-	fprintf(f, "    %s:0x%02x,%s,%d {\r\n", name, id, publisher, size);
+	size_t size = sizeof(*this) + signals_capacity * sizeof(signals[0]);
+
 	for (uint32_t i = 0; i < signals_count; i++)
-		signals[i]->ToLdfFile(f);
-	fprintf(f, "    }\r\n");
+		size += sizeof(*signals[i]);
+
+	return size;
 }
 
 
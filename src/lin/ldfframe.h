@@ -11,6 +11,9 @@
 #include <ldfnode.h>
 #include <ldfsignal.h>
 #include <ldfframesignal.h>
+#include <ldfindex.h>
+#include <ldfdiagnostics.h>
+#include <ldfwriter.h>
 
 
 namespace lin {
@@ -24,14 +27,15 @@ private:
 	uint8_t *publisher;
 	uint8_t size;
 
-	ldfframesignal *signals[1000];
-	uint8_t signals_count;
+	ldfframesignal **signals;
+	uint32_t signals_count;
+	uint32_t signals_capacity;
 
 public:
-	ldfframe(const uint8_t *name, uint8_t id, const uint8_t *publisher, uint8_t size);
+	ldfframe(ldfstrings *strings, const uint8_t *name, uint8_t id, const uint8_t *publisher, uint8_t size);
 	virtual ~ldfframe();
 
-	static ldfframe *FromLdfStatement(uint8_t *statement);
+	static ldfframe *FromLdfStatement(ldfstrings *strings, uint8_t *statement);
 
 	uint8_t *GetName();
 	uint8_t GetId();
@@ -47,15 +51,17 @@ public:
 	void UpdateSignalName(const uint8_t *old_signal_name, const uint8_t *new_signal_name);
 	void UpdateNodeName(const uint8_t *old_name, const uint8_t *new_name);
 
-	void ValidatePublisher(ldfnode *master, ldfnode **slaves, uint32_t slaves_count, uint8_t **validation_messages, uint32_t *validation_messages_count);
-	void ValidateUnicity(ldfframe *frame, uint8_t **validation_messages, uint32_t *validation_messages_count);
-	void ValidateSignals(ldfsignal **signals, uint32_t signals_count, uint8_t **validation_messages, uint32_t *validation_messages_count);
+	void ValidatePublisher(ldfnode *master, ldfnode **slaves, uint32_t slaves_count, ldfdiagnostics *diagnostics);
+	void ValidateUnicity(ldfframe *frame, ldfdiagnostics *diagnostics);
+	void ValidateSignals(ldfindex *signals_by_name, ldfdiagnostics *diagnostics);
 
 	static int32_t CompareId(const ldfframe *a, const ldfframe *b);
 	static int32_t ComparePublisher(const ldfframe *a, const ldfframe *b);
-	void SortData();
+	bool SortData();
 
-	void ToLdfFile(FILE *f);
+	void ToLdfFile(ldfwriter *w);
+
+	size_t GetMemoryFootprint();
 
 };
 
@@ -14,34 +14,34 @@
 
 namespace lin {
 
-ldfframesignal::ldfframesignal(const uint8_t *name, uint16_t offset)
+ldfframesignal::ldfframesignal(ldfstrings *strings, const uint8_t *name, uint16_t offset)
 {
-	this->name = StrDup(name);
+	this->name = strings->Intern(name);
 	this->offset = offset;
 }
 
 ldfframesignal::~ldfframesignal()
 {
-	if (name) delete name;
 }
 
-ldfframesignal *ldfframesignal::FromLdfStatement(uint8_t *statement)
+ldfframesignal *ldfframesignal::FromLdfStatement(ldfstrings *strings, uint8_t *statement)
 {
 	char *p = NULL;
+	char *save = NULL;
 	char *name = NULL;
 	uint16_t offset = 0;
 
 	// Name
-	p = strtok((char *)statement, ":," BLANK_CHARACTERS);
+	p = strtok_r((char *)statement, ":," BLANK_CHARACTERS, &save);
 	if (p) name = p;
 
 	// ID
-	if (p) p = strtok(NULL, ":," BLANK_CHARACTERS);
+	if (p) p = strtok_r(NULL, ":," BLANK_CHARACTERS, &save);
 	if (p) offset = ParseInt(p);
 
 	if (name)
 	{
-		return new ldfframesignal(Str(name), offset);
+		return new ldfframesignal(strings, Str(name), offset);
 	}
 	else
 	{
@@ -75,8 +75,7 @@ uint16_t ldfframesignal::GetOffset()
 
 void ldfframesignal::SetName(const uint8_t *name)
 {
-	delete this->name;
-	this->name = StrDup(name);
+	this->name = (uint8_t *)name;
 }
 
 void ldfframesignal::SetOffset(uint16_t offset)
@@ -84,9 +83,13 @@ void ldfframesignal::SetOffset(uint16_t offset)
 	this->offset = offset;
 }
 
-void ldfframesignal::ToLdfFile(FILE *f)
+void ldfframesignal::ToLdfFile(ldfwriter *w)
 {
-	fprintf(f, "        %s,%d;\r\n", name, offset);
+	w->Text("        ");
+	w->Text(name);
+	w->Char(',');
+	w->Dec(offset);
+	w->Text(";\r\n");
 }
 
 } /* namespace lin */
@@ -9,6 +9,8 @@
 #define LIN_LDFFRAMESIGNAL_H_
 
 #include <stdint.h>
+#include <ldfstrings.h>
+#include <ldfwriter.h>
 
 namespace lin {
 
@@ -19,10 +21,10 @@ private:
 	uint16_t offset;
 
 public:
-	ldfframesignal(const uint8_t *name, uint16_t offset);
+	ldfframesignal(ldfstrings *strings, const uint8_t *name, uint16_t offset);
 	virtual ~ldfframesignal();
 
-	static ldfframesignal *FromLdfStatement(uint8_t *statement);
+	static ldfframesignal *FromLdfStatement(ldfstrings *strings, uint8_t *statement);
 	static int32_t SorterFrameSignals(const void *a, const void *b);
 
 	uint8_t *GetName();
@@ -30,7 +32,7 @@ public:
 	void SetName(const uint8_t *name);
 	void SetOffset(uint16_t offset);
 
-	void ToLdfFile(FILE *f);
+	void ToLdfFile(ldfwriter *w);
 
 };
 
@@ -0,0 +1,138 @@
+/*
+ * ldfindex.cpp
+ *
+ *  Created on: 15 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ldfindex.h>
+
+
+#define LDFINDEX_TABLE_SIZE					64
+
+
+namespace lin {
+
+ldfindex::ldfindex()
+{
+	table_size = LDFINDEX_TABLE_SIZE;
+	table = (entry_s *)calloc(table_size, sizeof(entry_s));
+	count = 0;
+}
+
+ldfindex::~ldfindex()
+{
+	free(table);
+}
+
+uint32_t ldfindex::Slot(const void *key)
+{
+	// Mix pointer bits, the lowest ones are always zero
+	uint64_t h = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ULL;
+	return (uint32_t)(h >> 32) & (table_size - 1);
+}
+
+void ldfindex::Grow()
+{
+	entry_s *old_table = table;
+	uint32_t old_size = table_size;
+
+	// Double the table and place all entries again
+	table_size *= 2;
+	table = (entry_s *)calloc(table_size, sizeof(entry_s));
+	for (uint32_t i = 0; i < old_size; i++)
+	{
+		if (old_table[i].key == NULL) continue;
+
+		uint32_t j = Slot(old_table[i].key);
+		while (table[j].key != NULL) j = (j + 1) & (table_size - 1);
+		table[j] = old_table[i];
+	}
+
+	free(old_table);
+}
+
+void *ldfindex::Get(const void *key)
+{
+	if (key == NULL)
+		return NULL;
+
+	for (uint32_t i = Slot(key); table[i].key != NULL; i = (i + 1) & (table_size - 1))
+	{
+		if (table[i].key == key)
+			return table[i].value;
+	}
+
+	return NULL;
+}
+
+void ldfindex::Put(const void *key, void *value)
+{
+	uint32_t i;
+
+	if (key == NULL)
+		return;
+
+	// Replace the value if the key is already there
+	for (i = Slot(key); table[i].key != NULL; i = (i + 1) & (table_size - 1))
+	{
+		if (table[i].key == key)
+		{
+			table[i].value = value;
+			return;
+		}
+	}
+
+	table[i].key = key;
+	table[i].value = value;
+	count++;
+
+	// Keep load factor under 1/2
+	if (2 * count > table_size)
+		Grow();
+}
+
+void ldfindex::Remove(const void *key)
+{
+	uint32_t i, j, k;
+
+	if (key == NULL)
+		return;
+
+	// Look for the key
+	for (i = Slot(key); table[i].key != key; i = (i + 1) & (table_size - 1))
+	{
+		if (table[i].key == NULL)
+			return;
+	}
+
+	// Shift back the following entries of the cluster that would not be found otherwise
+	for (j = (i + 1) & (table_size - 1); table[j].key != NULL; j = (j + 1) & (table_size - 1))
+	{
+		k = Slot(table[j].key);
+		if (((j - k) & (table_size - 1)) >= ((j - i) & (table_size - 1)))
+		{
+			table[i] = table[j];
+			i = j;
+		}
+	}
+
+	table[i].key = NULL;
+	table[i].value = NULL;
+	count--;
+}
+
+void ldfindex::Clear()
+{
+	memset(table, 0, table_size * sizeof(entry_s));
+	count = 0;
+}
+
+size_t ldfindex::GetMemoryFootprint()
+{
+	return sizeof(*this) + table_size * sizeof(entry_s);
+}
+
+} /* namespace lin */
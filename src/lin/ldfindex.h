@@ -0,0 +1,52 @@
+/*
+ * ldfindex.h
+ *
+ *  Created on: 15 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LDFINDEX_H_
+#define LIN_LDFINDEX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace lin {
+
+/*
+ * Hash index from interned names to entities. Keys are compared by address, so
+ * they shall come from the database strings table.
+ */
+class ldfindex {
+
+private:
+	struct entry_s
+	{
+		const void *key;
+		void *value;
+	};
+
+	entry_s *table;
+	uint32_t table_size;
+	uint32_t count;
+
+	uint32_t Slot(const void *key);
+	void Grow();
+
+public:
+	ldfindex();
+	virtual ~ldfindex();
+
+	void *Get(const void *key);
+	void Put(const void *key, void *value);
+	void Remove(const void *key);
+	void Clear();
+
+	size_t GetMemoryFootprint();
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LDFINDEX_H_ */
@@ -12,32 +12,43 @@
 
 namespace lin {
 
-ldflogicalvalue::ldflogicalvalue(uint32_t value, const uint8_t *description)
+ldflogicalvalue::ldflogicalvalue(ldfstrings *strings, uint32_t value, const uint8_t *description)
 {
 	this->value = value;
-	this->description = StrDup(description);
+	this->description = strings->Intern(description);
 }
 
 ldflogicalvalue::~ldflogicalvalue()
 {
-	if (description) delete description;
 }
 
 
-ldflogicalvalue *ldflogicalvalue::FromLdfStatement(const uint8_t *statement)
+ldflogicalvalue *ldflogicalvalue::FromLdfStatement(ldfstrings *strings, const uint8_t *statement)
 {
 	uint32_t value;
+	char *save = NULL;
 
 	// Read value
-	char *p = strtok((char *)statement, "," BLANK_CHARACTERS);
+	char *p = strtok_r((char *)statement, "," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	value = ParseInt(p);
 
-	// Read description
-	p = strtok(NULL, "\"");
+	// Read description, skipping the blanks before the opening quote
+	p = strtok_r(NULL, "\"", &save);
+	if (p && p[strspn(p, BLANK_CHARACTERS)] == '\0') p = strtok_r(NULL, "\"", &save);
 
 	// Return a new logical value
-	return new ldflogicalvalue(value, Str(p));
+	return new ldflogicalvalue(strings, value, Str(p));
+}
+
+uint32_t ldflogicalvalue::GetValue()
+{
+	return value;
+}
+
+const uint8_t *ldflogicalvalue::GetDescription()
+{
+	return description;
 }
 
 
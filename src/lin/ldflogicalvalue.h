@@ -9,6 +9,7 @@
 #define LIN_LDFLOGICALVALUE_H_
 
 #include <stdint.h>
+#include <ldfstrings.h>
 
 
 namespace lin {
@@ -20,10 +21,13 @@ private:
 	uint8_t *description;
 
 public:
-	ldflogicalvalue(uint32_t value, const uint8_t *description);
+	ldflogicalvalue(ldfstrings *strings, uint32_t value, const uint8_t *description);
 	virtual ~ldflogicalvalue();
 
-	static ldflogicalvalue *FromLdfStatement(const uint8_t *statement);
+	static ldflogicalvalue *FromLdfStatement(ldfstrings *strings, const uint8_t *statement);
+
+	uint32_t GetValue();
+	const uint8_t *GetDescription();
 
 };
 
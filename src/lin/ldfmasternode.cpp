@@ -14,7 +14,7 @@
 
 namespace lin {
 
-ldfmasternode::ldfmasternode(const uint8_t *name, uint16_t timebase, uint16_t jitter) : ldfnode(name)
+ldfmasternode::ldfmasternode(ldfstrings *strings, const uint8_t *name, uint16_t timebase, uint16_t jitter) : ldfnode(strings, name)
 {
 	this->timebase = timebase;
 	this->jitter = jitter;
@@ -23,30 +23,31 @@ ldfmasternode::ldfmasternode(const uint8_t *name, uint16_t timebase, uint16_t ji
 ldfmasternode::~ldfmasternode() {
 }
 
-ldfmasternode *ldfmasternode::FromLdfStatement(const uint8_t *statement)
+ldfmasternode *ldfmasternode::FromLdfStatement(ldfstrings *strings, const uint8_t *statement)
 {
 	char *p = NULL;
+	char *save = NULL;
 	char *name = NULL;
 	uint16_t timebase = 0;
 	uint16_t jitter = 0;
 
 	// Name
-	p = strtok((char *)statement, "," BLANK_CHARACTERS);
+	p = strtok_r((char *)statement, "," BLANK_CHARACTERS, &save);
 	if (p) name = p;
 
 	// Timebase
-	if (p) p = strtok(NULL, "," BLANK_CHARACTERS);
-	if (p) timebase = ParseInt(p);
+	if (p) p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);
+	if (p) timebase = atof(p) * 10;
 
 	// Jitter
-	if (p) p = strtok(NULL, "," BLANK_CHARACTERS);	// Skip word ms
-	if (p) p = strtok(NULL, "," BLANK_CHARACTERS);
+	if (p) p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);	// Skip word ms
+	if (p) p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);
 	if (p) jitter = atof(p) * 10;
 
 	// Add master
 	if (name != NULL)
 	{
-		return new ldfmasternode(Str(name), timebase, jitter);
+		return new ldfmasternode(strings, Str(name), timebase, jitter);
 	}
 	else
 	{
@@ -74,9 +75,9 @@ void ldfmasternode::SetJitter(uint16_t jitter)
 	this->jitter = jitter;
 }
 
-void ldfmasternode::ToLdfFile(FILE *f)
+void ldfmasternode::ToLdfFile(ldfwriter *w)
 {
-	fprintf(f, "Master: %s, %0.1f ms, %0.1f ms;\r\n", GetName(), 1.0f * timebase / 10.0f, 1.0f * jitter / 10.0f);
+	w->Printf("Master: %s, %0.1f ms, %0.1f ms;\r\n", GetName(), 1.0f * timebase / 10.0f, 1.0f * jitter / 10.0f);
 }
 
 
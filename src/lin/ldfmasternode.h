@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <ldfnode.h>
+#include <ldfwriter.h>
 
 namespace lin {
 
@@ -21,10 +22,10 @@ private:
 	uint16_t jitter;
 
 public:
-	ldfmasternode(const uint8_t *name, uint16_t timebase, uint16_t jitter);
+	ldfmasternode(ldfstrings *strings, const uint8_t *name, uint16_t timebase, uint16_t jitter);
 	virtual ~ldfmasternode();
 
-	static ldfmasternode *FromLdfStatement(const uint8_t *statement);
+	static ldfmasternode *FromLdfStatement(ldfstrings *strings, const uint8_t *statement);
 
 	uint16_t GetTimebase();
 	void SetTimebase(uint16_t timebase);
@@ -32,7 +33,7 @@ public:
 	uint16_t GetJitter();
 	void SetJitter(uint16_t jitter);
 
-	void ToLdfFile(FILE *f);
+	void ToLdfFile(ldfwriter *w);
 
 };
 
@@ -11,14 +11,12 @@
 
 namespace lin {
 
-ldfnode::ldfnode(const uint8_t *name) {
-	// Copy the name
-	this->name = StrDup(name);
+ldfnode::ldfnode(ldfstrings *strings, const uint8_t *name) {
+	// Intern the name
+	this->name = strings->Intern(name);
 }
 
 ldfnode::~ldfnode() {
-	// Remove the name
-	if (name) delete name;
 }
 
 bool ldfnode::CheckNodeName(uint8_t *name, ldfnode *master, ldfnode **slaves, uint32_t slaves_count)
@@ -29,13 +27,13 @@ bool ldfnode::CheckNodeName(uint8_t *name, ldfnode *master, ldfnode **slaves, ui
 	// Check publisher is master
 	if (master != NULL)
 	{
-		name_ok = StrEq(name, master->name);
+		name_ok = NameEq(name, master->name);
 	}
 
 	// Check publisher in slaves
 	for (i = 0; !name_ok && (i < slaves_count); i++)
 	{
-		name_ok = StrEq(name, slaves[i]->name);
+		name_ok = NameEq(name, slaves[i]->name);
 	}
 
 	return name_ok;
@@ -48,11 +46,10 @@ uint8_t *ldfnode::GetName()
 
 void ldfnode::UpdateName(const uint8_t *old_name, const uint8_t *new_name)
 {
-	if (!StrEq(old_name, name))
+	if (!NameEq(old_name, name))
 		return;
 
-	delete name;
-	name = StrDup(new_name);
+	name = (uint8_t *)new_name;
 }
 
 
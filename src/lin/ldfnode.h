@@ -9,6 +9,7 @@
 #define LIN_LDFNODE_H_
 
 #include <stdint.h>
+#include <ldfstrings.h>
 
 namespace lin {
 
@@ -18,7 +19,7 @@ private:
 	uint8_t *name;
 
 public:
-	ldfnode(const uint8_t *name);
+	ldfnode(ldfstrings *strings, const uint8_t *name);
 	virtual ~ldfnode();
 
 	static bool CheckNodeName(uint8_t *name, ldfnode *master, ldfnode **slaves, uint32_t slaves_count);
@@ -13,42 +13,47 @@
 
 namespace lin {
 
-ldfnodeattributes::ldfnodeattributes(const uint8_t *name)
+ldfnodeattributes::ldfnodeattributes(ldfstrings *strings, const uint8_t *name)
 {
-	this->name = StrDup(name);
+	this->strings = strings;
+	this->name = strings->Intern(name);
 	this->protocol = LIN_PROTOCOL_VERSION_NONE;
 	this->configured_NAD = 0xFF;
 	this->initial_NAD = 0xFF;
 	this->product_id = { 0, 0, 0 };
 	this->response_error_signal_name = NULL;
+	this->fault_state_signals = NULL;
 	this->fault_state_signals_count = 0;
+	this->fault_state_signals_capacity = 0;
 	this->P2_min = 50;
 	this->ST_min = 0;
 	this->N_As_timeout = 1000;
 	this->N_Cr_timeout = 1000;
+	this->configurable_frames = NULL;
 	this->configurable_frames_count = 0;
+	this->configurable_frames_capacity = 0;
 }
 
 ldfnodeattributes::~ldfnodeattributes()
 {
-	if (name != NULL) delete name;
-	if (response_error_signal_name != NULL) delete response_error_signal_name;
-	while (fault_state_signals_count > 0) delete fault_state_signals[--fault_state_signals_count];
 	while (configurable_frames_count > 0) delete configurable_frames[--configurable_frames_count];
+	free(configurable_frames);
+	free(fault_state_signals);
 }
 
 void ldfnodeattributes::UpdateFromLdfStatement(uint8_t *statement)
 {
 	char *p = NULL;
+	char *save = NULL;
 
 	// Isolate parameter name
-	p = strtok((char *) statement, "=," BLANK_CHARACTERS);
+	p = strtok_r((char *) statement, "=," BLANK_CHARACTERS, &save);
 	if (!p) return;
 
 	// Isolate and parse parameter value
 	if (StrEq(p, "LIN_protocol"))
 	{
-		p = strtok(NULL, "=," BLANK_CHARACTERS);
+		p = strtok_r(NULL, "=," BLANK_CHARACTERS, &save);
 		if (!p) return;
 
 		if (StrEq(p, "\"2.1\""))
@@ -58,123 +63,109 @@ void ldfnodeattributes::UpdateFromLdfStatement(uint8_t *statement)
 	}
 	else if (StrEq(p, "configured_NAD"))
 	{
-		p = strtok(NULL, "=," BLANK_CHARACTERS);
+		p = strtok_r(NULL, "=," BLANK_CHARACTERS, &save);
 		if (p) configured_NAD = ParseInt(p);
 	}
 	else if (StrEq(p, "initial_NAD"))
 	{
-		p = strtok(NULL, "=," BLANK_CHARACTERS);
+		p = strtok_r(NULL, "=," BLANK_CHARACTERS, &save);
 		if (p) initial_NAD = ParseInt(p);
 	}
 	else if (StrEq(p, "product_id"))
 	{
 		// Supplier ID
-		p = strtok(NULL, "=," BLANK_CHARACTERS);
+		p = strtok_r(NULL, "=," BLANK_CHARACTERS, &save);
 		if (p) product_id.supplier_id = ParseInt(p);
 
 		// Function ID
-		if (p) p = strtok(NULL, "=," BLANK_CHARACTERS);
+		if (p) p = strtok_r(NULL, "=," BLANK_CHARACTERS, &save);
 		if (p) product_id.function_id = ParseInt(p);
 
 		// Variant
-		if (p) p = strtok(NULL, "=," BLANK_CHARACTERS);
+		if (p) p = strtok_r(NULL, "=," BLANK_CHARACTERS, &save);
 		if (p) product_id.variant = ParseInt(p);
 	}
 	else if (StrEq(p, "response_error"))
 	{
-		p = strtok(NULL, "=,");
-		if (p) response_error_signal_name = StrDup(p);
+		p = strtok_r(NULL, "=," BLANK_CHARACTERS, &save);
+		if (p) response_error_signal_name = strings->Intern(p);
 	}
 	else if (StrEq(p, "fault_state_signals"))
 	{
 		while (p)
 		{
-			p = strtok(NULL, "=,");
-			if (p) fault_state_signals[fault_state_signals_count++] = StrDup(p);
+			p = strtok_r(NULL, "=," BLANK_CHARACTERS, &save);
+			if (p) ArrayAppend(&fault_state_signals, &fault_state_signals_count, &fault_state_signals_capacity, strings->Intern(p));
 		}
 	}
 	else if (StrEq(p, "P2_min"))
 	{
-		p = strtok(NULL, "=,");
+		p = strtok_r(NULL, "=,", &save);
 		if (p) P2_min = atof(p);
 	}
 	else if (StrEq(p, "ST_min"))
 	{
-		p = strtok(NULL, "=,");
+		p = strtok_r(NULL, "=,", &save);
 		if (p) ST_min = atof(p);
 	}
 	else if (StrEq(p, "N_As_timeout"))
 	{
-		p = strtok(NULL, "=,");
+		p = strtok_r(NULL, "=,", &save);
 		if (p) N_As_timeout = atof(p);
 	}
 	else if (StrEq(p, "N_Cr_timeout"))
 	{
-		p = strtok(NULL, "=,");
+		p = strtok_r(NULL, "=,", &save);
 		if (p) N_Cr_timeout = atof(p);
 	}
 }
 
 void ldfnodeattributes::AddConfigurableFrame(ldfconfigurableframe *frame)
 {
-	configurable_frames[configurable_frames_count++] = frame;
+	ArrayAppend(&configurable_frames, &configurable_frames_count, &configurable_frames_capacity, frame);
 }
 
-void ldfnodeattributes::ValidateNode(ldfnode **slaves, uint32_t slaves_count, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfnodeattributes::ValidateNode(ldfnode **slaves, uint32_t slaves_count, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
 	if (this->protocol == LIN_PROTOCOL_VERSION_NONE)
 	{
-		sprintf(str, STR_ERR "Node_attributes '%s' protocol not defined.", name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_NODE_PROTOCOL, name, NULL, 0);
 	}
 
 	if (!ldfnode::CheckNodeName(name, NULL, slaves, slaves_count))
 	{
-		sprintf(str, STR_ERR "Node_attributes '%s' node not defined in database's slaves", name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_NODE_UNDEFINED, name, NULL, 0);
 	}
 }
 
-void ldfnodeattributes::ValidateUnicity(ldfnodeattributes *attributes, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfnodeattributes::ValidateUnicity(ldfnodeattributes *attributes, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
-	if (StrEq(name, attributes->name))
+	if (NameEq(name, attributes->name))
 	{
-		sprintf(str, STR_ERR "Node_attributes '%s' node defined twice", name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_NODE_REPEATED, name, NULL, 0);
 	}
 }
 
-void ldfnodeattributes::ValidateFrames(ldfframe **frames, uint32_t frames_count, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfnodeattributes::ValidateFrames(ldfindex *frames_by_name, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
 	uint32_t i, j;
 
 	for (i = 0; i < configurable_frames_count; i++)
 	{
-		ldfframe *f = NULL;
-
 		// Look for frame definition
-		for (j = 0; (f == NULL) && (j < frames_count); j++)
-		{
-			f = StrEq(frames[j]->GetName(), configurable_frames[i]->GetName()) ? frames[j] : NULL;
-		}
+		ldfframe *f = (ldfframe *)frames_by_name->Get(configurable_frames[i]->GetName());
 
 		// Check frame exists
 		if (f == NULL)
 		{
-			sprintf(str, STR_ERR "Node_attributes '%s' configurable frame '%s' not defined.", name, configurable_frames[i]->GetName());
-			validation_messages[*validation_messages_count++] = StrDup(str);
+			diagnostics->Add(ldfdiagnostics::LDF_DIAG_NODE_FRAME_UNDEFINED, name, configurable_frames[i]->GetName(), 0);
 			continue;
 		}
 
 		// Check configurable frame repeated
 		for (j = i + 1; j < configurable_frames_count; j++)
 		{
-			configurable_frames[i]->ValidateUnicity(name, configurable_frames[j], validation_messages, validation_messages_count);
+			configurable_frames[i]->ValidateUnicity(name, configurable_frames[j], diagnostics);
 		}
 	}
 }
@@ -219,12 +210,22 @@ uint8_t *ldfnodeattributes::GetResponseErrorSignalName()
 	return response_error_signal_name;
 }
 
+uint8_t *ldfnodeattributes::GetFaultStateSignal(uint32_t ix)
+{
+	return fault_state_signals[ix];
+}
+
+uint32_t ldfnodeattributes::GetFaultStateSignalsCount()
+{
+	return fault_state_signals_count;
+}
+
 ldfconfigurableframe *ldfnodeattributes::GetConfigurableFrame(uint32_t ix)
 {
 	return configurable_frames[ix];
 }
 
-uint16_t ldfnodeattributes::GetConfigurableFramesCount()
+uint32_t ldfnodeattributes::GetConfigurableFramesCount()
 {
 	return configurable_frames_count;
 }
@@ -301,18 +302,32 @@ void ldfnodeattributes::SetN_Cr_timeout(uint16_t v)
 
 void ldfnodeattributes::SetResponseErrorSignalName(const uint8_t *v)
 {
-	if (response_error_signal_name != NULL) delete response_error_signal_name;
-	response_error_signal_name = (v != NULL) ? StrDup(v) : NULL;
+	response_error_signal_name = strings->Intern(v);
 }
 
-void ldfnodeattributes::SortData()
+void ldfnodeattributes::AddFaultStateSignal(const uint8_t *v)
 {
+	ArrayAppend(&fault_state_signals, &fault_state_signals_count, &fault_state_signals_capacity, strings->Intern(v));
+}
+
+bool ldfnodeattributes::SortData()
+{
+	uint32_t i;
+
+	// Tell whether the order changed, repeated frames are checked in order
+	for (i = 1; i < configurable_frames_count; i++)
+		if (ldfconfigurableframe::SorterConfigurableFrames(&configurable_frames[i - 1], &configurable_frames[i]) > 0)
+			break;
+	if (i >= configurable_frames_count)
+		return false;
+
 	qsort(configurable_frames, configurable_frames_count, sizeof(configurable_frames[0]), ldfconfigurableframe::SorterConfigurableFrames);
+	return true;
 }
 
 void ldfnodeattributes::UpdateConfigurableFrameNames(const uint8_t *old_frame_name, const uint8_t *new_frame_name)
 {
-	for (int i = 0; i < configurable_frames_count; i++)
+	for (uint32_t i = 0; i < configurable_frames_count; i++)
 	{
 		configurable_frames[i]->UpdateName(old_frame_name, new_frame_name);
 	}
@@ -320,10 +335,10 @@ void ldfnodeattributes::UpdateConfigurableFrameNames(const uint8_t *old_frame_na
 
 void ldfnodeattributes::DeleteConfigurableFramesByName(const uint8_t *frame_name)
 {
-	for (int i = 0; i < configurable_frames_count; i++)
+	for (uint32_t i = 0; i < configurable_frames_count; i++)
 	{
 		// Skip configurable frames with different name
-		if (!StrEq(configurable_frames[i]->GetName(), frame_name))
+		if (!NameEq(configurable_frames[i]->GetName(), frame_name))
 		{
 			continue;
 		}
@@ -339,48 +354,93 @@ void ldfnodeattributes::DeleteConfigurableFramesByName(const uint8_t *frame_name
 
 void ldfnodeattributes::UpdateResponseErrorSignalName(const uint8_t *old_signal_name, const uint8_t *new_signal_name)
 {
-	if (StrEq(response_error_signal_name, old_signal_name))
+	if (NameEq(response_error_signal_name, old_signal_name))
 	{
-		delete response_error_signal_name;
-		response_error_signal_name = StrDup(new_signal_name);
+		response_error_signal_name = (uint8_t *)new_signal_name;
 	}
 }
 
-void ldfnodeattributes::ToLdfFile(FILE *f)
+void ldfnodeattributes::ToLdfFile(ldfwriter *w)
 {
-	fprintf(f, "    %s {\r\n", name);
-	fprintf(f, "        LIN_protocol = \"%s\";\r\n", (protocol == LIN_PROTOCOL_VERSION_2_0) ? "2.0" : "2.1");
-	fprintf(f, "        configured_NAD = 0x%02X;\r\n", configured_NAD);
+	w->Text("    ");
+	w->Text(name);
+	w->Text(" {\r\n");
+	w->Text("        LIN_protocol = \"");
+	w->Text((protocol == LIN_PROTOCOL_VERSION_2_0) ? "2.0" : "2.1");
+	w->Text("\";\r\n");
+	w->Text("        configured_NAD = 0x");
+	w->Hex(configured_NAD, 2, true);
+	w->Text(";\r\n");
 	if (initial_NAD != 0xFF)
-		fprintf(f, "        initial_NAD = 0x%02X;\r\n", initial_NAD);
+	{
+		w->Text("        initial_NAD = 0x");
+		w->Hex(initial_NAD, 2, true);
+		w->Text(";\r\n");
+	}
 
 	if (protocol >= LIN_PROTOCOL_VERSION_2_0)
 	{
-		fprintf(f, "        product_id = 0x%04X, 0x%04X, 0x%04X;\r\n", product_id.supplier_id, product_id.function_id, product_id.variant);
+		w->Text("        product_id = 0x");
+		w->Hex(product_id.supplier_id, 4, true);
+		w->Text(", 0x");
+		w->Hex(product_id.function_id, 4, true);
+		w->Text(", 0x");
+		w->Hex(product_id.variant, 4, true);
+		w->Text(";\r\n");
 		if (response_error_signal_name)
-			fprintf(f, "        response_error = %s;\r\n", response_error_signal_name);
-		fprintf(f, "        P2_min = %d ms;\r\n", P2_min);
-		fprintf(f, "        ST_min = %d ms;\r\n", ST_min);
-		fprintf(f, "        N_As_timeout = %d ms;\r\n", N_As_timeout);
-		fprintf(f, "        N_Cr_timeout = %d ms;\r\n", N_Cr_timeout);
-		fprintf(f, "\r\n");
-
-		fprintf(f, "        configurable_frames {\r\n");
+		{
+			w->Text("        response_error = ");
+			w->Text(response_error_signal_name);
+			w->Text(";\r\n");
+		}
+		w->Text("        P2_min = ");
+		w->Dec(P2_min);
+		w->Text(" ms;\r\n");
+		w->Text("        ST_min = ");
+		w->Dec(ST_min);
+		w->Text(" ms;\r\n");
+		w->Text("        N_As_timeout = ");
+		w->Dec(N_As_timeout);
+		w->Text(" ms;\r\n");
+		w->Text("        N_Cr_timeout = ");
+		w->Dec(N_Cr_timeout);
+		w->Text(" ms;\r\n");
+		w->Text("\r\n");
+
+		w->Text("        configurable_frames {\r\n");
 		for (uint32_t i = 0; i < configurable_frames_count; i++)
 		{
 			if (protocol == LIN_PROTOCOL_VERSION_2_0)
 			{
-				fprintf(f, "            %s = 0x%02X;\r\n", configurable_frames[i]->GetName(), configurable_frames[i]->GetId());
+				w->Text("            ");
+				w->Text(configurable_frames[i]->GetName());
+				w->Text(" = 0x");
+				w->Hex(configurable_frames[i]->GetId(), 2, true);
+				w->Text(";\r\n");
 			}
 			else if (protocol == LIN_PROTOCOL_VERSION_2_1)
 			{
-				fprintf(f, "            %s;\r\n", configurable_frames[i]->GetName());
+				w->Text("            ");
+				w->Text(configurable_frames[i]->GetName());
+				w->Text(";\r\n");
 			}
 		}
-		fprintf(f, "        }\r\n");
+		w->Text("        }\r\n");
 	}
 
-	fprintf(f, "    }\r\n");
+	w->Text("    }\r\n");
+}
+
+size_t ldfnodeattributes::GetMemoryFootprint()
+{
+	size_t size = sizeof(*this);
+
+	size += fault_state_signals_capacity * sizeof(fault_state_signals[0]);
+	size += configurable_frames_capacity * sizeof(configurable_frames[0]);
+	for (uint32_t i = 0; i < configurable_frames_count; i++)
+		size += sizeof(*configurable_frames[i]);
+
+	return size;
 }
 
 
@@ -13,6 +13,9 @@
 #include <ldfnode.h>
 #include <ldfframe.h>
 #include <ldfconfigurableframe.h>
+#include <ldfindex.h>
+#include <ldfdiagnostics.h>
+#include <ldfwriter.h>
 
 
 namespace lin {
@@ -28,32 +31,35 @@ public:
 	};
 
 private:
+	ldfstrings *strings;
 	uint8_t *name;
 	lin_protocol_version_e protocol;
 	uint8_t configured_NAD;
 	uint8_t initial_NAD;
 	product_id_s product_id;
 	uint8_t *response_error_signal_name;
-	uint8_t *fault_state_signals[1000];
+	uint8_t **fault_state_signals;
 	uint32_t fault_state_signals_count;
+	uint32_t fault_state_signals_capacity;
 	uint16_t P2_min;
 	uint16_t ST_min;
 	uint16_t N_As_timeout;
 	uint16_t N_Cr_timeout;
-	ldfconfigurableframe *configurable_frames[1000];
-	uint16_t configurable_frames_count;
+	ldfconfigurableframe **configurable_frames;
+	uint32_t configurable_frames_count;
+	uint32_t configurable_frames_capacity;
 
 	static int32_t SorterConfigurableFrames(const void *a, const void *b);
 
 public:
-	ldfnodeattributes(const uint8_t *name);
+	ldfnodeattributes(ldfstrings *strings, const uint8_t *name);
 	virtual ~ldfnodeattributes();
 
 	void UpdateFromLdfStatement(uint8_t *statement);
 	void AddConfigurableFrame(ldfconfigurableframe *frame);
-	void ValidateNode(ldfnode **slaves, uint32_t slaves_count, uint8_t **validation_messages, uint32_t *validation_messages_count);
-	void ValidateUnicity(ldfnodeattributes *attributes, uint8_t **validation_messages, uint32_t *validation_messages_count);
-	void ValidateFrames(ldfframe **frames, uint32_t frames_count, uint8_t **validation_messages, uint32_t *validation_messages_count);
+	void ValidateNode(ldfnode **slaves, uint32_t slaves_count, ldfdiagnostics *diagnostics);
+	void ValidateUnicity(ldfnodeattributes *attributes, ldfdiagnostics *diagnostics);
+	void ValidateFrames(ldfindex *frames_by_name, ldfdiagnostics *diagnostics);
 
 	uint8_t *GetName();
 	lin_protocol_version_e GetProtocolVersion();
@@ -67,8 +73,10 @@ public:
 	uint16_t GetN_As_timeout();
 	uint16_t GetN_Cr_timeout();
 	uint8_t *GetResponseErrorSignalName();
+	uint8_t *GetFaultStateSignal(uint32_t ix);
+	uint32_t GetFaultStateSignalsCount();
 	ldfconfigurableframe *GetConfigurableFrame(uint32_t ix);
-	uint16_t GetConfigurableFramesCount();
+	uint32_t GetConfigurableFramesCount();
 
 	void SetProtocolVersion(lin_protocol_version_e v);
 	void SetInitialNAD(uint8_t v);
@@ -81,14 +89,17 @@ public:
 	void SetN_As_timeout(uint16_t v);
 	void SetN_Cr_timeout(uint16_t v);
 	void SetResponseErrorSignalName(const uint8_t *v);
+	void AddFaultStateSignal(const uint8_t *v);
 
-	void SortData();
+	bool SortData();
 
 	void UpdateConfigurableFrameNames(const uint8_t *old_frame_name, const uint8_t *new_frame_name);
 	void DeleteConfigurableFramesByName(const uint8_t *frame_name);
 	void UpdateResponseErrorSignalName(const uint8_t *old_signal_name, const uint8_t *new_signal_name);
 
-	void ToLdfFile(FILE *f);
+	void ToLdfFile(ldfwriter *w);
+
+	size_t GetMemoryFootprint();
 
 };
 
@@ -12,52 +12,78 @@
 
 namespace lin {
 
-ldfphysicalvalue::ldfphysicalvalue(float min, float max, float scale, float offset, const uint8_t *description)
+ldfphysicalvalue::ldfphysicalvalue(ldfstrings *strings, float min, float max, float scale, float offset, const uint8_t *description)
 {
 	this->min = min;
 	this->max = max;
 	this->scale = scale;
 	this->offset = offset;
-	this->description = StrDup(description);
+	this->description = strings->Intern(description);
 }
 
 ldfphysicalvalue::~ldfphysicalvalue()
 {
-	if (description) delete description;
 }
 
-ldfphysicalvalue *ldfphysicalvalue::FromLdfStatement(const uint8_t *statement)
+ldfphysicalvalue *ldfphysicalvalue::FromLdfStatement(ldfstrings *strings, const uint8_t *statement)
 {
+	char *save = NULL;
 	float min;
 	float max;
 	float scale;
 	float offset;
 
 	// Min
-	char *p = strtok((char *) statement, "," BLANK_CHARACTERS);
+	char *p = strtok_r((char *) statement, "," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	min = strtof(p, NULL);
 
 	// Max
-	p = strtok(NULL, "," BLANK_CHARACTERS);
+	p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	max = strtof(p, NULL);
 
 	// Scale
-	p = strtok(NULL, "," BLANK_CHARACTERS);
+	p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	scale = strtof(p, NULL);
 
 	// Offset
-	p = strtok(NULL, "," BLANK_CHARACTERS);
+	p = strtok_r(NULL, "," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	offset = strtof(p, NULL);
 
-	// Description
-	p = strtok(NULL, "\"");
+	// Description, skipping the blanks before the opening quote
+	p = strtok_r(NULL, "\"", &save);
+	if (p && p[strspn(p, BLANK_CHARACTERS)] == '\0') p = strtok_r(NULL, "\"", &save);
 
 	// Return a new physical value
-	return new ldfphysicalvalue(min, max, scale, offset, Str(p));
+	return new ldfphysicalvalue(strings, min, max, scale, offset, Str(p));
+}
+
+float ldfphysicalvalue::GetMin()
+{
+	return min;
+}
+
+float ldfphysicalvalue::GetMax()
+{
+	return max;
+}
+
+float ldfphysicalvalue::GetScale()
+{
+	return scale;
+}
+
+float ldfphysicalvalue::GetOffset()
+{
+	return offset;
+}
+
+const uint8_t *ldfphysicalvalue::GetDescription()
+{
+	return description;
 }
 
 } /* namespace lin */
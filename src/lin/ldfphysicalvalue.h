@@ -9,6 +9,7 @@
 #define LIN_LDFPHYSICALVALUE_H_
 
 #include <stdint.h>
+#include <ldfstrings.h>
 
 namespace lin {
 
@@ -22,10 +23,16 @@ private:
 	uint8_t *description;
 
 public:
-	ldfphysicalvalue(float min, float max, float scale, float offset, const uint8_t *description);
+	ldfphysicalvalue(ldfstrings *strings, float min, float max, float scale, float offset, const uint8_t *description);
 	virtual ~ldfphysicalvalue();
 
-	static ldfphysicalvalue *FromLdfStatement(const uint8_t *statement);
+	static ldfphysicalvalue *FromLdfStatement(ldfstrings *strings, const uint8_t *statement);
+
+	float GetMin();
+	float GetMax();
+	float GetScale();
+	float GetOffset();
+	const uint8_t *GetDescription();
 
 };
 
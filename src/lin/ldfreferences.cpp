@@ -0,0 +1,166 @@
+/*
+ * ldfreferences.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <stdlib.h>
+#include <ldfcommon.h>
+#include <ldfreferences.h>
+
+
+// Lists longer than this keep an index of their users positions
+#define LDFREFERENCES_INDEXED_USERS			16
+
+
+namespace lin {
+
+ldfreferences::ldfreferences()
+{
+	lists = NULL;
+	lists_count = 0;
+	lists_capacity = 0;
+}
+
+ldfreferences::~ldfreferences()
+{
+	Clear();
+	free(lists);
+}
+
+ldfreferences::list_s *ldfreferences::GetList(ldfreferencetype_e type, const uint8_t *name, bool create)
+{
+	uintptr_t ix = (uintptr_t)lists_by_name[type].Get(name);
+	list_s l;
+
+	if (ix != 0)
+		return &lists[ix - 1];
+
+	if (!create || name == NULL)
+		return NULL;
+
+	// Open an empty list for the name
+	l.users = NULL;
+	l.users_count = 0;
+	l.users_capacity = 0;
+	l.positions = NULL;
+	ArrayAppend(&lists, &lists_count, &lists_capacity, l);
+	lists_by_name[type].Put(name, (void *)(uintptr_t)lists_count);
+
+	return &lists[lists_count - 1];
+}
+
+uint32_t ldfreferences::GetPosition(list_s *l, void *entity)
+{
+	if (l->positions != NULL)
+	{
+		uintptr_t ix = (uintptr_t)l->positions->Get(entity);
+		return (ix != 0) ? (uint32_t)(ix - 1) : l->users_count;
+	}
+
+	for (uint32_t i = 0; i < l->users_count; i++)
+		if (l->users[i].entity == entity)
+			return i;
+
+	return l->users_count;
+}
+
+void ldfreferences::Add(ldfreferencetype_e type, const uint8_t *name, ldfusertype_e user_type, void *entity)
+{
+	list_s *l = GetList(type, name, true);
+	ldfuser_s u;
+	uint32_t ix;
+
+	if (l == NULL)
+		return;
+
+	// Count one more reference of a known user
+	ix = GetPosition(l, entity);
+	if (ix < l->users_count)
+	{
+		l->users[ix].references++;
+		return;
+	}
+
+	u.type = user_type;
+	u.references = 1;
+	u.entity = entity;
+	ArrayAppend(&l->users, &l->users_count, &l->users_capacity, u);
+
+	// Index positions once the list is long
+	if (l->positions != NULL)
+	{
+		l->positions->Put(entity, (void *)(uintptr_t)l->users_count);
+	}
+	else if (l->users_count > LDFREFERENCES_INDEXED_USERS)
+	{
+		l->positions = new ldfindex();
+		for (uint32_t i = 0; i < l->users_count; i++)
+			l->positions->Put(l->users[i].entity, (void *)(uintptr_t)(i + 1));
+	}
+}
+
+void ldfreferences::Remove(ldfreferencetype_e type, const uint8_t *name, void *entity)
+{
+	list_s *l = GetList(type, name, false);
+	uint32_t ix;
+
+	if (l == NULL)
+		return;
+
+	ix = GetPosition(l, entity);
+	if (ix >= l->users_count || --l->users[ix].references > 0)
+		return;
+
+	// Move the last user over the removed one
+	l->users_count--;
+	if (ix < l->users_count)
+	{
+		l->users[ix] = l->users[l->users_count];
+		if (l->positions != NULL) l->positions->Put(l->users[ix].entity, (void *)(uintptr_t)(ix + 1));
+	}
+	if (l->positions != NULL) l->positions->Remove(entity);
+}
+
+void ldfreferences::Clear()
+{
+	for (uint32_t i = 0; i < lists_count; i++)
+	{
+		free(lists[i].users);
+		if (lists[i].positions != NULL) delete lists[i].positions;
+	}
+	lists_count = 0;
+
+	for (uint32_t i = 0; i < LDF_REF_TYPES_COUNT; i++)
+		lists_by_name[i].Clear();
+}
+
+uint32_t ldfreferences::GetUsersCount(ldfreferencetype_e type, const uint8_t *name)
+{
+	list_s *l = GetList(type, name, false);
+	return (l != NULL) ? l->users_count : 0;
+}
+
+ldfreferences::ldfuser_s *ldfreferences::GetUser(ldfreferencetype_e type, const uint8_t *name, uint32_t ix)
+{
+	return &GetList(type, name, false)->users[ix];
+}
+
+size_t ldfreferences::GetMemoryFootprint()
+{
+	size_t size = sizeof(*this) + lists_capacity * sizeof(list_s);
+
+	for (uint32_t i = 0; i < LDF_REF_TYPES_COUNT; i++)
+		size += lists_by_name[i].GetMemoryFootprint() - sizeof(ldfindex);
+
+	for (uint32_t i = 0; i < lists_count; i++)
+	{
+		size += lists[i].users_capacity * sizeof(ldfuser_s);
+		if (lists[i].positions != NULL) size += lists[i].positions->GetMemoryFootprint();
+	}
+
+	return size;
+}
+
+} /* namespace lin */
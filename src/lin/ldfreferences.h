@@ -0,0 +1,88 @@
+/*
+ * ldfreferences.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LDFREFERENCES_H_
+#define LIN_LDFREFERENCES_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ldfindex.h>
+
+
+namespace lin {
+
+/*
+ * Cross references from signal, frame and node names to the entities that use
+ * them. Each user is listed once per name with the number of times it refers to
+ * it, so a change only touches the lists of the names involved. Names shall
+ * come from the database strings table.
+ */
+class ldfreferences {
+
+public:
+	enum ldfreferencetype_e
+	{
+		LDF_REF_SIGNAL = 0,
+		LDF_REF_FRAME,
+		LDF_REF_NODE,
+		LDF_REF_TYPES_COUNT
+	};
+
+	enum ldfusertype_e
+	{
+		LDF_USER_SIGNAL = 0,
+		LDF_USER_FRAME,
+		LDF_USER_NODE_ATTRIBUTES,
+		LDF_USER_SCHEDULE_TABLE,
+		LDF_USER_ENCODING_SIGNALS
+	};
+
+	struct ldfuser_s
+	{
+		ldfusertype_e type;
+		uint32_t references;
+		void *entity;
+	};
+
+private:
+	struct list_s
+	{
+		ldfuser_s *users;
+		uint32_t users_count;
+		uint32_t users_capacity;
+
+		// Positions of users, only for long lists
+		ldfindex *positions;
+	};
+
+	// Users lists, found by name through the index of their reference type
+	ldfindex lists_by_name[LDF_REF_TYPES_COUNT];
+	list_s *lists;
+	uint32_t lists_count;
+	uint32_t lists_capacity;
+
+	list_s *GetList(ldfreferencetype_e type, const uint8_t *name, bool create);
+	uint32_t GetPosition(list_s *l, void *entity);
+
+public:
+	ldfreferences();
+	virtual ~ldfreferences();
+
+	void Add(ldfreferencetype_e type, const uint8_t *name, ldfusertype_e user_type, void *entity);
+	void Remove(ldfreferencetype_e type, const uint8_t *name, void *entity);
+	void Clear();
+
+	uint32_t GetUsersCount(ldfreferencetype_e type, const uint8_t *name);
+	ldfuser_s *GetUser(ldfreferencetype_e type, const uint8_t *name, uint32_t ix);
+
+	size_t GetMemoryFootprint();
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LDFREFERENCES_H_ */
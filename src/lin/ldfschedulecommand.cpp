@@ -15,68 +15,65 @@
 namespace lin {
 
 
-ldfschedulecommand::ldfschedulecommand(ldfschedulecommandtype_t type, const uint8_t *frame_name, uint16_t timeout, const uint8_t *slave_name, const uint8_t *data, const uint8_t *assign_frame_name)
+ldfschedulecommand::ldfschedulecommand(ldfstrings *strings, ldfschedulecommandtype_t type, const uint8_t *frame_name, uint16_t timeout, const uint8_t *slave_name, const uint8_t *data, const uint8_t *assign_frame_name)
 {
 	this->type = type;
-	this->frame_name = StrDup(frame_name);
+	this->frame_name = strings->Intern(frame_name);
 	this->timeout = timeout;
-	this->slave_name = StrDup(slave_name);
+	this->slave_name = strings->Intern(slave_name);
 	for (uint32_t i = 0; i < 8 ; i++) this->data[i] = (data != NULL) ? data[i] : 0;
-	this->assign_frame_name = StrDup(assign_frame_name);
+	this->assign_frame_name = strings->Intern(assign_frame_name);
 }
 
 ldfschedulecommand::~ldfschedulecommand()
 {
-	if (frame_name) delete frame_name;
-	if (slave_name) delete slave_name;
-	if (assign_frame_name) delete assign_frame_name;
 }
 
-char *ldfschedulecommand::ParseSlaveInBrackets(char *p, char **p_slave)
+char *ldfschedulecommand::ParseSlaveInBrackets(char *p, char **p_slave, char **save)
 {
-	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS);
-	p = StrTokenParseNext(p, p_slave, BLANK_CHARACTERS);
-	return StrTokenParseNextAndCheck(p, "}", BLANK_CHARACTERS);
+	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS, save);
+	p = StrTokenParseNext(p, p_slave, BLANK_CHARACTERS, save);
+	return StrTokenParseNextAndCheck(p, "}", BLANK_CHARACTERS, save);
 }
 
-char *ldfschedulecommand::ParseDataDump(char *p, char **p_slave, char *data)
+char *ldfschedulecommand::ParseDataDump(char *p, char **p_slave, char *data, char **save)
 {
-	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS);
-	p = StrTokenParseNext(p, p_slave, "," BLANK_CHARACTERS);	// Read slave
+	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS, save);
+	p = StrTokenParseNext(p, p_slave, "," BLANK_CHARACTERS, save);	// Read slave
 	for (int i = 0; (p != NULL) && (i < 5); i++)									// Read data dump
 	{
-		p = StrTokenParseNext(p, NULL, "," BLANK_CHARACTERS);
+		p = StrTokenParseNext(p, NULL, "," BLANK_CHARACTERS, save);
 		if (p != NULL) data[i] = ParseInt(p);
 	}
-	return StrTokenParseNextAndCheck(p, "}", BLANK_CHARACTERS);
+	return StrTokenParseNextAndCheck(p, "}", BLANK_CHARACTERS, save);
 }
 
-char *ldfschedulecommand::ParseFreeFormat(char *p, char *data)
+char *ldfschedulecommand::ParseFreeFormat(char *p, char *data, char **save)
 {
-	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS);
+	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS, save);
 	for (int i = 0; (p != NULL) && (i < 8); i++)									// Read free format data
 	{
-		p = StrTokenParseNext(p, NULL, "," BLANK_CHARACTERS);
+		p = StrTokenParseNext(p, NULL, "," BLANK_CHARACTERS, save);
 		data[i] = ParseInt(p);
 	}
-	return StrTokenParseNextAndCheck(p, "}", BLANK_CHARACTERS);
+	return StrTokenParseNextAndCheck(p, "}", BLANK_CHARACTERS, save);
 }
 
-char *ldfschedulecommand::ParseAssignFrameId(char *p, char **p_slave, char **p_assign_frame)
+char *ldfschedulecommand::ParseAssignFrameId(char *p, char **p_slave, char **p_assign_frame, char **save)
 {
-	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS);
-	p = StrTokenParseNext(p, p_slave, "," BLANK_CHARACTERS);		// Read slave
-	p = StrTokenParseNext(p, p_assign_frame, "," BLANK_CHARACTERS);	// Read assign frame
-	return StrTokenParseNextAndCheck(p, "}", BLANK_CHARACTERS);
+	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS, save);
+	p = StrTokenParseNext(p, p_slave, "," BLANK_CHARACTERS, save);		// Read slave
+	p = StrTokenParseNext(p, p_assign_frame, "," BLANK_CHARACTERS, save);	// Read assign frame
+	return StrTokenParseNextAndCheck(p, "}", BLANK_CHARACTERS, save);
 }
 
-char *ldfschedulecommand::ParseAssignFrameIdRange(char *p, char **p_slave, char **p_assign_frame, char *data)
+char *ldfschedulecommand::ParseAssignFrameIdRange(char *p, char **p_slave, char **p_assign_frame, char *data, char **save)
 {
-	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS);
-	p = StrTokenParseNext(p, p_slave, "," BLANK_CHARACTERS);	// Read slave
+	p = StrTokenParseNextAndCheck(p, "{", BLANK_CHARACTERS, save);
+	p = StrTokenParseNext(p, p_slave, "," BLANK_CHARACTERS, save);	// Read slave
 
 	// data[0] contains frame protected id in configurable_frames slave node list
-	p = StrTokenParseNext(p, NULL, "," BLANK_CHARACTERS);
+	p = StrTokenParseNext(p, NULL, "," BLANK_CHARACTERS, save);
 	data[0] = ParseInt(p);
 
 	// Protected identifier cannot be 0, so return it as a string, and process it later
@@ -85,7 +82,7 @@ char *ldfschedulecommand::ParseAssignFrameIdRange(char *p, char **p_slave, char
 	// data[1] contains frame count
 	for (data[1] = 1; (p != NULL) && (data[1] < 4); data[1]++)
 	{
-		p = StrTokenParseNext(p, NULL, "," BLANK_CHARACTERS);
+		p = StrTokenParseNext(p, NULL, "," BLANK_CHARACTERS, save);
 		if (p == NULL)
 			return NULL;
 
@@ -97,9 +94,10 @@ char *ldfschedulecommand::ParseAssignFrameIdRange(char *p, char **p_slave, char
 	return p;
 }
 
-ldfschedulecommand *ldfschedulecommand::FromLdfStatement(const uint8_t *statement)
+ldfschedulecommand *ldfschedulecommand::FromLdfStatement(ldfstrings *strings, const uint8_t *statement)
 {
 	char *p;
+	char *save = NULL;
 	ldfschedulecommandtype_t type;
 	char *frame_name = NULL;
 	uint16_t timeout = 0;
@@ -108,7 +106,7 @@ ldfschedulecommand *ldfschedulecommand::FromLdfStatement(const uint8_t *statemen
 	char data[8];
 
 	// Frame name
-	p = StrTokenParseFirst((char*)statement, &frame_name, BLANK_CHARACTERS);
+	p = StrTokenParseFirst((char*)statement, &frame_name, BLANK_CHARACTERS, &save);
 
 	if (StrEq(frame_name, "MasterReq"))
 	{
@@ -121,32 +119,32 @@ ldfschedulecommand *ldfschedulecommand::FromLdfStatement(const uint8_t *statemen
 	else if (StrEq(frame_name, "AssignNAD"))
 	{
 		type = LDF_SCMD_TYPE_AssignNAD;
-		p = ParseSlaveInBrackets(p, &slave);
+		p = ParseSlaveInBrackets(p, &slave, &save);
 	}
 	else if (StrEq(frame_name, "DataDump"))
 	{
 		type = LDF_SCMD_TYPE_DataDump;
-		p = ParseDataDump(p, &slave, data);
+		p = ParseDataDump(p, &slave, data, &save);
 	}
 	else if (StrEq(frame_name, "SaveConfiguration"))
 	{
 		type = LDF_SCMD_TYPE_SaveConfiguration;
-		p = ParseSlaveInBrackets(p, &slave);
+		p = ParseSlaveInBrackets(p, &slave, &save);
 	}
 	else if (StrEq(frame_name, "FreeFormat"))
 	{
 		type = LDF_SCMD_TYPE_FreeFormat;
-		p = ParseFreeFormat(p, data);
+		p = ParseFreeFormat(p, data, &save);
 	}
 	else if (StrEq(frame_name, "AssignFrameIdRange"))
 	{
 		type = LDF_SCMD_TYPE_AssignFrameIdRange;
-		p = ParseAssignFrameIdRange(p, &slave, &assign_frame, data);
+		p = ParseAssignFrameIdRange(p, &slave, &assign_frame, data, &save);
 	}
 	else if (StrEq(frame_name, "AssignFrameId"))
 	{
 		type = LDF_SCMD_TYPE_AssignFrameId;
-		p = ParseAssignFrameId(p, &slave, &assign_frame);
+		p = ParseAssignFrameId(p, &slave, &assign_frame, &save);
 	}
 	else
 	{
@@ -155,20 +153,20 @@ ldfschedulecommand *ldfschedulecommand::FromLdfStatement(const uint8_t *statemen
 	if (p == NULL) return NULL;
 
 	// Check delay word
-	p = StrTokenParseNextAndCheck(p, "delay", BLANK_CHARACTERS);
+	p = StrTokenParseNextAndCheck(p, "delay", BLANK_CHARACTERS, &save);
 	if (p == NULL) return NULL;
 
 	// Timeout
-	p = StrTokenParseNext(p, NULL, BLANK_CHARACTERS);
+	p = StrTokenParseNext(p, NULL, BLANK_CHARACTERS, &save);
 	if (p == NULL) return NULL;
 	timeout = ParseInt(p);
 
 	// Check ms word
-	p = StrTokenParseNextAndCheck(p, "ms", BLANK_CHARACTERS);
+	p = StrTokenParseNextAndCheck(p, "ms", BLANK_CHARACTERS, &save);
 	if (p == NULL) return NULL;
 
 	// Return command
-	return new ldfschedulecommand(type, Str(frame_name), timeout, Str(slave), Str(data), Str(assign_frame));
+	return new ldfschedulecommand(strings, type, Str(frame_name), timeout, Str(slave), Str(data), Str(assign_frame));
 }
 
 ldfschedulecommand *ldfschedulecommand::FromStrCommand(ldf *db, const uint8_t *command, const uint8_t *timeout)
@@ -180,7 +178,7 @@ ldfschedulecommand *ldfschedulecommand::FromStrCommand(ldf *db, const uint8_t *c
 	sprintf(str, "%s delay %s", command, timeout);
 
 	// Parse input
-	c = FromLdfStatement(Str(str));
+	c = FromLdfStatement(db->GetStrings(), Str(str));
 	if (c == NULL) return NULL;
 
 	if (c->type == LDF_SCMD_TYPE_AssignFrameIdRange)
@@ -190,7 +188,6 @@ ldfschedulecommand *ldfschedulecommand::FromStrCommand(ldf *db, const uint8_t *c
 
 		// data[0] contains frame protected id in configurable_frames slave node list
 		c->data[0] = db->GetFrameByName(c->assign_frame_name)->GetPid();
-		delete c->assign_frame_name;
 		c->assign_frame_name = NULL;
 
 		// data[1] contains frame count, ie. it shall be bigger than 0 and smaller than 5
@@ -242,30 +239,25 @@ uint8_t ldfschedulecommand::GetAssignFrameIdRangeCount()
 
 void ldfschedulecommand::UpdateFrameName(const uint8_t *old_name, const uint8_t *new_name)
 {
-	if (StrEq(frame_name, old_name))
+	if (NameEq(frame_name, old_name))
 	{
-		delete frame_name;
-		frame_name = StrDup(new_name);
+		frame_name = (uint8_t *)new_name;
 	}
 }
 
 void ldfschedulecommand::UpdateSlaveName(const uint8_t *old_name, const uint8_t *new_name)
 {
-	if (StrEq(slave_name, old_name))
+	if (NameEq(slave_name, old_name))
 	{
-		delete slave_name;
-		slave_name = StrDup(new_name);
+		slave_name = (uint8_t *)new_name;
 	}
 }
 
-void ldfschedulecommand::ValidateUnicity(uint8_t *schedule_table, ldfschedulecommand *command, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfschedulecommand::ValidateUnicity(uint8_t *schedule_table, ldfschedulecommand *command, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
-	if (StrEq(frame_name, command->frame_name))
+	if (NameEq(frame_name, command->frame_name))
 	{
-		sprintf(str, STR_ERR "Schedule table '%s' schedule command frame name '%s' repeated.", schedule_table, frame_name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_TABLE_FRAME_REPEATED, schedule_table, frame_name, 0);
 	}
 }
 
@@ -319,7 +311,7 @@ const uint8_t *ldfschedulecommand::GetStrType()
 
 const uint8_t * ldfschedulecommand::GetStrCommand(ldf *db)
 {
-	static char res[1000];
+	static thread_local char res[1000];
 
 	switch (type)
 	{
@@ -372,10 +364,10 @@ const uint8_t * ldfschedulecommand::GetStrCommand(ldf *db)
 			sprintf(res, "AssignFrameIdRange { %s", slave_name);
 
 			// Add frame names to command
-			for (int i = 0; ff != NULL && i < aa->GetConfigurableFramesCount(); i++)
+			for (uint32_t i = 0; ff != NULL && i < aa->GetConfigurableFramesCount(); i++)
 			{
 				// Skip
-				if (!StrEq(aa->GetConfigurableFrame(i)->GetName(), ff->GetName()))
+				if (!NameEq(aa->GetConfigurableFrame(i)->GetName(), ff->GetName()))
 					continue;
 
 				// Add frames to command string
@@ -409,7 +401,7 @@ const uint8_t * ldfschedulecommand::GetStrCommand(ldf *db)
 
 const uint8_t *ldfschedulecommand::GetStrRawData()
 {
-	static char res[1000];
+	static thread_local char res[1000];
 
 	switch (type)
 	{
@@ -9,6 +9,8 @@
 #define LIN_LDFSCHEDULECOMMAND_H_
 
 #include <stdint.h>
+#include <ldfstrings.h>
+#include <ldfdiagnostics.h>
 
 namespace lin {
 
@@ -39,17 +41,17 @@ private:
 	uint8_t *assign_frame_name;
 
 private:
-	static char *ParseSlaveInBrackets(char *p, char **p_slave);
-	static char *ParseDataDump(char *p, char **p_slave, char *data);
-	static char *ParseFreeFormat(char *p, char *data);
-	static char *ParseAssignFrameId(char *p, char **p_slave, char **p_assign_frame);
-	static char *ParseAssignFrameIdRange(char *p, char **p_slave, char **p_assign_frame, char *data);
+	static char *ParseSlaveInBrackets(char *p, char **p_slave, char **save);
+	static char *ParseDataDump(char *p, char **p_slave, char *data, char **save);
+	static char *ParseFreeFormat(char *p, char *data, char **save);
+	static char *ParseAssignFrameId(char *p, char **p_slave, char **p_assign_frame, char **save);
+	static char *ParseAssignFrameIdRange(char *p, char **p_slave, char **p_assign_frame, char *data, char **save);
 
 public:
-	ldfschedulecommand(ldfschedulecommandtype_t type, const uint8_t *frame_name, uint16_t timeout, const uint8_t *slave_name, const uint8_t *data, const uint8_t *assign_frame_name);
+	ldfschedulecommand(ldfstrings *strings, ldfschedulecommandtype_t type, const uint8_t *frame_name, uint16_t timeout, const uint8_t *slave_name, const uint8_t *data, const uint8_t *assign_frame_name);
 	virtual ~ldfschedulecommand();
 
-	static ldfschedulecommand *FromLdfStatement(const uint8_t *statement);
+	static ldfschedulecommand *FromLdfStatement(ldfstrings *strings, const uint8_t *statement);
 	static ldfschedulecommand *FromStrCommand(ldf *db, const uint8_t *command, const uint8_t *timeout);
 
 	ldfschedulecommandtype_t GetType();
@@ -63,7 +65,7 @@ public:
 
 	void UpdateFrameName(const uint8_t *old_name, const uint8_t *new_name);
 	void UpdateSlaveName(const uint8_t *old_name, const uint8_t *new_name);
-	void ValidateUnicity(uint8_t *schedule_table, ldfschedulecommand *command, uint8_t **validation_messages, uint32_t *validation_messages_count);
+	void ValidateUnicity(uint8_t *schedule_table, ldfschedulecommand *command, ldfdiagnostics *diagnostics);
 
 	const uint8_t *GetStrType();
 	const uint8_t *GetStrCommand(ldf *db);
@@ -14,16 +14,18 @@
 namespace lin
 {
 
-ldfscheduletable::ldfscheduletable(const uint8_t *name)
+ldfscheduletable::ldfscheduletable(ldfstrings *strings, const uint8_t *name)
 {
-	this->name = StrDup(name);
+	this->name = strings->Intern(name);
+	this->commands = NULL;
 	this->commands_count = 0;
+	this->commands_capacity = 0;
 }
 
 ldfscheduletable::~ldfscheduletable()
 {
-	if (name) delete name;
 	while (commands_count > 0) delete commands[--commands_count];
+	free(commands);
 }
 
 uint8_t *ldfscheduletable::GetName()
@@ -36,14 +38,14 @@ ldfschedulecommand *ldfscheduletable::GetCommandByIndex(uint32_t ix)
 	return commands[ix];
 }
 
-uint16_t ldfscheduletable::GetCommandsCount()
+uint32_t ldfscheduletable::GetCommandsCount()
 {
 	return commands_count;
 }
 
 void ldfscheduletable::UpdateCommandsFrameName(const uint8_t *old_name, const uint8_t *new_name)
 {
-	for (int i = 0; i < commands_count; i++)
+	for (uint32_t i = 0; i < commands_count; i++)
 	{
 		commands[i]->UpdateFrameName(old_name, new_name);
 	}
@@ -51,7 +53,7 @@ void ldfscheduletable::UpdateCommandsFrameName(const uint8_t *old_name, const ui
 
 void ldfscheduletable::UpdateCommandsSlaveName(const uint8_t *old_name, const uint8_t *new_name)
 {
-	for (int i = 0; i < commands_count; i++)
+	for (uint32_t i = 0; i < commands_count; i++)
 	{
 		commands[i]->UpdateSlaveName(old_name, new_name);
 	}
@@ -59,15 +61,15 @@ void ldfscheduletable::UpdateCommandsSlaveName(const uint8_t *old_name, const ui
 
 void ldfscheduletable::DeleteCommandsByFrameName(const uint8_t *name)
 {
-	for (int i = 0; i < commands_count; i++)
-		if (StrEq(name, commands[i]->GetFrameName()))
+	for (uint32_t i = 0; i < commands_count; i++)
+		if (NameEq(name, commands[i]->GetFrameName()))
 			DeleteCommandByIndex(i);
 }
 
 void ldfscheduletable::DeleteCommandsBySlaveName(const uint8_t *name)
 {
-	for (int i = 0; i < commands_count; i++)
-		if (StrEq(name, commands[i]->GetSlaveName()))
+	for (uint32_t i = 0; i < commands_count; i++)
+		if (NameEq(name, commands[i]->GetSlaveName()))
 			DeleteCommandByIndex(i);
 }
 
@@ -81,57 +83,65 @@ void ldfscheduletable::DeleteCommandByIndex(uint32_t ix)
 
 void ldfscheduletable::AddCommand(ldfschedulecommand *command)
 {
-	commands[commands_count++] = command;
+	ArrayAppend(&commands, &commands_count, &commands_capacity, command);
 }
 
-void ldfscheduletable::ValidateUnicity(ldfscheduletable *table, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfscheduletable::ValidateUnicity(ldfscheduletable *table, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
-	if (StrEq(name, table->name))
+	if (NameEq(name, table->name))
 	{
-		sprintf(str, STR_ERR "Schedule table name '%s' repeated.", name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_TABLE_REPEATED, name, NULL, 0);
 	}
 }
 
-void ldfscheduletable::ValidateFrames(ldfframe **frames, uint32_t frames_count, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfscheduletable::ValidateFrames(ldfindex *frames_by_name, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
 	uint32_t i, j;
 
 	for (i = 0; i < commands_count; i++)
 	{
-		ldfframe *f = NULL;
-
 		// Look for frame definition
-		for (j = 0; (f == NULL) && (j < frames_count); j++)
-		{
-			f = StrEq(frames[j]->GetName(), commands[i]->GetFrameName()) ? frames[j] : NULL;
-		}
+		ldfframe *f = (ldfframe *)frames_by_name->Get(commands[i]->GetFrameName());
 
 		// Check frame exists
 		if (f == NULL)
 		{
-			sprintf(str, STR_ERR "Schedule table '%s' command frame '%s' not defined.", name, commands[i]->GetFrameName());
-			validation_messages[*validation_messages_count++] = StrDup(str);
+			diagnostics->Add(ldfdiagnostics::LDF_DIAG_TABLE_FRAME_UNDEFINED, name, commands[i]->GetFrameName(), 0);
 			continue;
 		}
 
 		// Check configurable frame repeated
 		for (j = i + 1; j < commands_count; j++)
 		{
-			commands[i]->ValidateUnicity(name, commands[j], validation_messages, validation_messages_count);
+			commands[i]->ValidateUnicity(name, commands[j], diagnostics);
 		}
 	}
 }
 
-void ldfscheduletable::ToLdfFile(FILE *f, ldf *db)
+void ldfscheduletable::ToLdfFile(ldfwriter *w, ldf *db)
 {
-	fprintf(f, "    %s {\r\n", name);
+	w->Text("    ");
+	w->Text(name);
+	w->Text(" {\r\n");
 	for (uint32_t i = 0; i < commands_count; i++)
-		fprintf(f, "        %s delay %d ms;\r\n", commands[i]->GetStrCommand(db), commands[i]->GetTimeoutMs());
-	fprintf(f, "    }\r\n");
+	{
+		w->Text("        ");
+		w->Text(commands[i]->GetStrCommand(db));
+		w->Text(" delay ");
+		w->Dec(commands[i]->GetTimeoutMs());
+		w->Text(" ms;\r\n");
+	}
+	w->Text("    }\r\n");
+}
+
+size_t ldfscheduletable::GetMemoryFootprint()
+{
+	size_t size = sizeof(*this) + commands_capacity * sizeof(commands[0]);
+
+	for (uint32_t i = 0; i < commands_count; i++)
+		size += sizeof(*commands[i]);
+
+	return size;
 }
 
 }
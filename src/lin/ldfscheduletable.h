@@ -11,6 +11,9 @@
 #include <stdint.h>
 #include <ldfframe.h>
 #include <ldfschedulecommand.h>
+#include <ldfindex.h>
+#include <ldfdiagnostics.h>
+#include <ldfwriter.h>
 
 
 namespace lin
@@ -24,16 +27,17 @@ private:
 	uint8_t *name;
 
 	// Schedule commands
-	ldfschedulecommand *commands[1000];
-	uint16_t commands_count;
+	ldfschedulecommand **commands;
+	uint32_t commands_count;
+	uint32_t commands_capacity;
 
 public:
-	ldfscheduletable(const uint8_t *name);
+	ldfscheduletable(ldfstrings *strings, const uint8_t *name);
 	virtual ~ldfscheduletable();
 
 	uint8_t *GetName();
 	ldfschedulecommand *GetCommandByIndex(uint32_t ix);
-	uint16_t GetCommandsCount();
+	uint32_t GetCommandsCount();
 	void UpdateCommandsFrameName(const uint8_t *old_name, const uint8_t *new_name);
 	void UpdateCommandsSlaveName(const uint8_t *old_name, const uint8_t *new_name);
 	void DeleteCommandsByFrameName(const uint8_t *name);
@@ -41,10 +45,12 @@ public:
 	void DeleteCommandByIndex(uint32_t ix);
 
 	void AddCommand(ldfschedulecommand *command);
-	void ValidateUnicity(ldfscheduletable *table, uint8_t **validation_messages, uint32_t *validation_messages_count);
-	void ValidateFrames(ldfframe **frames, uint32_t frames_count, uint8_t **validation_messages, uint32_t *validation_messages_count);
+	void ValidateUnicity(ldfscheduletable *table, ldfdiagnostics *diagnostics);
+	void ValidateFrames(ldfindex *frames_by_name, ldfdiagnostics *diagnostics);
 
-	void ToLdfFile(FILE *f, ldf *db);
+	void ToLdfFile(ldfwriter *w, ldf *db);
+
+	size_t GetMemoryFootprint();
 
 };
 
@@ -15,108 +15,98 @@
 
 namespace lin {
 
-ldfsignal::ldfsignal(const uint8_t *name, uint8_t bit_size, uint32_t default_value, const uint8_t *publisher, const uint8_t **subscribers, uint8_t subscribers_count)
+ldfsignal::ldfsignal(ldfstrings *strings, const uint8_t *name, uint8_t bit_size, uint32_t default_value, const uint8_t *publisher, const uint8_t **subscribers, uint32_t subscribers_count)
 {
-	// Copy name
-	this->name = StrDup(name);
+	// Intern names
+	this->name = strings->Intern(name);
 	this->bit_size = bit_size;
 	this->default_value = default_value;
-	this->publisher = StrDup(publisher);
+	this->publisher = strings->Intern(publisher);
+	this->subscribers = (uint8_t **)malloc(subscribers_count * sizeof(uint8_t *));
 	for (this->subscribers_count = 0; this->subscribers_count < subscribers_count; this->subscribers_count++)
-		this->subscribers[this->subscribers_count] = StrDup(subscribers[this->subscribers_count]);
+		this->subscribers[this->subscribers_count] = strings->Intern(subscribers[this->subscribers_count]);
 }
 
 ldfsignal::~ldfsignal()
 {
-	// Erase resources
-	if (name != NULL)
-		delete name;
-	if (publisher != NULL)
-		delete publisher;
-	while (subscribers_count > 0)
-		delete subscribers[--subscribers_count];
+	free(subscribers);
 }
 
-ldfsignal *ldfsignal::FromLdfStatement(uint8_t *statement)
+ldfsignal *ldfsignal::FromLdfStatement(ldfstrings *strings, uint8_t *statement)
 {
 	char *p = NULL;
+	char *save = NULL;
 	char *name = NULL;
 	uint8_t bit_size = 0;
 	uint32_t default_value = 0;
 	char *publisher = NULL;
-	char *subscribers[128];
-	uint8_t subscribers_count = 0;
+	char **subscribers = NULL;
+	uint32_t subscribers_count = 0;
+	uint32_t subscribers_capacity = 0;
+	ldfsignal *signal = NULL;
 
 	// Signal name
-	p = strtok((char *)statement, ":," BLANK_CHARACTERS);
+	p = strtok_r((char *)statement, ":," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	name = p;
 
 	// Bit size
-	p = strtok(NULL, ":," BLANK_CHARACTERS);
+	p = strtok_r(NULL, ":," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	bit_size = ParseInt(p);
 
 	// Default value
-	p = strtok(NULL, ":," BLANK_CHARACTERS);
+	p = strtok_r(NULL, ":," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	default_value = ParseInt(p);
 
 	// Publisher
-	p = strtok(NULL, ":," BLANK_CHARACTERS);
+	p = strtok_r(NULL, ":," BLANK_CHARACTERS, &save);
 	if (!p) return NULL;
 	publisher = p;
 
 	// Subscribers
 	while (p)
 	{
-		p = strtok(NULL, ":," BLANK_CHARACTERS);
-		if (p) subscribers[subscribers_count++] = p;
+		p = strtok_r(NULL, ":," BLANK_CHARACTERS, &save);
+		if (p) ArrayAppend(&subscribers, &subscribers_count, &subscribers_capacity, p);
 	}
 
 	// Validate and return new signal
 	if (name != NULL && publisher != NULL && subscribers_count != 0)
 	{
-		return new ldfsignal(
+		signal = new ldfsignal(strings,
 				Str(name), bit_size, default_value,
 				Str(publisher),
 				(const uint8_t **)subscribers, subscribers_count);
 	}
-	else
-	{
-		return NULL;
-	}
+
+	free(subscribers);
+	return signal;
 }
 
-void ldfsignal::ValidateNodes(ldfnode *master, ldfnode **slaves, uint32_t slaves_count, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfsignal::ValidateNodes(ldfnode *master, ldfnode **slaves, uint32_t slaves_count, ldfdiagnostics *diagnostics)
 {
 	uint32_t i;
-	char str[1000];
-
 	if (!ldfnode::CheckNodeName(publisher, master, slaves, slaves_count))
 	{
-		sprintf(str, STR_ERR "Publisher '%s' not defined in database", publisher);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_SIGNAL_PUBLISHER, name, publisher, 0);
 	}
 
 	for (i = 0; i < subscribers_count; i++)
 	{
 		if (!ldfnode::CheckNodeName(subscribers[i], master, slaves, slaves_count))
 		{
-			sprintf(str, STR_ERR "Subscriber '%s' not defined in database", subscribers[i]);
-			validation_messages[*validation_messages_count++] = StrDup(str);
+			diagnostics->Add(ldfdiagnostics::LDF_DIAG_SIGNAL_SUBSCRIBER, name, subscribers[i], 0);
 		}
 	}
 }
 
-void ldfsignal::ValidateUnicity(ldfsignal *signal, uint8_t **validation_messages, uint32_t *validation_messages_count)
+void ldfsignal::ValidateUnicity(ldfsignal *signal, ldfdiagnostics *diagnostics)
 {
-	char str[1000];
-
-	if (StrEq(name, signal->name))
+	if (NameEq(name, signal->name))
 	{
-		sprintf(str, STR_ERR "Signal '%s' is defined twice", name);
-		validation_messages[*validation_messages_count++] = StrDup(str);
+		diagnostics->Add(ldfdiagnostics::LDF_DIAG_SIGNAL_REPEATED, name, NULL, 0);
 	}
 }
 
@@ -152,9 +142,9 @@ uint8_t *ldfsignal::GetSubscriber(uint32_t ix)
 
 bool ldfsignal::UsesSlave(const uint8_t *slave_name)
 {
-	bool in_use = StrEq(slave_name, publisher);
+	bool in_use = NameEq(slave_name, publisher);
 	for (uint32_t jx = 0; !in_use && jx < subscribers_count; jx++)
-		in_use = StrEq(slave_name, subscribers[jx]);
+		in_use = NameEq(slave_name, subscribers[jx]);
 
 	return in_use;
 }
@@ -162,30 +152,38 @@ bool ldfsignal::UsesSlave(const uint8_t *slave_name)
 void ldfsignal::UpdateNodeName(const uint8_t *old_name, const uint8_t *new_name)
 {
 	// Update publisher, otherwise update subscribers
-	if (StrEq(old_name, publisher))
+	if (NameEq(old_name, publisher))
 	{
-		delete publisher;
-		publisher = StrDup(new_name);
+		publisher = (uint8_t *)new_name;
 	}
 	else
 	{
-		for (int i = 0; i < subscribers_count; i++)
+		for (uint32_t i = 0; i < subscribers_count; i++)
 		{
-			if (!StrEq(old_name, subscribers[i])) continue;
+			if (!NameEq(old_name, subscribers[i])) continue;
 
-			delete subscribers[i];
-			subscribers[i] = StrDup(new_name);
+			subscribers[i] = (uint8_t *)new_name;
 			break;
 		}
 	}
 }
 
-void ldfsignal::ToLdfFile(FILE *f)
+void ldfsignal::ToLdfFile(ldfwriter *w)
 {
-	fprintf(f, "    %s: %d, 0x%X, %s", name, bit_size, default_value, publisher);
+	w->Text("    ");
+	w->Text(name);
+	w->Text(": ");
+	w->Dec(bit_size);
+	w->Text(", 0x");
+	w->Hex(default_value, 0, true);
+	w->Text(", ");
+	w->Text(publisher);
 	for (uint32_t i = 0; i < subscribers_count; i++)
-		fprintf(f, ", %s", subscribers[i]);
-	fprintf(f, ";\r\n");
+	{
+		w->Text(", ");
+		w->Text(subscribers[i]);
+	}
+	w->Text(";\r\n");
 }
 
 int32_t ldfsignal::Compare(const ldfsignal *a, const ldfsignal *b)
@@ -202,5 +200,10 @@ int32_t ldfsignal::ComparePublisher(const ldfsignal *a, const ldfsignal *b)
 	return strcmp((char *)a->publisher, (char *)b->publisher);
 }
 
+size_t ldfsignal::GetMemoryFootprint()
+{
+	return sizeof(*this) + subscribers_count * sizeof(subscribers[0]);
+}
+
 
 } /* namespace lin */
@@ -10,6 +10,8 @@
 
 #include <stdint.h>
 #include <ldfnode.h>
+#include <ldfdiagnostics.h>
+#include <ldfwriter.h>
 
 namespace lin {
 
@@ -20,17 +22,17 @@ private:
 	uint8_t bit_size;
 	uint32_t default_value;
 	uint8_t *publisher;
-	uint8_t *subscribers[128];
-	uint8_t subscribers_count;
+	uint8_t **subscribers;
+	uint32_t subscribers_count;
 
 public:
-	ldfsignal(const uint8_t *name, uint8_t bit_size, uint32_t default_value, const uint8_t *publisher, const uint8_t **subscribers, uint8_t subscribers_count);
+	ldfsignal(ldfstrings *strings, const uint8_t *name, uint8_t bit_size, uint32_t default_value, const uint8_t *publisher, const uint8_t **subscribers, uint32_t subscribers_count);
 	virtual ~ldfsignal();
 
-	static ldfsignal *FromLdfStatement(uint8_t *statement);
+	static ldfsignal *FromLdfStatement(ldfstrings *strings, uint8_t *statement);
 
-	void ValidateNodes(ldfnode *master, ldfnode **slaves, uint32_t slaves_count, uint8_t **validation_messages, uint32_t *validation_messages_count);
-	void ValidateUnicity(ldfsignal *signal, uint8_t **validation_messages, uint32_t *validation_messages_count);
+	void ValidateNodes(ldfnode *master, ldfnode **slaves, uint32_t slaves_count, ldfdiagnostics *diagnostics);
+	void ValidateUnicity(ldfsignal *signal, ldfdiagnostics *diagnostics);
 	const uint8_t *GetName();
 	uint8_t GetBitSize();
 	uint32_t GetDefaultValue();
@@ -41,11 +43,13 @@ public:
 	bool UsesSlave(const uint8_t *slave_name);
 	void UpdateNodeName(const uint8_t *old_name, const uint8_t *new_name);
 
-	void ToLdfFile(FILE *f);
+	void ToLdfFile(ldfwriter *w);
 
 	static int32_t Compare(const ldfsignal *a, const ldfsignal *b);
 	static int32_t ComparePublisher(const ldfsignal *a, const ldfsignal *b);
 
+	size_t GetMemoryFootprint();
+
 };
 
 } /* namespace lin */
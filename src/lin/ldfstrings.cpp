@@ -0,0 +1,167 @@
+/*
+ * ldfstrings.cpp
+ *
+ *  Created on: 14 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ldfstrings.h>
+
+
+#define LDFSTRINGS_BLOCK_SIZE				65536
+#define LDFSTRINGS_TABLE_SIZE				1024
+
+
+namespace lin {
+
+ldfstrings::ldfstrings()
+{
+	blocks = NULL;
+	arena_size = 0;
+	table_size = LDFSTRINGS_TABLE_SIZE;
+	table = (entry_s *)calloc(table_size, sizeof(entry_s));
+	count = 0;
+}
+
+ldfstrings::~ldfstrings()
+{
+	// Release the arena block by block
+	while (blocks != NULL)
+	{
+		block_s *next = blocks->next;
+		free(blocks);
+		blocks = next;
+	}
+
+	free(table);
+}
+
+uint32_t ldfstrings::Hash(const uint8_t *s, size_t *length)
+{
+	uint32_t h = 2166136261u;
+	const uint8_t *p;
+
+	for (p = s; *p; p++)
+		h = (h ^ *p) * 16777619u;
+
+	*length = p - s;
+	return h;
+}
+
+void ldfstrings::Grow()
+{
+	entry_s *old_table = table;
+	uint32_t old_size = table_size;
+
+	// Double the table and place all entries again
+	table_size *= 2;
+	table = (entry_s *)calloc(table_size, sizeof(entry_s));
+	for (uint32_t i = 0; i < old_size; i++)
+	{
+		if (old_table[i].str == NULL) continue;
+
+		uint32_t j = old_table[i].hash & (table_size - 1);
+		while (table[j].str != NULL) j = (j + 1) & (table_size - 1);
+		table[j] = old_table[i];
+	}
+
+	free(old_table);
+}
+
+void *ldfstrings::Alloc(size_t size)
+{
+	uint8_t *p;
+
+	// Keep all allocations 8 bytes aligned
+	size = (size + 7) & ~(size_t)7;
+
+	// Open a new block when the current one is full, big requests get their own block
+	if (blocks == NULL || blocks->used + size > blocks->size)
+	{
+		size_t block_size = (size > LDFSTRINGS_BLOCK_SIZE) ? size : LDFSTRINGS_BLOCK_SIZE;
+		block_s *b = (block_s *)malloc(sizeof(block_s) + block_size);
+
+		b->size = block_size;
+		b->used = 0;
+		b->next = blocks;
+		blocks = b;
+		arena_size += sizeof(block_s) + block_size;
+	}
+
+	p = (uint8_t *)(blocks + 1) + blocks->used;
+	blocks->used += size;
+
+	return p;
+}
+
+uint8_t *ldfstrings::Intern(const uint8_t *s)
+{
+	size_t length;
+	uint32_t h, i;
+
+	if (s == NULL)
+		return NULL;
+
+	// Look for the string
+	h = Hash(s, &length);
+	for (i = h & (table_size - 1); table[i].str != NULL; i = (i + 1) & (table_size - 1))
+	{
+		if (table[i].hash == h && strcmp((const char *)table[i].str, (const char *)s) == 0)
+			return table[i].str;
+	}
+
+	// Copy it into the arena
+	table[i].str = (uint8_t *)Alloc(length + 1);
+	table[i].hash = h;
+	memcpy(table[i].str, s, length + 1);
+	s = table[i].str;
+	count++;
+
+	// Keep load factor under 1/2
+	if (2 * count > table_size)
+		Grow();
+
+	return (uint8_t *)s;
+}
+
+uint8_t *ldfstrings::Intern(const char *s)
+{
+	return Intern((const uint8_t *)s);
+}
+
+uint8_t *ldfstrings::Find(const uint8_t *s)
+{
+	size_t length;
+	uint32_t h, i;
+
+	if (s == NULL)
+		return NULL;
+
+	h = Hash(s, &length);
+	for (i = h & (table_size - 1); table[i].str != NULL; i = (i + 1) & (table_size - 1))
+	{
+		if (table[i].str == s || (table[i].hash == h && strcmp((const char *)table[i].str, (const char *)s) == 0))
+			return table[i].str;
+	}
+
+	return NULL;
+}
+
+uint32_t ldfstrings::GetCount()
+{
+	return count;
+}
+
+size_t ldfstrings::GetArenaSize()
+{
+	return arena_size;
+}
+
+size_t ldfstrings::GetMemoryFootprint()
+{
+	return sizeof(*this) + arena_size + table_size * sizeof(entry_s);
+}
+
+} /* namespace lin */
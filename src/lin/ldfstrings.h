@@ -0,0 +1,75 @@
+/*
+ * ldfstrings.h
+ *
+ *  Created on: 14 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LDFSTRINGS_H_
+#define LIN_LDFSTRINGS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace lin {
+
+/*
+ * Interned identifiers of a database. Every distinct name is stored once in an
+ * arena owned by the database, so two names are equal only if they are the same
+ * pointer. Entities keep pointers into the table and never release them, the
+ * whole arena is released at once with the database.
+ *
+ * Names handed to entity methods (Update*, Set*, Delete*, Uses*) shall already
+ * be interned in the database table; text coming from elsewhere goes through
+ * Intern() or Find() first.
+ */
+class ldfstrings {
+
+private:
+	struct block_s
+	{
+		block_s *next;
+		size_t size;
+		size_t used;
+	};
+
+	struct entry_s
+	{
+		uint8_t *str;
+		uint32_t hash;
+	};
+
+	// Arena blocks, the newest one first
+	block_s *blocks;
+	size_t arena_size;
+
+	// Open addressing hash table
+	entry_s *table;
+	uint32_t table_size;
+	uint32_t count;
+
+	static uint32_t Hash(const uint8_t *s, size_t *length);
+	void *Alloc(size_t size);
+	void Grow();
+
+public:
+	ldfstrings();
+	virtual ~ldfstrings();
+
+	uint8_t *Intern(const uint8_t *s);
+	uint8_t *Intern(const char *s);
+	uint8_t *Find(const uint8_t *s);
+
+	uint32_t GetCount();
+	size_t GetArenaSize();
+	size_t GetMemoryFootprint();
+
+};
+
+// Interned names compare by address
+inline bool NameEq(const uint8_t *a, const uint8_t *b) { return a != NULL && a == b; }
+
+} /* namespace lin */
+
+#endif /* LIN_LDFSTRINGS_H_ */
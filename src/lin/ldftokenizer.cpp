@@ -0,0 +1,123 @@
+/*
+ * ldftokenizer.cpp
+ *
+ *  Created on: 12 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <ldftokenizer.h>
+
+
+using namespace std;
+
+
+namespace lin {
+
+ldftokenizer::ldftokenizer(const uint8_t *filename)
+{
+	struct stat st;
+
+	data = NULL;
+	size = 0;
+	position = 0;
+	skip = false;
+
+	// Open file
+	int fd = open((const char *)filename, O_RDONLY);
+	if (fd < 0)
+	{
+		throw runtime_error("Filename does not exist");
+	}
+
+	// Map the file privately, so statements can be terminated in place without touching the file
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		throw runtime_error("Filename cannot be read");
+	}
+	if (st.st_size > 0)
+	{
+		void *p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED)
+		{
+			close(fd);
+			throw runtime_error("Filename cannot be read");
+		}
+
+		data = (uint8_t *)p;
+		size = st.st_size;
+		madvise(data, size, MADV_SEQUENTIAL);
+	}
+
+	// The mapping keeps its own reference to the file
+	close(fd);
+}
+
+ldftokenizer::~ldftokenizer()
+{
+	if (data) munmap(data, size);
+}
+
+bool ldftokenizer::Next(ldftoken_s *token)
+{
+	uint8_t *start = NULL;
+
+	while (position < size)
+	{
+		uint8_t *p = data + position;
+
+		switch (*p)
+		{
+
+		case ';':
+		case '{':
+		case '}':
+			// Close the span in place, an empty span is an empty string at the delimiter
+			token->type = (*p == ';') ? LDF_TOKEN_STATEMENT : (*p == '{') ? LDF_TOKEN_GROUP_START : LDF_TOKEN_GROUP_END;
+			token->text = (start != NULL) ? start : p;
+			token->length = p - token->text;
+			*p = 0;
+			position++;
+			return true;
+
+		case '/':
+			// Comments are valid to the end of the line, blank them if they are inside a span
+			skip = true;
+			if (start) *p = ' ';
+			break;
+
+		case '\n':
+			skip = false;
+			break;
+
+		case ' ':
+		case '\t':
+		case '\r':
+			break;
+
+		default:
+			if (skip)
+			{
+				if (start) *p = ' ';
+			}
+			else if (start == NULL)
+			{
+				start = p;
+			}
+			break;
+
+		}
+
+		position++;
+	}
+
+	// Text after the last delimiter is not a statement
+	return false;
+}
+
+} /* namespace lin */
@@ -0,0 +1,50 @@
+/*
+ * ldftokenizer.h
+ *
+ *  Created on: 12 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LDFTOKENIZER_H_
+#define LIN_LDFTOKENIZER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace lin {
+
+class ldftokenizer {
+
+public:
+	enum ldftokentype_e
+	{
+		LDF_TOKEN_STATEMENT,		// Text terminated by ';'
+		LDF_TOKEN_GROUP_START,		// Text terminated by '{'
+		LDF_TOKEN_GROUP_END			// Text terminated by '}'
+	};
+
+	struct ldftoken_s
+	{
+		ldftokentype_e type;
+		uint8_t *text;				// Points into the mapped file, NUL terminated in place
+		uint32_t length;
+	};
+
+private:
+	uint8_t *data;
+	size_t size;
+	size_t position;
+	bool skip;
+
+public:
+	ldftokenizer(const uint8_t *filename);
+	virtual ~ldftokenizer();
+
+	bool Next(ldftoken_s *token);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LDFTOKENIZER_H_ */
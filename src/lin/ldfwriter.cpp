@@ -0,0 +1,205 @@
+/*
+ * ldfwriter.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ldfwriter.h>
+
+
+// Initial size of in memory text, and size of the buffer of streams
+#define LDFWRITER_BUFFER_SIZE				65536
+
+// Longest text of a Printf expected to fit without a second pass
+#define LDFWRITER_PRINTF_SIZE				256
+
+
+namespace lin {
+
+ldfwriter::ldfwriter()
+{
+	buffer = NULL;
+	length = 0;
+	capacity = 0;
+	fd = -1;
+	ok = true;
+}
+
+ldfwriter::ldfwriter(int fd) : ldfwriter()
+{
+	this->fd = fd;
+}
+
+ldfwriter::~ldfwriter()
+{
+	free(buffer);
+}
+
+void ldfwriter::Reserve(size_t n)
+{
+	if (length + n <= capacity)
+		return;
+
+	// Streams empty the buffer before growing it
+	if (fd >= 0)
+	{
+		Flush();
+		if (length + n <= capacity)
+			return;
+	}
+
+	capacity = (capacity == 0) ? LDFWRITER_BUFFER_SIZE : capacity;
+	while (length + n > capacity) capacity *= 2;
+	buffer = (char *)realloc(buffer, capacity);
+}
+
+void ldfwriter::Text(const char *s)
+{
+	size_t n;
+
+	// Same output as printf for NULL strings
+	if (s == NULL)
+		s = "(null)";
+
+	n = strlen(s);
+	Reserve(n);
+	memcpy(buffer + length, s, n);
+	length += n;
+}
+
+void ldfwriter::Text(const uint8_t *s)
+{
+	Text((const char *)s);
+}
+
+void ldfwriter::Char(char c)
+{
+	Reserve(1);
+	buffer[length++] = c;
+}
+
+void ldfwriter::Dec(int32_t v)
+{
+	char digits[12];
+	uint32_t u = (v < 0) ? 0u - (uint32_t)v : (uint32_t)v;
+	int n = 0;
+
+	// Write digits backwards, then the sign
+	do
+	{
+		digits[n++] = '0' + (u % 10);
+		u /= 10;
+	} while (u != 0);
+	if (v < 0)
+		digits[n++] = '-';
+
+	Reserve(n);
+	while (n > 0)
+		buffer[length++] = digits[--n];
+}
+
+void ldfwriter::Hex(uint32_t v, uint8_t digits, bool upper)
+{
+	const char *symbols = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+	char text[8];
+	int n = 0;
+
+	// Write digits backwards, padding with zeros up to the requested width
+	do
+	{
+		text[n++] = symbols[v & 0xF];
+		v >>= 4;
+	} while (v != 0);
+
+	Reserve(((digits > n) ? digits : n));
+	for (int i = n; i < digits; i++)
+		buffer[length++] = '0';
+	while (n > 0)
+		buffer[length++] = text[--n];
+}
+
+void ldfwriter::Printf(const char *format, ...)
+{
+	va_list args;
+	int n;
+
+	// Format in place, a second pass is only needed for long texts
+	Reserve(LDFWRITER_PRINTF_SIZE);
+	va_start(args, format);
+	n = vsnprintf(buffer + length, capacity - length, format, args);
+	va_end(args);
+	if (n < 0)
+		return;
+
+	if ((size_t)n >= capacity - length)
+	{
+		Reserve(n + 1);
+		va_start(args, format);
+		vsnprintf(buffer + length, capacity - length, format, args);
+		va_end(args);
+	}
+
+	length += n;
+}
+
+const char *ldfwriter::GetBuffer()
+{
+	return buffer;
+}
+
+size_t ldfwriter::GetLength()
+{
+	return length;
+}
+
+bool ldfwriter::Flush()
+{
+	size_t written = 0;
+
+	// Text in memory is written with WriteFile
+	if (fd < 0)
+		return ok;
+
+	while (ok && written < length)
+	{
+		ssize_t n = write(fd, buffer + written, length - written);
+		if (n <= 0)
+			ok = false;
+		else
+			written += n;
+	}
+	length = 0;
+
+	return ok;
+}
+
+bool ldfwriter::WriteFile(const uint8_t *filename)
+{
+	size_t written = 0;
+	int file;
+
+	// Open file
+	file = open((const char *)filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (file < 0)
+		return false;
+
+	// Write all the text, usually at once
+	while (written < length)
+	{
+		ssize_t n = write(file, buffer + written, length - written);
+		if (n <= 0)
+			break;
+		written += n;
+	}
+
+	return (close(file) == 0) && (written == length);
+}
+
+} /* namespace lin */
@@ -0,0 +1,61 @@
+/*
+ * ldfwriter.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LDFWRITER_H_
+#define LIN_LDFWRITER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace lin {
+
+/*
+ * Output buffer for LDF text. Names and integers are copied straight into the
+ * buffer without parsing a format, and the whole text is written to the file
+ * with a single system call. A writer opened on a file descriptor streams the
+ * text instead, flushing the buffer every time it fills up.
+ *
+ * Text is printed like printf does, NULL strings included, so the output does
+ * not change from the one written with stdio.
+ */
+class ldfwriter {
+
+private:
+	char *buffer;
+	size_t length;
+	size_t capacity;
+
+	// Stream descriptor, -1 when the text is kept in memory
+	int fd;
+	bool ok;
+
+	void Reserve(size_t n);
+
+public:
+	ldfwriter();
+	ldfwriter(int fd);
+	virtual ~ldfwriter();
+
+	void Text(const char *s);
+	void Text(const uint8_t *s);
+	void Char(char c);
+	void Dec(int32_t v);
+	void Hex(uint32_t v, uint8_t digits, bool upper);
+	void Printf(const char *format, ...);
+
+	const char *GetBuffer();
+	size_t GetLength();
+
+	bool Flush();
+	bool WriteFile(const uint8_t *filename);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LDFWRITER_H_ */
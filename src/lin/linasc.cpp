@@ -0,0 +1,638 @@
+/*
+ * linasc.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linprotocol.h>
+#include <linasc.h>
+
+
+// Version of the logging format written in the header
+#define LIN_ASC_VERSION						"13.0.0"
+
+// Width of the time column, spaces first
+#define LIN_ASC_TIME_WIDTH					11
+
+
+namespace lin {
+
+static const char hex_digits[] = "0123456789abcdef";
+
+// Value of every hexadecimal digit, -1 for the rest of characters
+struct linasc_digits_s
+{
+	int8_t value[256];
+};
+
+static constexpr linasc_digits_s MakeDigits()
+{
+	linasc_digits_s d = {};
+
+	for (int c = 0; c < 256; c++)
+		d.value[c] = -1;
+	for (int c = 0; c < 10; c++)
+		d.value['0' + c] = c;
+	for (int c = 0; c < 6; c++)
+		d.value['a' + c] = d.value['A' + c] = 10 + c;
+
+	return d;
+}
+
+static constexpr linasc_digits_s digits_table = MakeDigits();
+
+static const uint64_t pow10[] = { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+		100000000ull, 1000000000ull };
+
+
+static inline bool IsSpace(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+static inline char *Skip(char *p, const char *e)
+{
+	while (p < e && IsSpace(*p)) p++;
+	return p;
+}
+
+// Word followed by a space or the end of the line, the cursor is left after it
+static bool Word(char **p, const char *e, const char *word)
+{
+	size_t n = strlen(word);
+	char *q = Skip(*p, e);
+
+	if ((size_t)(e - q) < n || memcmp(q, word, n) != 0 || (q + n < e && !IsSpace(q[n])))
+		return false;
+
+	*p = q + n;
+	return true;
+}
+
+// Seconds with up to nine decimals into nanoseconds, further decimals are dropped
+static bool ParseTime(char **p, const char *e, uint64_t *ns)
+{
+	uint64_t seconds = 0, fraction = 0;
+	uint32_t decimals = 0;
+	char *q = *p;
+
+	if (q == e || (unsigned)(*q - '0') > 9)
+		return false;
+
+	while (q < e && (unsigned)(*q - '0') <= 9)
+		seconds = seconds * 10 + (*q++ - '0');
+
+	if (q < e && *q == '.')
+	{
+		for (q++; q < e && (unsigned)(*q - '0') <= 9; q++)
+		{
+			if (decimals < 9)
+			{
+				fraction = fraction * 10 + (*q - '0');
+				decimals++;
+			}
+		}
+	}
+
+	*ns = seconds * 1000000000ull + fraction * pow10[9 - decimals];
+	*p = q;
+	return true;
+}
+
+
+linascreader::linascreader(ldf *db)
+{
+	this->db = db;
+	fd = -1;
+	buffer = NULL;
+	start = 0;
+	end = 0;
+	eof = true;
+	hex = true;
+	relative = false;
+	timestamp = 0;
+	lines = 0;
+	frames = 0;
+	skipped = 0;
+	bytes = 0;
+}
+
+linascreader::~linascreader()
+{
+	Close();
+}
+
+bool linascreader::Open(const char *filename)
+{
+	Close();
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	// One more byte, names at the end of the buffer are ended in place
+	buffer = (char *)malloc(LIN_ASC_BUFFER_SIZE + 1);
+	start = 0;
+	end = 0;
+	eof = false;
+
+	// Defaults of Vector tools when the header says nothing
+	hex = true;
+	relative = false;
+	timestamp = 0;
+
+	lines = 0;
+	frames = 0;
+	skipped = 0;
+	bytes = 0;
+
+	return true;
+}
+
+void linascreader::Close()
+{
+	if (fd >= 0)
+		close(fd);
+	free(buffer);
+
+	fd = -1;
+	buffer = NULL;
+	eof = true;
+}
+
+char *linascreader::NextLine(char **line_end)
+{
+	bool discard = false;
+
+	while (fd >= 0)
+	{
+		char *line = buffer + start;
+		char *nl = (char *)memchr(line, '\n', end - start);
+		ssize_t n;
+
+		if (nl != NULL || (eof && start < end))
+		{
+			// The last line can come without new line
+			if (nl == NULL)
+				nl = buffer + end;
+			start = (nl - buffer) + (nl < buffer + end);
+
+			// Tail of a line longer than the buffer
+			if (discard)
+			{
+				discard = false;
+				continue;
+			}
+
+			lines++;
+			*line_end = (nl > line && nl[-1] == '\r') ? nl - 1 : nl;
+			return line;
+		}
+		if (eof)
+			break;
+
+		// Keep the partial line and read after it, lines filling the whole buffer are skipped
+		if (start == 0 && end == LIN_ASC_BUFFER_SIZE)
+		{
+			if (!discard)
+			{
+				lines++;
+				skipped++;
+			}
+			discard = true;
+			end = 0;
+		}
+		else
+		{
+			memmove(buffer, buffer + start, end - start);
+			end -= start;
+			start = 0;
+		}
+
+		n = read(fd, buffer + end, LIN_ASC_BUFFER_SIZE - end);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			eof = true;
+		else
+		{
+			end += n;
+			bytes += n;
+		}
+	}
+
+	return NULL;
+}
+
+// base hex|dec  timestamps absolute|relative
+void linascreader::ParseHeader(const char *p, const char *e)
+{
+	char *q = (char *)p + 4;
+
+	if (Word(&q, e, "hex"))
+		hex = true;
+	else if (Word(&q, e, "dec"))
+		hex = false;
+
+	if (Word(&q, e, "timestamps"))
+	{
+		if (Word(&q, e, "absolute"))
+			relative = false;
+		else if (Word(&q, e, "relative"))
+			relative = true;
+	}
+}
+
+bool linascreader::ParseNumber(const char **p, const char *e, uint32_t *v)
+{
+	const char *q = *p;
+	const char *digits;
+	uint32_t value = 0;
+
+	if (hex)
+	{
+		if (e - q > 2 && q[0] == '0' && (q[1] == 'x' || q[1] == 'X'))
+			q += 2;
+
+		for (digits = q; q < e && digits_table.value[(uint8_t)*q] >= 0; q++)
+			value = (value << 4) | digits_table.value[(uint8_t)*q];
+	}
+	else
+	{
+		for (digits = q; q < e && (unsigned)(*q - '0') <= 9; q++)
+			value = value * 10 + (*q - '0');
+	}
+
+	// From one to eight digits, and the whole word
+	if (q == digits || q - digits > 8 || (q < e && !IsSpace(*q)))
+		return false;
+
+	*v = value;
+	*p = q;
+	return true;
+}
+
+// Number of the frame or its name in the database
+bool linascreader::ParseId(char **p, char *e, uint8_t *id)
+{
+	char *q = Skip(*p, e);
+	char *w = q;
+	uint32_t v;
+	ldfframe *f;
+	char c;
+
+	// Names first, names of hex digits like ACC are numbers too. Names do not start with a digit.
+	if (db != NULL && q < e && (unsigned)(*q - '0') > 9)
+	{
+		// Name ended in place for the strings table
+		for (w = q; w < e && !IsSpace(*w); w++)
+			;
+		c = *w;
+		*w = '\0';
+		f = db->GetFrameByName((const uint8_t *)q);
+		*w = c;
+
+		if (f != NULL && f->GetId() < LIN_PROTOCOL_IDS)
+		{
+			*id = f->GetId();
+			*p = w;
+			return true;
+		}
+		w = q;
+	}
+
+	if (!ParseNumber((const char **)&w, e, &v) || v >= LIN_PROTOCOL_IDS)
+		return false;
+
+	*id = v;
+	*p = w;
+	return true;
+}
+
+bool linascreader::ParseEvent(char *p, char *e, lincapture::lincaptureframe_s *frame)
+{
+	uint64_t t;
+	uint32_t v;
+	uint8_t id;
+
+	// Time, every event moves relative timestamps
+	if (!ParseTime(&p, e, &t))
+		return false;
+	timestamp = relative ? timestamp + t : t;
+
+	// Channel, L1 is bus 0
+	p = Skip(p, e);
+	if (p == e || *p != 'L')
+		return false;
+	for (p++, v = 0; p < e && (unsigned)(*p - '0') <= 9; p++)
+		v = v * 10 + (*p - '0');
+	if (v == 0 || v > 256 || (p < e && !IsSpace(*p)))
+		return false;
+
+	memset(frame, 0, sizeof(*frame));
+	frame->timestamp = timestamp;
+	frame->bus = v - 1;
+
+	// Errors
+	if (Word(&p, e, "TransmErr"))
+		frame->flags = lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE;
+	else if (Word(&p, e, "CSErr"))
+		frame->flags = lincapture::LIN_CAPTURE_ERROR_CHECKSUM;
+	else if (Word(&p, e, "RcvError:"))
+		frame->flags = lincapture::LIN_CAPTURE_ERROR_FRAMING;
+	if (frame->flags != 0 && !(Word(&p, e, "id") && Word(&p, e, "=")))
+		return false;
+
+	if (!ParseId(&p, e, &id))
+		return false;
+	frame->pid = linprotocol::Pid(id);
+	if (frame->flags & (lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE | lincapture::LIN_CAPTURE_ERROR_FRAMING))
+		return true;
+
+	// Response
+	if (!Word(&p, e, "Rx") && !Word(&p, e, "Tx"))
+		return false;
+	p = Skip(p, e);
+	if (!ParseNumber((const char **)&p, e, &v) || v > 8)
+		return false;
+	frame->length = v;
+
+	// Data bytes, two hexadecimal digits in the usual case
+	for (uint8_t i = 0; i < frame->length; i++)
+	{
+		int8_t h, l;
+
+		p = Skip(p, e);
+		if (hex && e - p >= 2 && (h = digits_table.value[(uint8_t)p[0]]) >= 0 &&
+			(l = digits_table.value[(uint8_t)p[1]]) >= 0 && (e - p == 2 || IsSpace(p[2])))
+		{
+			frame->data[i] = (h << 4) | l;
+			p += 2;
+			continue;
+		}
+		if (!ParseNumber((const char **)&p, e, &v) || v > 0xFF)
+			return false;
+		frame->data[i] = v;
+	}
+
+	if (!Word(&p, e, "checksum") || !Word(&p, e, "="))
+		return false;
+	p = Skip(p, e);
+	if (!ParseNumber((const char **)&p, e, &v) || v > 0xFF)
+		return false;
+	frame->checksum = v;
+
+	return true;
+}
+
+bool linascreader::Next(lincapture::lincaptureframe_s *frame)
+{
+	char *line, *e;
+
+	while ((line = NextLine(&e)) != NULL)
+	{
+		char *p = Skip(line, e);
+
+		if (p == e)
+			continue;
+
+		// Events start with their time, other lines are headers or comments
+		if ((unsigned)(*p - '0') <= 9)
+		{
+			if (ParseEvent(p, e, frame))
+			{
+				frames++;
+				return true;
+			}
+			skipped++;
+		}
+		else if (e - p > 4 && memcmp(p, "base", 4) == 0 && IsSpace(p[4]))
+		{
+			ParseHeader(p, e);
+		}
+	}
+
+	return false;
+}
+
+uint64_t linascreader::GetLinesCount()
+{
+	return lines;
+}
+
+uint64_t linascreader::GetFramesCount()
+{
+	return frames;
+}
+
+uint64_t linascreader::GetSkippedLinesCount()
+{
+	return skipped;
+}
+
+uint64_t linascreader::GetBytesCount()
+{
+	return bytes;
+}
+
+
+linascwriter::linascwriter(ldf *db)
+{
+	this->db = db;
+	fd = -1;
+	out = NULL;
+	origin = 0;
+	frames = 0;
+}
+
+linascwriter::~linascwriter()
+{
+	Close();
+}
+
+bool linascwriter::Open(const char *filename)
+{
+	char date[64];
+	time_t now;
+	struct tm tm;
+
+	Close();
+
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0)
+		return false;
+	out = new ldfwriter(fd);
+	frames = 0;
+
+	// Date as Vector tools write it, "Sat Oct 17 06:50:00.000 pm 2026"
+	now = time(NULL);
+	localtime_r(&now, &tm);
+	strftime(date, sizeof(date), "%a %b %d %I:%M:%S.000 ", &tm);
+	strcat(date, (tm.tm_hour < 12) ? "am" : "pm");
+	strftime(date + strlen(date), sizeof(date) - strlen(date), " %Y", &tm);
+
+	// Header
+	out->Text("date ");
+	out->Text(date);
+	out->Text("\nbase hex  timestamps absolute\n");
+	out->Text("internal events logged\n");
+	out->Text("// version " LIN_ASC_VERSION "\n");
+	out->Text("Begin Triggerblock ");
+	out->Text(date);
+	out->Char('\n');
+	out->Text("   0.000000 Start of measurement\n");
+
+	return true;
+}
+
+bool linascwriter::Close()
+{
+	bool ok;
+
+	if (fd < 0)
+		return true;
+
+	out->Text("End TriggerBlock\n");
+	ok = out->Flush();
+	delete out;
+	ok = (close(fd) == 0) && ok;
+
+	fd = -1;
+	out = NULL;
+
+	return ok;
+}
+
+void linascwriter::SetOrigin(uint64_t timestamp)
+{
+	origin = timestamp;
+}
+
+// Seconds with LIN_ASC_DECIMALS decimals, right aligned in the time column
+char *linascwriter::FormatTime(char *p, uint64_t timestamp)
+{
+	uint64_t t = (timestamp > origin) ? timestamp - origin : 0;
+	uint64_t seconds = t / 1000000000ull;
+	uint64_t fraction = (t % 1000000000ull) / pow10[9 - LIN_ASC_DECIMALS];
+	char digits[20];
+	int n = 0;
+
+	do
+	{
+		digits[n++] = '0' + (seconds % 10);
+		seconds /= 10;
+	} while (seconds != 0);
+
+	for (int i = n + 1 + LIN_ASC_DECIMALS; i < LIN_ASC_TIME_WIDTH; i++)
+		*p++ = ' ';
+	while (n > 0)
+		*p++ = digits[--n];
+
+	*p++ = '.';
+	for (int i = LIN_ASC_DECIMALS - 1; i >= 0; i--)
+	{
+		p[i] = '0' + (fraction % 10);
+		fraction /= 10;
+	}
+
+	return p + LIN_ASC_DECIMALS;
+}
+
+static inline char *FormatHex(char *p, uint8_t v)
+{
+	*p++ = hex_digits[v >> 4];
+	*p++ = hex_digits[v & 0xF];
+	return p;
+}
+
+static inline char *FormatText(char *p, const char *s)
+{
+	while (*s != '\0')
+		*p++ = *s++;
+	return p;
+}
+
+bool linascwriter::Write(const lincapture::lincaptureframe_s *frame)
+{
+	uint8_t id = frame->pid & 0x3F;
+	uint8_t length = (frame->length > 8) ? 8 : frame->length;
+	uint32_t bus = frame->bus + 1;
+	ldfframe *f;
+	char line[128];
+	char *p = line;
+
+	if (fd < 0)
+		return false;
+
+	// Time and channel
+	p = FormatTime(p, frame->timestamp);
+	p = FormatText(p, " L");
+	if (bus >= 100) *p++ = '0' + bus / 100;
+	if (bus >= 10) *p++ = '0' + (bus / 10) % 10;
+	*p++ = '0' + bus % 10;
+	*p++ = ' ';
+
+	// Errors without response carry the ID only, the rest of errors are framing errors
+	if (frame->flags & lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE)
+	{
+		p = FormatText(p, "TransmErr id = ");
+		p = FormatHex(p, id);
+	}
+	else if (frame->flags & ~lincapture::LIN_CAPTURE_ERROR_CHECKSUM)
+	{
+		p = FormatText(p, "RcvError: id = ");
+		p = FormatHex(p, id);
+	}
+	else
+	{
+		if (frame->flags & lincapture::LIN_CAPTURE_ERROR_CHECKSUM)
+		{
+			p = FormatText(p, "CSErr id = ");
+			p = FormatHex(p, id);
+		}
+		else if (db != NULL && (f = db->GetFrameById(id)) != NULL)
+		{
+			// Names can be long, they are written on their own
+			*p = '\0';
+			out->Text(line);
+			out->Text(f->GetName());
+			p = line;
+		}
+		else
+		{
+			p = FormatHex(p, id);
+		}
+
+		p = FormatText(p, " Rx ");
+		*p++ = '0' + length;
+		for (uint8_t i = 0; i < length; i++)
+		{
+			*p++ = ' ';
+			p = FormatHex(p, frame->data[i]);
+		}
+		p = FormatText(p, " checksum = ");
+		p = FormatHex(p, frame->checksum);
+	}
+
+	*p++ = '\n';
+	*p = '\0';
+	out->Text(line);
+	frames++;
+
+	return true;
+}
+
+uint64_t linascwriter::GetFramesCount()
+{
+	return frames;
+}
+
+} /* namespace lin */
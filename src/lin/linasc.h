@@ -0,0 +1,131 @@
+/*
+ * linasc.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINASC_H_
+#define LIN_LINASC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ldf.h>
+#include <ldfwriter.h>
+#include <lincapture.h>
+
+
+// Text is read in chunks of this size, longer lines are skipped
+#define LIN_ASC_BUFFER_SIZE					(1 << 20)
+
+// Decimals of the timestamps written, microseconds like Vector tools
+#define LIN_ASC_DECIMALS					6
+
+
+namespace lin {
+
+/*
+ * Streaming reader of Vector ASC text logs of LIN traffic. The file is read in
+ * chunks of a fixed buffer, so memory does not grow with its size, and lines
+ * are split and parsed in place: timestamps, IDs and data bytes are converted
+ * with lookup tables, without sscanf or strtod.
+ *
+ * These events are read, the rest of lines are skipped:
+ *
+ *   <time> L<bus> <id> Rx|Tx <length> <data> ... checksum = <checksum> ...
+ *   <time> L<bus> TransmErr id = <id> ...
+ *   <time> L<bus> CSErr id = <id> Rx|Tx <length> <data> ... checksum = <checksum> ...
+ *   <time> L<bus> RcvError: id = <id> ...
+ *
+ * as headers without response, checksum errors and framing errors. Numbers are
+ * hexadecimal or decimal as the "base" header line says, and timestamps are the
+ * seconds since the start of the measurement, absolute or relative to the
+ * previous event as the same line says. IDs can be frame names too, they are
+ * looked up in the database when given before being read as numbers, so names
+ * of hexadecimal digits like ACC are not taken for IDs.
+ */
+class linascreader {
+
+private:
+	ldf *db;
+	int fd;
+
+	// Text between start and end is read and not parsed yet
+	char *buffer;
+	size_t start;
+	size_t end;
+	bool eof;
+
+	bool hex;
+	bool relative;
+	uint64_t timestamp;
+
+	uint64_t lines;
+	uint64_t frames;
+	uint64_t skipped;
+	uint64_t bytes;
+
+	char *NextLine(char **line_end);
+	void ParseHeader(const char *p, const char *e);
+	bool ParseEvent(char *p, char *e, lincapture::lincaptureframe_s *frame);
+	bool ParseId(char **p, char *e, uint8_t *id);
+	bool ParseNumber(const char **p, const char *e, uint32_t *v);
+
+public:
+	// The database is only needed for frame names, it can be NULL
+	linascreader(ldf *db);
+	virtual ~linascreader();
+
+	bool Open(const char *filename);
+	void Close();
+
+	// Next frame event of the log, false at the end of the file
+	bool Next(lincapture::lincaptureframe_s *frame);
+
+	uint64_t GetLinesCount();
+	uint64_t GetFramesCount();
+	uint64_t GetSkippedLinesCount();
+	uint64_t GetBytesCount();
+
+};
+
+/*
+ * Streaming writer of Vector ASC text logs, with hexadecimal numbers and
+ * absolute timestamps. Lines are formatted with lookup tables into the buffer
+ * of a stream ldfwriter, which writes it to the file every time it fills up.
+ *
+ * When a database is given, frames with an ID of the database are written with
+ * the frame name instead of the ID, as symbolic logs are.
+ */
+class linascwriter {
+
+private:
+	ldf *db;
+	int fd;
+	ldfwriter *out;
+
+	// Time written as 0, the start of the measurement
+	uint64_t origin;
+	uint64_t frames;
+
+	char *FormatTime(char *p, uint64_t timestamp);
+
+public:
+	linascwriter(ldf *db);
+	virtual ~linascwriter();
+
+	bool Open(const char *filename);
+	bool Close();
+
+	// Frames before the origin are written at 0
+	void SetOrigin(uint64_t timestamp);
+
+	bool Write(const lincapture::lincaptureframe_s *frame);
+
+	uint64_t GetFramesCount();
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINASC_H_ */
@@ -0,0 +1,193 @@
+/*
+ * lincapture.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <lincapture.h>
+
+
+using namespace std;
+
+
+// Smallest ring, in frames
+#define LIN_CAPTURE_MIN_CAPACITY			16
+
+
+namespace lin {
+
+// Sequence of a slot holding frame n, odd while it is written
+static inline uint64_t Written(uint64_t n)
+{
+	return 2 * n + 2;
+}
+
+static inline uint64_t Writing(uint64_t n)
+{
+	return 2 * n + 1;
+}
+
+lincapture::lincapture(uint32_t capacity) : head(0), sleeping(0), wake(0)
+{
+	uint32_t size = LIN_CAPTURE_MIN_CAPACITY;
+
+	// Power of two, so positions map to slots with a mask
+	while (size < capacity && size < 0x80000000u)
+		size <<= 1;
+
+	slots = new slot_s[size];
+	for (uint32_t i = 0; i < size; i++)
+		slots[i].sequence.store(0, memory_order_relaxed);
+	mask = size - 1;
+}
+
+lincapture::~lincapture()
+{
+	delete[] slots;
+}
+
+uint32_t lincapture::GetCapacity()
+{
+	return mask + 1;
+}
+
+uint64_t lincapture::GetWritten()
+{
+	return head.load(memory_order_acquire);
+}
+
+void lincapture::Write(const lincaptureframe_s *frame)
+{
+	uint64_t n = head.load(memory_order_relaxed);
+	slot_s *s = &slots[n & mask];
+	uint64_t data;
+
+	memcpy(&data, frame->data, sizeof(data));
+
+	// Mark the slot as being written before touching the frame
+	s->sequence.store(Writing(n), memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	s->timestamp.store(frame->timestamp, memory_order_relaxed);
+	s->data.store(data, memory_order_relaxed);
+	s->info.store(frame->pid | (frame->length << 8) | (frame->checksum << 16) | ((uint64_t)frame->flags << 24) | ((uint64_t)frame->bus << 32),
+			memory_order_relaxed);
+	s->sequence.store(Written(n), memory_order_release);
+
+	// Publish, and wake sleeping consumers only when there are any
+	head.store(n + 1, memory_order_seq_cst);
+	if (sleeping.load(memory_order_seq_cst) != 0 && sleeping.exchange(0, memory_order_seq_cst) != 0)
+	{
+		wake.fetch_add(1, memory_order_seq_cst);
+		syscall(SYS_futex, (uint32_t *)&wake, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+	}
+}
+
+lincapturereader::lincapturereader(lincapture *ring)
+{
+	this->ring = ring;
+	position = ring->GetWritten();
+	read = 0;
+	dropped = 0;
+}
+
+lincapturereader::~lincapturereader()
+{
+}
+
+void lincapturereader::Skip(uint64_t position)
+{
+	if (position > this->position)
+	{
+		dropped += position - this->position;
+		this->position = position;
+	}
+}
+
+uint32_t lincapturereader::Read(lincapture::lincaptureframe_s *frames, uint32_t count)
+{
+	uint64_t head = ring->head.load(memory_order_acquire);
+	uint64_t capacity = ring->mask + 1;
+	uint32_t n = 0;
+
+	// Frames older than the ring size are gone
+	if (head - position > capacity)
+		Skip(head - capacity);
+
+	while (n < count && position < head)
+	{
+		lincapture::slot_s *s = &ring->slots[position & ring->mask];
+		uint64_t expected = Written(position);
+		uint64_t timestamp, data, info;
+
+		// Copy the frame, it is good if the slot sequence did not change meanwhile
+		if (s->sequence.load(memory_order_acquire) == expected)
+		{
+			timestamp = s->timestamp.load(memory_order_relaxed);
+			data = s->data.load(memory_order_relaxed);
+			info = s->info.load(memory_order_relaxed);
+			atomic_thread_fence(memory_order_acquire);
+
+			if (s->sequence.load(memory_order_relaxed) == expected)
+			{
+				lincapture::lincaptureframe_s *f = &frames[n++];
+
+				f->timestamp = timestamp;
+				memcpy(f->data, &data, sizeof(f->data));
+				f->pid = info;
+				f->length = info >> 8;
+				f->checksum = info >> 16;
+				f->flags = info >> 24;
+				f->bus = info >> 32;
+				position++;
+				continue;
+			}
+		}
+
+		// Overwritten, the writer is a whole ring ahead or writing this slot again
+		head = ring->head.load(memory_order_acquire);
+		Skip((head > position + capacity) ? head - capacity : position + 1);
+	}
+
+	read += n;
+	return n;
+}
+
+bool lincapturereader::Wait(int timeout_ms)
+{
+	struct timespec ts;
+	uint32_t wake;
+
+	if (position < ring->head.load(memory_order_acquire))
+		return true;
+
+	// Announce the wait before checking again, so a frame written meanwhile wakes it
+	ring->sleeping.store(1, memory_order_seq_cst);
+	wake = ring->wake.load(memory_order_seq_cst);
+	if (position >= ring->head.load(memory_order_seq_cst))
+	{
+		ts.tv_sec = timeout_ms / 1000;
+		ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+		syscall(SYS_futex, (uint32_t *)&ring->wake, FUTEX_WAIT_PRIVATE, wake, (timeout_ms < 0) ? NULL : &ts, NULL, 0);
+	}
+
+	return position < ring->head.load(memory_order_acquire);
+}
+
+uint64_t lincapturereader::GetRead()
+{
+	return read;
+}
+
+uint64_t lincapturereader::GetDropped()
+{
+	return dropped;
+}
+
+} /* namespace lin */
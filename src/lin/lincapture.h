@@ -0,0 +1,120 @@
+/*
+ * lincapture.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINCAPTURE_H_
+#define LIN_LINCAPTURE_H_
+
+#include <stdint.h>
+#include <atomic>
+
+
+namespace lin {
+
+/*
+ * Ring of captured frames, written by the thread reading the bus and read by
+ * any number of consumers (GUI, loggers, analyzers), each one getting every
+ * frame.
+ *
+ * The writer never waits: it overwrites the oldest frames whether they were
+ * read or not. Every slot holds a sequence number, odd while it is written
+ * (a per slot seqlock), so consumers detect frames overwritten before or while
+ * they read them, and count them as dropped. Consumers falling behind only
+ * lose frames, they never slow down the writer or the other consumers.
+ *
+ * One ring has one writer. Several buses are captured with one ring each, or
+ * into one ring from a single thread polling them all.
+ */
+class lincapture {
+
+public:
+	enum lincaptureflags_e
+	{
+		LIN_CAPTURE_ERROR_PARITY = 0x01,		// Protected ID with wrong parity
+		LIN_CAPTURE_ERROR_CHECKSUM = 0x02,
+		LIN_CAPTURE_ERROR_SYNC = 0x04,			// Break not followed by 0x55
+		LIN_CAPTURE_ERROR_FRAMING = 0x08,
+		LIN_CAPTURE_ERROR_NO_RESPONSE = 0x10,	// Header without response
+		LIN_CAPTURE_ERROR_INCOMPLETE = 0x20		// Response shorter than expected
+	};
+
+	struct lincaptureframe_s
+	{
+		uint64_t timestamp;				// CLOCK_MONOTONIC nanoseconds of the break
+		uint8_t data[8];
+		uint8_t pid;
+		uint8_t length;					// Data bytes received
+		uint8_t checksum;
+		uint8_t flags;					// lincaptureflags_e
+		uint8_t bus;
+	};
+
+private:
+	friend class lincapturereader;
+
+	// Frame in three words, so it is copied with atomic accesses
+	struct slot_s
+	{
+		std::atomic<uint64_t> sequence;
+		std::atomic<uint64_t> timestamp;
+		std::atomic<uint64_t> data;
+		std::atomic<uint64_t> info;
+	};
+
+	slot_s *slots;
+	uint32_t mask;
+	alignas(64) std::atomic<uint64_t> head;
+
+	// Set by consumers going to sleep in Wait(), cleared by the writer when it
+	// wakes them through a futex on wake, so it wakes them once and not per frame
+	alignas(64) std::atomic<uint32_t> sleeping;
+	std::atomic<uint32_t> wake;
+
+public:
+	lincapture(uint32_t capacity);
+	virtual ~lincapture();
+
+	uint32_t GetCapacity();
+	uint64_t GetWritten();
+
+	// Writer thread only
+	void Write(const lincaptureframe_s *frame);
+
+};
+
+/*
+ * Consumer of a capture ring, used by one thread. It reads the frames written
+ * after it was created, in order, counting the ones overwritten before it got
+ * to them.
+ */
+class lincapturereader {
+
+private:
+	lincapture *ring;
+	uint64_t position;
+	uint64_t read;
+	uint64_t dropped;
+
+	void Skip(uint64_t position);
+
+public:
+	lincapturereader(lincapture *ring);
+	virtual ~lincapturereader();
+
+	// Copies up to count frames, returns how many
+	uint32_t Read(lincapture::lincaptureframe_s *frames, uint32_t count);
+
+	// Sleeps until there are frames to read or timeout_ms pass, -1 waits forever
+	bool Wait(int timeout_ms);
+
+	uint64_t GetRead();
+	uint64_t GetDropped();
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINCAPTURE_H_ */
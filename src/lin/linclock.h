@@ -0,0 +1,36 @@
+/*
+ * linclock.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINCLOCK_H_
+#define LIN_LINCLOCK_H_
+
+#include <stdint.h>
+#include <time.h>
+
+
+namespace lin {
+
+/*
+ * Time of the LIN runtime: nanoseconds of CLOCK_MONOTONIC, the clock the master
+ * node and the replay sleep on and the serial transport stamps bytes with.
+ */
+class linclock {
+
+public:
+	static inline uint64_t Now()
+	{
+		struct timespec ts;
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINCLOCK_H_ */
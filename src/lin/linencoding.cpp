@@ -0,0 +1,399 @@
+/*
+ * linencoding.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <linencoding.h>
+
+
+// Longest byte array, in bytes
+#define LIN_ENCODING_MAX_BYTES				8
+
+
+namespace lin {
+
+linencoding::linencoding(ldf *db)
+{
+	this->db = db;
+	types = NULL;
+	types_count = 0;
+	signals = NULL;
+	signals_count = 0;
+
+	Compile();
+}
+
+linencoding::~linencoding()
+{
+	FreeTypes();
+}
+
+void linencoding::FreeTypes()
+{
+	for (uint32_t i = 0; i < types_count; i++)
+	{
+		delete[] types[i].logical;
+		delete[] types[i].direct;
+	}
+	delete[] types;
+	delete[] signals;
+	types = NULL;
+	types_count = 0;
+	signals = NULL;
+	signals_count = 0;
+	signals_by_name.Clear();
+}
+
+static int CompareLogical(const void *a, const void *b)
+{
+	uint32_t va = ((const linencoding::linencodinglogical_s *)a)->value;
+	uint32_t vb = ((const linencoding::linencodinglogical_s *)b)->value;
+
+	return (va > vb) - (va < vb);
+}
+
+void linencoding::Compile()
+{
+	FreeTypes();
+
+	// Encoding types
+	types_count = db->GetEncodingTypesCount();
+	types = new linencodingtype_s[types_count];
+	for (uint32_t i = 0; i < types_count; i++)
+	{
+		linencodingtype_s *t = &types[i];
+		ldfencodingtype *e = db->GetEncodingTypeByIndex(i);
+		ldfphysicalvalue *pv = e->GetPhysicalValue();
+
+		memset(t, 0, sizeof(*t));
+		t->type = e;
+		if (e->GetTreatAsBcd()) t->flags |= LIN_ENCODING_BCD;
+		if (e->GetTreatAsAscii()) t->flags |= LIN_ENCODING_ASCII;
+
+		// Physical range, min and max are raw values
+		if (pv != NULL)
+		{
+			t->flags |= LIN_ENCODING_PHYSICAL;
+			t->min = (pv->GetMin() > 0) ? (uint32_t)pv->GetMin() : 0;
+			t->max = (pv->GetMax() > 0) ? (uint32_t)pv->GetMax() : 0;
+			t->scale = pv->GetScale();
+			t->offset = pv->GetOffset();
+			t->unit = pv->GetDescription();
+		}
+
+		// Logical values sorted by value for a binary search
+		t->logical_count = e->GetLogicalValuesCount();
+		if (t->logical_count == 0)
+			continue;
+		t->flags |= LIN_ENCODING_LOGICAL;
+		t->logical = new linencodinglogical_s[t->logical_count];
+		for (uint32_t j = 0; j < t->logical_count; j++)
+		{
+			t->logical[j].value = e->GetLogicalValue(j)->GetValue();
+			t->logical[j].text = e->GetLogicalValue(j)->GetDescription();
+		}
+		qsort(t->logical, t->logical_count, sizeof(t->logical[0]), CompareLogical);
+
+		// Small values are also indexed by value
+		if (t->logical[t->logical_count - 1].value < LIN_ENCODING_DIRECT_VALUES)
+		{
+			t->direct_count = t->logical[t->logical_count - 1].value + 1;
+			t->direct = new const uint8_t *[t->direct_count];
+			memset(t->direct, 0, t->direct_count * sizeof(t->direct[0]));
+			for (uint32_t j = 0; j < t->logical_count; j++)
+				t->direct[t->logical[j].value] = t->logical[j].text;
+		}
+	}
+
+	// Signals, without encoding until a representation names them
+	signals_count = db->GetSignalsCount();
+	signals = new linencodingsignal_s[signals_count];
+	for (uint32_t i = 0; i < signals_count; i++)
+	{
+		signals[i].signal = db->GetSignalByIndex(i);
+		signals[i].encoding = NULL;
+		signals[i].size = signals[i].signal->GetBitSize();
+		signals_by_name.Put(signals[i].signal->GetName(), &signals[i]);
+	}
+
+	// Signal representations
+	for (uint32_t i = 0; i < db->GetEncodingSignalsCount(); i++)
+	{
+		ldfencodingsignals *es = db->GetEncodingSignalsByIndex(i);
+		const linencodingtype_s *t = NULL;
+
+		for (uint32_t j = 0; j < types_count; j++)
+			if (NameEq(types[j].type->GetName(), es->GetEncodingName()))
+				t = &types[j];
+		if (t == NULL)
+			continue;
+
+		for (uint32_t j = 0; j < es->GetSignalsCount(); j++)
+		{
+			linencodingsignal_s *s = (linencodingsignal_s *)signals_by_name.Get(es->GetSignal(j));
+			if (s != NULL)
+				s->encoding = t;
+		}
+	}
+}
+
+const linencoding::linencodingsignal_s *linencoding::GetSignalByIndex(uint32_t ix)
+{
+	return (ix < signals_count) ? &signals[ix] : NULL;
+}
+
+const linencoding::linencodingsignal_s *linencoding::GetSignalByName(const uint8_t *name)
+{
+	name = db->GetStrings()->Find(name);
+	if (name == NULL)
+		return NULL;
+
+	return (const linencodingsignal_s *)signals_by_name.Get(name);
+}
+
+uint32_t linencoding::GetSignalsCount()
+{
+	return signals_count;
+}
+
+void linencoding::ToPhysical(const linencodingsignal_s *s, const uint32_t *raw, double *physical, uint32_t count)
+{
+	const linencodingtype_s *t = s->encoding;
+
+	// Signals without physical encoding show the raw value
+	if (t == NULL || !(t->flags & LIN_ENCODING_PHYSICAL))
+	{
+		for (uint32_t i = 0; i < count; i++)
+			physical[i] = raw[i];
+		return;
+	}
+
+	// Physical range, the scale may be negative
+	double scale = t->scale, offset = t->offset;
+	double lo = t->min * scale + offset;
+	double hi = t->max * scale + offset;
+	if (lo > hi)
+	{
+		double v = lo;
+		lo = hi;
+		hi = v;
+	}
+
+	// Branch free and on signed values, so it is vectorized
+	for (uint32_t i = 0; i < count; i++)
+	{
+		double v = (int32_t)raw[i] * scale + offset;
+		physical[i] = (v >= lo && v <= hi) ? v : NAN;
+	}
+}
+
+void linencoding::FromPhysical(const linencodingsignal_s *s, const double *physical, uint32_t *raw, uint32_t count)
+{
+	const linencodingtype_s *t = s->encoding;
+	double limit = (s->size >= 32) ? 4294967295.0 : (double)((1ull << s->size) - 1);
+	double min = 0, max = limit, scale = 1, offset = 0;
+
+	if (t != NULL && (t->flags & LIN_ENCODING_PHYSICAL) && t->scale != 0)
+	{
+		min = t->min;
+		max = (t->max < limit) ? t->max : limit;
+		scale = t->scale;
+		offset = t->offset;
+	}
+
+	// Nearest raw value in the physical range, NaN gives the minimum
+	for (uint32_t i = 0; i < count; i++)
+	{
+		double v = nearbyint((physical[i] - offset) / scale);
+		if (!(v >= min)) v = min;
+		if (v > max) v = max;
+		raw[i] = (uint32_t)v;
+	}
+}
+
+void linencoding::ToLogical(const linencodingsignal_s *s, const uint32_t *raw, const uint8_t **text, uint32_t count)
+{
+	const linencodingtype_s *t = s->encoding;
+
+	if (t == NULL || t->logical_count == 0)
+	{
+		for (uint32_t i = 0; i < count; i++)
+			text[i] = NULL;
+		return;
+	}
+
+	// Small values by index
+	if (t->direct != NULL)
+	{
+		for (uint32_t i = 0; i < count; i++)
+			text[i] = (raw[i] < t->direct_count) ? t->direct[raw[i]] : NULL;
+		return;
+	}
+
+	// Binary search on the rest
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t lo = 0, hi = t->logical_count;
+
+		while (lo < hi)
+		{
+			uint32_t mid = (lo + hi) / 2;
+			if (t->logical[mid].value < raw[i])
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		text[i] = (lo < t->logical_count && t->logical[lo].value == raw[i]) ? t->logical[lo].text : NULL;
+	}
+}
+
+bool linencoding::FromLogical(const linencodingsignal_s *s, const uint8_t *text, uint32_t *raw)
+{
+	const linencodingtype_s *t = s->encoding;
+
+	if (t == NULL)
+		return false;
+
+	// Descriptions are interned, but the text may not come from the database
+	for (uint32_t i = 0; i < t->logical_count; i++)
+	{
+		if (strcmp((const char *)t->logical[i].text, (const char *)text) == 0)
+		{
+			*raw = t->logical[i].value;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool linencoding::ToBcd(const linencodingsignal_s *s, uint64_t raw, char *text)
+{
+	uint32_t bytes = s->size / 8;
+	bool valid = true;
+
+	if (bytes > LIN_ENCODING_MAX_BYTES) bytes = LIN_ENCODING_MAX_BYTES;
+
+	// Two digits per byte, most significant digit in the high nibble
+	for (uint32_t i = 0; i < bytes; i++)
+	{
+		uint8_t b = raw >> (i * 8);
+		uint8_t hi = b >> 4, lo = b & 0x0F;
+
+		valid = valid && hi <= 9 && lo <= 9;
+		*text++ = (hi <= 9) ? '0' + hi : '?';
+		*text++ = (lo <= 9) ? '0' + lo : '?';
+	}
+	*text = '\0';
+
+	return valid;
+}
+
+bool linencoding::FromBcd(const linencodingsignal_s *s, const char *text, uint64_t *raw)
+{
+	uint32_t bytes = s->size / 8;
+	uint32_t length = strlen(text);
+	uint32_t digits;
+
+	if (bytes > LIN_ENCODING_MAX_BYTES) bytes = LIN_ENCODING_MAX_BYTES;
+	digits = bytes * 2;
+	if (length > digits)
+		return false;
+
+	// Shorter numbers are padded with leading zeros
+	*raw = 0;
+	for (uint32_t i = 0; i < digits; i++)
+	{
+		uint64_t d = 0;
+
+		if (i >= digits - length)
+		{
+			char c = text[i - (digits - length)];
+			if (c < '0' || c > '9')
+				return false;
+			d = c - '0';
+		}
+		*raw |= d << ((i / 2) * 8 + ((i & 1) ? 0 : 4));
+	}
+
+	return true;
+}
+
+void linencoding::ToAscii(const linencodingsignal_s *s, uint64_t raw, char *text)
+{
+	uint32_t bytes = s->size / 8;
+
+	if (bytes > LIN_ENCODING_MAX_BYTES) bytes = LIN_ENCODING_MAX_BYTES;
+
+	// Up to the first null character
+	for (uint32_t i = 0; i < bytes; i++)
+	{
+		char c = raw >> (i * 8);
+		if (c == '\0')
+			break;
+		*text++ = c;
+	}
+	*text = '\0';
+}
+
+bool linencoding::FromAscii(const linencodingsignal_s *s, const char *text, uint64_t *raw)
+{
+	uint32_t bytes = s->size / 8;
+	uint32_t length = strlen(text);
+
+	if (bytes > LIN_ENCODING_MAX_BYTES) bytes = LIN_ENCODING_MAX_BYTES;
+	if (length > bytes)
+		return false;
+
+	// Shorter texts are padded with null characters
+	*raw = 0;
+	for (uint32_t i = 0; i < length; i++)
+		*raw |= (uint64_t)(uint8_t)text[i] << (i * 8);
+
+	return true;
+}
+
+uint32_t linencoding::ToText(const linencodingsignal_s *s, uint64_t raw, char *text, size_t size)
+{
+	const linencodingtype_s *t = s->encoding;
+	char buffer[LIN_ENCODING_MAX_BYTES * 2 + 1];
+	uint32_t value = raw;
+	const uint8_t *logical;
+	double physical;
+
+	if (t != NULL)
+	{
+		if (t->flags & LIN_ENCODING_BCD)
+		{
+			ToBcd(s, raw, buffer);
+			return snprintf(text, size, "%s", buffer);
+		}
+		if (t->flags & LIN_ENCODING_ASCII)
+		{
+			ToAscii(s, raw, buffer);
+			return snprintf(text, size, "\"%s\"", buffer);
+		}
+
+		ToLogical(s, &value, &logical, 1);
+		if (logical != NULL)
+			return snprintf(text, size, "%s", logical);
+
+		ToPhysical(s, &value, &physical, 1);
+		if ((t->flags & LIN_ENCODING_PHYSICAL) && !isnan(physical))
+		{
+			if (t->unit == NULL || t->unit[0] == '\0')
+				return snprintf(text, size, "%g", physical);
+			return snprintf(text, size, "%g %s", physical, t->unit);
+		}
+	}
+
+	return snprintf(text, size, "0x%llX", (unsigned long long)raw);
+}
+
+} /* namespace lin */
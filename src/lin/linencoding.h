@@ -0,0 +1,120 @@
+/*
+ * linencoding.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINENCODING_H_
+#define LIN_LINENCODING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ldf.h>
+
+
+// Logical values below this one are looked up in a table indexed by value
+#define LIN_ENCODING_DIRECT_VALUES			256
+
+
+namespace lin {
+
+/*
+ * Conversions of signal values with the encodings of a database. Every encoding
+ * type is compiled once into its physical range, scale and offset as numbers
+ * and its logical values sorted by value, or in a table indexed by value when
+ * they are small. Every signal is resolved once to its compiled encoding
+ * through Signal_representation.
+ *
+ * Scalar values (up to 31 bits, LIN scalars have 16) convert in batches over
+ * arrays of raw samples of one signal: the physical conversion is one multiply
+ * and add per sample without branches, so the compiler vectorizes it. Raw
+ * values outside the physical range give NaN. Byte arrays with BCD or ASCII
+ * encodings convert to and from text, with byte 0 (the first byte sent) as the
+ * first two digits or the first character.
+ *
+ * The encodings are compiled again with Compile() after the database changes.
+ */
+class linencoding {
+
+public:
+	enum linencodingflags_e
+	{
+		LIN_ENCODING_PHYSICAL = 0x01,
+		LIN_ENCODING_LOGICAL = 0x02,
+		LIN_ENCODING_BCD = 0x04,
+		LIN_ENCODING_ASCII = 0x08
+	};
+
+	struct linencodinglogical_s
+	{
+		uint32_t value;
+		const uint8_t *text;
+	};
+
+	struct linencodingtype_s
+	{
+		ldfencodingtype *type;
+		uint8_t flags;					// linencodingflags_e
+
+		// Physical range, in raw values
+		uint32_t min;
+		uint32_t max;
+		double scale;
+		double offset;
+		const uint8_t *unit;
+
+		// Logical values sorted by value, and by value when all are small
+		linencodinglogical_s *logical;
+		uint32_t logical_count;
+		const uint8_t **direct;
+		uint32_t direct_count;
+	};
+
+	struct linencodingsignal_s
+	{
+		ldfsignal *signal;
+		const linencodingtype_s *encoding;	// NULL for signals without encoding
+		uint8_t size;
+	};
+
+private:
+	ldf *db;
+	linencodingtype_s *types;
+	uint32_t types_count;
+	linencodingsignal_s *signals;
+	uint32_t signals_count;
+	ldfindex signals_by_name;
+
+	void FreeTypes();
+
+public:
+	linencoding(ldf *db);
+	virtual ~linencoding();
+
+	void Compile();
+
+	const linencodingsignal_s *GetSignalByIndex(uint32_t ix);
+	const linencodingsignal_s *GetSignalByName(const uint8_t *name);
+	uint32_t GetSignalsCount();
+
+	// Scalar signals, count samples at once
+	static void ToPhysical(const linencodingsignal_s *s, const uint32_t *raw, double *physical, uint32_t count);
+	static void FromPhysical(const linencodingsignal_s *s, const double *physical, uint32_t *raw, uint32_t count);
+	static void ToLogical(const linencodingsignal_s *s, const uint32_t *raw, const uint8_t **text, uint32_t count);
+	static bool FromLogical(const linencodingsignal_s *s, const uint8_t *text, uint32_t *raw);
+
+	// Byte array signals, text holds two characters per byte for BCD and one for ASCII, and the end of string
+	static bool ToBcd(const linencodingsignal_s *s, uint64_t raw, char *text);
+	static bool FromBcd(const linencodingsignal_s *s, const char *text, uint64_t *raw);
+	static void ToAscii(const linencodingsignal_s *s, uint64_t raw, char *text);
+	static bool FromAscii(const linencodingsignal_s *s, const char *text, uint64_t *raw);
+
+	// Value as shown to the user: logical text, physical value and unit, BCD, ASCII or raw value
+	static uint32_t ToText(const linencodingsignal_s *s, uint64_t raw, char *text, size_t size);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINENCODING_H_ */
@@ -0,0 +1,98 @@
+/*
+ * linlayout.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <linlayout.h>
+
+
+// Bits of the longest frame data
+#define LIN_LAYOUT_MAX_BITS					64
+
+
+namespace lin {
+
+linlayout::linlayout(ldf *db)
+{
+	this->db = db;
+	signals = NULL;
+	signals_count = 0;
+
+	Compile();
+}
+
+linlayout::~linlayout()
+{
+	delete[] signals;
+}
+
+void linlayout::Compile()
+{
+	uint32_t count = 0;
+
+	memset(frames, 0, sizeof(frames));
+	delete[] signals;
+
+	// Signals of all the frames in one array
+	for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		ldfframe *f = db->GetFrameById(id);
+		if (f != NULL)
+			count += f->GetSignalsCount();
+	}
+	signals = new linlayoutsignal_s[count];
+	signals_count = 0;
+
+	for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		linlayoutframe_s *lf = &frames[id];
+		ldfframe *f = db->GetFrameById(id);
+		uint32_t bits;
+		uint64_t used = 0;
+
+		if (f == NULL)
+			continue;
+
+		lf->frame = f;
+		lf->length = (f->GetSize() <= 8) ? f->GetSize() : 8;
+		lf->first = signals_count;
+		lf->count = f->GetSignalsCount();
+		bits = lf->length * 8;
+
+		for (uint32_t i = 0; i < lf->count; i++)
+		{
+			linlayoutsignal_s *ls = &signals[signals_count++];
+			ldfframesignal *fs = f->GetSignal(i);
+			uint32_t offset = fs->GetOffset();
+			uint32_t size;
+
+			ls->signal = db->GetSignalByName(fs->GetName());
+			ls->shift = 0;
+			ls->size = 0;
+			ls->mask = 0;
+
+			// Undefined signals and signals starting after the data keep an empty mask
+			if (ls->signal == NULL || offset >= bits)
+				continue;
+
+			// Bits past the end of the data are dropped
+			size = ls->signal->GetBitSize();
+			if (size > bits - offset)
+				size = bits - offset;
+
+			ls->shift = offset;
+			ls->size = size;
+			ls->mask = (size >= LIN_LAYOUT_MAX_BITS) ? ~0ull : ((1ull << size) - 1);
+			used |= ls->mask << offset;
+		}
+
+		// Unused bits are recessive
+		lf->fill = ~used;
+		if (bits < LIN_LAYOUT_MAX_BITS)
+			lf->fill &= (1ull << bits) - 1;
+	}
+}
+
+} /* namespace lin */
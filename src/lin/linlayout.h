@@ -0,0 +1,106 @@
+/*
+ * linlayout.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINLAYOUT_H_
+#define LIN_LINLAYOUT_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <endian.h>
+#include <ldf.h>
+#include <linprotocol.h>
+
+
+namespace lin {
+
+/*
+ * Signal layouts of the frames of a database, compiled for packing and unpacking
+ * all the signals of a frame in one pass.
+ *
+ * LIN sends the data least significant bit first, so the data of a frame read
+ * as a little endian 64 bit word has the signal at offset N starting at bit N
+ * of the word. Every signal, scalar or byte array, is then one shift and one
+ * mask of that word, whatever its alignment. Signal values are kept in frame
+ * signal order, with byte arrays as little endian values.
+ *
+ * Frames are looked up by ID. The layouts are compiled again with Compile()
+ * after the database changes.
+ */
+class linlayout {
+
+public:
+	struct linlayoutsignal_s
+	{
+		uint64_t mask;					// Value bits, 0 for signals outside the frame or undefined
+		uint8_t shift;					// Offset in the frame
+		uint8_t size;
+		ldfsignal *signal;
+	};
+
+	struct linlayoutframe_s
+	{
+		uint64_t fill;					// Bits not used by any signal, sent as 1
+		uint8_t length;					// Data bytes, up to 8
+		uint32_t first;					// First signal in the signals array
+		uint32_t count;
+		ldfframe *frame;
+	};
+
+private:
+	ldf *db;
+	linlayoutframe_s frames[LIN_PROTOCOL_IDS];
+	linlayoutsignal_s *signals;
+	uint32_t signals_count;
+
+public:
+	linlayout(ldf *db);
+	virtual ~linlayout();
+
+	void Compile();
+
+	// Frame layout, NULL when no frame uses the ID
+	inline const linlayoutframe_s *GetFrame(uint8_t id)
+	{
+		return (id < LIN_PROTOCOL_IDS && frames[id].frame != NULL) ? &frames[id] : NULL;
+	}
+
+	inline const linlayoutsignal_s *GetSignal(const linlayoutframe_s *f, uint32_t ix)
+	{
+		return (ix < f->count) ? &signals[f->first + ix] : NULL;
+	}
+
+	// Signal values to frame data, length bytes are written
+	inline void Pack(const linlayoutframe_s *f, const uint64_t *values, uint8_t *data)
+	{
+		const linlayoutsignal_s *s = &signals[f->first];
+		uint64_t word = f->fill;
+
+		for (uint32_t i = 0; i < f->count; i++)
+			word |= (values[i] & s[i].mask) << s[i].shift;
+
+		word = htole64(word);
+		memcpy(data, &word, f->length);
+	}
+
+	// Frame data to signal values, length bytes are read
+	inline void Unpack(const linlayoutframe_s *f, const uint8_t *data, uint64_t *values)
+	{
+		const linlayoutsignal_s *s = &signals[f->first];
+		uint64_t word = 0;
+
+		memcpy(&word, data, f->length);
+		word = le64toh(word);
+
+		for (uint32_t i = 0; i < f->count; i++)
+			values[i] = (word >> s[i].shift) & s[i].mask;
+	}
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINLAYOUT_H_ */
@@ -0,0 +1,266 @@
+/*
+ * linmaster.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <linclock.h>
+#include <linprotocol.h>
+#include <linmaster.h>
+
+
+// Master node time base and jitter are kept in tenths of millisecond
+#define LIN_MASTER_TENTH_MS_NS				100000ull
+#define LIN_MASTER_MS_NS					1000000ull
+
+
+namespace lin {
+
+linmaster::linmaster(ldf *db, linmastersend_t send, void *context) :
+		current(0), pending(-1), running(false), stopping(false)
+{
+	this->db = db;
+	this->send = send;
+	this->context = context;
+	tables = NULL;
+	tables_count = 0;
+	timebase_ns = 0;
+	jitter_ns = 0;
+	memset(&stats, 0, sizeof(stats));
+
+	Compile();
+}
+
+linmaster::~linmaster()
+{
+	FreeTables();
+}
+
+void linmaster::FreeTables()
+{
+	for (uint32_t i = 0; i < tables_count; i++)
+	{
+		delete[] tables[i].slots;
+		delete[] tables[i].stats;
+	}
+	delete[] tables;
+	tables = NULL;
+	tables_count = 0;
+}
+
+void linmaster::Compile()
+{
+	ldfmasternode *master = db->GetMasterNode();
+
+	FreeTables();
+
+	timebase_ns = master->GetTimebase() * LIN_MASTER_TENTH_MS_NS;
+	jitter_ns = master->GetJitter() * LIN_MASTER_TENTH_MS_NS;
+
+	tables_count = db->GetScheduleTablesCount();
+	tables = new linmastertable_s[tables_count];
+	for (uint32_t i = 0; i < tables_count; i++)
+	{
+		linmastertable_s *t = &tables[i];
+
+		t->table = db->GetScheduleTableByIndex(i);
+		t->count = t->table->GetCommandsCount();
+		t->slots = new linmasterslot_s[t->count];
+		t->stats = new linmasterslotstats_s[t->count];
+		memset(t->stats, 0, t->count * sizeof(linmasterslotstats_s));
+
+		for (uint32_t j = 0; j < t->count; j++)
+		{
+			linmasterslot_s *s = &t->slots[j];
+
+			s->command = t->table->GetCommandByIndex(j);
+			s->frame = NULL;
+
+			// Unconditional frames send their own ID, the rest are diagnostic frames
+			switch (s->command->GetType())
+			{
+			case ldfschedulecommand::LDF_SCMD_TYPE_UnconditionalFrame:
+				s->frame = db->GetFrameByName(s->command->GetFrameName());
+				s->pid = (s->frame != NULL) ? s->frame->GetPid() : 0;
+				break;
+			case ldfschedulecommand::LDF_SCMD_TYPE_SlaveResp:
+				s->pid = linprotocol::Pid(LIN_PROTOCOL_SLAVE_RESPONSE_ID);
+				break;
+			default:
+				s->pid = linprotocol::Pid(LIN_PROTOCOL_MASTER_REQUEST_ID);
+				break;
+			}
+
+			// Slots start on time base ticks, a slot lasts at least one tick
+			s->delay_ns = s->command->GetTimeoutMs() * LIN_MASTER_MS_NS;
+			if (timebase_ns > 0)
+				s->delay_ns = ((s->delay_ns + timebase_ns - 1) / timebase_ns) * timebase_ns;
+			if (s->delay_ns == 0)
+				s->delay_ns = (timebase_ns > 0) ? timebase_ns : LIN_MASTER_MS_NS;
+		}
+	}
+
+	current = 0;
+	pending = -1;
+	memset(&stats, 0, sizeof(stats));
+}
+
+uint32_t linmaster::GetScheduleTablesCount()
+{
+	return tables_count;
+}
+
+ldfscheduletable *linmaster::GetScheduleTable(uint32_t ix)
+{
+	return (ix < tables_count) ? tables[ix].table : NULL;
+}
+
+uint32_t linmaster::GetSlotsCount(uint32_t ix)
+{
+	return (ix < tables_count) ? tables[ix].count : 0;
+}
+
+const linmaster::linmasterslot_s *linmaster::GetSlot(uint32_t ix, uint32_t slot)
+{
+	return (ix < tables_count && slot < tables[ix].count) ? &tables[ix].slots[slot] : NULL;
+}
+
+const linmaster::linmasterslotstats_s *linmaster::GetSlotStats(uint32_t ix, uint32_t slot)
+{
+	return (ix < tables_count && slot < tables[ix].count) ? &tables[ix].stats[slot] : NULL;
+}
+
+void linmaster::GetStats(linmasterstats_s *stats)
+{
+	*stats = this->stats;
+}
+
+void linmaster::ResetStats()
+{
+	for (uint32_t i = 0; i < tables_count; i++)
+		memset(tables[i].stats, 0, tables[i].count * sizeof(linmasterslotstats_s));
+	memset(&stats, 0, sizeof(stats));
+}
+
+uint64_t linmaster::GetJitterNs()
+{
+	return jitter_ns;
+}
+
+bool linmaster::SetScheduleTable(const uint8_t *name)
+{
+	const uint8_t *n = db->GetStrings()->Find(name);
+
+	for (uint32_t i = 0; i < tables_count; i++)
+		if (NameEq(tables[i].table->GetName(), n))
+			return SetScheduleTable(i);
+
+	return false;
+}
+
+bool linmaster::SetScheduleTable(uint32_t ix)
+{
+	if (ix >= tables_count || tables[ix].count == 0)
+		return false;
+
+	// The running thread takes it at the next slot boundary
+	if (running)
+		pending = ix;
+	else
+		current = ix;
+
+	return true;
+}
+
+uint32_t linmaster::GetCurrentScheduleTable()
+{
+	return current;
+}
+
+bool linmaster::Run()
+{
+	uint32_t t = current;
+	uint32_t s = 0;
+	uint64_t deadline;
+
+	if (t >= tables_count || tables[t].count == 0)
+	{
+		stopping = false;
+		return false;
+	}
+
+	running = true;
+	deadline = linclock::Now();
+
+	while (!stopping)
+	{
+		struct timespec ts;
+		linmasterslot_s *slot;
+		linmasterslotstats_s *st;
+		uint64_t now, late;
+		int32_t p;
+
+		// Sleep until the absolute deadline of the slot
+		ts.tv_sec = deadline / 1000000000ull;
+		ts.tv_nsec = deadline % 1000000000ull;
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+			;
+
+		// Table switch requested during the last slot, up to its end
+		p = pending.exchange(-1);
+		if (p >= 0)
+		{
+			t = p;
+			s = 0;
+			current = t;
+			stats.switches++;
+		}
+		slot = &tables[t].slots[s];
+		st = &tables[t].stats[s];
+
+		// Observed jitter
+		now = linclock::Now();
+		late = (now > deadline) ? now - deadline : 0;
+		st->runs++;
+		st->total_jitter_ns += late;
+		if (late > st->max_jitter_ns)
+			st->max_jitter_ns = late;
+		if (late > jitter_ns)
+			st->misses++;
+
+		send(context, slot, deadline);
+
+		// Next slot, starting from the deadline and not from now so errors do not add up
+		deadline += slot->delay_ns;
+		if (++s == tables[t].count)
+		{
+			s = 0;
+			stats.cycles++;
+		}
+
+		// Slot longer than its time, do not send the late headers back to back
+		now = linclock::Now();
+		if (now > deadline)
+		{
+			deadline = now;
+			stats.overruns++;
+		}
+	}
+
+	// The stop request is taken
+	running = false;
+	stopping = false;
+
+	return true;
+}
+
+void linmaster::Stop()
+{
+	stopping = true;
+}
+
+} /* namespace lin */
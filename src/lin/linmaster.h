@@ -0,0 +1,126 @@
+/*
+ * linmaster.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINMASTER_H_
+#define LIN_LINMASTER_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <ldf.h>
+
+
+namespace lin {
+
+/*
+ * Master node emulation, runs the schedule tables of a database in real time.
+ * The tables are compiled into slots holding the protected ID to send and the
+ * slot time, rounded up to the time base of the master node.
+ *
+ * Run() sleeps until the absolute deadline of each slot on CLOCK_MONOTONIC and
+ * calls the send callback, which sends the header (and the master request for
+ * diagnostic slots). The next deadline is the previous one plus the slot time,
+ * so wake up latencies do not add up over the cycles. A new schedule table set
+ * while running starts when the current slot ends.
+ *
+ * Each slot counts its runs, the latency of the wake up against its deadline
+ * (the observed jitter) and the runs whose latency exceeded the jitter of the
+ * master node. Statistics are updated by the thread in Run() only, other
+ * threads read them while running as an approximation.
+ */
+class linmaster {
+
+public:
+	struct linmasterslot_s
+	{
+		uint8_t pid;
+		ldfschedulecommand *command;
+		ldfframe *frame;				// NULL for diagnostic and undefined frames
+		uint64_t delay_ns;				// Slot time, until the next slot starts
+	};
+
+	struct linmasterslotstats_s
+	{
+		uint32_t runs;
+		uint32_t misses;				// Runs started later than the jitter of the database
+		uint64_t max_jitter_ns;
+		uint64_t total_jitter_ns;
+	};
+
+	struct linmasterstats_s
+	{
+		uint32_t cycles;				// Schedule tables run to the end
+		uint32_t switches;
+		uint32_t overruns;				// Slots that ended after the next deadline, the schedule is started again from now
+	};
+
+	// Called at the start of each slot, deadline is the time it should have started at
+	typedef void (*linmastersend_t)(void *context, const linmasterslot_s *slot, uint64_t deadline);
+
+private:
+	struct linmastertable_s
+	{
+		ldfscheduletable *table;
+		linmasterslot_s *slots;
+		linmasterslotstats_s *stats;
+		uint32_t count;
+	};
+
+	ldf *db;
+	linmastersend_t send;
+	void *context;
+
+	linmastertable_s *tables;
+	uint32_t tables_count;
+	uint64_t timebase_ns;
+	uint64_t jitter_ns;
+
+	std::atomic<uint32_t> current;
+	std::atomic<int32_t> pending;
+	std::atomic<bool> running;
+	std::atomic<bool> stopping;		// Set by Stop(), cleared when Run() returns
+	linmasterstats_s stats;
+
+	void FreeTables();
+
+public:
+	linmaster(ldf *db, linmastersend_t send, void *context);
+	virtual ~linmaster();
+
+	// Compiles the tables again after the database changes, not while running
+	void Compile();
+
+	uint32_t GetScheduleTablesCount();
+	ldfscheduletable *GetScheduleTable(uint32_t ix);
+	uint32_t GetSlotsCount(uint32_t ix);
+	const linmasterslot_s *GetSlot(uint32_t ix, uint32_t slot);
+	const linmasterslotstats_s *GetSlotStats(uint32_t ix, uint32_t slot);
+	void GetStats(linmasterstats_s *stats);
+	void ResetStats();
+	uint64_t GetJitterNs();
+
+	/*
+	 * Selects the schedule table to run. Before Run() it is the first table,
+	 * while running it replaces the current table when its slot ends. Tables
+	 * without slots cannot be selected.
+	 */
+	bool SetScheduleTable(const uint8_t *name);
+	bool SetScheduleTable(uint32_t ix);
+	uint32_t GetCurrentScheduleTable();
+
+	/*
+	 * Runs the schedule until Stop(), returns false when there is nothing to
+	 * run. A Stop() issued before Run() starts, as from the thread that
+	 * started it, makes it return at once.
+	 */
+	bool Run();
+	void Stop();
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINMASTER_H_ */
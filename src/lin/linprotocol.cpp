@@ -0,0 +1,64 @@
+/*
+ * linprotocol.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <linprotocol.h>
+
+
+namespace lin {
+
+// ID with parity bits P0 = ID0 ^ ID1 ^ ID2 ^ ID4 and P1 = !(ID1 ^ ID3 ^ ID4 ^ ID5)
+const uint8_t linprotocol::pid_table[LIN_PROTOCOL_IDS] =
+{
+	0x80, 0xC1, 0x42, 0x03, 0xC4, 0x85, 0x06, 0x47,
+	0x08, 0x49, 0xCA, 0x8B, 0x4C, 0x0D, 0x8E, 0xCF,
+	0x50, 0x11, 0x92, 0xD3, 0x14, 0x55, 0xD6, 0x97,
+	0xD8, 0x99, 0x1A, 0x5B, 0x9C, 0xDD, 0x5E, 0x1F,
+	0x20, 0x61, 0xE2, 0xA3, 0x64, 0x25, 0xA6, 0xE7,
+	0xA8, 0xE9, 0x6A, 0x2B, 0xEC, 0xAD, 0x2E, 0x6F,
+	0xF0, 0xB1, 0x32, 0x73, 0xB4, 0xF5, 0x76, 0x37,
+	0x78, 0x39, 0xBA, 0xFB, 0x3C, 0x7D, 0xFE, 0xBF,
+};
+
+// Reverse of the protected ID table
+const uint8_t linprotocol::id_table[256] =
+{
+	0xFF, 0xFF, 0xFF, 0x03, 0xFF, 0xFF, 0x06, 0xFF, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0x0D, 0xFF, 0xFF,
+	0xFF, 0x11, 0xFF, 0xFF, 0x14, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1A, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F,
+	0x20, 0xFF, 0xFF, 0xFF, 0xFF, 0x25, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x2B, 0xFF, 0xFF, 0x2E, 0xFF,
+	0xFF, 0xFF, 0x32, 0xFF, 0xFF, 0xFF, 0xFF, 0x37, 0xFF, 0x39, 0xFF, 0xFF, 0x3C, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0x07, 0xFF, 0x09, 0xFF, 0xFF, 0x0C, 0xFF, 0xFF, 0xFF,
+	0x10, 0xFF, 0xFF, 0xFF, 0xFF, 0x15, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1B, 0xFF, 0xFF, 0x1E, 0xFF,
+	0xFF, 0x21, 0xFF, 0xFF, 0x24, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x2A, 0xFF, 0xFF, 0xFF, 0xFF, 0x2F,
+	0xFF, 0xFF, 0xFF, 0x33, 0xFF, 0xFF, 0x36, 0xFF, 0x38, 0xFF, 0xFF, 0xFF, 0xFF, 0x3D, 0xFF, 0xFF,
+	0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x05, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0B, 0xFF, 0xFF, 0x0E, 0xFF,
+	0xFF, 0xFF, 0x12, 0xFF, 0xFF, 0xFF, 0xFF, 0x17, 0xFF, 0x19, 0xFF, 0xFF, 0x1C, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0x23, 0xFF, 0xFF, 0x26, 0xFF, 0x28, 0xFF, 0xFF, 0xFF, 0xFF, 0x2D, 0xFF, 0xFF,
+	0xFF, 0x31, 0xFF, 0xFF, 0x34, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3A, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+	0xFF, 0x01, 0xFF, 0xFF, 0x04, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0A, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F,
+	0xFF, 0xFF, 0xFF, 0x13, 0xFF, 0xFF, 0x16, 0xFF, 0x18, 0xFF, 0xFF, 0xFF, 0xFF, 0x1D, 0xFF, 0xFF,
+	0xFF, 0xFF, 0x22, 0xFF, 0xFF, 0xFF, 0xFF, 0x27, 0xFF, 0x29, 0xFF, 0xFF, 0x2C, 0xFF, 0xFF, 0xFF,
+	0x30, 0xFF, 0xFF, 0xFF, 0xFF, 0x35, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3B, 0xFF, 0xFF, 0x3E, 0xFF,
+};
+
+uint32_t linprotocol::CheckFrames(const linprotocolframe_s *frames, uint32_t count, uint8_t *ok)
+{
+	uint32_t bad = 0;
+
+	// Without branches, so bad frames cost the same as good ones
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const linprotocolframe_s *f = &frames[i];
+		uint8_t good = (Checksum(f->pid, f->model, f->data, f->length) == f->checksum) & IsValidPid(f->pid);
+
+		ok[i] = good;
+		bad += !good;
+	}
+
+	return bad;
+}
+
+} /* namespace lin */
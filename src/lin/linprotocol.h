@@ -0,0 +1,115 @@
+/*
+ * linprotocol.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINPROTOCOL_H_
+#define LIN_LINPROTOCOL_H_
+
+#include <stdint.h>
+
+
+// Frame IDs, and protected IDs with wrong parity in the reverse table
+#define LIN_PROTOCOL_IDS					64
+#define LIN_PROTOCOL_INVALID_ID				0xFF
+
+// Diagnostic frame IDs, master request and slave response, always with classic checksum
+#define LIN_PROTOCOL_MASTER_REQUEST_ID		0x3C
+#define LIN_PROTOCOL_SLAVE_RESPONSE_ID		0x3D
+
+
+namespace lin {
+
+/*
+ * LIN protocol kernels: protected ID parity and frame checksums.
+ *
+ * Protected IDs come from a table of the 64 IDs, and a table of the 256 bytes
+ * gives back the ID of a protected ID with good parity, so parity checks are a
+ * single load.
+ *
+ * The checksum is the inverted eight bit sum with carry of the data, and of
+ * the protected ID too for the enhanced model. The carries are added at the
+ * end, which gives the same result as adding them after every byte. Batches of
+ * captured frames keep the data as little endian 64 bit words (byte 0 in the
+ * low bits), summed eight bytes at once by folding byte and word halves.
+ */
+class linprotocol {
+
+public:
+	enum linchecksum_e
+	{
+		LIN_CHECKSUM_CLASSIC = 0,		// Data bytes, diagnostic frames and LIN 1.x
+		LIN_CHECKSUM_ENHANCED			// Protected ID and data bytes, LIN 2.x
+	};
+
+	struct linprotocolframe_s
+	{
+		uint64_t data;					// Little endian, bytes after length are ignored
+		uint8_t pid;
+		uint8_t length;					// Data bytes, up to 8
+		uint8_t model;					// linchecksum_e
+		uint8_t checksum;				// Checksum received
+	};
+
+private:
+	static const uint8_t pid_table[LIN_PROTOCOL_IDS];
+	static const uint8_t id_table[256];
+
+public:
+	static inline uint8_t Pid(uint8_t id)
+	{
+		return pid_table[id & 0x3F];
+	}
+
+	// ID of a protected ID, LIN_PROTOCOL_INVALID_ID when its parity is wrong
+	static inline uint8_t PidToId(uint8_t pid)
+	{
+		return id_table[pid];
+	}
+
+	static inline bool IsValidPid(uint8_t pid)
+	{
+		return id_table[pid] != LIN_PROTOCOL_INVALID_ID;
+	}
+
+	static inline uint8_t Checksum(uint8_t pid, uint8_t model, const uint8_t *data, uint8_t length)
+	{
+		uint32_t sum = (model == LIN_CHECKSUM_ENHANCED) ? pid : 0;
+
+		for (uint8_t i = 0; i < length; i++)
+			sum += data[i];
+
+		// Add the carries back, twice as the first fold may carry again
+		sum = (sum & 0xFF) + (sum >> 8);
+		sum = (sum & 0xFF) + (sum >> 8);
+		return ~sum;
+	}
+
+	static inline uint8_t Checksum(uint8_t pid, uint8_t model, uint64_t data, uint8_t length)
+	{
+		uint64_t sum = data & ((length >= 8) ? ~0ull : ((1ull << (length * 8)) - 1));
+
+		// Eight bytes to one sum, folding halves of the word
+		sum = (sum & 0x00FF00FF00FF00FFull) + ((sum >> 8) & 0x00FF00FF00FF00FFull);
+		sum = (sum & 0x0000FFFF0000FFFFull) + ((sum >> 16) & 0x0000FFFF0000FFFFull);
+		sum = (sum & 0xFFFFFFFFull) + (sum >> 32);
+		sum += pid & -(uint32_t)(model == LIN_CHECKSUM_ENHANCED);
+
+		sum = (sum & 0xFF) + (sum >> 8);
+		sum = (sum & 0xFF) + (sum >> 8);
+		return ~sum;
+	}
+
+	/*
+	 * Checks protected ID parity and checksum of count frames, ok[i] is set to 1
+	 * for good frames and 0 for the rest. Returns the number of bad frames.
+	 */
+	static uint32_t CheckFrames(const linprotocolframe_s *frames, uint32_t count, uint8_t *ok);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINPROTOCOL_H_ */
@@ -0,0 +1,149 @@
+/*
+ * linreplay.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <linclock.h>
+#include <linserial.h>
+#include <linreplay.h>
+
+
+// Default tolerance, a tenth of the shortest frame at 19200 bps
+#define LIN_REPLAY_TOLERANCE_NS				250000ull
+
+
+namespace lin {
+
+linreplay::linreplay(lintracereader *trace, linreplaysend_t send, void *context) : stopping(false)
+{
+	this->trace = trace;
+	this->send = send;
+	this->context = context;
+	speed = 1;
+	tolerance_ns = LIN_REPLAY_TOLERANCE_NS;
+	memset(&stats, 0, sizeof(stats));
+}
+
+linreplay::~linreplay()
+{
+}
+
+void linreplay::SetSpeed(double speed)
+{
+	this->speed = (speed > 0) ? speed : 0;
+}
+
+double linreplay::GetSpeed()
+{
+	return speed;
+}
+
+void linreplay::SetTolerance(uint64_t tolerance_ns)
+{
+	this->tolerance_ns = tolerance_ns;
+}
+
+void linreplay::GetStats(linreplaystats_s *stats)
+{
+	*stats = this->stats;
+}
+
+void linreplay::ResetStats()
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+bool linreplay::Run()
+{
+	lincapture::lincaptureframe_s frame;
+	uint64_t start, first, deadline;
+
+	trace->SetPrefetch(LIN_REPLAY_PREFETCH_BLOCKS);
+	if (stopping || !trace->Next(&frame))
+	{
+		stopping = false;
+		trace->SetPrefetch(0);
+		return false;
+	}
+
+	start = linclock::Now();
+	first = frame.timestamp;
+
+	do
+	{
+		uint64_t sent = 0;
+		uint64_t drift = 0;
+
+		// Absolute deadline of the frame, scaled from the start of the replay
+		if (speed > 0)
+		{
+			struct timespec ts;
+
+			deadline = start + (uint64_t)((frame.timestamp - first) / speed);
+			ts.tv_sec = deadline / 1000000000ull;
+			ts.tv_nsec = deadline % 1000000000ull;
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+				;
+		}
+		else
+		{
+			deadline = linclock::Now();
+		}
+
+		if (!send(context, &frame, deadline, &sent))
+			stats.errors++;
+
+		// Drift of the header on the bus, the wake up latency and the time to write it
+		if (speed > 0)
+		{
+			if (sent == 0)
+				sent = linclock::Now();
+			drift = (sent > deadline) ? sent - deadline : 0;
+		}
+
+		stats.frames++;
+		stats.total_drift_ns += drift;
+		if (drift > stats.max_drift_ns)
+			stats.max_drift_ns = drift;
+		if (drift > tolerance_ns)
+			stats.late++;
+	}
+	while (!stopping && trace->Next(&frame));
+
+	// The stop request is taken
+	stopping = false;
+	trace->SetPrefetch(0);
+
+	return true;
+}
+
+void linreplay::Stop()
+{
+	stopping = true;
+}
+
+bool linreplay::SendSerial(void *context, const lincapture::lincaptureframe_s *frame, uint64_t deadline, uint64_t *sent)
+{
+	linserial *serial = (linserial *)context;
+	uint8_t length = (frame->length > 8) ? 8 : frame->length;
+	uint8_t response[9];
+
+	if (!serial->WriteHeader(frame->pid))
+		return false;
+	*sent = linclock::Now();
+
+	// Headers nobody answered are replayed the same way
+	if (length == 0 || (frame->flags & lincapture::LIN_CAPTURE_ERROR_NO_RESPONSE))
+		return true;
+
+	memcpy(response, frame->data, length);
+	response[length] = frame->checksum;
+	return serial->WriteResponse(response, length + 1);
+}
+
+} /* namespace lin */
@@ -0,0 +1,99 @@
+/*
+ * linreplay.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINREPLAY_H_
+#define LIN_LINREPLAY_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <lincapture.h>
+#include <lintrace.h>
+
+
+// Trace blocks read ahead of the frame being replayed
+#define LIN_REPLAY_PREFETCH_BLOCKS			4
+
+
+namespace lin {
+
+/*
+ * Replay of a recorded trace, from the cursor of the trace reader to its end.
+ *
+ * Every frame gets an absolute deadline on CLOCK_MONOTONIC, the start of the
+ * replay plus its time since the first frame divided by the speed: 1 keeps the
+ * recorded timing, 10 replays ten times faster and 0 sends the frames back to
+ * back. Run() decodes the next frame before sleeping until its deadline, with
+ * the trace read ahead, and calls the send callback. Deadlines do not move
+ * when a frame is late, so the replay catches up with the recording instead of
+ * drifting away from it.
+ *
+ * The drift of a frame is how late its header went out against its deadline,
+ * the send callback gives the time it was written. Frames later than the
+ * tolerance are counted as late.
+ *
+ * SendSerial() is a send callback for a linserial opened on a LIN interface,
+ * or on a pseudo-terminal feeding a device under test: it sends the header and
+ * the recorded response, or only the header for frames without response.
+ */
+class linreplay {
+
+public:
+	struct linreplaystats_s
+	{
+		uint64_t frames;
+		uint64_t errors;				// Frames the send callback failed to send
+		uint64_t late;					// Frames sent later than the tolerance
+		uint64_t max_drift_ns;
+		uint64_t total_drift_ns;
+	};
+
+	/*
+	 * Called at the deadline of each frame, returns false when the frame could
+	 * not be sent. sent is set to the time the header was written, it is left
+	 * at 0 by callbacks that cannot tell and the time they return is taken.
+	 */
+	typedef bool (*linreplaysend_t)(void *context, const lincapture::lincaptureframe_s *frame, uint64_t deadline,
+			uint64_t *sent);
+
+private:
+	lintracereader *trace;
+	linreplaysend_t send;
+	void *context;
+
+	double speed;
+	uint64_t tolerance_ns;
+
+	std::atomic<bool> stopping;		// Set by Stop(), cleared when Run() returns
+	linreplaystats_s stats;
+
+public:
+	linreplay(lintracereader *trace, linreplaysend_t send, void *context);
+	virtual ~linreplay();
+
+	// Times faster than recorded, 0 as fast as possible
+	void SetSpeed(double speed);
+	double GetSpeed();
+	void SetTolerance(uint64_t tolerance_ns);
+
+	void GetStats(linreplaystats_s *stats);
+	void ResetStats();
+
+	/*
+	 * Replays until the end of the trace or Stop(), returns false when nothing
+	 * was replayed. A Stop() issued before Run() starts makes it return at once.
+	 */
+	bool Run();
+	void Stop();
+
+	// Send callback writing frames to a linserial passed as context
+	static bool SendSerial(void *context, const lincapture::lincaptureframe_s *frame, uint64_t deadline, uint64_t *sent);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINREPLAY_H_ */
@@ -0,0 +1,451 @@
+/*
+ * linserial.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#include <linprotocol.h>
+#include <linclock.h>
+#include <linserial.h>
+
+// termios2 of the kernel, its struct termios clashes with the one of the C library
+#define termios linserial_kernel_termios
+#include <asm/termbits.h>
+#undef termios
+
+
+// LIN sync byte
+#define LIN_SYNC_BYTE						0x55
+
+// Time allowed for the echo to come back, on top of the time to send the bytes
+#define LIN_SERIAL_ECHO_MARGIN_MS			20
+
+// Break field sent by the master, dominant bits
+#define LIN_SERIAL_BREAK_BITS				13
+
+
+namespace lin {
+
+// Speeds of termios, LIN uses 2400, 9600 and 19200 bps. Others, like 10417 bps, are set as BOTHER with termios2.
+static const struct
+{
+	uint32_t speed;
+	speed_t code;
+} speeds[] =
+{
+	{ 1200, B1200 },
+	{ 2400, B2400 },
+	{ 4800, B4800 },
+	{ 9600, B9600 },
+	{ 19200, B19200 },
+	{ 38400, B38400 },
+	{ 57600, B57600 },
+	{ 115200, B115200 },
+};
+
+linserial::linserial()
+{
+	fd = -1;
+	echo = false;
+	hardware_break = false;
+	speed = 0;
+	buffer_length = 0;
+	buffer_position = 0;
+	buffer_timestamp = 0;
+	marks_breaks = false;
+	pending_break = false;
+	break_timestamp = 0;
+	memset(&stats, 0, sizeof(stats));
+}
+
+linserial::~linserial()
+{
+	Close();
+}
+
+bool linserial::Open(const char *path, uint32_t speed, bool echo)
+{
+	struct termios t;
+	struct termios2 t2;
+	struct serial_struct serial;
+	speed_t code = B38400;
+	bool other_speed = true;
+
+	Close();
+
+	if (speed == 0)
+		return false;
+	for (uint32_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+	{
+		if (speeds[i].speed == speed)
+		{
+			code = speeds[i].code;
+			other_speed = false;
+		}
+	}
+
+	fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fd < 0)
+		return false;
+
+	// Raw 8N1, breaks and framing errors marked in the data
+	if (tcgetattr(fd, &t) != 0)
+	{
+		Close();
+		return false;
+	}
+	cfmakeraw(&t);
+	t.c_iflag &= ~(IGNBRK | BRKINT | IGNPAR | ISTRIP | IXON | IXOFF);
+	t.c_iflag |= PARMRK | INPCK;
+	t.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+	t.c_cflag |= CLOCAL | CREAD | CS8;
+	t.c_cc[VMIN] = 0;
+	t.c_cc[VTIME] = 0;
+	cfsetispeed(&t, code);
+	cfsetospeed(&t, code);
+	if (tcsetattr(fd, TCSANOW, &t) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	// Speeds without a Bxxx code are given in bps to the driver
+	if (other_speed)
+	{
+		if (ioctl(fd, TCGETS2, &t2) != 0)
+		{
+			Close();
+			return false;
+		}
+		t2.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+		t2.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+		t2.c_ispeed = speed;
+		t2.c_ospeed = speed;
+		if (ioctl(fd, TCSETS2, &t2) != 0)
+		{
+			Close();
+			return false;
+		}
+	}
+
+	// Ask USB-UARTs to deliver bytes as soon as they arrive, ignored by other ttys
+	hardware_break = false;
+	if (ioctl(fd, TIOCGSERIAL, &serial) == 0)
+	{
+		serial.flags |= ASYNC_LOW_LATENCY;
+		ioctl(fd, TIOCSSERIAL, &serial);
+		hardware_break = true;
+	}
+
+	tcflush(fd, TCIOFLUSH);
+
+	this->echo = echo;
+	this->speed = speed;
+	buffer_length = 0;
+	buffer_position = 0;
+	marks_breaks = false;
+	pending_break = false;
+	memset(&stats, 0, sizeof(stats));
+
+	return true;
+}
+
+void linserial::Close()
+{
+	if (fd >= 0)
+		close(fd);
+	fd = -1;
+}
+
+int linserial::GetFd()
+{
+	return fd;
+}
+
+bool linserial::Fill(uint32_t count, int timeout_ms)
+{
+	// Keep pending bytes at the start of the buffer
+	if (buffer_position > 0)
+	{
+		memmove(buffer, buffer + buffer_position, buffer_length - buffer_position);
+		buffer_length -= buffer_position;
+		buffer_position = 0;
+	}
+
+	while (buffer_length < count)
+	{
+		struct pollfd p = { fd, POLLIN, 0 };
+		ssize_t n;
+
+		n = read(fd, buffer + buffer_length, sizeof(buffer) - buffer_length);
+		if (n > 0)
+		{
+			buffer_length += n;
+			buffer_timestamp = linclock::Now();
+			continue;
+		}
+		if (n < 0 && errno != EAGAIN && errno != EINTR)
+			return false;
+
+		// Wait for more bytes
+		if (poll(&p, 1, timeout_ms) <= 0 || (p.revents & (POLLERR | POLLHUP | POLLNVAL)))
+			return false;
+	}
+
+	return true;
+}
+
+linserial::linserialbyte_e linserial::Next(uint8_t *byte, int timeout_ms)
+{
+	uint8_t *p;
+
+	if (buffer_length - buffer_position < 1 && !Fill(1, timeout_ms))
+		return LIN_SERIAL_BYTE_TIMEOUT;
+
+	// Plain byte
+	p = &buffer[buffer_position];
+	if (p[0] != 0xFF)
+	{
+		*byte = p[0];
+		buffer_position++;
+		return LIN_SERIAL_BYTE_DATA;
+	}
+
+	// Marks start with 0xFF, the rest of the mark is already on its way
+	if (buffer_length - buffer_position < 2 && !Fill(2, timeout_ms))
+		return LIN_SERIAL_BYTE_TIMEOUT;
+	p = &buffer[buffer_position];
+	if (p[1] != 0x00)
+	{
+		// 0xFF 0xFF is a 0xFF data byte
+		*byte = 0xFF;
+		buffer_position += (p[1] == 0xFF) ? 2 : 1;
+		return LIN_SERIAL_BYTE_DATA;
+	}
+
+	if (buffer_length - buffer_position < 3 && !Fill(3, timeout_ms))
+		return LIN_SERIAL_BYTE_TIMEOUT;
+	p = &buffer[buffer_position];
+	*byte = p[2];
+	buffer_position += 3;
+
+	// Break, or framing error with the byte received. A break often comes as a framing error of a 0x00 byte.
+	if (*byte == 0x00)
+	{
+		marks_breaks = true;
+		return LIN_SERIAL_BYTE_BREAK;
+	}
+	return LIN_SERIAL_BYTE_FRAMING_ERROR;
+}
+
+bool linserial::ReadHeader(uint8_t *pid, uint64_t *timestamp, int timeout_ms)
+{
+	linserialbyte_e r;
+	uint8_t b;
+
+	while (true)
+	{
+		// Wait for a break, unless a response was cut by one
+		if (pending_break)
+		{
+			pending_break = false;
+		}
+		else
+		{
+			r = Next(&b, timeout_ms);
+			if (r == LIN_SERIAL_BYTE_TIMEOUT)
+				return false;
+			if (r == LIN_SERIAL_BYTE_FRAMING_ERROR)
+			{
+				stats.framing_errors++;
+				continue;
+			}
+
+			break_timestamp = buffer_timestamp;
+
+			/*
+			 * On ttys that do not mark breaks, a 0x00 byte is a break when the sync
+			 * byte and a protected ID with good parity follow it. Looking ahead
+			 * keeps this right whatever the slave did with the previous frame,
+			 * responses of frames nobody read are skipped as data.
+			 */
+			if (r == LIN_SERIAL_BYTE_DATA)
+			{
+				if (b != 0x00 || marks_breaks)
+					continue;
+				if (buffer_length - buffer_position < 2 && !Fill(2, timeout_ms))
+					return false;
+				if (buffer[buffer_position] != LIN_SYNC_BYTE || !linprotocol::IsValidPid(buffer[buffer_position + 1]))
+					continue;
+			}
+		}
+
+		// Sync byte
+		r = Next(&b, timeout_ms);
+		if (r == LIN_SERIAL_BYTE_TIMEOUT)
+			return false;
+		if (r == LIN_SERIAL_BYTE_BREAK)
+		{
+			pending_break = true;
+			break_timestamp = buffer_timestamp;
+			continue;
+		}
+		if (r != LIN_SERIAL_BYTE_DATA || b != LIN_SYNC_BYTE)
+		{
+			stats.sync_errors++;
+			continue;
+		}
+
+		// Protected identifier
+		r = Next(&b, timeout_ms);
+		if (r == LIN_SERIAL_BYTE_TIMEOUT)
+			return false;
+		if (r == LIN_SERIAL_BYTE_BREAK)
+		{
+			pending_break = true;
+			break_timestamp = buffer_timestamp;
+			continue;
+		}
+		if (r != LIN_SERIAL_BYTE_DATA)
+		{
+			stats.framing_errors++;
+			continue;
+		}
+
+		*pid = b;
+		if (timestamp) *timestamp = break_timestamp;
+		stats.headers++;
+		return true;
+	}
+}
+
+uint8_t linserial::ReadResponse(uint8_t *data, uint8_t size, int timeout_ms, uint64_t *timestamp)
+{
+	uint8_t count = 0;
+
+	while (count < size)
+	{
+		linserialbyte_e r = Next(&data[count], timeout_ms);
+
+		if (r == LIN_SERIAL_BYTE_DATA)
+		{
+			count++;
+			continue;
+		}
+
+		// A break starts the next frame
+		if (r == LIN_SERIAL_BYTE_BREAK)
+		{
+			pending_break = true;
+			break_timestamp = buffer_timestamp;
+		}
+		else if (r == LIN_SERIAL_BYTE_FRAMING_ERROR)
+		{
+			stats.framing_errors++;
+		}
+		break;
+	}
+
+	if (timestamp) *timestamp = buffer_timestamp;
+	return count;
+}
+
+bool linserial::WriteBytes(const uint8_t *data, uint8_t size)
+{
+	uint8_t written = 0;
+
+	while (written < size)
+	{
+		ssize_t n = write(fd, data + written, size - written);
+
+		if (n > 0)
+		{
+			written += n;
+		}
+		else if (n < 0 && (errno == EAGAIN || errno == EINTR))
+		{
+			struct pollfd p = { fd, POLLOUT, 0 };
+			poll(&p, 1, -1);
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool linserial::WriteHeader(uint8_t pid)
+{
+	const uint8_t header[2] = { LIN_SYNC_BYTE, pid };
+	const uint8_t zero = 0x00;
+	uint8_t echoed;
+
+	// Break after the bytes already queued, pseudo-terminals accept the ioctl but send nothing, they get a 0x00 byte
+	tcdrain(fd);
+	if (hardware_break && ioctl(fd, TIOCSBRK) == 0)
+	{
+		usleep(LIN_SERIAL_BREAK_BITS * 1000000 / speed + 1);
+		ioctl(fd, TIOCCBRK);
+	}
+	else if (!WriteBytes(&zero, 1))
+	{
+		return false;
+	}
+
+	if (!WriteBytes(header, sizeof(header)))
+		return false;
+
+	// The echo of a header is read as a header
+	if (echo)
+	{
+		int timeout_ms = (LIN_SERIAL_BREAK_BITS + 20) * 1000 / speed + LIN_SERIAL_ECHO_MARGIN_MS;
+
+		if (!ReadHeader(&echoed, NULL, timeout_ms) || echoed != pid)
+		{
+			stats.echo_errors++;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool linserial::WriteResponse(const uint8_t *data, uint8_t size)
+{
+	uint8_t echoed[LIN_SERIAL_BUFFER_SIZE];
+
+	if (!WriteBytes(data, size))
+		return false;
+
+	// The transceiver echoes the bus, a different echo means another node was writing too
+	if (echo)
+	{
+		int timeout_ms = (size * 10 * 1000) / speed + LIN_SERIAL_ECHO_MARGIN_MS;
+
+		if (ReadResponse(echoed, size, timeout_ms, NULL) != size || memcmp(echoed, data, size) != 0)
+		{
+			stats.echo_errors++;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void linserial::GetStats(linserialstats_s *stats)
+{
+	*stats = this->stats;
+}
+
+} /* namespace lin */
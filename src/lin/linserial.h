@@ -0,0 +1,116 @@
+/*
+ * linserial.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINSERIAL_H_
+#define LIN_LINSERIAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+// Bytes read from the tty at once
+#define LIN_SERIAL_BUFFER_SIZE				256
+
+
+namespace lin {
+
+/*
+ * Serial transport for the USB-TTL LIN interface (TJA1021 behind a USB-UART).
+ * The tty is opened in raw mode at the LIN speed, with parity and break marks
+ * enabled, so a break comes as the 0xFF 0x00 0x00 sequence and a framing error
+ * as 0xFF 0x00 byte. Until the tty marks a break, a 0x00 byte followed by the
+ * sync byte and a protected ID with good parity is also taken as a header, as
+ * UARTs that do not report breaks deliver it that way, and it lets a
+ * pseudo-terminal pair stand in for the hardware: writing 0x00 0x55 PID to the
+ * master side sends a header. Headers with wrong parity are only seen on ttys
+ * that mark breaks.
+ *
+ * Speeds without a termios Bxxx code, like 10417 bps, are set in bps with
+ * termios2.
+ *
+ * The TJA1021 echoes every byte written to the bus, with echo enabled the
+ * transport reads the echo back after each write and checks it.
+ *
+ * A slave node is served with:
+ *
+ *   while (serial.ReadHeader(&pid, &timestamp, -1))
+ *   {
+ *       if ((size = slave.OnHeader(pid, &response)) > 0)
+ *           serial.WriteResponse(response, size);
+ *       else if (... node subscribes the frame ...)
+ *           slave.OnResponse(pid, data, serial.ReadResponse(data, length + 1, timeout, &timestamp));
+ *   }
+ *
+ * Timestamps are nanoseconds of CLOCK_MONOTONIC taken when the bytes holding
+ * the break, or the last byte of a response, were read.
+ */
+class linserial {
+
+public:
+	enum linserialbyte_e
+	{
+		LIN_SERIAL_BYTE_DATA = 0,
+		LIN_SERIAL_BYTE_BREAK,
+		LIN_SERIAL_BYTE_FRAMING_ERROR,
+		LIN_SERIAL_BYTE_TIMEOUT
+	};
+
+	struct linserialstats_s
+	{
+		uint32_t headers;
+		uint32_t sync_errors;			// Break not followed by 0x55
+		uint32_t framing_errors;
+		uint32_t echo_errors;			// Echo differs from the bytes written, bus conflict
+	};
+
+private:
+	int fd;
+	bool echo;
+	bool hardware_break;			// Serial port, pseudo-terminals cannot send breaks
+	uint32_t speed;
+
+	// Received bytes, parsed in place
+	uint8_t buffer[LIN_SERIAL_BUFFER_SIZE];
+	uint32_t buffer_length;
+	uint32_t buffer_position;
+	uint64_t buffer_timestamp;
+
+	// Once a break is marked, 0x00 bytes are only data
+	bool marks_breaks;
+
+	// Break received while reading a response
+	bool pending_break;
+	uint64_t break_timestamp;
+
+	linserialstats_s stats;
+
+	bool Fill(uint32_t count, int timeout_ms);
+	linserialbyte_e Next(uint8_t *byte, int timeout_ms);
+	bool WriteBytes(const uint8_t *data, uint8_t size);
+
+public:
+	linserial();
+	virtual ~linserial();
+
+	bool Open(const char *path, uint32_t speed, bool echo);
+	void Close();
+	int GetFd();
+
+	bool ReadHeader(uint8_t *pid, uint64_t *timestamp, int timeout_ms);
+	uint8_t ReadResponse(uint8_t *data, uint8_t size, int timeout_ms, uint64_t *timestamp);
+
+	// Break, sync and protected ID, as the master node sends them
+	bool WriteHeader(uint8_t pid);
+	bool WriteResponse(const uint8_t *data, uint8_t size);
+
+	void GetStats(linserialstats_s *stats);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINSERIAL_H_ */
@@ -0,0 +1,148 @@
+/*
+ * linslave.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <string.h>
+#include <stdexcept>
+#include <linslave.h>
+
+
+using namespace std;
+
+
+namespace lin {
+
+linslave::linslave(ldf *db, const uint8_t *node_name)
+{
+	this->db = db;
+	this->node_name = db->GetStrings()->Find(node_name);
+
+	// The emulated node shall be one of the slaves of the database
+	uint32_t i;
+	for (i = 0; i < db->GetSlaveNodesCount(); i++)
+		if (NameEq(db->GetSlaveNodeByIndex(i)->GetName(), this->node_name))
+			break;
+	if (i == db->GetSlaveNodesCount())
+	{
+		throw runtime_error("Slave node not defined in database");
+	}
+
+	Compile();
+}
+
+linslave::~linslave()
+{
+}
+
+bool linslave::Subscribes(ldfframe *frame)
+{
+	// Node subscribes a frame when it subscribes any of its signals
+	for (uint32_t i = 0; i < frame->GetSignalsCount(); i++)
+	{
+		ldfsignal *s = db->GetSignalByName(frame->GetSignal(i)->GetName());
+		if (s == NULL)
+			continue;
+
+		for (uint32_t j = 0; j < s->GetSubscribersCount(); j++)
+			if (NameEq(s->GetSubscriber(j), node_name))
+				return true;
+	}
+
+	return false;
+}
+
+void linslave::Compile()
+{
+	memset(table, 0, sizeof(table));
+
+	for (uint8_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		linslaveentry_s *e = &table[id];
+		ldfframe *f = db->GetFrameById(id);
+
+		// IDs without frame are ignored
+		if (f == NULL)
+			continue;
+
+		e->frame = f;
+		e->pid = f->GetPid();
+		e->length = (f->GetSize() <= 8) ? f->GetSize() : 8;
+		e->checksum = (id < LIN_PROTOCOL_MASTER_REQUEST_ID && db->GetLinProtocolVersion() != LIN_PROTOCOL_VERSION_NONE) ?
+				linprotocol::LIN_CHECKSUM_ENHANCED : linprotocol::LIN_CHECKSUM_CLASSIC;
+
+		// Direction from the point of view of the emulated node
+		if (NameEq(f->GetPublisher(), node_name))
+			e->direction = LIN_SLAVE_PUBLISH;
+		else if (Subscribes(f))
+			e->direction = LIN_SLAVE_SUBSCRIBE;
+		else
+			e->direction = LIN_SLAVE_IGNORE;
+
+		// Response from signal default values, unused bits are recessive
+		memset(e->response, 0xFF, e->length);
+		for (uint32_t i = 0; i < f->GetSignalsCount(); i++)
+		{
+			ldfframesignal *fs = f->GetSignal(i);
+			ldfsignal *s = db->GetSignalByName(fs->GetName());
+			if (s == NULL)
+				continue;
+
+			for (uint32_t b = 0; b < s->GetBitSize(); b++)
+			{
+				uint32_t bit = fs->GetOffset() + b;
+				if (bit >= e->length * 8u)
+					break;
+
+				if (b < 32 && ((s->GetDefaultValue() >> b) & 1))
+					e->response[bit >> 3] |= (1 << (bit & 7));
+				else
+					e->response[bit >> 3] &= ~(1 << (bit & 7));
+			}
+		}
+		e->response[e->length] = linprotocol::Checksum(e->pid, e->checksum, e->response, e->length);
+	}
+}
+
+const uint8_t *linslave::GetNodeName()
+{
+	return node_name;
+}
+
+const linslave::linslaveentry_s *linslave::GetEntry(uint8_t id)
+{
+	return (id < LIN_PROTOCOL_IDS) ? &table[id] : NULL;
+}
+
+bool linslave::OnResponse(uint8_t pid, const uint8_t *response, uint8_t size)
+{
+	linslaveentry_s *e = &table[pid & 0x3F];
+
+	// Only complete responses of subscribed frames with a good checksum are kept
+	if (e->pid != pid || e->direction != LIN_SLAVE_SUBSCRIBE || size != e->length + 1)
+		return false;
+	if (linprotocol::Checksum(pid, e->checksum, response, e->length) != response[e->length])
+		return false;
+
+	memcpy(e->response, response, size);
+	return true;
+}
+
+bool linslave::SetResponseData(uint8_t id, const uint8_t *data)
+{
+	linslaveentry_s *e;
+
+	if (id >= LIN_PROTOCOL_IDS || table[id].direction != LIN_SLAVE_PUBLISH)
+		return false;
+
+	// Update data and its checksum, so the response is still ready to be sent
+	e = &table[id];
+	memcpy(e->response, data, e->length);
+	e->response[e->length] = linprotocol::Checksum(e->pid, e->checksum, e->response, e->length);
+
+	return true;
+}
+
+} /* namespace lin */
@@ -0,0 +1,92 @@
+/*
+ * linslave.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINSLAVE_H_
+#define LIN_LINSLAVE_H_
+
+#include <stdint.h>
+#include <ldf.h>
+#include <linprotocol.h>
+
+
+// Longest response, data and checksum
+#define LIN_RESPONSE_MAX_SIZE				9
+
+
+namespace lin {
+
+/*
+ * Emulation of one slave node of a database. The database is compiled into a
+ * table indexed by frame ID, whose entries hold everything needed to answer a
+ * header: the protected ID it is expected with, whether the node publishes or
+ * subscribes the frame, its length, its checksum model and the response ready
+ * to be sent, data followed by checksum.
+ *
+ * Headers and responses are served from the table only, without lookups,
+ * allocations or string comparisons. The table is compiled again with Compile()
+ * after the database changes.
+ */
+class linslave {
+
+public:
+	enum linslavedirection_e
+	{
+		LIN_SLAVE_IGNORE = 0,			// Frame is not used by the node
+		LIN_SLAVE_PUBLISH,				// Node sends the response
+		LIN_SLAVE_SUBSCRIBE				// Node receives the response
+	};
+
+	struct linslaveentry_s
+	{
+		uint8_t pid;
+		uint8_t direction;				// linslavedirection_e
+		uint8_t length;					// Data bytes, without checksum
+		uint8_t checksum;				// linprotocol::linchecksum_e
+		uint8_t response[LIN_RESPONSE_MAX_SIZE];	// Data and checksum, last data received for subscribed frames
+		ldfframe *frame;
+	};
+
+private:
+	ldf *db;
+	const uint8_t *node_name;
+	linslaveentry_s table[LIN_PROTOCOL_IDS];
+
+	bool Subscribes(ldfframe *frame);
+
+public:
+	linslave(ldf *db, const uint8_t *node_name);
+	virtual ~linslave();
+
+	void Compile();
+
+	const uint8_t *GetNodeName();
+	const linslaveentry_s *GetEntry(uint8_t id);
+
+	/*
+	 * Header received, returns the bytes to send and points response to them, or
+	 * 0 when the node does not publish the frame or the parity of the PID is
+	 * wrong.
+	 */
+	inline uint8_t OnHeader(uint8_t pid, const uint8_t **response)
+	{
+		const linslaveentry_s *e = &table[pid & 0x3F];
+
+		if (e->pid != pid || e->direction != LIN_SLAVE_PUBLISH)
+			return 0;
+
+		*response = e->response;
+		return e->length + 1;
+	}
+
+	bool OnResponse(uint8_t pid, const uint8_t *response, uint8_t size);
+	bool SetResponseData(uint8_t id, const uint8_t *data);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINSLAVE_H_ */
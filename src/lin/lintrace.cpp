@@ -0,0 +1,720 @@
+/*
+ * lintrace.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <algorithm>
+#include <lintrace.h>
+
+
+#define LINT_MAGIC					"LINT"
+#define LINT_BLOCK_MAGIC			"LINB"
+#define LINT_VERSION				1
+
+// Control byte of a frame
+#define LINT_LENGTH_MASK			0x0F
+#define LINT_HAS_FLAGS				0x10
+#define LINT_HAS_BUS				0x20
+#define LINT_REPEATED				0x40
+
+// Largest frame: timestamp varint, control, PID, flags, bus, data and checksum
+#define LINT_MAX_FRAME_SIZE			(10 + 4 + 8 + 1)
+
+
+using namespace std;
+
+
+namespace lin {
+
+struct lintrace_header_s
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t index_offset;			// 0 while the trace is being written
+	uint64_t frames;
+	uint32_t blocks;
+	uint32_t reserved;
+};
+
+// Header of every block, and entry of the index
+struct lintrace_block_s
+{
+	char magic[4];
+	uint32_t size;					// Bytes of frames after the header
+	uint64_t offset;				// Of the header in the file
+	uint64_t frame;					// Number of the first frame
+	uint64_t timestamp;				// Of the first frame
+	uint64_t last_timestamp;
+	uint64_t ids;					// Bit per frame ID in the block
+	uint32_t count;
+	uint32_t reserved;
+};
+
+// Entry of the index per frame ID, its blocks are id_blocks[first..first + count)
+struct lintrace_id_s
+{
+	uint64_t frames;
+	uint32_t first;
+	uint32_t count;
+};
+
+
+static inline uint8_t *PutVarint(uint8_t *p, uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		*p++ = v | 0x80;
+		v >>= 7;
+	}
+	*p++ = v;
+
+	return p;
+}
+
+static inline bool GetVarint(const uint8_t **p, const uint8_t *end, uint64_t *v)
+{
+	const uint8_t *q = *p;
+	uint64_t r = 0;
+
+	for (uint32_t shift = 0; q < end && shift < 64; shift += 7)
+	{
+		r |= (uint64_t)(*q & 0x7F) << shift;
+		if ((*q++ & 0x80) == 0)
+		{
+			*p = q;
+			*v = r;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Signed time differences, small either way
+static inline uint64_t ZigZag(int64_t v)
+{
+	return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t UnZigZag(uint64_t v)
+{
+	return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+
+lintracewriter::lintracewriter()
+{
+	fd = -1;
+	offset = 0;
+	block = new uint8_t[sizeof(lintrace_block_s) + LIN_TRACE_BLOCK_SIZE];
+	block_size = 0;
+	block_count = 0;
+	block_frame = 0;
+	block_timestamp = 0;
+	block_ids = 0;
+	previous = 0;
+	frames = 0;
+	last_timestamp = 0;
+	memset(id_frames, 0, sizeof(id_frames));
+}
+
+lintracewriter::~lintracewriter()
+{
+	if (fd >= 0)
+		Close();
+	delete[] block;
+}
+
+bool lintracewriter::WriteAll(const void *data, size_t size)
+{
+	const uint8_t *p = (const uint8_t *)data;
+
+	while (size > 0)
+	{
+		ssize_t n = write(fd, p, size);
+		if (n <= 0)
+			return false;
+		p += n;
+		size -= n;
+	}
+
+	return true;
+}
+
+bool lintracewriter::Open(const char *filename)
+{
+	lintrace_header_s h;
+
+	if (fd >= 0)
+		Close();
+
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+
+	// Header without index until Close()
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, LINT_MAGIC, sizeof(h.magic));
+	h.version = LINT_VERSION;
+	if (!WriteAll(&h, sizeof(h)))
+	{
+		close(fd);
+		fd = -1;
+		return false;
+	}
+
+	offset = sizeof(h);
+	block_size = 0;
+	block_count = 0;
+	frames = 0;
+	last_timestamp = 0;
+	blocks.clear();
+	for (uint32_t i = 0; i < LIN_PROTOCOL_IDS; i++)
+		id_blocks[i].clear();
+	memset(id_frames, 0, sizeof(id_frames));
+
+	return true;
+}
+
+bool lintracewriter::Write(const lincapture::lincaptureframe_s *frame)
+{
+	uint8_t id = frame->pid & 0x3F;
+	uint8_t length = (frame->length > 8) ? 8 : frame->length;
+	uint8_t control = length;
+	uint64_t data = 0;
+	uint8_t *p;
+
+	if (fd < 0)
+		return false;
+
+	if (block_size + LINT_MAX_FRAME_SIZE > LIN_TRACE_BLOCK_SIZE && !Flush())
+		return false;
+
+	// First frame of a block, decoded without the previous blocks
+	if (block_count == 0)
+	{
+		block_frame = frames;
+		block_timestamp = frame->timestamp;
+		block_ids = 0;
+		previous = frame->timestamp;
+		memset(last_length, 0xFF, sizeof(last_length));
+	}
+
+	memcpy(&data, frame->data, length);
+	if (last_length[id] == length && last_data[id] == data && last_checksum[id] == frame->checksum)
+		control |= LINT_REPEATED;
+	if (frame->flags != 0)
+		control |= LINT_HAS_FLAGS;
+	if (frame->bus != 0)
+		control |= LINT_HAS_BUS;
+
+	p = block + sizeof(lintrace_block_s) + block_size;
+	p = PutVarint(p, ZigZag(frame->timestamp - previous));
+	*p++ = control;
+	*p++ = frame->pid;
+	if (control & LINT_HAS_FLAGS)
+		*p++ = frame->flags;
+	if (control & LINT_HAS_BUS)
+		*p++ = frame->bus;
+	if (!(control & LINT_REPEATED))
+	{
+		memcpy(p, frame->data, length);
+		p += length;
+		*p++ = frame->checksum;
+		last_data[id] = data;
+		last_length[id] = length;
+		last_checksum[id] = frame->checksum;
+	}
+	block_size = p - (block + sizeof(lintrace_block_s));
+
+	previous = frame->timestamp;
+	last_timestamp = frame->timestamp;
+	block_ids |= 1ull << id;
+	block_count++;
+	id_frames[id]++;
+	frames++;
+
+	return true;
+}
+
+bool lintracewriter::Flush()
+{
+	lintrace_block_s b;
+
+	if (fd < 0)
+		return false;
+	if (block_count == 0)
+		return true;
+
+	memset(&b, 0, sizeof(b));
+	memcpy(b.magic, LINT_BLOCK_MAGIC, sizeof(b.magic));
+	b.size = block_size;
+	b.offset = offset;
+	b.frame = block_frame;
+	b.timestamp = block_timestamp;
+	b.last_timestamp = last_timestamp;
+	b.ids = block_ids;
+	b.count = block_count;
+
+	// Header and frames in one write, so a killed recorder leaves whole blocks
+	memcpy(block, &b, sizeof(b));
+	if (!WriteAll(block, sizeof(b) + block_size))
+		return false;
+
+	for (uint32_t i = 0; i < LIN_PROTOCOL_IDS; i++)
+		if (block_ids & (1ull << i))
+			id_blocks[i].push_back(blocks.size());
+	blocks.push_back(b);
+
+	offset += sizeof(b) + block_size;
+	block_size = 0;
+	block_count = 0;
+
+	return true;
+}
+
+bool lintracewriter::Close()
+{
+	static const uint8_t zeros[8] = { 0 };
+	lintrace_header_s h;
+	lintrace_id_s ids[LIN_PROTOCOL_IDS];
+	uint32_t first = 0;
+	bool ok;
+
+	if (fd < 0)
+		return false;
+
+	ok = Flush();
+
+	// Index, aligned so the reader uses it in place
+	ok = ok && WriteAll(zeros, (8 - offset % 8) % 8);
+	offset = (offset + 7) & ~7ull;
+
+	for (uint32_t i = 0; i < LIN_PROTOCOL_IDS; i++)
+	{
+		ids[i].frames = id_frames[i];
+		ids[i].first = first;
+		ids[i].count = id_blocks[i].size();
+		first += ids[i].count;
+	}
+
+	ok = ok && WriteAll(blocks.data(), blocks.size() * sizeof(lintrace_block_s));
+	ok = ok && WriteAll(ids, sizeof(ids));
+	for (uint32_t i = 0; i < LIN_PROTOCOL_IDS; i++)
+		ok = ok && WriteAll(id_blocks[i].data(), id_blocks[i].size() * sizeof(uint32_t));
+
+	// The index offset is written last, a trace without it is recovered from its blocks
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, LINT_MAGIC, sizeof(h.magic));
+	h.version = LINT_VERSION;
+	h.index_offset = offset;
+	h.frames = frames;
+	h.blocks = blocks.size();
+	ok = ok && pwrite(fd, &h, sizeof(h), 0) == sizeof(h);
+
+	ok = (close(fd) == 0) && ok;
+	fd = -1;
+
+	return ok;
+}
+
+uint64_t lintracewriter::GetFramesCount()
+{
+	return frames;
+}
+
+uint64_t lintracewriter::GetSize()
+{
+	return offset + ((block_count > 0) ? sizeof(lintrace_block_s) + block_size : 0);
+}
+
+
+lintracereader::lintracereader()
+{
+	image = NULL;
+	size = 0;
+	complete = false;
+	blocks = NULL;
+	blocks_count = 0;
+	ids = NULL;
+	id_blocks = NULL;
+	frames = 0;
+	prefetch = 0;
+	block = 0;
+	p = NULL;
+	end = NULL;
+	left = 0;
+	frame = 0;
+	timestamp = 0;
+}
+
+lintracereader::~lintracereader()
+{
+	Close();
+}
+
+bool lintracereader::Open(const char *filename)
+{
+	lintrace_header_s h;
+	struct stat st;
+	void *m;
+
+	Close();
+
+	// Map trace file
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(h))
+	{
+		close(fd);
+		return false;
+	}
+	m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (m == MAP_FAILED)
+		return false;
+
+	image = (const uint8_t *)m;
+	size = st.st_size;
+
+	memcpy(&h, image, sizeof(h));
+	if (memcmp(h.magic, LINT_MAGIC, sizeof(h.magic)) != 0 || h.version != LINT_VERSION)
+	{
+		Close();
+		return false;
+	}
+
+	// Index in place when the trace was closed and it fits in the file
+	complete = false;
+	if (h.index_offset >= sizeof(h) && h.index_offset % 8 == 0 &&
+		h.index_offset + (uint64_t)h.blocks * sizeof(lintrace_block_s) + LIN_PROTOCOL_IDS * sizeof(lintrace_id_s) <= size)
+	{
+		uint64_t lists = 0;
+
+		blocks = (const lintrace_block_s *)(image + h.index_offset);
+		blocks_count = h.blocks;
+		ids = (const lintrace_id_s *)(blocks + blocks_count);
+		id_blocks = (const uint32_t *)(ids + LIN_PROTOCOL_IDS);
+		for (uint32_t i = 0; i < LIN_PROTOCOL_IDS; i++)
+			lists += ids[i].count;
+		complete = ((const uint8_t *)(id_blocks + lists) <= image + size);
+		frames = h.frames;
+	}
+
+	if (!complete && !Recover())
+	{
+		Close();
+		return false;
+	}
+
+	SeekFrame(0);
+
+	return true;
+}
+
+bool lintracereader::Recover()
+{
+	const uint8_t *q = image + sizeof(lintrace_header_s);
+	const uint8_t *limit = image + size;
+	lintrace_block_s b;
+	uint32_t first = 0;
+
+	recovered_blocks.clear();
+	recovered_ids.assign(LIN_PROTOCOL_IDS, lintrace_id_s());
+	recovered_id_blocks.clear();
+
+	// Walk the blocks, looking for the next sync header after a damaged one
+	while (q + sizeof(b) <= limit)
+	{
+		memcpy(&b, q, sizeof(b));
+		if (memcmp(b.magic, LINT_BLOCK_MAGIC, sizeof(b.magic)) == 0 && b.offset == (uint64_t)(q - image) &&
+			b.size <= (uint64_t)(limit - q - sizeof(b)) && b.count <= b.size)
+		{
+			recovered_blocks.push_back(b);
+			q += sizeof(b) + b.size;
+			continue;
+		}
+
+		q = (const uint8_t *)memmem(q + 1, limit - q - 1, LINT_BLOCK_MAGIC, sizeof(b.magic));
+		if (q == NULL)
+			break;
+	}
+
+	// Blocks of every frame ID, frames per ID are only known by decoding
+	for (uint32_t i = 0; i < LIN_PROTOCOL_IDS; i++)
+	{
+		recovered_ids[i].frames = 0;
+		recovered_ids[i].first = first;
+		for (uint32_t j = 0; j < recovered_blocks.size(); j++)
+			if (recovered_blocks[j].ids & (1ull << i))
+				recovered_id_blocks.push_back(j);
+		recovered_ids[i].count = recovered_id_blocks.size() - first;
+		first = recovered_id_blocks.size();
+	}
+
+	blocks = recovered_blocks.data();
+	blocks_count = recovered_blocks.size();
+	ids = recovered_ids.data();
+	id_blocks = recovered_id_blocks.data();
+	frames = (blocks_count > 0) ? blocks[blocks_count - 1].frame + blocks[blocks_count - 1].count : 0;
+
+	return true;
+}
+
+void lintracereader::Close()
+{
+	if (image != NULL)
+		munmap((void *)image, size);
+	image = NULL;
+	size = 0;
+	complete = false;
+	blocks = NULL;
+	blocks_count = 0;
+	ids = NULL;
+	id_blocks = NULL;
+	recovered_blocks.clear();
+	recovered_ids.clear();
+	recovered_id_blocks.clear();
+	frames = 0;
+	block = 0;
+	left = 0;
+}
+
+bool lintracereader::IsComplete()
+{
+	return complete;
+}
+
+uint64_t lintracereader::GetFramesCount()
+{
+	return frames;
+}
+
+uint64_t lintracereader::GetFramesCount(uint8_t id)
+{
+	return (ids != NULL && id < LIN_PROTOCOL_IDS) ? ids[id].frames : 0;
+}
+
+uint64_t lintracereader::GetFirstTimestamp()
+{
+	return (blocks_count > 0) ? blocks[0].timestamp : 0;
+}
+
+uint64_t lintracereader::GetLastTimestamp()
+{
+	return (blocks_count > 0) ? blocks[blocks_count - 1].last_timestamp : 0;
+}
+
+uint32_t lintracereader::GetBlocksCount()
+{
+	return blocks_count;
+}
+
+uint64_t lintracereader::GetBlockFrame(uint32_t b)
+{
+	return (b < blocks_count) ? blocks[b].frame : frames;
+}
+
+void lintracereader::SetPrefetch(uint32_t blocks)
+{
+	prefetch = blocks;
+}
+
+bool lintracereader::LoadBlock(uint32_t b)
+{
+	block = b;
+	p = image + blocks[b].offset + sizeof(lintrace_block_s);
+	end = p + blocks[b].size;
+	left = blocks[b].count;
+	frame = blocks[b].frame;
+	timestamp = blocks[b].timestamp;
+	memset(last_length, 0xFF, sizeof(last_length));
+
+	// Pages of the next blocks, so they are read before the cursor gets to them
+	if (prefetch > 0 && b + 1 < blocks_count)
+	{
+		uint32_t last = (b + prefetch < blocks_count) ? b + prefetch : blocks_count - 1;
+		uintptr_t from = (uintptr_t)(image + blocks[b + 1].offset) & ~(uintptr_t)(sysconf(_SC_PAGESIZE) - 1);
+		uintptr_t to = (uintptr_t)(image + blocks[last].offset + sizeof(lintrace_block_s) + blocks[last].size);
+
+		if (to <= (uintptr_t)(image + size))
+			madvise((void *)from, to - from, MADV_WILLNEED);
+	}
+
+	return p <= end && end <= image + size;
+}
+
+bool lintracereader::Decode(lincapture::lincaptureframe_s *f)
+{
+	uint64_t delta;
+	uint8_t control, id;
+
+	if (!GetVarint(&p, end, &delta) || end - p < 2)
+		return false;
+
+	timestamp += UnZigZag(delta);
+	control = *p++;
+	f->timestamp = timestamp;
+	f->pid = *p++;
+	f->flags = 0;
+	f->bus = 0;
+	id = f->pid & 0x3F;
+
+	if ((control & LINT_HAS_FLAGS) && p < end)
+		f->flags = *p++;
+	if ((control & LINT_HAS_BUS) && p < end)
+		f->bus = *p++;
+
+	if (control & LINT_REPEATED)
+	{
+		if (last_length[id] > 8)
+			return false;
+		f->length = last_length[id];
+		f->checksum = last_checksum[id];
+		memcpy(f->data, &last_data[id], sizeof(f->data));
+	}
+	else
+	{
+		f->length = control & LINT_LENGTH_MASK;
+		if (f->length > 8 || end - p < f->length + 1)
+			return false;
+		last_data[id] = 0;
+		memcpy(&last_data[id], p, f->length);
+		memcpy(f->data, &last_data[id], sizeof(f->data));
+		p += f->length;
+		f->checksum = *p++;
+		last_length[id] = f->length;
+		last_checksum[id] = f->checksum;
+	}
+
+	left--;
+	frame++;
+
+	return true;
+}
+
+uint32_t lintracereader::FindBlockByTime(uint64_t timestamp)
+{
+	// First block ending at or after the time
+	const lintrace_block_s *b = lower_bound(blocks, blocks + blocks_count, timestamp,
+			[](const lintrace_block_s &a, uint64_t t) { return a.last_timestamp < t; });
+
+	return b - blocks;
+}
+
+bool lintracereader::SeekTime(uint64_t timestamp)
+{
+	uint32_t b = FindBlockByTime(timestamp);
+
+	if (b >= blocks_count)
+		return SeekFrame(frames);
+
+	if (!LoadBlock(b))
+		return false;
+
+	// Decode up to the first frame at or after the time, looking at its time only
+	while (left > 0)
+	{
+		lincapture::lincaptureframe_s f;
+		const uint8_t *q = p;
+		uint64_t delta;
+
+		if (!GetVarint(&q, end, &delta))
+			return false;
+		if (this->timestamp + UnZigZag(delta) >= timestamp)
+			return true;
+		if (!Decode(&f))
+			return false;
+	}
+
+	return true;
+}
+
+bool lintracereader::SeekFrame(uint64_t n)
+{
+	// Past the end, Next() finds nothing
+	if (n >= frames || blocks_count == 0)
+	{
+		block = blocks_count;
+		left = 0;
+		frame = frames;
+		return n == frames;
+	}
+
+	// Last block starting at or before the frame
+	const lintrace_block_s *b = upper_bound(blocks, blocks + blocks_count, n,
+			[](uint64_t n, const lintrace_block_s &a) { return n < a.frame; });
+	if (b == blocks || !LoadBlock(b - 1 - blocks))
+		return false;
+
+	while (frame < n)
+	{
+		lincapture::lincaptureframe_s f;
+
+		if (left == 0 || !Decode(&f))
+			return false;
+	}
+
+	return true;
+}
+
+uint64_t lintracereader::GetPosition()
+{
+	return frame;
+}
+
+bool lintracereader::Next(lincapture::lincaptureframe_s *frame)
+{
+	while (left == 0)
+	{
+		if (block + 1 >= blocks_count)
+			return false;
+		if (!LoadBlock(block + 1))
+			return false;
+	}
+
+	return Decode(frame);
+}
+
+bool lintracereader::Next(uint8_t id, lincapture::lincaptureframe_s *frame)
+{
+	if (id >= LIN_PROTOCOL_IDS)
+		return false;
+
+	while (true)
+	{
+		// Frames left in a block holding the ID
+		if (left > 0 && (blocks[block].ids & (1ull << id)))
+		{
+			while (left > 0)
+			{
+				if (!Decode(frame))
+					return false;
+				if ((frame->pid & 0x3F) == id)
+					return true;
+			}
+		}
+
+		// Next block holding it, from the list of the ID
+		const uint32_t *list = id_blocks + ids[id].first;
+		const uint32_t *next = upper_bound(list, list + ids[id].count, block);
+
+		if (block >= blocks_count || next == list + ids[id].count)
+		{
+			SeekFrame(frames);
+			return false;
+		}
+		if (!LoadBlock(*next))
+			return false;
+	}
+}
+
+} /* namespace lin */
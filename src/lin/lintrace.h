@@ -0,0 +1,174 @@
+/*
+ * lintrace.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINTRACE_H_
+#define LIN_LINTRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <lincapture.h>
+#include <linprotocol.h>
+
+
+// Frames are buffered and written in blocks of about this size
+#define LIN_TRACE_BLOCK_SIZE				16384
+
+
+namespace lin {
+
+struct lintrace_block_s;
+struct lintrace_id_s;
+
+/*
+ * Binary trace of bus frames (.lint), append only:
+ *
+ *   header | block | block | ... | index
+ *
+ * Blocks start with a sync header, holding the number and time of their first
+ * frame and the IDs they contain, followed by the frames. Every frame is the
+ * zigzag varint of the nanoseconds since the previous frame, a control byte
+ * with the data length and which optional fields follow, the PID, the flags and
+ * bus when not zero, the data and the checksum: 15 bytes for a frame of 8 data
+ * bytes a few milliseconds after the previous one. Data and checksum equal to
+ * the previous frame of the same ID in the block are not repeated, so frames
+ * whose signals do not change take 6 bytes.
+ *
+ * Close() appends the index, the first frame and time of every block and the
+ * list of blocks holding each frame ID, and writes its offset in the header.
+ * A trace not closed (the recorder was killed) is still read, the reader walks
+ * the block headers and builds the index itself, losing at most the block that
+ * was being buffered.
+ */
+class lintracewriter {
+
+private:
+	int fd;
+	uint64_t offset;
+
+	// Block being filled, its header is written at the start of the buffer
+	uint8_t *block;
+	uint32_t block_size;
+	uint32_t block_count;
+	uint64_t block_frame;
+	uint64_t block_timestamp;
+	uint64_t block_ids;
+	uint64_t previous;
+
+	// Last data of every frame ID in the block
+	uint64_t last_data[LIN_PROTOCOL_IDS];
+	uint8_t last_length[LIN_PROTOCOL_IDS];
+	uint8_t last_checksum[LIN_PROTOCOL_IDS];
+
+	uint64_t frames;
+	uint64_t last_timestamp;
+
+	// Index kept in memory until Close()
+	std::vector<lintrace_block_s> blocks;
+	std::vector<uint32_t> id_blocks[LIN_PROTOCOL_IDS];
+	uint64_t id_frames[LIN_PROTOCOL_IDS];
+
+	bool WriteAll(const void *data, size_t size);
+
+public:
+	lintracewriter();
+	virtual ~lintracewriter();
+
+	bool Open(const char *filename);
+	bool Close();
+
+	// Frames shall come in time order, as read from one capture ring
+	bool Write(const lincapture::lincaptureframe_s *frame);
+
+	// Writes the frames buffered so far as a block
+	bool Flush();
+
+	uint64_t GetFramesCount();
+	uint64_t GetSize();
+
+};
+
+/*
+ * Reader of a binary trace. The file is mapped and the index used in place, so
+ * opening takes the same time for a minute or a week of traffic, and any time
+ * or frame ID is reached by binary searches and decoding at most one block.
+ *
+ * The reader is a cursor: SeekTime() or SeekFrame() place it and Next() reads
+ * the frames from there, all of them or only the ones of a frame ID, skipping
+ * the blocks without it.
+ */
+class lintracereader {
+
+private:
+	const uint8_t *image;
+	size_t size;
+	bool complete;
+
+	// Index, in the image or built when the trace was not closed
+	const lintrace_block_s *blocks;
+	uint32_t blocks_count;
+	const lintrace_id_s *ids;
+	const uint32_t *id_blocks;
+	std::vector<lintrace_block_s> recovered_blocks;
+	std::vector<lintrace_id_s> recovered_ids;
+	std::vector<uint32_t> recovered_id_blocks;
+
+	uint64_t frames;
+	uint32_t prefetch;
+
+	// Cursor
+	uint32_t block;
+	const uint8_t *p;
+	const uint8_t *end;
+	uint32_t left;
+	uint64_t frame;
+	uint64_t timestamp;
+	uint64_t last_data[LIN_PROTOCOL_IDS];
+	uint8_t last_length[LIN_PROTOCOL_IDS];
+	uint8_t last_checksum[LIN_PROTOCOL_IDS];
+
+	bool Recover();
+	bool LoadBlock(uint32_t b);
+	bool Decode(lincapture::lincaptureframe_s *f);
+	uint32_t FindBlockByTime(uint64_t timestamp);
+
+public:
+	lintracereader();
+	virtual ~lintracereader();
+
+	bool Open(const char *filename);
+	void Close();
+
+	// False when the index was rebuilt from the blocks
+	bool IsComplete();
+
+	// Frames per ID are only kept in the index, they are 0 for a trace not closed
+	uint64_t GetFramesCount();
+	uint64_t GetFramesCount(uint8_t id);
+	uint64_t GetFirstTimestamp();
+	uint64_t GetLastTimestamp();
+	uint32_t GetBlocksCount();
+	uint64_t GetBlockFrame(uint32_t b);
+
+	// Asks the kernel to read ahead the blocks after the one being decoded, 0 by default
+	void SetPrefetch(uint32_t blocks);
+
+	// Places the cursor on the first frame at or after the time, or on frame n
+	bool SeekTime(uint64_t timestamp);
+	bool SeekFrame(uint64_t n);
+
+	// Number of the frame Next() reads
+	uint64_t GetPosition();
+
+	bool Next(lincapture::lincaptureframe_s *frame);
+	bool Next(uint8_t id, lincapture::lincaptureframe_s *frame);
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINTRACE_H_ */
@@ -0,0 +1,415 @@
+/*
+ * lintracedecoder.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#include <string.h>
+#include <endian.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <lintrace.h>
+#include <lintracedecoder.h>
+
+
+// Samples converted to physical values at once
+#define LIN_TRACE_DECODER_BATCH				4096
+
+// Trace blocks decoded at once by a worker, at most
+#define LIN_TRACE_DECODER_CHUNK_BLOCKS		16
+
+// Samples of a column converted by one worker
+#define LIN_TRACE_DECODER_PIECE				(1u << 20)
+
+
+using namespace std;
+
+
+namespace lin {
+
+// Runs the worker on threads threads, the calling thread is one of them
+static void RunWorkers(uint32_t threads, const function<void()> &worker)
+{
+	thread *workers = new thread[threads];
+
+	for (uint32_t i = 1; i < threads; i++)
+		workers[i] = thread(worker);
+	worker();
+	for (uint32_t i = 1; i < threads; i++)
+		workers[i].join();
+	delete[] workers;
+}
+
+lintracedecoder::lintracedecoder(ldf *db) : layout(db), encoding(db)
+{
+	this->db = db;
+	columns = NULL;
+	columns_count = 0;
+	slots = NULL;
+	slots_count = 0;
+	frames = 0;
+	skipped = 0;
+
+	MapColumns();
+}
+
+lintracedecoder::~lintracedecoder()
+{
+	FreeColumns();
+}
+
+void lintracedecoder::FreeColumns()
+{
+	for (uint32_t i = 0; i < columns_count; i++)
+	{
+		delete[] columns[i].timestamps;
+		delete[] columns[i].raw;
+		delete[] columns[i].physical;
+	}
+	delete[] columns;
+	columns = NULL;
+	columns_count = 0;
+	delete[] slots;
+	slots = NULL;
+	slots_count = 0;
+	frames = 0;
+	skipped = 0;
+}
+
+void lintracedecoder::Compile()
+{
+	layout.Compile();
+	encoding.Compile();
+	MapColumns();
+}
+
+void lintracedecoder::MapColumns()
+{
+	FreeColumns();
+
+	columns_count = encoding.GetSignalsCount();
+	columns = new lintracecolumn_s[columns_count];
+	memset(columns, 0, columns_count * sizeof(lintracecolumn_s));
+	for (uint32_t i = 0; i < columns_count; i++)
+	{
+		columns[i].encoding = encoding.GetSignalByIndex(i);
+		columns[i].signal = columns[i].encoding->signal;
+	}
+
+	// Frame layout signals to columns
+	for (uint32_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		const linlayout::linlayoutframe_s *f = layout.GetFrame(id);
+		if (f != NULL && f->first + f->count > slots_count)
+			slots_count = f->first + f->count;
+	}
+	slots = new lintracecolumn_s *[slots_count];
+	memset(slots, 0, slots_count * sizeof(lintracecolumn_s *));
+	for (uint32_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+	{
+		const linlayout::linlayoutframe_s *f = layout.GetFrame(id);
+		if (f == NULL)
+			continue;
+
+		for (uint32_t i = 0; i < f->count; i++)
+		{
+			const linlayout::linlayoutsignal_s *s = layout.GetSignal(f, i);
+			const linencoding::linencodingsignal_s *e;
+
+			if (s->mask == 0 || s->signal == NULL || (e = encoding.GetSignalByName(s->signal->GetName())) == NULL)
+				continue;
+
+			slots[f->first + i] = &columns[e - encoding.GetSignalByIndex(0)];
+			slots[f->first + i]->sources++;
+		}
+	}
+}
+
+const linlayout::linlayoutframe_s *lintracedecoder::GetValidFrame(const lincapture::lincaptureframe_s *f)
+{
+	const linlayout::linlayoutframe_s *l;
+
+	if (f->flags != 0)
+		return NULL;
+
+	l = layout.GetFrame(f->pid & 0x3F);
+	return (l != NULL && l->length == f->length) ? l : NULL;
+}
+
+bool lintracedecoder::Decode(const char *filename, uint32_t threads)
+{
+	lintracereader trace;
+	uint32_t chunks;
+	vector<uint64_t> counts, offsets;
+	vector<pair<uint32_t, uint64_t>> pieces;
+	atomic<uint32_t> next;
+	atomic<bool> ok(true);
+	atomic<uint64_t> skipped_frames(0);
+
+	// Previous results
+	for (uint32_t i = 0; i < columns_count; i++)
+	{
+		delete[] columns[i].timestamps;
+		delete[] columns[i].raw;
+		delete[] columns[i].physical;
+		columns[i].timestamps = NULL;
+		columns[i].raw = NULL;
+		columns[i].physical = NULL;
+		columns[i].count = 0;
+	}
+	frames = 0;
+	skipped = 0;
+
+	if (!trace.Open(filename))
+		return false;
+
+	// Several chunks per worker, each chunk a run of blocks small enough to be grouped in cache
+	if (threads == 0) threads = thread::hardware_concurrency();
+	if (threads == 0) threads = 1;
+	chunks = max(threads * LIN_TRACE_DECODER_CHUNKS, trace.GetBlocksCount() / LIN_TRACE_DECODER_CHUNK_BLOCKS);
+	if (chunks > trace.GetBlocksCount()) chunks = trace.GetBlocksCount();
+	if (chunks == 0)
+		return true;
+	if (threads > chunks) threads = chunks;
+
+	// Decodes the frames of a chunk with a worker's own reader
+	auto decode_chunk = [&](lintracereader *r, uint32_t c, auto f)
+	{
+		uint64_t end = r->GetBlockFrame((uint64_t)(c + 1) * trace.GetBlocksCount() / chunks);
+		lincapture::lincaptureframe_s frame;
+
+		if (!r->SeekFrame(r->GetBlockFrame((uint64_t)c * trace.GetBlocksCount() / chunks)))
+		{
+			ok = false;
+			return;
+		}
+		while (r->GetPosition() < end)
+		{
+			if (!r->Next(&frame))
+			{
+				ok = false;
+				return;
+			}
+			f(&frame);
+		}
+	};
+
+	// First pass, frames of every ID in every chunk
+	counts.assign((size_t)chunks * LIN_PROTOCOL_IDS, 0);
+	next = 0;
+	RunWorkers(threads, [&]()
+	{
+		lintracereader r;
+		uint32_t c;
+
+		if (!r.Open(filename))
+		{
+			ok = false;
+			return;
+		}
+		while ((c = next++) < chunks)
+		{
+			uint64_t *count = &counts[(size_t)c * LIN_PROTOCOL_IDS];
+
+			decode_chunk(&r, c, [&](const lincapture::lincaptureframe_s *frame)
+			{
+				if (GetValidFrame(frame) != NULL)
+					count[frame->pid & 0x3F]++;
+				else
+					skipped_frames++;
+			});
+		}
+	});
+	if (!ok)
+		return false;
+
+	// Where every chunk writes the samples of every frame signal, chunks in time order
+	offsets.assign((size_t)chunks * slots_count, 0);
+	for (uint32_t c = 0; c < chunks; c++)
+	{
+		for (uint32_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+		{
+			const linlayout::linlayoutframe_s *f = layout.GetFrame(id);
+			uint64_t n = counts[(size_t)c * LIN_PROTOCOL_IDS + id];
+
+			if (f == NULL)
+				continue;
+
+			frames += n;
+			for (uint32_t i = 0; i < f->count; i++)
+			{
+				lintracecolumn_s *col = slots[f->first + i];
+				if (col == NULL)
+					continue;
+
+				offsets[(size_t)c * slots_count + f->first + i] = col->count;
+				col->count += n;
+			}
+		}
+	}
+	skipped = skipped_frames;
+
+	for (uint32_t i = 0; i < columns_count; i++)
+	{
+		lintracecolumn_s *col = &columns[i];
+
+		if (col->count == 0)
+			continue;
+
+		col->timestamps = new uint64_t[col->count];
+		col->raw = new uint64_t[col->count];
+		if (col->encoding->encoding != NULL && (col->encoding->encoding->flags & linencoding::LIN_ENCODING_PHYSICAL))
+			col->physical = new double[col->count];
+	}
+
+	// Second pass, frames of every chunk grouped by ID, then unpacked signal by signal into the columns
+	next = 0;
+	RunWorkers(threads, [&]()
+	{
+		lintracereader r;
+		vector<uint64_t> timestamps, words;
+		uint64_t first[LIN_PROTOCOL_IDS], position[LIN_PROTOCOL_IDS];
+		uint32_t c;
+
+		if (!r.Open(filename))
+		{
+			ok = false;
+			return;
+		}
+		while ((c = next++) < chunks)
+		{
+			const uint64_t *count = &counts[(size_t)c * LIN_PROTOCOL_IDS];
+			uint64_t n = 0;
+
+			for (uint32_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+			{
+				first[id] = position[id] = n;
+				n += count[id];
+			}
+			timestamps.resize(n);
+			words.resize(n);
+
+			decode_chunk(&r, c, [&](const lincapture::lincaptureframe_s *frame)
+			{
+				uint64_t p, word;
+
+				if (GetValidFrame(frame) == NULL)
+					return;
+
+				p = position[frame->pid & 0x3F]++;
+				memcpy(&word, frame->data, sizeof(word));
+				timestamps[p] = frame->timestamp;
+				words[p] = le64toh(word);
+			});
+
+			// Few columns written at once, in sequence
+			for (uint32_t id = 0; id < LIN_PROTOCOL_IDS; id++)
+			{
+				const linlayout::linlayoutframe_s *f = layout.GetFrame(id);
+
+				if (f == NULL || count[id] == 0)
+					continue;
+
+				for (uint32_t i = 0; i < f->count; i++)
+				{
+					const linlayout::linlayoutsignal_s *s = layout.GetSignal(f, i);
+					lintracecolumn_s *col = slots[f->first + i];
+					uint64_t to = offsets[(size_t)c * slots_count + f->first + i];
+
+					if (col == NULL)
+						continue;
+
+					memcpy(col->timestamps + to, &timestamps[first[id]], count[id] * sizeof(uint64_t));
+					for (uint64_t j = 0; j < count[id]; j++)
+						col->raw[to + j] = (words[first[id] + j] >> s->shift) & s->mask;
+				}
+			}
+		}
+	});
+	if (!ok)
+		return false;
+
+	// Signals carried by several frames were written frame after frame in every chunk
+	for (uint32_t i = 0; i < columns_count; i++)
+	{
+		lintracecolumn_s *col = &columns[i];
+		vector<pair<uint64_t, uint64_t>> samples;
+
+		if (col->sources < 2 || col->count == 0)
+			continue;
+
+		samples.resize(col->count);
+		for (uint64_t j = 0; j < col->count; j++)
+			samples[j] = make_pair(col->timestamps[j], col->raw[j]);
+		stable_sort(samples.begin(), samples.end(),
+				[](const pair<uint64_t, uint64_t> &a, const pair<uint64_t, uint64_t> &b) { return a.first < b.first; });
+		for (uint64_t j = 0; j < col->count; j++)
+		{
+			col->timestamps[j] = samples[j].first;
+			col->raw[j] = samples[j].second;
+		}
+	}
+
+	// Physical values, in pieces of columns
+	for (uint32_t i = 0; i < columns_count; i++)
+		for (uint64_t j = 0; columns[i].physical != NULL && j < columns[i].count; j += LIN_TRACE_DECODER_PIECE)
+			pieces.push_back(make_pair(i, j));
+
+	next = 0;
+	RunWorkers(threads, [&]()
+	{
+		uint32_t raw[LIN_TRACE_DECODER_BATCH];
+		uint32_t ix;
+
+		while ((ix = next++) < pieces.size())
+		{
+			lintracecolumn_s *col = &columns[pieces[ix].first];
+			uint64_t from = pieces[ix].second;
+			uint64_t to = min(from + LIN_TRACE_DECODER_PIECE, col->count);
+
+			for (uint64_t j = from; j < to; j += LIN_TRACE_DECODER_BATCH)
+			{
+				uint32_t n = min((uint64_t)LIN_TRACE_DECODER_BATCH, to - j);
+
+				for (uint32_t k = 0; k < n; k++)
+					raw[k] = col->raw[j + k];
+				linencoding::ToPhysical(col->encoding, raw, col->physical + j, n);
+			}
+		}
+	});
+
+	return true;
+}
+
+uint32_t lintracedecoder::GetColumnsCount()
+{
+	return columns_count;
+}
+
+const lintracedecoder::lintracecolumn_s *lintracedecoder::GetColumnByIndex(uint32_t ix)
+{
+	return (ix < columns_count) ? &columns[ix] : NULL;
+}
+
+const lintracedecoder::lintracecolumn_s *lintracedecoder::GetColumnByName(const uint8_t *name)
+{
+	const linencoding::linencodingsignal_s *e = encoding.GetSignalByName(name);
+
+	return (e != NULL) ? &columns[e - encoding.GetSignalByIndex(0)] : NULL;
+}
+
+uint64_t lintracedecoder::GetFramesCount()
+{
+	return frames;
+}
+
+uint64_t lintracedecoder::GetSkippedFramesCount()
+{
+	return skipped;
+}
+
+} /* namespace lin */
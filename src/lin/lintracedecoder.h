@@ -0,0 +1,94 @@
+/*
+ * lintracedecoder.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: iso9660
+ */
+
+#ifndef LIN_LINTRACEDECODER_H_
+#define LIN_LINTRACEDECODER_H_
+
+#include <stdint.h>
+#include <ldf.h>
+#include <linlayout.h>
+#include <linencoding.h>
+#include <lincapture.h>
+
+
+// Chunks of trace blocks per worker, so workers finishing early take more
+#define LIN_TRACE_DECODER_CHUNKS			8
+
+
+namespace lin {
+
+/*
+ * Offline decoder of binary traces into one column of samples per signal of a
+ * database: the time of the frame, the raw value and, for signals with a
+ * physical encoding, the physical value.
+ *
+ * The blocks of the trace are split in chunks decoded in parallel, each worker
+ * with its own reader of the mapped file. A first pass counts the frames of
+ * every ID in every chunk, which gives the size of every column and where each
+ * chunk writes in it, so the second pass unpacks the frames with the compiled
+ * layouts straight into the columns, in time order, without merging. Physical
+ * values are then converted in batches per column.
+ *
+ * Frames with error flags, of IDs without frame in the database or with a
+ * length other than the frame length are skipped.
+ */
+class lintracedecoder {
+
+public:
+	struct lintracecolumn_s
+	{
+		ldfsignal *signal;
+		const linencoding::linencodingsignal_s *encoding;
+		uint64_t count;
+		uint64_t *timestamps;
+		uint64_t *raw;
+		double *physical;				// NULL for signals without physical encoding
+		uint32_t sources;				// Frames carrying the signal
+	};
+
+private:
+	ldf *db;
+	linlayout layout;
+	linencoding encoding;
+
+	// One column per signal of the database, in the same order
+	lintracecolumn_s *columns;
+	uint32_t columns_count;
+
+	// Column of every signal of every frame layout, NULL for signals outside their frame
+	lintracecolumn_s **slots;
+	uint32_t slots_count;
+
+	uint64_t frames;
+	uint64_t skipped;
+
+	void FreeColumns();
+	void MapColumns();
+	const linlayout::linlayoutframe_s *GetValidFrame(const lincapture::lincaptureframe_s *f);
+
+public:
+	lintracedecoder(ldf *db);
+	virtual ~lintracedecoder();
+
+	// Layouts and encodings are compiled again after the database changes
+	void Compile();
+
+	// Decodes a whole trace, with one worker per core when threads is 0
+	bool Decode(const char *filename, uint32_t threads);
+
+	uint32_t GetColumnsCount();
+	const lintracecolumn_s *GetColumnByIndex(uint32_t ix);
+	const lintracecolumn_s *GetColumnByName(const uint8_t *name);
+
+	uint64_t GetFramesCount();
+	uint64_t GetSkippedFramesCount();
+
+};
+
+} /* namespace lin */
+
+#endif /* LIN_LINTRACEDECODER_H_ */
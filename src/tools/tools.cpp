@@ -136,8 +136,8 @@ void TreeViewPrepare(GObject *v, const char **columns)
 
 const char *GetStrPrintf(const char *format, ...)
 {
-	static char str[100000];
-	static int ix = 0;
+	static thread_local char str[100000];
+	static thread_local int ix = 0;
 	va_list argptr;
 
 	// Increase index
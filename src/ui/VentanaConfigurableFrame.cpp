@@ -80,7 +80,7 @@ ldfconfigurableframe *VentanaConfigurableFrame::ShowModal(GObject *parent)
 		const gchar *name = gtk_combo_box_get_active_id(GTK_COMBO_BOX(g_VentanaConfigurableFrameName));
 
 		// Compose the signal
-		res = new ldfconfigurableframe(Str(name), id);
+		res = new ldfconfigurableframe(db->GetStrings(), Str(name), id);
 	}
 	gtk_widget_hide(GTK_WIDGET(handle));
 
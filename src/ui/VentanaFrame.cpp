@@ -154,7 +154,7 @@ ldfframe *VentanaFrame::ShowModal(GObject *parent)
 		const gchar *publisher = gtk_combo_box_get_active_id(GTK_COMBO_BOX(g_VentanaFramePublisher));
 
 		// Compose the signal
-		res = new ldfframe(Str(name), id, Str(publisher), size);
+		res = new ldfframe(db->GetStrings(), Str(name), id, Str(publisher), size);
 
 		// Signals
 		char *strOffset;
@@ -167,7 +167,7 @@ ldfframe *VentanaFrame::ShowModal(GObject *parent)
 			{
 				gtk_tree_model_get(model, &iter, 0, &strOffset, -1);
 				gtk_tree_model_get(model, &iter, 1, &signal, -1);
-				res->AddSignal(new ldfframesignal(Str(signal), MultiParseInt(strOffset)));
+				res->AddSignal(new ldfframesignal(db->GetStrings(), Str(signal), MultiParseInt(strOffset)));
 			}
 			while (gtk_tree_model_iter_next(model, &iter));
 		}
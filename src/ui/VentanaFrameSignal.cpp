@@ -151,7 +151,7 @@ ldfframesignal *VentanaFrameSignal::ShowModal(GObject *parent)
 		const gchar *name = gtk_combo_box_get_active_id(GTK_COMBO_BOX(g_VentanaFrameSignalName));
 
 		// Compose the signal
-		res = new ldfframesignal(Str(name), offset);
+		res = new ldfframesignal(db->GetStrings(), Str(name), offset);
 	}
 	gtk_widget_hide(GTK_WIDGET(handle));
 
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include "tools.h"
 #include "ldfcommon.h"
+#include "ldfcache.h"
 #include "ManagerConfig.h"
 #include "VentanaInicio.h"
 #include "VentanaNodoEsclavo.h"
@@ -30,6 +31,8 @@ VentanaInicio::VentanaInicio(GtkBuilder *builder)
 	// Initialize attributes
 	this->db = NULL;
 	this->builder = builder;
+	log_source = 0;
+	log_next = 0;
 	handle = gtk_builder_get_object(builder, "VentanaInicio");
 
 	// Pin widgets
@@ -121,6 +124,7 @@ VentanaInicio::VentanaInicio(GtkBuilder *builder)
 
 VentanaInicio::~VentanaInicio()
 {
+	if (log_source != 0) g_source_remove(log_source);
 	if (db != NULL) delete db;
 }
 
@@ -131,9 +135,13 @@ void VentanaInicio::ReloadDatabase()
 	// Check database path is valid
 	if (database_path == NULL) return;
 
-	// If database is loaded delete it and create a new one
+	// Stop logging findings of the previous database
+	if (log_source != 0) g_source_remove(log_source);
+	log_source = 0;
+
+	// If database is loaded delete it and create a new one, from its binary cache when it is up to date
 	if (db != NULL) delete db;
-	db = new ldf(database_path);
+	db = ldfcache::Load(database_path);
 
 	// Pause all signal handlers
 	G_PAUSE_DATA(PanelConfiguracionDatabase, this);
@@ -151,15 +159,16 @@ void VentanaInicio::ReloadDatabase()
 	// Set database path in file chooser
 	gtk_file_chooser_set_filename(GTK_FILE_CHOOSER(g_PanelConfiguracionDatabase), (char *)database_path);
 
-	// Fill log
-	if (db->GetValidationMessagesCount() == 0)
+	// Fill log, findings are formatted a batch at a time while the window is idle
+	if (db->GetDiagnostics()->GetCount() == 0)
 	{
 		LogViewAddLine(g_PanelConfiguracionLog, "LIN database loaded without issues.");
 	}
 	else
 	{
-		for (uint32_t i = 0; i < db->GetValidationMessagesCount(); i++)
-			LogViewAddLine(g_PanelConfiguracionLog, (const gchar *)db->GetValidationMessageByIndex(i));
+		LogViewAddLine(g_PanelConfiguracionLog, GetStrPrintf("LIN database loaded with %u issues.", db->GetDiagnostics()->GetCount()));
+		log_next = 0;
+		log_source = g_idle_add(OnPanelConfiguracionLog_idle, this);
 	}
 
 	// Database LIN protocol version
@@ -203,6 +212,20 @@ void VentanaInicio::ReloadDatabase()
 	G_PLAY_FUNC(PanelDatabaseMasterJitter, EditableInsertValidator);
 }
 
+void VentanaInicio::Revalidate()
+{
+	uint32_t count = db->GetDiagnostics()->GetCount();
+
+	// Check again only what changed since the last validation
+	db->Revalidate();
+	if (db->GetDiagnostics()->GetCount() != count)
+		LogViewAddLine(g_PanelConfiguracionLog, GetStrPrintf("LIN database has now %u issues.", db->GetDiagnostics()->GetCount()));
+
+	// Findings are reordered, a log still being written starts again from the first one
+	if (log_source != 0)
+		log_next = 0;
+}
+
 void VentanaInicio::PrepareListSlaves()
 {
 	const char *columns[] = { "Slave", "INAD", "CNAD", "ERR SIG", "CFG FRM", NULL };
@@ -415,6 +438,33 @@ void VentanaInicio::ReloadListScheduleTables()
 	}
 }
 
+gboolean VentanaInicio::OnPanelConfiguracionLog_idle(gpointer user_data)
+{
+	VentanaInicio *v = (VentanaInicio *)user_data;
+	ldfdiagnostics *d = v->db->GetDiagnostics();
+	char text[1000];
+
+	// Write next batch of findings
+	for (uint32_t i = 0; (i < 200) && (v->log_next < d->GetCount()); i++, v->log_next++)
+	{
+		d->GetText(v->log_next, text, sizeof(text));
+		if (d->GetOccurrences(v->log_next) > 1)
+			LogViewAddLine(v->g_PanelConfiguracionLog, GetStrPrintf("%s (%u times)", text, d->GetOccurrences(v->log_next)));
+		else
+			LogViewAddLine(v->g_PanelConfiguracionLog, text);
+	}
+
+	// Keep the source until all findings are written
+	if (v->log_next < d->GetCount())
+		return G_SOURCE_CONTINUE;
+
+	if (d->GetDroppedCount() > 0)
+		LogViewAddLine(v->g_PanelConfiguracionLog, GetStrPrintf("%u more issues not listed.", d->GetDroppedCount()));
+
+	v->log_source = 0;
+	return G_SOURCE_REMOVE;
+}
+
 void VentanaInicio::OnPanelConfiguracionDatabase_file_set(GtkFileChooserButton *widget, gpointer user_data)
 {
 	VentanaInicio *v = (VentanaInicio *)user_data;
@@ -466,6 +516,7 @@ void VentanaInicio::OnPanelDatabaseLinProtocolVersion_changed(GtkComboBox *widge
 	VentanaInicio *v = (VentanaInicio *)user_data;
 
 	v->db->SetLinProtocolVersion(GetProtocolVersionByStringID(gtk_combo_box_get_active_id(widget)));
+	v->Revalidate();
 }
 
 void VentanaInicio::OnPanelDatabaseLinLanguageVersion_changed(GtkComboBox *widget, gpointer user_data)
@@ -473,6 +524,7 @@ void VentanaInicio::OnPanelDatabaseLinLanguageVersion_changed(GtkComboBox *widge
 	VentanaInicio *v = (VentanaInicio *)user_data;
 
 	v->db->SetLinLanguageVersion(GetLanguageVersionByStringID(gtk_combo_box_get_active_id(widget)));
+	v->Revalidate();
 }
 
 void VentanaInicio::OnPanelDatabaseLinSpeed_changed(GtkCellEditable *widget, gpointer user_data)
@@ -480,6 +532,7 @@ void VentanaInicio::OnPanelDatabaseLinSpeed_changed(GtkCellEditable *widget, gpo
 	VentanaInicio *v = (VentanaInicio *)user_data;
 
 	v->db->SetLinSpeed(EntryGetInt(G_OBJECT(widget)));
+	v->Revalidate();
 }
 
 void VentanaInicio::OnPanelDatabaseMasterName_changed(GtkCellEditable *widget, gpointer user_data)
@@ -504,6 +557,7 @@ void VentanaInicio::OnPanelDatabaseMasterName_changed(GtkCellEditable *widget, g
 	// Update node name and reload all lists
 	v->db->UpdateMasterNodeName(v->db->GetMasterNode()->GetName(), Str(new_master_name));
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSignals();
 	v->ReloadListFrames();
 }
@@ -543,6 +597,7 @@ void VentanaInicio::OnPanelDatabaseSlavesNew_clicked(GtkButton *button, gpointer
 
 	// Reload slaves list
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSlaves();
 	v->ReloadListSignals();
 }
@@ -568,6 +623,7 @@ void VentanaInicio::OnPanelDatabaseSlavesEdit_clicked(GtkButton *button, gpointe
 
 	// Reload slaves list
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSlaves();
 	v->ReloadListSignals();
 	v->ReloadListFrames();
@@ -580,13 +636,20 @@ void VentanaInicio::OnPanelDatabaseSlavesDelete_clicked(GtkButton *button, gpoin
 	GtkTreeModel *model;
 	GtkTreeIter iter;
 	gchar *slave_name;
+	uint32_t users_count;
 
 	// Get slave name
 	gtk_tree_selection_get_selected(GTK_TREE_SELECTION(v->g_PanelDatabaseSlavesSelection), &model, &iter);
 	gtk_tree_model_get(model, &iter, 0, &slave_name, -1);
 
-	// Ask before deleting
-	if (!ShowChooseMessageBox(v->handle, "Delete slave '%s'?", slave_name))
+	// Ask before deleting, telling where it is used
+	users_count = v->db->GetReferences()->GetUsersCount(ldfreferences::LDF_REF_NODE, v->db->GetStrings()->Find(Str(slave_name)));
+	if (users_count > 0)
+	{
+		if (!ShowChooseMessageBox(v->handle, "Slave '%s' is used in %u places. Delete it?", slave_name, users_count))
+			return;
+	}
+	else if (!ShowChooseMessageBox(v->handle, "Delete slave '%s'?", slave_name))
 		return;
 
 	// Delete slave node
@@ -594,6 +657,7 @@ void VentanaInicio::OnPanelDatabaseSlavesDelete_clicked(GtkButton *button, gpoin
 
 	// Reload slaves list
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSlaves();
 	v->ReloadListSignals();
 	v->ReloadListFrames();
@@ -640,6 +704,7 @@ void VentanaInicio::OnPanelDatabaseSignalsNew_clicked(GtkButton *button, gpointe
 	// Store the new signal
 	v->db->AddSignal(s);
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSignals();
 }
 
@@ -662,6 +727,7 @@ void VentanaInicio::OnPanelDatabaseSignalsEdit_clicked(GtkButton *button, gpoint
 	// Update signal
 	v->db->UpdateSignal(Str(signal_name), s);
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSlaves();
 	v->ReloadListSignals();
 	v->ReloadListFrames();
@@ -673,18 +739,26 @@ void VentanaInicio::OnPanelDatabaseSignalsDelete_clicked(GtkButton *button, gpoi
 	GtkTreeModel *model;
 	GtkTreeIter iter;
 	gchar *signal_name;
+	uint32_t users_count;
 
 	// Get signal name
 	gtk_tree_selection_get_selected(GTK_TREE_SELECTION(v->g_PanelDatabaseSignalsSelection), &model, &iter);
 	gtk_tree_model_get(model, &iter, 0, &signal_name, -1);
 
-	// Ask before deleting
-	if (!ShowChooseMessageBox(v->handle, "Delete signal '%s'?", signal_name))
+	// Ask before deleting, telling where it is used
+	users_count = v->db->GetReferences()->GetUsersCount(ldfreferences::LDF_REF_SIGNAL, v->db->GetStrings()->Find(Str(signal_name)));
+	if (users_count > 0)
+	{
+		if (!ShowChooseMessageBox(v->handle, "Signal '%s' is used in %u places. Delete it?", signal_name, users_count))
+			return;
+	}
+	else if (!ShowChooseMessageBox(v->handle, "Delete signal '%s'?", signal_name))
 		return;
 
 	// Delete the signal
 	v->db->DeleteSignal(Str(signal_name));
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSlaves();
 	v->ReloadListSignals();
 	v->ReloadListFrames();
@@ -735,6 +809,7 @@ void VentanaInicio::OnPanelDatabaseFramesNew_clicked(GtkButton *button, gpointer
 	// Store the new signal
 	v->db->AddFrame(s);
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSignals();
 	v->ReloadListFrames();
 }
@@ -758,6 +833,7 @@ void VentanaInicio::OnPanelDatabaseFramesEdit_clicked(GtkButton *button, gpointe
 	// Update frame
 	v->db->UpdateFrame(Str(frame_name), f);
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSlaves();
 	v->ReloadListSignals();
 	v->ReloadListFrames();
@@ -770,18 +846,26 @@ void VentanaInicio::OnPanelDatabaseFramesDelete_clicked(GtkButton *button, gpoin
 	GtkTreeModel *model;
 	GtkTreeIter iter;
 	gchar *frame_name;
+	uint32_t users_count;
 
 	// Get frame name
 	gtk_tree_selection_get_selected(GTK_TREE_SELECTION(v->g_PanelDatabaseFramesSelection), &model, &iter);
 	gtk_tree_model_get(model, &iter, 0, &frame_name, -1);
 
-	// Ask before deleting
-	if (!ShowChooseMessageBox(v->handle, "Delete frame '%s'?", frame_name))
+	// Ask before deleting, telling where it is used
+	users_count = v->db->GetReferences()->GetUsersCount(ldfreferences::LDF_REF_FRAME, v->db->GetStrings()->Find(Str(frame_name)));
+	if (users_count > 0)
+	{
+		if (!ShowChooseMessageBox(v->handle, "Frame '%s' is used in %u places. Delete it?", frame_name, users_count))
+			return;
+	}
+	else if (!ShowChooseMessageBox(v->handle, "Delete frame '%s'?", frame_name))
 		return;
 
 	// Delete the frame
 	v->db->DeleteFrame(Str(frame_name));
 	v->db->SortData();
+	v->Revalidate();
 	v->ReloadListSlaves();
 	v->ReloadListSignals();
 	v->ReloadListFrames();
@@ -838,6 +922,7 @@ void VentanaInicio::OnPanelDatabaseScheduleTablesNew_clicked(GtkButton *button,
 
 	// Update schedule table
 	v->db->AddScheduleTable(t);
+	v->Revalidate();
 	v->ReloadListScheduleTables();
 }
 
@@ -860,6 +945,7 @@ void VentanaInicio::OnPanelDatabaseScheduleTablesEdit_clicked(GtkButton *button,
 
 	// Update schedule table
 	v->db->UpdateScheduleTable(Str(schedule_table_name), t);
+	v->Revalidate();
 	v->ReloadListScheduleTables();
 }
 
@@ -880,6 +966,7 @@ void VentanaInicio::OnPanelDatabaseScheduleTablesDelete_clicked(GtkButton *butto
 
 	// Delete schedule table
 	v->db->DeleteScheduleTable(Str(schedule_table_name));
+	v->Revalidate();
 	v->ReloadListScheduleTables();
 }
 
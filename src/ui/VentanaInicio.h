@@ -55,8 +55,13 @@ private:
 	G_VAR(PanelConfiguracionSave);
 	G_VAR(PanelConfiguracionSaveAs);
 
+	// Validation findings still to be written in the log
+	guint log_source;
+	uint32_t log_next;
+
 	// Processes
 	void ReloadDatabase();
+	void Revalidate();
 	void PrepareListSlaves();
 	void ReloadListSlaves();
 	void PrepareListSignals();
@@ -67,6 +72,7 @@ private:
 	void ReloadListScheduleTables();
 
 	// Signal events
+	static gboolean OnPanelConfiguracionLog_idle(gpointer user_data);
 	static void OnPanelConfiguracionDatabase_file_set(GtkFileChooserButton *widget, gpointer user_data);
 	static void OnPanelConfiguracionSave_clicked(GtkButton *button, gpointer user_data);
 	static void OnPanelConfiguracionSaveAs_clicked(GtkButton *button, gpointer user_data);
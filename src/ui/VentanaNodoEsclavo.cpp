@@ -206,7 +206,7 @@ ldfnodeattributes *VentanaNodoEsclavo::ShowModal(GObject *parent)
 	if (gtk_dialog_run(GTK_DIALOG(handle)))
 	{
 		// Name
-		res = new ldfnodeattributes(Str(EntryGetStr(g_VentanaNodoEsclavoName)));
+		res = new ldfnodeattributes(db->GetStrings(), Str(EntryGetStr(g_VentanaNodoEsclavoName)));
 
 		// Protocol version
 		res->SetProtocolVersion(GetProtocolVersionByStringID(gtk_combo_box_get_active_id(GTK_COMBO_BOX(g_VentanaNodoEsclavoProtocolVersion))));
@@ -254,7 +254,7 @@ ldfnodeattributes *VentanaNodoEsclavo::ShowModal(GObject *parent)
 			{
 				gtk_tree_model_get(model, &iter, 0, &frame_id, -1);
 				gtk_tree_model_get(model, &iter, 1, &frame_name, -1);
-				res->AddConfigurableFrame(new ldfconfigurableframe(Str(frame_name), MultiParseInt(frame_id)));
+				res->AddConfigurableFrame(new ldfconfigurableframe(db->GetStrings(), Str(frame_name), MultiParseInt(frame_id)));
 			}
 			while (gtk_tree_model_iter_next(model, &iter));
 		}
@@ -162,55 +162,57 @@ ldfschedulecommand *VentanaScheduleCommand::ShowModal(GObject *parent)
 
 		if (StrEq(str_type, "MasterReq"))
 		{
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_MasterReq, Str(str_type), timeout, NULL, NULL, NULL);
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_MasterReq, Str(str_type), timeout, NULL, NULL, NULL);
 		}
 		else if (StrEq(str_type, "SlaveResp"))
 		{
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_SlaveResp, Str(str_type), timeout, NULL, NULL, NULL);
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_SlaveResp, Str(str_type), timeout, NULL, NULL, NULL);
 		}
 		else if (StrEq(str_type, "AssignNAD"))
 		{
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_AssignNAD, Str(str_type), timeout, Str(str_slave), NULL, NULL);
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_AssignNAD, Str(str_type), timeout, Str(str_slave), NULL, NULL);
 		}
 		else if (StrEq(str_type, "DataDump"))
 		{
-			char *p = StrTokenParseFirst((char *)str_data, NULL, " ");
+			char *save = NULL;
+			char *p = StrTokenParseFirst((char *)str_data, NULL, " ", &save);
 			data[0] = ParseInt(p);
 			for (uint32_t i = 0; i < 4; i++)
 			{
-				p = StrTokenParseNext(p, NULL, " ");
+				p = StrTokenParseNext(p, NULL, " ", &save);
 				data[i + 1] = ParseInt(p);
 			}
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_DataDump, Str(str_type), timeout, Str(str_slave), data, NULL);
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_DataDump, Str(str_type), timeout, Str(str_slave), data, NULL);
 		}
 		else if (StrEq(str_type, "SaveConfiguration"))
 		{
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_SaveConfiguration, Str(str_type), timeout, Str(str_slave), NULL, NULL);
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_SaveConfiguration, Str(str_type), timeout, Str(str_slave), NULL, NULL);
 		}
 		else if (StrEq(str_type, "FreeFormat"))
 		{
-			char *p = StrTokenParseFirst((char *)str_data, NULL, " ");
+			char *save = NULL;
+			char *p = StrTokenParseFirst((char *)str_data, NULL, " ", &save);
 			data[0] = ParseInt(p);
 			for (uint32_t i = 0; i < 7; i++)
 			{
-				p = StrTokenParseNext(p, NULL, " ");
+				p = StrTokenParseNext(p, NULL, " ", &save);
 				data[i + 1] = ParseInt(p);
 			}
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_FreeFormat, Str(str_type), timeout, NULL, data, NULL);
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_FreeFormat, Str(str_type), timeout, NULL, data, NULL);
 		}
 		else if (StrEq(str_type, "AssignFrameIdRange"))
 		{
 			data[0] = db->GetFrameByName(Str(str_assign_frame))->GetPid();
 			data[1] = data_count;
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_AssignFrameIdRange, Str(str_type), timeout, Str(str_slave), data, NULL);
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_AssignFrameIdRange, Str(str_type), timeout, Str(str_slave), data, NULL);
 		}
 		else if (StrEq(str_type, "AssignFrameId"))
 		{
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_AssignFrameId, Str(str_type), timeout, Str(str_slave), NULL, Str(str_assign_frame));
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_AssignFrameId, Str(str_type), timeout, Str(str_slave), NULL, Str(str_assign_frame));
 		}
 		else
 		{
-			res = new ldfschedulecommand(ldfschedulecommand::LDF_SCMD_TYPE_UnconditionalFrame, Str(str_frame), timeout, NULL, NULL, NULL);
+			res = new ldfschedulecommand(db->GetStrings(), ldfschedulecommand::LDF_SCMD_TYPE_UnconditionalFrame, Str(str_frame), timeout, NULL, NULL, NULL);
 		}
 	}
 	gtk_widget_hide(GTK_WIDGET(handle));
@@ -300,7 +300,7 @@ ldfscheduletable *VentanaScheduleTable::ShowModal(GObject *parent)
 		GtkTreeModel *tm = gtk_tree_view_get_model(tv);
 
 		// Create schedule table
-		res = new ldfscheduletable(Str(EntryGetStr(g_VentanaScheduleTableName)));
+		res = new ldfscheduletable(db->GetStrings(), Str(EntryGetStr(g_VentanaScheduleTableName)));
 
 		// Add commands to schedule table
 		char *command;
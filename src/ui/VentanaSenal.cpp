@@ -164,7 +164,7 @@ ldfsignal *VentanaSenal::ShowModal(GObject *parent)
 		}
 
 		// Compose the signal
-		res = new ldfsignal(Str(signal_name), bit_size, default_value, Str(publisher), (const uint8_t **)subscribers, subscribers_count);
+		res = new ldfsignal(db->GetStrings(), Str(signal_name), bit_size, default_value, Str(publisher), (const uint8_t **)subscribers, subscribers_count);
 	}
 	gtk_widget_hide(GTK_WIDGET(handle));
 